@@ -0,0 +1,252 @@
+#include <ice/arctic_annotation_table.hxx>
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        //! \brief Process-wide attribute names, the index of a name is its key.
+        struct AttributeKeyRegistry
+        {
+            AttributeKeyRegistry() noexcept
+            {
+                // Needs to match the order of the predefined keys.
+                for (ice::String const name : { ice::String{ u8"in" }, ice::String{ u8"out" }, ice::String{ u8"constant" } })
+                {
+                    keys.emplace(std::u8string{ name }, ice::u32(keys.size()));
+                }
+            }
+
+            std::shared_mutex mutex;
+            std::unordered_map<std::u8string, ice::u32> keys;
+        };
+
+        auto attribute_key_registry() noexcept -> ice::arctic::detail::AttributeKeyRegistry&
+        {
+            static ice::arctic::detail::AttributeKeyRegistry registry{ };
+            return registry;
+        }
+
+        auto parse_attribute_integer(ice::String text, ice::u32 base, ice::u32 prefix_size) noexcept -> ice::i64
+        {
+            ice::i64 result = 0;
+            for (ice::utf8 const character : text.substr(prefix_size))
+            {
+                if (character == u8'\'')
+                {
+                    continue;
+                }
+
+                ice::u32 digit = 0;
+                if (character >= u8'0' && character <= u8'9')
+                {
+                    digit = character - u8'0';
+                }
+                else
+                {
+                    digit = (character | 0x20) - u8'a' + 10;
+                }
+                result = result * base + digit;
+            }
+            return result;
+        }
+
+        auto parse_attribute_float(ice::String text) noexcept -> ice::f64
+        {
+            char digits[64];
+            ice::u32 count = 0;
+            for (ice::utf8 const character : text)
+            {
+                if (character != u8'\'' && count < std::size(digits))
+                {
+                    digits[count++] = char(character);
+                }
+            }
+
+            ice::f64 result = 0.0;
+            std::from_chars(digits, digits + count, result);
+            return result;
+        }
+
+        auto decode_attribute(ice::arctic::SyntaxNode_AnnotationAttribute const* node) noexcept -> ice::arctic::Attribute
+        {
+            ice::arctic::Attribute result{
+                .key = ice::arctic::intern_attribute_key(node->name.value),
+                .type = AttributeValueType::None,
+                .integer = 0,
+                .floating = 0.0,
+                .text = node->value.value,
+                .node = node,
+            };
+
+            switch (node->value.type)
+            {
+            case TokenType::KW_True:
+            case TokenType::KW_False:
+                result.type = AttributeValueType::Bool;
+                result.integer = node->value.type == TokenType::KW_True;
+                break;
+            case TokenType::CT_Number:
+                result.type = AttributeValueType::Integer;
+                result.integer = parse_attribute_integer(node->value.value, 10, 0);
+                break;
+            case TokenType::CT_NumberHex:
+                result.type = AttributeValueType::Integer;
+                result.integer = parse_attribute_integer(node->value.value, 16, 2);
+                break;
+            case TokenType::CT_NumberBin:
+                result.type = AttributeValueType::Integer;
+                result.integer = parse_attribute_integer(node->value.value, 2, 2);
+                break;
+            case TokenType::CT_NumberOct:
+                result.type = AttributeValueType::Integer;
+                result.integer = parse_attribute_integer(node->value.value, 8, 1);
+                break;
+            case TokenType::CT_NumberFloat:
+                result.type = AttributeValueType::Float;
+                result.floating = parse_attribute_float(node->value.value);
+                result.integer = ice::i64(result.floating);
+                break;
+            case TokenType::CT_String:
+            case TokenType::CT_Literal:
+                result.type = AttributeValueType::String;
+                result.text = node->value.value.substr(1, node->value.value.size() - 2);
+                break;
+            case TokenType::CT_Symbol:
+                result.type = AttributeValueType::Symbol;
+                break;
+            default:
+                break;
+            }
+
+            if (result.type == AttributeValueType::Integer)
+            {
+                result.floating = ice::f64(result.integer);
+            }
+            return result;
+        }
+
+    } // namespace detail
+
+    auto intern_attribute_key(ice::String name) noexcept -> ice::arctic::AttributeKey
+    {
+        ice::arctic::detail::AttributeKeyRegistry& registry = ice::arctic::detail::attribute_key_registry();
+
+        std::u8string key_name{ name };
+        {
+            std::shared_lock const lock{ registry.mutex };
+            auto const it = registry.keys.find(key_name);
+            if (it != registry.keys.end())
+            {
+                return AttributeKey{ it->second };
+            }
+        }
+
+        std::unique_lock const lock{ registry.mutex };
+        ice::u32 const new_key = ice::u32(registry.keys.size());
+        return AttributeKey{ registry.keys.emplace(std::move(key_name), new_key).first->second };
+    }
+
+    auto find_attribute_key(ice::String name) noexcept -> ice::arctic::AttributeKey
+    {
+        ice::arctic::detail::AttributeKeyRegistry& registry = ice::arctic::detail::attribute_key_registry();
+
+        std::shared_lock const lock{ registry.mutex };
+        auto const it = registry.keys.find(std::u8string{ name });
+        return it != registry.keys.end() ? AttributeKey{ it->second } : AttributeKey::Invalid;
+    }
+
+    auto AnnotationTable::find(ice::arctic::AttributeKey key) const noexcept -> ice::arctic::Attribute const*
+    {
+        ice::u32 const key_value = static_cast<ice::u32>(key);
+        if (key_value < Constant_MaxIndexedKey)
+        {
+            ice::u64 const key_bit = ice::u64{ 1 } << key_value;
+            if ((_key_mask & key_bit) == 0)
+            {
+                return nullptr;
+            }
+            return &_attributes[std::popcount(_key_mask & (key_bit - 1))];
+        }
+
+        for (ice::arctic::Attribute const& attribute : _attributes.subspan(std::popcount(_key_mask)))
+        {
+            if (attribute.key == key)
+            {
+                return &attribute;
+            }
+        }
+        return nullptr;
+    }
+
+    void AnnotationTables::add_definition(ice::arctic::SyntaxNode const* definition) noexcept
+    {
+        if (definition->annotation == nullptr)
+        {
+            return;
+        }
+
+        TableRange range{ .key_mask = 0, .first = ice::u32(_attributes.size()), .count = 0 };
+
+        for (ice::arctic::SyntaxNode const* annotation = definition->annotation; annotation != nullptr; annotation = annotation->sibling)
+        {
+            for (ice::arctic::SyntaxNode const* attribute = annotation->child; attribute != nullptr; attribute = attribute->sibling)
+            {
+                _attributes.push_back(
+                    ice::arctic::detail::decode_attribute(static_cast<SyntaxNode_AnnotationAttribute const*>(attribute))
+                );
+                range.count += 1;
+            }
+        }
+
+        // The first attribute of each indexed key is moved to the front, so it can be found from the key mask alone.
+        auto const table_begin = _attributes.begin() + range.first;
+        std::stable_partition(table_begin, _attributes.end(), [&range](ice::arctic::Attribute const& attribute) noexcept
+            {
+                ice::u32 const key_value = static_cast<ice::u32>(attribute.key);
+                if (key_value >= AnnotationTable::Constant_MaxIndexedKey || (range.key_mask & (ice::u64{ 1 } << key_value)) != 0)
+                {
+                    return false;
+                }
+
+                range.key_mask |= ice::u64{ 1 } << key_value;
+                return true;
+            }
+        );
+
+        std::sort(table_begin, table_begin + std::popcount(range.key_mask), [](auto const& left, auto const& right) noexcept
+            {
+                return left.key < right.key;
+            }
+        );
+
+        _tables.insert_or_assign(definition, range);
+    }
+
+    auto AnnotationTables::find(ice::arctic::SyntaxNode const* definition) const noexcept -> ice::arctic::AnnotationTable
+    {
+        auto const it = _tables.find(definition);
+        if (it == _tables.end())
+        {
+            return { };
+        }
+
+        TableRange const& range = it->second;
+        return { range.key_mask, ice::Span<ice::arctic::Attribute const>{ _attributes }.subspan(range.first, range.count) };
+    }
+
+    void AnnotationTables::clear() noexcept
+    {
+        _attributes.clear();
+        _tables.clear();
+    }
+
+} // namespace ice::arctic
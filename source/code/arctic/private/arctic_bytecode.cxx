@@ -0,0 +1,267 @@
+#include <ice/arctic_bytecode.hxx>
+
+#include <fmt/format.h>
+#include <bit>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        static constexpr ice::arctic::OpcodeInfo Constant_OpcodeInfos[]{
+            { u8"nop", InstructionFormat::None, false },
+            { u8"return", InstructionFormat::None, false },
+            { u8"move", InstructionFormat::AB, true },
+            { u8"load_constant", InstructionFormat::ABx, true },
+            { u8"load_constant_splat", InstructionFormat::ABx, false },
+            { u8"load_data", InstructionFormat::ABx, true },
+            { u8"store_data", InstructionFormat::ABx, false },
+            { u8"splat", InstructionFormat::AB, false },
+            { u8"swizzle", InstructionFormat::ABC, false },
+            { u8"call", InstructionFormat::ABx, false },
+            { u8"convert_f32_i32", InstructionFormat::AB, true },
+            { u8"convert_f32_u32", InstructionFormat::AB, true },
+            { u8"convert_i32_f32", InstructionFormat::AB, true },
+            { u8"convert_u32_f32", InstructionFormat::AB, true },
+            { u8"add_f32", InstructionFormat::ABC, true },
+            { u8"sub_f32", InstructionFormat::ABC, true },
+            { u8"mul_f32", InstructionFormat::ABC, true },
+            { u8"div_f32", InstructionFormat::ABC, true },
+            { u8"neg_f32", InstructionFormat::AB, true },
+            { u8"add_i32", InstructionFormat::ABC, true },
+            { u8"sub_i32", InstructionFormat::ABC, true },
+            { u8"mul_i32", InstructionFormat::ABC, true },
+            { u8"div_i32", InstructionFormat::ABC, true },
+            { u8"neg_i32", InstructionFormat::AB, true },
+            { u8"add_u32", InstructionFormat::ABC, true },
+            { u8"sub_u32", InstructionFormat::ABC, true },
+            { u8"mul_u32", InstructionFormat::ABC, true },
+            { u8"div_u32", InstructionFormat::ABC, true },
+            { u8"and_bool", InstructionFormat::ABC, true },
+            { u8"or_bool", InstructionFormat::ABC, true },
+            { u8"mul_mtx_vec_f32", InstructionFormat::ABC, false },
+            { u8"mul_vec_mtx_f32", InstructionFormat::ABC, false },
+            { u8"mul_mtx_mtx_f32", InstructionFormat::ABC, false },
+        };
+
+        static_assert(std::size(Constant_OpcodeInfos) == ice::u32(ice::arctic::Opcode::Count));
+
+        static constexpr ice::arctic::OpcodeInfo Constant_InvalidOpcodeInfo{ u8"<invalid>", InstructionFormat::None, false };
+
+        //! \returns The number of words used by a table of the given entries.
+        template<typename T>
+        constexpr auto bytecode_table_words(ice::u64 count) noexcept -> ice::u64
+        {
+            return count * (sizeof(T) / sizeof(ice::u32));
+        }
+
+        template<typename T>
+        auto bytecode_table(ice::Span<ice::u32 const> words, ice::u64& offset, ice::u32 count) noexcept -> ice::Span<T const>
+        {
+            T const* const first = reinterpret_cast<T const*>(words.data() + offset);
+            offset += bytecode_table_words<T>(count);
+            return { first, count };
+        }
+
+        inline auto bytecode_text(ice::String text) noexcept -> std::string_view
+        {
+            return { reinterpret_cast<char const*>(text.data()), text.size() };
+        }
+
+        struct BytecodeTextWriter
+        {
+            std::u8string& out;
+
+            template<typename... Args>
+            void append(fmt::format_string<Args...> format, Args&&... args) noexcept
+            {
+                std::string const text = fmt::format(format, std::forward<Args>(args)...);
+                out.append(reinterpret_cast<ice::utf8 const*>(text.data()), text.size());
+            }
+        };
+
+    } // namespace detail
+
+    auto opcode_info(ice::arctic::Opcode opcode) noexcept -> ice::arctic::OpcodeInfo const&
+    {
+        return ice::u32(opcode) < ice::u32(Opcode::Count)
+            ? detail::Constant_OpcodeInfos[ice::u32(opcode)]
+            : detail::Constant_InvalidOpcodeInfo;
+    }
+
+    auto BytecodeView::from_words(ice::Span<ice::u32 const> words) noexcept -> ice::arctic::BytecodeView
+    {
+        constexpr ice::u64 header_words = sizeof(BytecodeHeader) / sizeof(ice::u32);
+        if (words.size() < header_words)
+        {
+            return { };
+        }
+
+        ice::arctic::BytecodeHeader const* const header = reinterpret_cast<BytecodeHeader const*>(words.data());
+        if (header->magic != BytecodeHeader::Constant_Magic || header->version != BytecodeHeader::Constant_Version)
+        {
+            return { };
+        }
+
+        ice::u64 const expected_words = header_words
+            + header->instruction_count
+            + header->constant_count
+            + detail::bytecode_table_words<BytecodeFunction>(header->function_count)
+            + detail::bytecode_table_words<BytecodeBinding>(header->binding_count)
+            + detail::bytecode_table_words<BytecodeDataRef>(header->data_ref_count)
+            + (ice::u64{ header->string_size } + 3) / 4;
+
+        if (expected_words != words.size())
+        {
+            return { };
+        }
+
+        ice::arctic::BytecodeView result{ };
+        result._header = header;
+
+        ice::u64 offset = header_words;
+        result._instructions = detail::bytecode_table<Instruction>(words, offset, header->instruction_count);
+        result._constants = detail::bytecode_table<ice::u32>(words, offset, header->constant_count);
+        result._functions = detail::bytecode_table<BytecodeFunction>(words, offset, header->function_count);
+        result._bindings = detail::bytecode_table<BytecodeBinding>(words, offset, header->binding_count);
+        result._data_refs = detail::bytecode_table<BytecodeDataRef>(words, offset, header->data_ref_count);
+        result._strings = { reinterpret_cast<ice::utf8 const*>(words.data() + offset), header->string_size };
+
+        // Strings are read up to their terminator, so the table needs to end with one.
+        if (result._strings.empty() == false && result._strings.back() != u8'\0')
+        {
+            return { };
+        }
+
+        for (ice::arctic::BytecodeFunction const& function : result._functions)
+        {
+            if (ice::u64{ function.first_instruction } + function.instruction_count > header->instruction_count)
+            {
+                return { };
+            }
+        }
+        return result;
+    }
+
+    auto BytecodeView::string(ice::u32 offset) const noexcept -> ice::String
+    {
+        if (offset >= _strings.size())
+        {
+            return { };
+        }
+
+        ice::String const rest = _strings.substr(offset);
+        return rest.substr(0, rest.find(u8'\0'));
+    }
+
+    auto BytecodeView::find_function(ice::String name) const noexcept -> ice::u32
+    {
+        for (ice::u32 idx = 0; idx < _functions.size(); ++idx)
+        {
+            if (string(_functions[idx].name) == name)
+            {
+                return idx;
+            }
+        }
+        return Constant_None;
+    }
+
+    void disassemble(ice::arctic::BytecodeView bytecode, std::u8string& out) noexcept
+    {
+        detail::BytecodeTextWriter writer{ out };
+        if (bytecode.is_valid() == false)
+        {
+            writer.append("<invalid bytecode>\n");
+            return;
+        }
+
+        writer.append("bindings:\n");
+        for (ice::u32 idx = 0; idx < bytecode.bindings().size(); ++idx)
+        {
+            ice::arctic::BytecodeBinding const& binding = bytecode.bindings()[idx];
+            writer.append("  b{} {} ({} bytes)\n", idx, detail::bytecode_text(bytecode.string(binding.name)), binding.size);
+        }
+
+        writer.append("data:\n");
+        for (ice::u32 idx = 0; idx < bytecode.data_refs().size(); ++idx)
+        {
+            ice::arctic::BytecodeDataRef const& ref = bytecode.data_refs()[idx];
+            writer.append("  d{} b{} +{}\n", idx, ref.binding, ref.offset);
+        }
+
+        writer.append("constants:\n");
+        for (ice::u32 idx = 0; idx < bytecode.constants().size(); ++idx)
+        {
+            ice::u32 const value = bytecode.constants()[idx];
+            writer.append("  k{} 0x{:08x} ({} / {})\n", idx, value, ice::i32(value), std::bit_cast<ice::f32>(value));
+        }
+
+        for (ice::arctic::BytecodeFunction const& function : bytecode.functions())
+        {
+            writer.append("function {} (arguments {}, result {}, registers {}, stack {}){}\n",
+                detail::bytecode_text(bytecode.string(function.name)),
+                function.argument_size,
+                function.result_size,
+                function.register_count,
+                function.stack_size,
+                function.is_entry ? " entry" : ""
+            );
+
+            ice::Span<ice::arctic::Instruction const> const code = bytecode.instructions().subspan(
+                function.first_instruction, function.instruction_count
+            );
+
+            for (ice::u32 idx = 0; idx < code.size(); ++idx)
+            {
+                ice::arctic::Instruction const instruction = code[idx];
+                ice::arctic::OpcodeInfo const& info = ice::arctic::opcode_info(instruction.opcode());
+
+                writer.append("  {:04} {:<20} x{} ", idx, detail::bytecode_text(info.name), instruction.width());
+                switch (info.format)
+                {
+                case InstructionFormat::AB:
+                    writer.append("r{}, r{}", instruction.a(), instruction.b());
+                    break;
+                case InstructionFormat::ABC:
+                    if (instruction.opcode() == Opcode::Swizzle)
+                    {
+                        writer.append("r{}, r{}, .", instruction.a(), instruction.b());
+                        for (ice::u32 lane = 0; lane < instruction.width(); ++lane)
+                        {
+                            writer.append("{}", "xyzw"[(instruction.c() >> (lane * 2)) & 0x3]);
+                        }
+                    }
+                    else
+                    {
+                        writer.append("r{}, r{}, r{}", instruction.a(), instruction.b(), instruction.c());
+                    }
+                    break;
+                case InstructionFormat::ABx:
+                    switch (instruction.opcode())
+                    {
+                    case Opcode::LoadConstant:
+                    case Opcode::LoadConstantSplat:
+                        writer.append("r{}, k{}", instruction.a(), instruction.bx());
+                        break;
+                    case Opcode::Call:
+                        writer.append("r{}, {}", instruction.a(),
+                            instruction.bx() < bytecode.functions().size()
+                                ? detail::bytecode_text(bytecode.string(bytecode.functions()[instruction.bx()].name))
+                                : std::string_view{ "<invalid>" }
+                        );
+                        break;
+                    default:
+                        writer.append("r{}, d{}", instruction.a(), instruction.bx());
+                        break;
+                    }
+                    break;
+                default:
+                    break;
+                }
+                writer.append("\n");
+            }
+        }
+    }
+
+} // namespace ice::arctic
@@ -0,0 +1,1724 @@
+#include <ice/arctic_bytecode_compiler.hxx>
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        constexpr bool bytecode_scalar_supported(ice::arctic::TokenType scalar) noexcept
+        {
+            return scalar == TokenType::NT_f32
+                || scalar == TokenType::NT_i32
+                || scalar == TokenType::NT_u32
+                || scalar == TokenType::NT_Bool;
+        }
+
+        //! \returns The lane index of a swizzle character, characters are checked by the semantic model.
+        constexpr auto bytecode_swizzle_lane(ice::utf8 character) noexcept -> ice::u8
+        {
+            switch (character)
+            {
+            case u8'y': case u8'g': return 1;
+            case u8'z': case u8'b': return 2;
+            case u8'w': case u8'a': return 3;
+            default: return 0;
+            }
+        }
+
+        //! \returns The opcode of a binary operation working on lanes of the given scalar, or 'Opcode::Count'.
+        constexpr auto bytecode_lane_opcode(ice::arctic::TokenType operation, ice::arctic::TokenType scalar) noexcept -> ice::arctic::Opcode
+        {
+            if (scalar == TokenType::NT_Bool)
+            {
+                switch (operation)
+                {
+                case TokenType::OP_And: return Opcode::AndBool;
+                case TokenType::OP_Or: return Opcode::OrBool;
+                default: return Opcode::Count;
+                }
+            }
+
+            ice::u32 offset = 0;
+            switch (operation)
+            {
+            case TokenType::OP_Plus: offset = 0; break;
+            case TokenType::OP_Minus: offset = 1; break;
+            case TokenType::OP_Mul: offset = 2; break;
+            case TokenType::OP_Div: offset = 3; break;
+            default: return Opcode::Count;
+            }
+
+            switch (scalar)
+            {
+            case TokenType::NT_f32: return ice::arctic::Opcode(ice::u32(Opcode::AddF32) + offset);
+            case TokenType::NT_i32: return ice::arctic::Opcode(ice::u32(Opcode::AddI32) + offset);
+            case TokenType::NT_u32: return ice::arctic::Opcode(ice::u32(Opcode::AddU32) + offset);
+            default: return Opcode::Count;
+            }
+        }
+
+        //! \returns The opcode converting lanes between scalars, 'Opcode::Nop' if the bits don't change
+        //!   and 'Opcode::Count' if there is no conversion.
+        constexpr auto bytecode_convert_opcode(ice::arctic::TokenType from, ice::arctic::TokenType to) noexcept -> ice::arctic::Opcode
+        {
+            if (from == to || (from == TokenType::NT_i32 && to == TokenType::NT_u32) || (from == TokenType::NT_u32 && to == TokenType::NT_i32))
+            {
+                return Opcode::Nop;
+            }
+
+            if (to == TokenType::NT_f32)
+            {
+                return from == TokenType::NT_i32 ? Opcode::ConvertF32FromI32
+                    : from == TokenType::NT_u32 ? Opcode::ConvertF32FromU32
+                    : Opcode::Count;
+            }
+
+            if (from == TokenType::NT_f32)
+            {
+                return to == TokenType::NT_i32 ? Opcode::ConvertI32FromF32
+                    : to == TokenType::NT_u32 ? Opcode::ConvertU32FromF32
+                    : Opcode::Count;
+            }
+            return Opcode::Count;
+        }
+
+        //! \brief Converts a constant at compile time, values out of range of the target are left for the VM.
+        inline bool bytecode_convert_constant(ice::arctic::Opcode opcode, ice::u32 bits, ice::u32& out_bits) noexcept
+        {
+            ice::f32 const value = std::bit_cast<ice::f32>(bits);
+            switch (opcode)
+            {
+            case Opcode::Nop:
+                out_bits = bits;
+                return true;
+            case Opcode::ConvertF32FromI32:
+                out_bits = std::bit_cast<ice::u32>(ice::f32(ice::i32(bits)));
+                return true;
+            case Opcode::ConvertF32FromU32:
+                out_bits = std::bit_cast<ice::u32>(ice::f32(bits));
+                return true;
+            case Opcode::ConvertI32FromF32:
+                if (std::isfinite(value) && value > -2147483904.0f && value < 2147483648.0f)
+                {
+                    out_bits = ice::u32(ice::i32(value));
+                    return true;
+                }
+                return false;
+            case Opcode::ConvertU32FromF32:
+                if (std::isfinite(value) && value > -1.0f && value < 4294967296.0f)
+                {
+                    out_bits = ice::u32(value);
+                    return true;
+                }
+                return false;
+            default:
+                return false;
+            }
+        }
+
+        inline bool bytecode_parse_integer(ice::String text, ice::u32 base, ice::u64& out_value) noexcept
+        {
+            std::string digits;
+            for (ice::utf8 const character : text)
+            {
+                if (character != u8'\'')
+                {
+                    digits.push_back(char(character));
+                }
+            }
+
+            std::from_chars_result const result = std::from_chars(digits.data(), digits.data() + digits.size(), out_value, int(base));
+            return digits.empty() == false && result.ec == std::errc{ } && result.ptr == digits.data() + digits.size();
+        }
+
+        //! \returns 'true' if the literal token was stored as the bits of the given scalar.
+        inline bool bytecode_literal_bits(ice::arctic::Token const& token, ice::arctic::TokenType scalar, ice::u32& out_bits) noexcept
+        {
+            ice::String const text = token.value;
+            ice::u64 integer = 0;
+            bool parsed = false;
+            switch (token.type)
+            {
+            case TokenType::KW_True:
+            case TokenType::KW_False:
+                out_bits = token.type == TokenType::KW_True ? 1 : 0;
+                return scalar == TokenType::NT_Bool;
+            case TokenType::CT_NumberFloat:
+            {
+                std::string digits;
+                for (ice::utf8 const character : text)
+                {
+                    if (character != u8'\'')
+                    {
+                        digits.push_back(char(character));
+                    }
+                }
+
+                ice::f32 value = 0.0f;
+                std::from_chars_result const result = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+                out_bits = std::bit_cast<ice::u32>(value);
+                return scalar == TokenType::NT_f32 && result.ec == std::errc{ } && result.ptr == digits.data() + digits.size();
+            }
+            case TokenType::CT_Number:
+                parsed = bytecode_parse_integer(text, 10, integer);
+                break;
+            case TokenType::CT_NumberHex:
+                parsed = text.size() > 2 && bytecode_parse_integer(text.substr(2), 16, integer);
+                break;
+            case TokenType::CT_NumberBin:
+                parsed = text.size() > 2 && bytecode_parse_integer(text.substr(2), 2, integer);
+                break;
+            case TokenType::CT_NumberOct:
+                parsed = bytecode_parse_integer(text.substr(1), 8, integer);
+                break;
+            default:
+                return false;
+            }
+
+            out_bits = ice::u32(integer);
+            return parsed
+                && (scalar == TokenType::NT_i32 || scalar == TokenType::NT_u32)
+                && integer <= std::numeric_limits<ice::u32>::max();
+        }
+
+        inline auto bytecode_first_token(ice::arctic::SyntaxNode const* node) noexcept -> ice::arctic::Token
+        {
+            for (; node != nullptr; node = node->child)
+            {
+                ice::arctic::Token const* result = nullptr;
+                ice::arctic::for_each_syntax_token(node, [&result](ice::arctic::Token const& token) noexcept
+                    {
+                        result = result == nullptr ? &token : result;
+                    }
+                );
+
+                if (result != nullptr)
+                {
+                    return *result;
+                }
+            }
+            return { };
+        }
+
+        constexpr bool bytecode_ranges_overlap(ice::u32 first, ice::u32 first_size, ice::u32 second, ice::u32 second_size) noexcept
+        {
+            return first < second + second_size && second < first + first_size;
+        }
+
+        //! \returns 'true' if the instruction can write its result to the given registers instead of its destination.
+        //! \note Only matrix products read their sources while writing, all other instructions read them first.
+        constexpr bool bytecode_can_write_to(ice::arctic::Instruction instruction, ice::u32 reg, ice::u32 size) noexcept
+        {
+            ice::u32 const width = instruction.width();
+            ice::u32 left_size = width * width;
+            ice::u32 right_size = width * width;
+            switch (instruction.opcode())
+            {
+            case Opcode::MulMatrixVectorF32: right_size = width; break;
+            case Opcode::MulVectorMatrixF32: left_size = width; break;
+            case Opcode::MulMatrixMatrixF32: break;
+            default: return true;
+            }
+
+            return bytecode_ranges_overlap(reg, size, instruction.b(), left_size) == false
+                && bytecode_ranges_overlap(reg, size, instruction.c(), right_size) == false;
+        }
+
+        template<typename T>
+        void bytecode_append_words(std::vector<ice::u32>& words, T const* values, ice::u64 count) noexcept
+        {
+            ice::u64 const offset = words.size();
+            words.resize(offset + count * (sizeof(T) / sizeof(ice::u32)));
+            if (count > 0)
+            {
+                std::memcpy(words.data() + offset, values, count * sizeof(T));
+            }
+        }
+
+    } // namespace detail
+
+    BytecodeCompiler::BytecodeCompiler(ice::arctic::SemanticModel& model) noexcept
+        : _model{ model }
+        , _layouts{ LayoutRules::Std430 }
+    {
+    }
+
+    auto BytecodeCompiler::compile(
+        ice::Span<ice::arctic::SyntaxNode const* const> definitions,
+        ice::arctic::Bytecode& out_bytecode
+    ) noexcept -> ice::arctic::ParseState
+    {
+        for (ice::arctic::SyntaxNode const* definition : definitions)
+        {
+            if (definition->entity == SyntaxEntity::DEF_Function)
+            {
+                declare_function(static_cast<SyntaxNode_Function const*>(definition));
+            }
+            else if (definition->entity == SyntaxEntity::DEF_ContextVariable)
+            {
+                // Variables with unsupported types get no binding, they are reported when used.
+                ice::arctic::TypeHandle const type = _model.type_of(definition);
+                ice::arctic::TypeLayout const layout = _layouts.type_layout(type);
+                if (register_size(type) > 0 && layout.size > 0)
+                {
+                    _binding_indices.emplace(definition, ice::u32(_bindings.size()));
+                    _bindings.push_back({
+                        .name = add_string(static_cast<SyntaxNode_ContextVariable const*>(definition)->name.value),
+                        .size = layout.size
+                    });
+                }
+            }
+        }
+
+        for (ice::u32 idx = 0; idx < _functions.size(); ++idx)
+        {
+            compile_function(idx);
+        }
+
+        for (ice::u32 idx = 0; idx < _functions.size(); ++idx)
+        {
+            compute_stack_size(idx);
+        }
+
+        if (_diagnostics.empty() == false)
+        {
+            return _diagnostics.front().state;
+        }
+
+        out_bytecode = ice::arctic::Bytecode{ write_words() };
+        return ParseState::Success;
+    }
+
+    void BytecodeCompiler::declare_function(ice::arctic::SyntaxNode_Function const* definition) noexcept
+    {
+        ice::arctic::Symbol const* const symbol = _model.symbol_of(definition);
+
+        FunctionEntry entry{
+            .definition = definition,
+            .result_type = symbol != nullptr ? symbol->type : nullptr,
+            .name = add_string(definition->name.value),
+            .first_instruction = 0,
+            .instruction_count = 0,
+            .register_count = 0,
+            .stack_size = 0,
+            .argument_size = 0,
+            .result_size = 0,
+            .first_call = 0,
+            .call_count = 0,
+            .is_entry = false,
+            .is_valid = symbol != nullptr && symbol->type != nullptr,
+            .is_visiting = false
+        };
+
+        for (ice::arctic::SyntaxNode const* child = definition->child; child != nullptr; child = child->sibling)
+        {
+            if (child->entity == SyntaxEntity::DEF_FunctionArgument)
+            {
+                ice::u32 const size = register_size(_model.type_of(child));
+                if (size == 0)
+                {
+                    report(ParseState::Error_Bytecode_UnsupportedType, static_cast<SyntaxNode_FunctionArgument const*>(child)->type);
+                    entry.is_valid = false;
+                }
+                entry.argument_size += size;
+            }
+        }
+
+        if (entry.result_type != nullptr && entry.result_type->kind == TypeKind::Stage)
+        {
+            entry.is_entry = true;
+            entry.result_type = entry_result_type(definition);
+        }
+
+        if (entry.result_type != nullptr && entry.result_type->kind != TypeKind::Void)
+        {
+            entry.result_size = register_size(entry.result_type);
+            if (entry.result_size == 0)
+            {
+                report(ParseState::Error_Bytecode_UnsupportedType, definition->result_type);
+                entry.is_valid = false;
+            }
+        }
+
+        // Sizes are stored in a single byte of the function table.
+        if (entry.argument_size > 0xff || entry.result_size > 0xff)
+        {
+            report(ParseState::Error_Bytecode_RegisterLimit, definition->name);
+            entry.is_valid = false;
+        }
+
+        if (_functions.size() >= Constant_MaxTableSize)
+        {
+            report(ParseState::Error_Bytecode_TableLimit, definition->name);
+            return;
+        }
+
+        _function_indices.emplace(definition, ice::u32(_functions.size()));
+        _functions.push_back(entry);
+    }
+
+    void BytecodeCompiler::compile_function(ice::u32 function) noexcept
+    {
+        FunctionEntry& entry = _functions[function];
+        entry.first_instruction = ice::u32(_code.size());
+        entry.first_call = ice::u32(_calls.size());
+        if (entry.is_valid == false)
+        {
+            return;
+        }
+
+        _function = function;
+        _registers.clear();
+        _register_limit_reported = false;
+        _statement = entry.definition->name;
+
+        ice::u32 reg = 0;
+        for (ice::arctic::SyntaxNode const* child = entry.definition->child; child != nullptr; child = child->sibling)
+        {
+            if (child->entity == SyntaxEntity::DEF_FunctionArgument)
+            {
+                _registers.emplace(child, reg);
+                reg += register_size(_model.type_of(child));
+            }
+        }
+
+        _register_top = reg;
+        _register_count = reg;
+        _result_register = allocate(entry.result_size);
+        clear_registers(_result_register, entry.result_size);
+
+        ice::arctic::SyntaxNode const* const body = entry.definition->sibling;
+        if (body != nullptr && body->entity == SyntaxEntity::DEF_FunctionBody)
+        {
+            compile_statements(body->child);
+        }
+
+        emit(ice::arctic::make_instruction(Opcode::Return, 1, 0));
+        entry.instruction_count = ice::u32(_code.size()) - entry.first_instruction;
+        entry.register_count = _register_count;
+        entry.call_count = ice::u32(_calls.size()) - entry.first_call;
+    }
+
+    auto BytecodeCompiler::compute_stack_size(ice::u32 function) noexcept -> ice::u32
+    {
+        FunctionEntry& entry = _functions[function];
+        if (entry.stack_size != 0 || entry.is_visiting)
+        {
+            return entry.stack_size;
+        }
+
+        entry.is_visiting = true;
+        ice::u32 stack_size = entry.register_count;
+        for (ice::u32 idx = entry.first_call; idx < entry.first_call + entry.call_count; ++idx)
+        {
+            CallSite const& call = _calls[idx];
+            if (_functions[call.callee].is_visiting)
+            {
+                // The VM has no separate call stack, each call needs its own registers.
+                report(ParseState::Error_Bytecode_RecursiveCall, call.token);
+                continue;
+            }
+            stack_size = std::max(stack_size, call.base + compute_stack_size(call.callee));
+        }
+        entry.is_visiting = false;
+
+        if (stack_size > 0xffff)
+        {
+            report(ParseState::Error_Bytecode_RegisterLimit, entry.definition->name);
+        }
+
+        // Functions without registers still need a valid size, so they are not computed again.
+        entry.stack_size = std::max(stack_size, 1u);
+        return entry.stack_size;
+    }
+
+    auto BytecodeCompiler::write_words() const noexcept -> std::vector<ice::u32>
+    {
+        ice::arctic::BytecodeHeader const header{
+            .magic = BytecodeHeader::Constant_Magic,
+            .version = BytecodeHeader::Constant_Version,
+            .instruction_count = ice::u32(_code.size()),
+            .constant_count = ice::u32(_constants.size()),
+            .function_count = ice::u32(_functions.size()),
+            .binding_count = ice::u32(_bindings.size()),
+            .data_ref_count = ice::u32(_data_refs.size()),
+            .string_size = ice::u32(_strings.size())
+        };
+
+        std::vector<ice::arctic::BytecodeFunction> functions;
+        functions.reserve(_functions.size());
+        for (FunctionEntry const& entry : _functions)
+        {
+            functions.push_back({
+                .name = entry.name,
+                .first_instruction = entry.first_instruction,
+                .instruction_count = entry.instruction_count,
+                .register_count = ice::u16(entry.register_count),
+                .stack_size = ice::u16(entry.stack_size),
+                .argument_size = ice::u8(entry.argument_size),
+                .result_size = ice::u8(entry.result_size),
+                .is_entry = ice::u8(entry.is_entry ? 1 : 0),
+                .reserved = 0
+            });
+        }
+
+        std::vector<ice::u32> words;
+        detail::bytecode_append_words(words, &header, 1);
+        detail::bytecode_append_words(words, _code.data(), _code.size());
+        detail::bytecode_append_words(words, _constants.data(), _constants.size());
+        detail::bytecode_append_words(words, functions.data(), functions.size());
+        detail::bytecode_append_words(words, _bindings.data(), _bindings.size());
+        detail::bytecode_append_words(words, _data_refs.data(), _data_refs.size());
+
+        ice::u64 const string_offset = words.size();
+        words.resize(string_offset + (_strings.size() + 3) / 4, 0);
+        if (_strings.empty() == false)
+        {
+            std::memcpy(words.data() + string_offset, _strings.data(), _strings.size());
+        }
+        return words;
+    }
+
+    void BytecodeCompiler::compile_statements(ice::arctic::SyntaxNode const* first) noexcept
+    {
+        for (ice::arctic::SyntaxNode const* node = first; node != nullptr; node = node->sibling)
+        {
+            ice::u32 const top = _register_top;
+            _statement = ice::arctic::detail::bytecode_first_token(node);
+
+            switch (node->entity)
+            {
+            case SyntaxEntity::DEF_Variable:
+                // Keeps the registers of the variable until the end of the scope.
+                compile_variable(static_cast<SyntaxNode_Variable const*>(node));
+                continue;
+            case SyntaxEntity::DEF_ExplicitScope:
+                compile_statements(node->child);
+                break;
+            case SyntaxEntity::EXP_Expression:
+                compile_list(node);
+                break;
+            default:
+                report(ParseState::Error_Bytecode_UnsupportedExpression, _statement);
+                break;
+            }
+            _register_top = top;
+        }
+    }
+
+    void BytecodeCompiler::compile_variable(ice::arctic::SyntaxNode_Variable const* variable) noexcept
+    {
+        ice::arctic::TypeHandle const type = _model.type_of(variable);
+        ice::u32 const size = register_size(type);
+        if (size == 0)
+        {
+            report(ParseState::Error_Bytecode_UnsupportedType, variable->type);
+            return;
+        }
+
+        // Registers are reserved before the initializer is compiled, so its temporary values can be released after it.
+        ice::u32 const reg = allocate(size);
+        ice::u32 const top = _register_top;
+        if (variable->child != nullptr)
+        {
+            Value const value = convert(compile_list(variable->child), type, variable->name);
+            if (value.type != nullptr)
+            {
+                store_value(reg, value);
+            }
+        }
+        else
+        {
+            clear_registers(reg, size);
+        }
+
+        _registers.emplace(variable, reg);
+        _register_top = top;
+    }
+
+    auto BytecodeCompiler::compile_list(ice::arctic::SyntaxNode const* parent) noexcept -> Value
+    {
+        // Building terms only reads the list, the tree is not modified.
+        ice::arctic::OperandList list;
+        if (list.build(const_cast<ice::arctic::SyntaxNode*>(parent)) == false)
+        {
+            report(ParseState::Error_Bytecode_UnsupportedExpression, ice::arctic::detail::bytecode_first_token(parent));
+            return { };
+        }
+        return compile_term(list, list.root());
+    }
+
+    auto BytecodeCompiler::compile_term(ice::arctic::OperandList const& list, ice::u32 term) noexcept -> Value
+    {
+        ice::arctic::OperandTerm const& compiled = list.terms()[term];
+        ice::arctic::SyntaxNode const* const node = list.items()[compiled.item].node;
+
+        // Registers allocated for the operands are only used by this term, its result can reuse them.
+        ice::u32 const first_temporary = _register_top;
+        switch (compiled.kind)
+        {
+        case OperandTermKind::Operand:
+            return compile_operand(node);
+        case OperandTermKind::Negate:
+            return negate(
+                compile_term(list, compiled.left),
+                static_cast<SyntaxNode_ExpressionUnaryOperation const*>(node)->operation,
+                first_temporary
+            );
+        default:
+        {
+            ice::arctic::Token const& operation = static_cast<SyntaxNode_ExpressionBinaryOperation const*>(node)->operation;
+            if (operation.type == TokenType::OP_Assign)
+            {
+                return compile_assignment(list, compiled);
+            }
+
+            Value const left = compile_term(list, compiled.left);
+            Value const right = compile_term(list, compiled.right);
+            return binary(left, operation, right, first_temporary);
+        }
+        }
+    }
+
+    auto BytecodeCompiler::compile_assignment(
+        ice::arctic::OperandList const& list,
+        ice::arctic::OperandTerm const& term
+    ) noexcept -> Value
+    {
+        ice::arctic::Token const& operation = static_cast<SyntaxNode_ExpressionBinaryOperation const*>(list.items()[term.item].node)->operation;
+        ice::arctic::OperandTerm const& target = list.terms()[term.left];
+        if (target.kind != OperandTermKind::Operand)
+        {
+            report(ParseState::Error_Bytecode_UnsupportedExpression, operation);
+            return { };
+        }
+
+        Place const place = place_of(list.items()[target.item].node);
+        Value const value = compile_term(list, term.right);
+        if (place.type == nullptr || value.type == nullptr)
+        {
+            return { };
+        }
+        return write(place, convert(value, place.type, operation), operation);
+    }
+
+    auto BytecodeCompiler::compile_operand(ice::arctic::SyntaxNode const* node) noexcept -> Value
+    {
+        switch (node->entity)
+        {
+        case SyntaxEntity::EXP_Value:
+        case SyntaxEntity::EXP_Call:
+            return read(place_of(node));
+        case SyntaxEntity::EXP_ExplicitScope:
+        case SyntaxEntity::EXP_Expression:
+            return compile_list(node);
+        default:
+            report(ParseState::Error_Bytecode_UnsupportedExpression, ice::arctic::detail::bytecode_first_token(node));
+            return { };
+        }
+    }
+
+    auto BytecodeCompiler::compile_literal(ice::arctic::SyntaxNode_ExpressionValue const* node) noexcept -> Value
+    {
+        ice::arctic::TypeHandle type = _model.type_of(node);
+        if (type == nullptr)
+        {
+            // Literals created after the model was resolved, ex.: by the constant folder, have the default literal types.
+            switch (node->value.type)
+            {
+            case TokenType::CT_NumberFloat: type = _model.types().scalar(TokenType::NT_f32); break;
+            case TokenType::KW_True:
+            case TokenType::KW_False: type = _model.types().scalar(TokenType::NT_Bool); break;
+            default: type = _model.types().scalar(TokenType::NT_i32); break;
+            }
+        }
+
+        ice::u32 bits = 0;
+        if (type->kind != TypeKind::Scalar || ice::arctic::detail::bytecode_literal_bits(node->value, type->scalar, bits) == false)
+        {
+            report(ParseState::Error_Bytecode_UnsupportedType, node->value);
+            return { };
+        }
+        return { .type = type, .reg = 0, .constant = bits, .is_constant = true, .producer = Constant_None };
+    }
+
+    auto BytecodeCompiler::compile_constant(ice::arctic::Symbol const* symbol, ice::arctic::Token const& token) noexcept -> Value
+    {
+        ice::arctic::SyntaxNode const* const definition = symbol->definition;
+        if (definition->child == nullptr || std::find(_expanding.begin(), _expanding.end(), definition) != _expanding.end())
+        {
+            report(ParseState::Error_Semantic_NotConstant, token);
+            return { };
+        }
+
+        _expanding.push_back(definition);
+        Value const result = convert(compile_list(definition->child), symbol->type, token);
+        _expanding.pop_back();
+        return result;
+    }
+
+    auto BytecodeCompiler::compile_call(ice::arctic::SyntaxNode_ExpressionCall const* node) noexcept -> Value
+    {
+        ice::arctic::Symbol const* const symbol = _model.symbol_of(node);
+        if (symbol != nullptr && symbol->kind == SymbolKind::Function)
+        {
+            auto const it = _function_indices.find(symbol->definition);
+            if (it == _function_indices.end())
+            {
+                report(ParseState::Error_Bytecode_UnsupportedExpression, node->function);
+                return { };
+            }
+            return compile_function_call(node, it->second);
+        }
+
+        // Builtin types have no symbol, the model only stores the type of the call.
+        ice::arctic::TypeHandle const type = _model.type_of(node);
+        if ((symbol == nullptr || symbol->kind == SymbolKind::Type) && type != nullptr)
+        {
+            return compile_constructor(node, type);
+        }
+
+        report(ParseState::Error_Bytecode_UnsupportedExpression, node->function);
+        return { };
+    }
+
+    auto BytecodeCompiler::compile_function_call(ice::arctic::SyntaxNode_ExpressionCall const* node, ice::u32 callee) noexcept -> Value
+    {
+        FunctionEntry const& function = _functions[callee];
+        if (function.is_valid == false)
+        {
+            return { };
+        }
+
+        ice::u32 const first_temporary = _register_top;
+        std::vector<Value> arguments;
+        ice::arctic::SyntaxNode const* parameter = function.definition->child;
+        for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+        {
+            if (child->entity != SyntaxEntity::EXP_CallArg)
+            {
+                continue;
+            }
+
+            while (parameter != nullptr && parameter->entity != SyntaxEntity::DEF_FunctionArgument)
+            {
+                parameter = parameter->sibling;
+            }
+
+            if (parameter == nullptr)
+            {
+                report(ParseState::Error_Semantic_TypeMismatch, node->function);
+                return { };
+            }
+
+            arguments.push_back(convert(compile_list(child), _model.type_of(parameter), node->function));
+            if (arguments.back().type == nullptr)
+            {
+                return { };
+            }
+            parameter = parameter->sibling;
+        }
+
+        while (parameter != nullptr && parameter->entity != SyntaxEntity::DEF_FunctionArgument)
+        {
+            parameter = parameter->sibling;
+        }
+
+        if (parameter != nullptr)
+        {
+            report(ParseState::Error_Semantic_TypeMismatch, node->function);
+            return { };
+        }
+
+        // Arguments are copied after all of them were evaluated, the block reuses their temporary values if none is overwritten too early.
+        ice::u32 const base = pack_registers(first_temporary, arguments, function.argument_size + function.result_size);
+        ice::u32 offset = base;
+        for (Value const& argument : arguments)
+        {
+            store_value(offset, argument);
+            offset += register_size(argument.type);
+        }
+
+        emit(ice::arctic::make_instruction_bx(Opcode::Call, 1, base, callee));
+        _calls.push_back({ .callee = callee, .base = base, .token = node->function });
+
+        ice::arctic::TypeHandle const result_type = function.result_type != nullptr
+            ? function.result_type
+            : _model.types().find_builtin(u8"void");
+
+        return { .type = result_type, .reg = base + function.argument_size, .constant = 0, .is_constant = false, .producer = Constant_None };
+    }
+
+    auto BytecodeCompiler::compile_constructor(
+        ice::arctic::SyntaxNode_ExpressionCall const* node,
+        ice::arctic::TypeHandle type
+    ) noexcept -> Value
+    {
+        ice::u32 const size = register_size(type);
+        if (size == 0)
+        {
+            report(ParseState::Error_Bytecode_UnsupportedType, node->function);
+            return { };
+        }
+
+        ice::u32 const first_temporary = _register_top;
+        std::vector<Value> arguments;
+        for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+        {
+            if (child->entity == SyntaxEntity::EXP_CallArg)
+            {
+                arguments.push_back(compile_list(child));
+                if (arguments.back().type == nullptr)
+                {
+                    return { };
+                }
+            }
+        }
+
+        // Scalars are converted and vectors are filled with a single scalar, matrices have no such shorthand.
+        if (arguments.size() == 1 && (arguments[0].type == type || type->kind == TypeKind::Scalar
+            || (type->kind == TypeKind::Vector && arguments[0].type->kind == TypeKind::Scalar)))
+        {
+            return convert(arguments[0], type, node->function);
+        }
+
+        ice::u32 total_size = 0;
+        if (type->kind == TypeKind::Struct)
+        {
+            if (arguments.size() != type->members.size())
+            {
+                report(ParseState::Error_Semantic_TypeMismatch, node->function);
+                return { };
+            }
+
+            for (ice::u32 idx = 0; idx < arguments.size(); ++idx)
+            {
+                arguments[idx] = convert(arguments[idx], type->members[idx].type, node->function);
+                total_size += register_size(arguments[idx].type);
+            }
+        }
+        else
+        {
+            // Arguments of vectors and matrices are concatenated, each component is converted to the scalar of the type.
+            for (Value& argument : arguments)
+            {
+                ice::arctic::TypeHandle const argument_type = argument.type;
+                if (argument_type->kind != TypeKind::Scalar && argument_type->kind != TypeKind::Vector && argument_type->kind != TypeKind::Matrix)
+                {
+                    report(ParseState::Error_Semantic_TypeMismatch, node->function);
+                    return { };
+                }
+
+                argument = convert_lanes(
+                    argument,
+                    _model.types().matrix(type->scalar, argument_type->rows, argument_type->columns),
+                    node->function
+                );
+                total_size += register_size(argument.type);
+            }
+        }
+
+        bool const is_valid = std::all_of(arguments.begin(), arguments.end(), [](Value const& argument) noexcept { return argument.type != nullptr; });
+        if (is_valid == false)
+        {
+            return { };
+        }
+
+        if (total_size != size)
+        {
+            report(ParseState::Error_Semantic_TypeMismatch, node->function);
+            return { };
+        }
+
+        Value result{ .type = type, .reg = pack_registers(first_temporary, arguments, size), .constant = 0, .is_constant = false, .producer = Constant_None };
+
+        // Constructors of literals are loaded from a single sequence of constants.
+        if (std::all_of(arguments.begin(), arguments.end(), [](Value const& argument) noexcept { return argument.is_constant; }))
+        {
+            std::vector<ice::u32> words;
+            for (Value const& argument : arguments)
+            {
+                words.push_back(argument.constant);
+            }
+
+            result.producer = load_constants(result.reg, words);
+            return result;
+        }
+
+        ice::u32 offset = result.reg;
+        for (Value const& argument : arguments)
+        {
+            store_value(offset, argument);
+            offset += register_size(argument.type);
+        }
+        return result;
+    }
+
+    auto BytecodeCompiler::place_of(ice::arctic::SyntaxNode const* node) noexcept -> Place
+    {
+        Place result{
+            .type = nullptr,
+            .value = { },
+            .is_value = false,
+            .is_readonly = false,
+            .location = 0,
+            .binding = Constant_None,
+            .swizzled = nullptr,
+            .components = { },
+            .component_count = 0
+        };
+
+        if (node->entity == SyntaxEntity::EXP_Call)
+        {
+            result.value = compile_call(static_cast<SyntaxNode_ExpressionCall const*>(node));
+            result.type = result.value.type;
+            result.is_value = true;
+            apply_members(result, node);
+            return result;
+        }
+
+        auto const* const value = static_cast<SyntaxNode_ExpressionValue const*>(node);
+        if (value->value.type != TokenType::CT_Symbol)
+        {
+            result.value = compile_literal(value);
+            result.type = result.value.type;
+            result.is_value = true;
+            apply_members(result, node);
+            return result;
+        }
+
+        ice::arctic::Symbol const* const symbol = _model.symbol_of(node);
+        if (symbol == nullptr)
+        {
+            report(ParseState::Error_Semantic_UnknownSymbol, value->value);
+            return result;
+        }
+
+        auto const local = _registers.find(symbol->definition);
+        auto const binding = _binding_indices.find(symbol->definition);
+        if (local != _registers.end())
+        {
+            result.type = _model.type_of(symbol->definition);
+            result.location = local->second;
+            result.is_readonly = symbol->kind == SymbolKind::Constant;
+        }
+        else if (binding != _binding_indices.end())
+        {
+            result.type = symbol->type;
+            result.binding = binding->second;
+        }
+        else if (symbol->kind == SymbolKind::Constant)
+        {
+            result.value = compile_constant(symbol, value->value);
+            result.type = result.value.type;
+            result.is_value = true;
+        }
+        else if (symbol->kind == SymbolKind::Function && symbol->definition == _functions[_function].definition)
+        {
+            result.type = _functions[_function].result_type;
+            result.location = _result_register;
+            if (_functions[_function].result_size == 0)
+            {
+                report(ParseState::Error_Bytecode_UnsupportedExpression, value->value);
+                result.type = nullptr;
+            }
+        }
+        else
+        {
+            // Global variables would be shared by all entities, context variables of unsupported types have no binding.
+            report(
+                symbol->kind == SymbolKind::ContextVariable ? ParseState::Error_Bytecode_UnsupportedType : ParseState::Error_Bytecode_UnsupportedExpression,
+                value->value
+            );
+            return result;
+        }
+
+        apply_members(result, node);
+        return result;
+    }
+
+    void BytecodeCompiler::apply_members(Place& place, ice::arctic::SyntaxNode const* node) noexcept
+    {
+        for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr && place.type != nullptr; child = child->sibling)
+        {
+            if (child->entity != SyntaxEntity::EXP_GetMember)
+            {
+                continue;
+            }
+
+            auto const* const get_member = static_cast<SyntaxNode_ExpressionGetMember const*>(child);
+            if (place.is_value)
+            {
+                // Members of values are read from the registers holding the value.
+                Value const value = materialize(place.value);
+                place.is_value = false;
+                place.is_readonly = true;
+                place.location = value.reg;
+            }
+
+            ice::arctic::TypeMember const* const member = _model.member_of(child);
+            if (member != nullptr && place.type->kind == TypeKind::Struct && place.component_count == 0)
+            {
+                ice::u32 const idx = ice::u32(member - place.type->members.data());
+                if (place.binding == Constant_None)
+                {
+                    place.location += member_register_offset(place.type, idx);
+                }
+                else
+                {
+                    place.location += _layouts.struct_layout(place.type)->members[idx].offset;
+                }
+                place.type = member->type;
+                continue;
+            }
+
+            ice::arctic::TypeHandle const type = _model.type_of(child);
+            ice::String const name = get_member->member.value;
+            if (member != nullptr || type == nullptr || name.size() > 4
+                || (place.type->kind != TypeKind::Vector && place.type->kind != TypeKind::Scalar))
+            {
+                report(ParseState::Error_Bytecode_UnsupportedExpression, get_member->member);
+                place.type = nullptr;
+                return;
+            }
+
+            // Swizzles of swizzles select from the lanes of the first one.
+            ice::u8 components[4]{ };
+            for (ice::u32 idx = 0; idx < name.size(); ++idx)
+            {
+                ice::u8 const lane = ice::arctic::detail::bytecode_swizzle_lane(name[idx]);
+                components[idx] = place.component_count == 0 ? lane : place.components[lane];
+            }
+
+            if (place.component_count == 0)
+            {
+                place.swizzled = place.type;
+            }
+            std::copy(std::begin(components), std::end(components), place.components);
+            place.component_count = ice::u32(name.size());
+            place.type = type;
+        }
+    }
+
+    auto BytecodeCompiler::read(Place const& place) noexcept -> Value
+    {
+        if (place.type == nullptr)
+        {
+            return { };
+        }
+
+        if (place.is_value)
+        {
+            return place.value;
+        }
+
+        Value result{ .type = place.type, .reg = place.location, .constant = 0, .is_constant = false, .producer = Constant_None };
+        if (place.component_count == 0)
+        {
+            if (place.binding != Constant_None)
+            {
+                result.reg = allocate(register_size(place.type));
+                transfer_data(Opcode::LoadData, place.type, place.binding, place.location, result.reg);
+                result.producer = place.type->kind == TypeKind::Scalar || place.type->kind == TypeKind::Vector
+                    ? ice::u32(_code.size()) - 1
+                    : Constant_None;
+            }
+            return result;
+        }
+
+        ice::u32 const count = place.component_count;
+        bool is_contiguous = true;
+        bool is_splat = true;
+        ice::u32 selectors = 0;
+        for (ice::u32 idx = 0; idx < count; ++idx)
+        {
+            is_contiguous &= place.components[idx] == place.components[0] + idx;
+            is_splat &= place.components[idx] == place.components[0];
+            selectors |= ice::u32(place.components[idx]) << (idx * 2);
+        }
+
+        // Lanes following each other are used in place, or loaded with a single instruction.
+        if (is_contiguous)
+        {
+            if (place.binding == Constant_None)
+            {
+                result.reg = place.location + place.components[0];
+            }
+            else
+            {
+                result.reg = allocate(count);
+                result.producer = emit(ice::arctic::make_instruction_bx(
+                    Opcode::LoadData, count, result.reg, add_data_ref(place.binding, place.location + place.components[0] * 4)
+                ));
+            }
+            return result;
+        }
+
+        ice::u32 source = place.location;
+        ice::u32 lane = place.components[0];
+        if (place.binding != Constant_None && is_splat)
+        {
+            // Splats only load the selected lane.
+            source = allocate(1);
+            lane = 0;
+            emit(ice::arctic::make_instruction_bx(
+                Opcode::LoadData, 1, source, add_data_ref(place.binding, place.location + place.components[0] * 4)
+            ));
+        }
+        else if (place.binding != Constant_None)
+        {
+            source = allocate(place.swizzled->rows);
+            transfer_data(Opcode::LoadData, place.swizzled, place.binding, place.location, source);
+        }
+
+        result.reg = allocate(count);
+        if (is_splat)
+        {
+            result.producer = emit(ice::arctic::make_instruction(Opcode::Splat, count, result.reg, source + lane));
+        }
+        else
+        {
+            result.producer = emit(ice::arctic::make_instruction(Opcode::Swizzle, count, result.reg, source, selectors));
+        }
+        return result;
+    }
+
+    auto BytecodeCompiler::write(Place const& place, Value value, ice::arctic::Token const& token) noexcept -> Value
+    {
+        if (value.type == nullptr)
+        {
+            return { };
+        }
+
+        if (place.is_value || place.is_readonly)
+        {
+            report(ParseState::Error_Bytecode_UnsupportedExpression, token);
+            return { };
+        }
+
+        if (place.component_count == 0)
+        {
+            if (place.binding == Constant_None)
+            {
+                store_value(place.location, value);
+                return { .type = value.type, .reg = place.location, .constant = 0, .is_constant = false, .producer = Constant_None };
+            }
+
+            value = materialize(value);
+            transfer_data(Opcode::StoreData, place.type, place.binding, place.location, value.reg);
+            return value;
+        }
+
+        // Each run of lanes following each other is written with a single instruction.
+        value = materialize(value);
+        for (ice::u32 first = 0; first < place.component_count;)
+        {
+            ice::u32 last = first + 1;
+            while (last < place.component_count && place.components[last] == place.components[last - 1] + 1)
+            {
+                last += 1;
+            }
+
+            ice::u32 const lane = place.components[first];
+            if (place.binding == Constant_None)
+            {
+                emit(ice::arctic::make_instruction(Opcode::Move, last - first, place.location + lane, value.reg + first));
+            }
+            else
+            {
+                emit(ice::arctic::make_instruction_bx(
+                    Opcode::StoreData, last - first, value.reg + first, add_data_ref(place.binding, place.location + lane * 4)
+                ));
+            }
+            first = last;
+        }
+        return value;
+    }
+
+    auto BytecodeCompiler::binary(
+        Value left,
+        ice::arctic::Token const& operation,
+        Value right,
+        ice::u32 first_temporary
+    ) noexcept -> Value
+    {
+        if (left.type == nullptr || right.type == nullptr)
+        {
+            return { };
+        }
+
+        ice::arctic::TypeHandle const result_type = _model.result_type(left.type, operation.type, right.type);
+        if (result_type == nullptr)
+        {
+            report(ParseState::Error_Semantic_TypeMismatch, operation);
+            return { };
+        }
+
+        bool const left_matrix = left.type->kind == TypeKind::Matrix;
+        bool const right_matrix = right.type->kind == TypeKind::Matrix;
+        if (operation.type == TokenType::OP_Mul
+            && (left_matrix || right_matrix)
+            && left.type->kind != TypeKind::Scalar
+            && right.type->kind != TypeKind::Scalar)
+        {
+            // Products are only defined for square matrices, their width is the number of columns.
+            ice::arctic::TypeHandle const matrix = left_matrix ? left.type : right.type;
+            if (matrix->scalar != TokenType::NT_f32 || matrix->rows != matrix->columns || (left_matrix && right_matrix && left.type != right.type))
+            {
+                report(ParseState::Error_Bytecode_UnsupportedType, operation);
+                return { };
+            }
+
+            Opcode const opcode = left_matrix == false ? Opcode::MulVectorMatrixF32
+                : right_matrix ? Opcode::MulMatrixMatrixF32
+                : Opcode::MulMatrixVectorF32;
+
+            // Products read their sources while writing, so the result only reuses the operands if it doesn't overlap them.
+            ice::u32 const size = register_size(result_type);
+            ice::arctic::Instruction const instruction = ice::arctic::make_instruction(opcode, matrix->columns, first_temporary, left.reg, right.reg);
+            _register_top = ice::arctic::detail::bytecode_can_write_to(instruction, first_temporary, size) ? first_temporary : _register_top;
+
+            Value result{ .type = result_type, .reg = allocate(size), .constant = 0, .is_constant = false, .producer = Constant_None };
+            result.producer = emit(ice::arctic::make_instruction(opcode, matrix->columns, result.reg, left.reg, right.reg));
+            return result;
+        }
+
+        ice::arctic::Opcode const opcode = ice::arctic::detail::bytecode_lane_opcode(operation.type, result_type->scalar);
+        if (opcode == Opcode::Count || (result_type->kind == TypeKind::Struct))
+        {
+            report(ParseState::Error_Bytecode_UnsupportedExpression, operation);
+            return { };
+        }
+
+        // Scalars are converted to the scalar of the other operand and broadcast to vectors or matrices.
+        left = materialize(convert(left, result_type, operation));
+        right = materialize(convert(right, result_type, operation));
+        if (left.type == nullptr || right.type == nullptr)
+        {
+            return { };
+        }
+
+        // Lane-wise operations read each source lane before writing it, the operands are no longer needed.
+        ice::u32 const size = register_size(result_type);
+        _register_top = first_temporary;
+
+        Value result{ .type = result_type, .reg = allocate(size), .constant = 0, .is_constant = false, .producer = Constant_None };
+        result.producer = emit_lanes(opcode, size, result.reg, left.reg, right.reg);
+        return result;
+    }
+
+    auto BytecodeCompiler::negate(Value value, ice::arctic::Token const& token, ice::u32 first_temporary) noexcept -> Value
+    {
+        if (value.type == nullptr)
+        {
+            return { };
+        }
+
+        ice::arctic::TokenType const scalar = value.type->scalar;
+        if (value.type->kind == TypeKind::Struct || scalar == TokenType::NT_Bool)
+        {
+            report(ParseState::Error_Bytecode_UnsupportedExpression, token);
+            return { };
+        }
+
+        if (value.is_constant)
+        {
+            value.constant = scalar == TokenType::NT_f32 ? value.constant ^ 0x8000'0000 : 0u - value.constant;
+            return value;
+        }
+
+        ice::u32 const size = register_size(value.type);
+        _register_top = first_temporary;
+
+        Value result{ .type = value.type, .reg = allocate(size), .constant = 0, .is_constant = false, .producer = Constant_None };
+        result.producer = emit_lanes(scalar == TokenType::NT_f32 ? Opcode::NegF32 : Opcode::NegI32, size, result.reg, value.reg, 0);
+        return result;
+    }
+
+    auto BytecodeCompiler::convert(Value value, ice::arctic::TypeHandle type, ice::arctic::Token const& token) noexcept -> Value
+    {
+        if (value.type == nullptr || type == nullptr)
+        {
+            return { };
+        }
+
+        if (value.type == type)
+        {
+            return value;
+        }
+
+        ice::arctic::TypeHandle const source = value.type;
+        if (source->kind == TypeKind::Scalar && (type->kind == TypeKind::Vector || type->kind == TypeKind::Matrix))
+        {
+            value = convert_lanes(value, _model.types().scalar(type->scalar), token);
+            if (value.type == nullptr)
+            {
+                return { };
+            }
+
+            ice::u32 const size = register_size(type);
+            Value result{ .type = type, .reg = allocate(size), .constant = 0, .is_constant = false, .producer = Constant_None };
+            if (value.is_constant)
+            {
+                result.producer = load_splat_constant(result.reg, size, value.constant);
+            }
+            else
+            {
+                for (ice::u32 offset = 0; offset < size; offset += 4)
+                {
+                    emit(ice::arctic::make_instruction(Opcode::Splat, std::min(size - offset, 4u), result.reg + offset, value.reg));
+                }
+            }
+            return result;
+        }
+
+        bool const same_shape = source->kind == type->kind
+            && source->rows == type->rows
+            && source->columns == type->columns
+            && source->kind != TypeKind::Struct;
+
+        if (same_shape == false)
+        {
+            report(ParseState::Error_Semantic_TypeMismatch, token);
+            return { };
+        }
+        return convert_lanes(value, type, token);
+    }
+
+    auto BytecodeCompiler::convert_lanes(Value value, ice::arctic::TypeHandle type, ice::arctic::Token const& token) noexcept -> Value
+    {
+        if (value.type == nullptr || value.type == type)
+        {
+            return value;
+        }
+
+        ice::arctic::Opcode const opcode = ice::arctic::detail::bytecode_convert_opcode(value.type->scalar, type->scalar);
+        if (opcode == Opcode::Count)
+        {
+            report(ParseState::Error_Semantic_TypeMismatch, token);
+            return { };
+        }
+
+        ice::u32 bits = 0;
+        if (opcode == Opcode::Nop || (value.is_constant && ice::arctic::detail::bytecode_convert_constant(opcode, value.constant, bits)))
+        {
+            // Signed and unsigned integers share their bits, constants are converted directly.
+            value.constant = value.is_constant && opcode != Opcode::Nop ? bits : value.constant;
+            value.type = type;
+            return value;
+        }
+
+        value = materialize(value);
+        ice::u32 const size = register_size(type);
+        Value result{ .type = type, .reg = allocate(size), .constant = 0, .is_constant = false, .producer = Constant_None };
+        result.producer = emit_lanes(opcode, size, result.reg, value.reg, 0);
+        return result;
+    }
+
+    auto BytecodeCompiler::materialize(Value value) noexcept -> Value
+    {
+        if (value.type == nullptr || value.is_constant == false)
+        {
+            return value;
+        }
+
+        ice::u32 const reg = allocate(1);
+        return {
+            .type = value.type,
+            .reg = reg,
+            .constant = 0,
+            .is_constant = false,
+            .producer = load_splat_constant(reg, 1, value.constant)
+        };
+    }
+
+    void BytecodeCompiler::store_value(ice::u32 reg, Value const& value) noexcept
+    {
+        if (value.is_constant)
+        {
+            load_splat_constant(reg, 1, value.constant);
+        }
+        else if (value.producer != Constant_None
+            && value.producer + 1 == _code.size()
+            && ice::arctic::detail::bytecode_can_write_to(_code.back(), reg, register_size(value.type)))
+        {
+            // The temporary value was just computed, so it's written to the destination directly.
+            _code.back().value = (_code.back().value & ~0xff00u) | (reg << 8);
+        }
+        else if (value.reg != reg)
+        {
+            ice::u32 const size = register_size(value.type);
+            for (ice::u32 offset = 0; offset < size; offset += 4)
+            {
+                emit(ice::arctic::make_instruction(Opcode::Move, std::min(size - offset, 4u), reg + offset, value.reg + offset));
+            }
+        }
+    }
+
+    void BytecodeCompiler::clear_registers(ice::u32 reg, ice::u32 size) noexcept
+    {
+        if (size != 0)
+        {
+            load_splat_constant(reg, size, 0);
+        }
+    }
+
+    auto BytecodeCompiler::load_constants(ice::u32 reg, ice::Span<ice::u32 const> words) noexcept -> ice::u32
+    {
+        ice::u32 const size = ice::u32(words.size());
+        if (std::all_of(words.begin(), words.end(), [&words](ice::u32 word) noexcept { return word == words[0]; }))
+        {
+            return load_splat_constant(reg, size, words[0]);
+        }
+
+        ice::u32 const constant = add_constants(words);
+        ice::u32 producer = Constant_None;
+        for (ice::u32 offset = 0; offset < size; offset += 4)
+        {
+            producer = emit(ice::arctic::make_instruction_bx(
+                Opcode::LoadConstant, std::min(size - offset, 4u), reg + offset, constant + offset
+            ));
+        }
+        return size <= 4 ? producer : Constant_None;
+    }
+
+    auto BytecodeCompiler::load_splat_constant(ice::u32 reg, ice::u32 size, ice::u32 bits) noexcept -> ice::u32
+    {
+        ice::u32 const constant = add_constants({ &bits, 1 });
+        ice::arctic::Opcode const opcode = size == 1 ? Opcode::LoadConstant : Opcode::LoadConstantSplat;
+
+        ice::u32 producer = Constant_None;
+        for (ice::u32 offset = 0; offset < size; offset += 4)
+        {
+            producer = emit(ice::arctic::make_instruction_bx(opcode, std::min(size - offset, 4u), reg + offset, constant));
+        }
+        return size <= 4 ? producer : Constant_None;
+    }
+
+    void BytecodeCompiler::transfer_data(
+        ice::arctic::Opcode opcode,
+        ice::arctic::TypeHandle type,
+        ice::u32 binding,
+        ice::u32 offset,
+        ice::u32 reg
+    ) noexcept
+    {
+        switch (type->kind)
+        {
+        case TypeKind::Scalar:
+        case TypeKind::Vector:
+            emit(ice::arctic::make_instruction_bx(opcode, type->rows, reg, add_data_ref(binding, offset)));
+            break;
+        case TypeKind::Matrix:
+        {
+            ice::u32 const stride = _layouts.column_stride(type);
+            for (ice::u32 column = 0; column < type->columns; ++column)
+            {
+                emit(ice::arctic::make_instruction_bx(
+                    opcode, type->rows, reg + column * type->rows, add_data_ref(binding, offset + column * stride)
+                ));
+            }
+            break;
+        }
+        case TypeKind::Struct:
+        {
+            ice::arctic::StructLayout const* const layout = _layouts.struct_layout(type);
+            for (ice::u32 idx = 0; idx < layout->members.size(); ++idx)
+            {
+                ice::arctic::MemberLayout const& member = layout->members[idx];
+                transfer_data(opcode, member.member->type, binding, offset + member.offset, reg + member_register_offset(type, idx));
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    auto BytecodeCompiler::emit_lanes(
+        ice::arctic::Opcode opcode,
+        ice::u32 size,
+        ice::u32 a,
+        ice::u32 b,
+        ice::u32 c
+    ) noexcept -> ice::u32
+    {
+        ice::arctic::InstructionFormat const format = ice::arctic::opcode_info(opcode).format;
+
+        ice::u32 producer = Constant_None;
+        for (ice::u32 offset = 0; offset < size; offset += 4)
+        {
+            producer = emit(ice::arctic::make_instruction(
+                opcode, std::min(size - offset, 4u), a + offset, b + offset, format == InstructionFormat::ABC ? c + offset : 0
+            ));
+        }
+        return size <= 4 ? producer : Constant_None;
+    }
+
+    auto BytecodeCompiler::emit(ice::arctic::Instruction instruction) noexcept -> ice::u32
+    {
+        _code.push_back(instruction);
+        return ice::u32(_code.size()) - 1;
+    }
+
+    auto BytecodeCompiler::allocate(ice::u32 size) noexcept -> ice::u32
+    {
+        if (_register_top + size > Constant_MaxRegisters)
+        {
+            if (_register_limit_reported == false)
+            {
+                report(ParseState::Error_Bytecode_RegisterLimit, _statement);
+                _register_limit_reported = true;
+            }
+            return 0;
+        }
+
+        ice::u32 const result = _register_top;
+        _register_top += size;
+        _register_count = std::max(_register_count, _register_top);
+        return result;
+    }
+
+    auto BytecodeCompiler::pack_registers(ice::u32 first_temporary, ice::Span<Value const> values, ice::u32 size) noexcept -> ice::u32
+    {
+        // Values are stored in order, each destination may only overlap registers of the values already stored.
+        //   A value moved down overlapping itself is fine, moves copy the lanes in order.
+        bool can_reuse = true;
+        ice::u32 destination = first_temporary;
+        for (ice::u32 idx = 0; idx < values.size() && can_reuse; ++idx)
+        {
+            ice::u32 const value_size = register_size(values[idx].type);
+            for (ice::u32 next = idx; next < values.size() && can_reuse; ++next)
+            {
+                Value const& source = values[next];
+                can_reuse = source.is_constant
+                    || (next == idx && destination <= source.reg)
+                    || ice::arctic::detail::bytecode_ranges_overlap(destination, value_size, source.reg, register_size(source.type)) == false;
+            }
+            destination += value_size;
+        }
+
+        _register_top = can_reuse ? first_temporary : _register_top;
+        return allocate(size);
+    }
+
+    auto BytecodeCompiler::add_constants(ice::Span<ice::u32 const> words) noexcept -> ice::u32
+    {
+        // Single constants are found by their bits, the pool is untyped so equal bits of different types are shared.
+        if (words.size() == 1)
+        {
+            auto const existing = _constant_indices.find(words[0]);
+            if (existing != _constant_indices.end())
+            {
+                return existing->second;
+            }
+        }
+        else
+        {
+            auto const it = std::search(_constants.begin(), _constants.end(), words.begin(), words.end());
+            if (it != _constants.end() || words.empty())
+            {
+                return ice::u32(it - _constants.begin());
+            }
+        }
+
+        // Constants are loaded with up to four lanes, so every loaded lane needs to be within the table.
+        ice::u32 const result = ice::u32(_constants.size());
+        if (result + words.size() > Constant_MaxTableSize)
+        {
+            if (_table_limit_reported == false)
+            {
+                report(ParseState::Error_Bytecode_TableLimit, _statement);
+                _table_limit_reported = true;
+            }
+            return 0;
+        }
+
+        _constants.insert(_constants.end(), words.begin(), words.end());
+        for (ice::u32 idx = 0; idx < words.size(); ++idx)
+        {
+            _constant_indices.try_emplace(words[idx], result + idx);
+        }
+        return result;
+    }
+
+    auto BytecodeCompiler::add_data_ref(ice::u32 binding, ice::u32 offset) noexcept -> ice::u32
+    {
+        auto const it = std::find_if(_data_refs.begin(), _data_refs.end(), [binding, offset](BytecodeDataRef const& ref) noexcept
+            {
+                return ref.binding == binding && ref.offset == offset;
+            }
+        );
+
+        if (it != _data_refs.end())
+        {
+            return ice::u32(it - _data_refs.begin());
+        }
+
+        if (_data_refs.size() >= Constant_MaxTableSize)
+        {
+            if (_table_limit_reported == false)
+            {
+                report(ParseState::Error_Bytecode_TableLimit, _statement);
+                _table_limit_reported = true;
+            }
+            return 0;
+        }
+
+        _data_refs.push_back({ .binding = binding, .offset = offset });
+        return ice::u32(_data_refs.size()) - 1;
+    }
+
+    auto BytecodeCompiler::add_string(ice::String text) noexcept -> ice::u32
+    {
+        auto const [it, inserted] = _string_offsets.emplace(text, ice::u32(_strings.size()));
+        if (inserted)
+        {
+            _strings.append(text);
+            _strings.push_back(u8'\0');
+        }
+        return it->second;
+    }
+
+    auto BytecodeCompiler::register_size(ice::arctic::TypeHandle type) const noexcept -> ice::u32
+    {
+        if (type == nullptr)
+        {
+            return 0;
+        }
+
+        switch (type->kind)
+        {
+        case TypeKind::Scalar:
+        case TypeKind::Vector:
+        case TypeKind::Matrix:
+            return ice::arctic::detail::bytecode_scalar_supported(type->scalar) ? ice::u32(type->rows) * type->columns : 0;
+        case TypeKind::Struct:
+        {
+            ice::u32 result = 0;
+            for (ice::arctic::TypeMember const& member : type->members)
+            {
+                ice::u32 const size = register_size(member.type);
+                if (size == 0)
+                {
+                    return 0;
+                }
+                result += size;
+            }
+            return result;
+        }
+        default:
+            return 0;
+        }
+    }
+
+    auto BytecodeCompiler::member_register_offset(ice::arctic::TypeHandle type, ice::u32 member) const noexcept -> ice::u32
+    {
+        ice::u32 result = 0;
+        for (ice::u32 idx = 0; idx < member; ++idx)
+        {
+            result += register_size(type->members[idx].type);
+        }
+        return result;
+    }
+
+    auto BytecodeCompiler::entry_result_type(ice::arctic::SyntaxNode_Function const* definition) noexcept -> ice::arctic::TypeHandle
+    {
+        ice::arctic::SyntaxNode const* const body = definition->sibling;
+        if (body == nullptr || body->entity != SyntaxEntity::DEF_FunctionBody)
+        {
+            return nullptr;
+        }
+
+        // Statements of nested scopes are searched in source order as well.
+        std::vector<ice::arctic::SyntaxNode const*> pending{ body->child };
+        while (pending.empty() == false)
+        {
+            ice::arctic::SyntaxNode const* const node = pending.back();
+            pending.pop_back();
+            if (node == nullptr)
+            {
+                continue;
+            }
+
+            pending.push_back(node->sibling);
+            if (node->entity == SyntaxEntity::DEF_ExplicitScope)
+            {
+                pending.push_back(node->child);
+                continue;
+            }
+
+            ice::arctic::OperandList list;
+            if (node->entity != SyntaxEntity::EXP_Expression || list.build(const_cast<ice::arctic::SyntaxNode*>(node)) == false)
+            {
+                continue;
+            }
+
+            ice::arctic::OperandTerm const& root = list.terms()[list.root()];
+            if (root.kind != OperandTermKind::Binary
+                || static_cast<SyntaxNode_ExpressionBinaryOperation const*>(list.items()[root.item].node)->operation.type != TokenType::OP_Assign)
+            {
+                continue;
+            }
+
+            ice::arctic::OperandTerm const& target = list.terms()[root.left];
+            ice::arctic::Symbol const* const symbol = target.kind == OperandTermKind::Operand
+                ? _model.symbol_of(list.items()[target.item].node)
+                : nullptr;
+
+            if (symbol != nullptr && symbol->definition == definition)
+            {
+                return term_type(list, root.right);
+            }
+        }
+        return nullptr;
+    }
+
+    auto BytecodeCompiler::term_type(ice::arctic::OperandList const& list, ice::u32 term) noexcept -> ice::arctic::TypeHandle
+    {
+        ice::arctic::OperandTerm const& typed = list.terms()[term];
+        ice::arctic::SyntaxNode const* const node = list.items()[typed.item].node;
+        switch (typed.kind)
+        {
+        case OperandTermKind::Operand:
+            return operand_type(node);
+        case OperandTermKind::Negate:
+            return term_type(list, typed.left);
+        default:
+        {
+            ice::arctic::TokenType const operation = static_cast<SyntaxNode_ExpressionBinaryOperation const*>(node)->operation.type;
+            ice::arctic::TypeHandle const left = term_type(list, typed.left);
+            return operation == TokenType::OP_Assign ? left : _model.result_type(left, operation, term_type(list, typed.right));
+        }
+        }
+    }
+
+    auto BytecodeCompiler::operand_type(ice::arctic::SyntaxNode const* node) noexcept -> ice::arctic::TypeHandle
+    {
+        if (node->entity == SyntaxEntity::EXP_Value || node->entity == SyntaxEntity::EXP_Call)
+        {
+            return _model.operand_type_of(node);
+        }
+
+        ice::arctic::OperandList list;
+        if (list.build(const_cast<ice::arctic::SyntaxNode*>(node)) == false)
+        {
+            return nullptr;
+        }
+        return term_type(list, list.root());
+    }
+
+    void BytecodeCompiler::report(ice::arctic::ParseState state, ice::arctic::Token const& token) noexcept
+    {
+        _diagnostics.push_back(ParseDiagnostic{ .state = state, .token = token, .expected = { }, .expected_count = 0 });
+    }
+
+} // namespace ice::arctic
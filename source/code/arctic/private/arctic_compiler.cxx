@@ -0,0 +1,72 @@
+#include <ice/arctic_compiler.hxx>
+#include <ice/arctic_word_matcher.hxx>
+#include <ice/arctic_word_processor.hxx>
+#include <ice/arctic_parser.hxx>
+#include <ice/arctic_parallel.hxx>
+#include <ice/arctic_trace.hxx>
+
+namespace ice::arctic
+{
+
+    auto compile_batch(
+        ice::arctic::WordMatcher const* matcher,
+        ice::Span<ice::arctic::SourceDesc const> sources,
+        ice::Span<ice::arctic::CompileResult> out_results,
+        ice::u32 jobs
+    ) noexcept -> ice::u32
+    {
+        assert(matcher->_dispatch_table != nullptr);
+        assert(out_results.size() >= sources.size());
+
+        std::atomic_uint32_t failed_count = 0;
+
+        ice::arctic::detail::parallel_for(
+            ice::u32(sources.size()),
+            jobs,
+            [&](ice::u32 /*worker_idx*/, ice::u32 source_idx) noexcept
+            {
+                ice::arctic::SourceDesc const& source = sources[source_idx];
+                ice::arctic::TraceScope const trace_scope{ "compile.source", nullptr, source_idx };
+
+                ice::arctic::Lexer lexer = ice::arctic::create_lexer(
+                    ice::arctic::create_word_processor(source.source, matcher),
+                    source.lexer_options
+                );
+
+                // Each source gets its own parser, so node allocations are never shared between workers.
+                ice::arctic::Parser parser{ source.parser_options };
+                for (ice::arctic::SyntaxVisitorBase* visitor : source.visitors)
+                {
+                    parser.add_visitor(*visitor);
+                }
+
+                ice::arctic::ParseState const state = parser.parse(lexer);
+                out_results[source_idx].state = state;
+                out_results[source_idx].diagnostics.assign(parser.diagnostics().begin(), parser.diagnostics().end());
+
+                if (ice::arctic::is_error(state))
+                {
+                    failed_count.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        );
+
+        return failed_count.load(std::memory_order_relaxed);
+    }
+
+    auto compile_batch(
+        ice::Span<ice::arctic::SourceDesc const> sources,
+        ice::Span<ice::arctic::CompileResult> out_results,
+        ice::u32 jobs
+    ) noexcept -> ice::u32
+    {
+        ice::arctic::WordMatcher matcher{ };
+        ice::arctic::initialize_ascii_matcher(&matcher);
+
+        ice::u32 const result = ice::arctic::compile_batch(&matcher, sources, out_results, jobs);
+
+        ice::arctic::shutdown_matcher(&matcher);
+        return result;
+    }
+
+} // namespace ice::arctic
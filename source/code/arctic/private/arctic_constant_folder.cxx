@@ -0,0 +1,650 @@
+#include <ice/arctic_constant_folder.hxx>
+#include <ice/arctic_operand_list.hxx>
+
+#include <fmt/format.h>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        //! \brief The value of a single term of an operand list.
+        struct FoldValue
+        {
+            bool constant;
+
+            //! \brief Set if replacing the term with a literal changes the tree, plain literals are kept as they are.
+            bool replace;
+            ice::arctic::ConstantValue value;
+        };
+
+        constexpr auto integer_bits(ice::arctic::TokenType scalar) noexcept -> ice::u32
+        {
+            switch (scalar)
+            {
+            case TokenType::NT_i8: case TokenType::NT_u8: return 8;
+            case TokenType::NT_i16: case TokenType::NT_u16: return 16;
+            case TokenType::NT_i32: case TokenType::NT_u32: return 32;
+            case TokenType::NT_i64: case TokenType::NT_u64: return 64;
+            default: return 0;
+            }
+        }
+
+        constexpr bool is_signed_integer(ice::arctic::TokenType scalar) noexcept
+        {
+            return (ice::u32(scalar) & ice::u32(TokenType::NativeType_Signed)) == ice::u32(TokenType::NativeType_Signed);
+        }
+
+        //! \brief Truncates the value to the width of the given integer type and extends it back to 64 bits.
+        constexpr auto wrap_integer(ice::u64 value, ice::arctic::TokenType scalar) noexcept -> ice::i64
+        {
+            ice::u32 const bits = integer_bits(scalar);
+            if (bits == 64)
+            {
+                return ice::i64(value);
+            }
+
+            ice::u64 const mask = (ice::u64{ 1 } << bits) - 1;
+            value &= mask;
+            if (is_signed_integer(scalar) && ((value >> (bits - 1)) & 1) != 0)
+            {
+                value |= ~mask;
+            }
+            return ice::i64(value);
+        }
+
+        constexpr bool parse_integer_literal(ice::String text, ice::u32 base, ice::u64& out_value) noexcept
+        {
+            out_value = 0;
+            for (ice::utf8 const character : text)
+            {
+                ice::u32 digit = 0;
+                if (character == u8'\'')
+                {
+                    continue;
+                }
+                else if (character >= u8'0' && character <= u8'9')
+                {
+                    digit = character - u8'0';
+                }
+                else if (character >= u8'a' && character <= u8'f')
+                {
+                    digit = character - u8'a' + 10;
+                }
+                else if (character >= u8'A' && character <= u8'F')
+                {
+                    digit = character - u8'A' + 10;
+                }
+                else
+                {
+                    return false;
+                }
+
+                if (digit >= base || out_value > (std::numeric_limits<ice::u64>::max() - digit) / base)
+                {
+                    return false;
+                }
+                out_value = out_value * base + digit;
+            }
+            return true;
+        }
+
+        template<typename T>
+        bool parse_float_literal(ice::String text, ice::f64& out_value) noexcept
+        {
+            std::string digits;
+            for (ice::utf8 const character : text)
+            {
+                if (character != u8'\'')
+                {
+                    digits.push_back(char(character));
+                }
+            }
+
+            T value{ };
+            std::from_chars_result const result = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+            out_value = value;
+            return result.ec == std::errc{ } && result.ptr == digits.data() + digits.size() && std::isfinite(value);
+        }
+
+        template<typename T>
+        bool fold_float_operation(ice::arctic::TokenType operation, T left, T right, ice::f64& out_value) noexcept
+        {
+            T result{ };
+            switch (operation)
+            {
+            case TokenType::OP_Plus: result = left + right; break;
+            case TokenType::OP_Minus: result = left - right; break;
+            case TokenType::OP_Mul: result = left * right; break;
+            case TokenType::OP_Div: result = left / right; break;
+            default: return false;
+            }
+
+            out_value = result;
+            return std::isfinite(result);
+        }
+
+        bool negate_constant(ice::arctic::ConstantValue const& operand, ice::arctic::ConstantValue& out_value) noexcept
+        {
+            ice::arctic::TypeHandle const type = operand.type;
+            if (type->kind != TypeKind::Scalar || type->scalar == TokenType::NT_Bool)
+            {
+                return false;
+            }
+
+            out_value.type = type;
+            if (type->scalar == TokenType::NT_f32 || type->scalar == TokenType::NT_f64)
+            {
+                out_value.floating = -operand.floating;
+            }
+            else
+            {
+                out_value.integer = wrap_integer(ice::u64{ 0 } - ice::u64(operand.integer), type->scalar);
+            }
+            return true;
+        }
+
+    } // namespace detail
+
+    ConstantFolder::ConstantFolder(ice::arctic::SyntaxNodeAllocator& alloc, ice::arctic::SemanticModel const& model) noexcept
+        : _alloc{ alloc }
+        , _model{ model }
+    {
+    }
+
+    auto ConstantFolder::fold(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept -> ice::arctic::ParseState
+    {
+        for (ice::arctic::SyntaxNode const* definition : definitions)
+        {
+            if (definition->entity == SyntaxEntity::DEF_Variable
+                && static_cast<SyntaxNode_Variable const*>(definition)->is_const)
+            {
+                _pending_globals.emplace(definition, false);
+            }
+        }
+
+        for (ice::arctic::SyntaxNode const* definition : definitions)
+        {
+            // The tree is owned by the allocator, definitions are only const for visitors.
+            ice::arctic::SyntaxNode* const node = const_cast<ice::arctic::SyntaxNode*>(definition);
+            if (node->entity == SyntaxEntity::DEF_Variable)
+            {
+                ice::arctic::SyntaxNode_Variable* const variable = static_cast<SyntaxNode_Variable*>(node);
+                if (variable->is_const)
+                {
+                    fold_global_constant(variable, variable->name);
+                }
+                else if (variable->child != nullptr)
+                {
+                    ice::arctic::ConstantValue value;
+                    fold_list(variable->child, value);
+                }
+            }
+            else if (node->entity == SyntaxEntity::DEF_Function && node->sibling != nullptr)
+            {
+                fold_statements(node->sibling->child);
+            }
+        }
+
+        return _diagnostics.empty() ? ParseState::Success : _diagnostics.front().state;
+    }
+
+    auto ConstantFolder::constant_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::ConstantValue const*
+    {
+        auto const it = _constants.find(node);
+        return it != _constants.end() ? &it->second : nullptr;
+    }
+
+    void ConstantFolder::fold_constant(ice::arctic::SyntaxNode_Variable* node) noexcept
+    {
+        // Errors found in the initializer are already reported at the failing operation.
+        ice::u64 const diagnostic_count = _diagnostics.size();
+
+        ice::arctic::ConstantValue value;
+        if (node->child == nullptr || fold_list(node->child, value) == false)
+        {
+            if (_diagnostics.size() == diagnostic_count)
+            {
+                report(ParseState::Error_Semantic_NotConstant, node->name);
+            }
+        }
+        else if (value.type != _model.type_of(node))
+        {
+            report(ParseState::Error_Semantic_TypeMismatch, node->name);
+        }
+        else
+        {
+            _constants.emplace(node, value);
+        }
+    }
+
+    void ConstantFolder::fold_global_constant(ice::arctic::SyntaxNode const* node, ice::arctic::Token const& reference) noexcept
+    {
+        auto const it = _pending_globals.find(node);
+        if (it == _pending_globals.end())
+        {
+            return;
+        }
+
+        if (it->second)
+        {
+            report(ParseState::Error_Semantic_NotConstant, reference);
+            return;
+        }
+
+        it->second = true;
+        fold_constant(static_cast<SyntaxNode_Variable*>(const_cast<SyntaxNode*>(node)));
+        _pending_globals.erase(node);
+    }
+
+    void ConstantFolder::fold_statements(ice::arctic::SyntaxNode* first) noexcept
+    {
+        for (ice::arctic::SyntaxNode* node = first; node != nullptr; node = node->sibling)
+        {
+            ice::arctic::ConstantValue value;
+            switch (node->entity)
+            {
+            case SyntaxEntity::DEF_Variable:
+                if (static_cast<SyntaxNode_Variable*>(node)->is_const)
+                {
+                    fold_constant(static_cast<SyntaxNode_Variable*>(node));
+                }
+                else if (node->child != nullptr)
+                {
+                    fold_list(node->child, value);
+                }
+                break;
+            case SyntaxEntity::DEF_ExplicitScope:
+                fold_statements(node->child);
+                break;
+            case SyntaxEntity::EXP_Expression:
+                fold_list(node, value);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    void ConstantFolder::fold_nested(ice::arctic::SyntaxNode* node) noexcept
+    {
+        ice::arctic::ConstantValue value;
+        switch (node->entity)
+        {
+        case SyntaxEntity::EXP_Call:
+            for (ice::arctic::SyntaxNode* argument = node->child; argument != nullptr; argument = argument->sibling)
+            {
+                fold_list(argument, value);
+            }
+            break;
+        case SyntaxEntity::EXP_Expression:
+        case SyntaxEntity::EXP_ExplicitScope:
+            fold_list(node, value);
+            break;
+        default:
+            break;
+        }
+    }
+
+    bool ConstantFolder::fold_list(ice::arctic::SyntaxNode* parent, ice::arctic::ConstantValue& out_value) noexcept
+    {
+        ice::arctic::OperandList list;
+        bool const valid = list.build(parent);
+
+        // Nested lists are single operands of this list, so they are folded first.
+        for (ice::arctic::OperandItem const& item : list.items())
+        {
+            if (item.kind == OperandItemKind::Operand)
+            {
+                fold_nested(item.node);
+            }
+        }
+
+        // Lists we don't understand are kept as they are.
+        if (valid == false)
+        {
+            return false;
+        }
+
+        ice::Span<ice::arctic::OperandItem const> const items = list.items();
+        ice::Span<ice::arctic::OperandTerm const> const terms = list.terms();
+
+        std::vector<ice::arctic::detail::FoldValue> values(terms.size());
+        std::vector<ice::arctic::OperandReplacement> replacements;
+        for (ice::u32 idx = 0; idx < terms.size(); ++idx)
+        {
+            ice::arctic::OperandTerm const& term = terms[idx];
+            ice::arctic::detail::FoldValue& result = values[idx];
+
+            if (term.kind == OperandTermKind::Operand)
+            {
+                ice::arctic::SyntaxNode const* const node = items[term.item].node;
+                bool const is_literal = node->entity == SyntaxEntity::EXP_Value
+                    && static_cast<SyntaxNode_ExpressionValue const*>(node)->value.type != TokenType::CT_Symbol;
+
+                // Replacing a plain literal with itself would only create garbage.
+                result.constant = evaluate_operand(node, result.value);
+                result.replace = result.constant && is_literal == false;
+                continue;
+            }
+
+            ice::arctic::detail::FoldValue const& left = values[term.left];
+            if (term.kind == OperandTermKind::Negate)
+            {
+                result.constant = left.constant && detail::negate_constant(left.value, result.value);
+            }
+            else
+            {
+                ice::arctic::detail::FoldValue const& right = values[term.right];
+                ice::arctic::Token const& operation = static_cast<SyntaxNode_ExpressionBinaryOperation const*>(
+                    items[term.item].node
+                )->operation;
+
+                result.constant = left.constant && right.constant && evaluate_binary(left.value, operation, right.value, result.value);
+            }
+            result.replace = result.constant;
+
+            // Only complete subexpressions are replaced, so constant operands of non-constant terms are replaced on their own.
+            if (result.constant == false)
+            {
+                for (ice::u32 const operand : { term.left, term.right })
+                {
+                    if (operand != OperandList::Constant_None && values[operand].replace)
+                    {
+                        replacements.push_back({ .term = operand, .node = nullptr });
+                    }
+                }
+            }
+        }
+
+        ice::arctic::detail::FoldValue const& root = values[list.root()];
+        if (root.replace)
+        {
+            replacements.push_back({ .term = list.root(), .node = nullptr });
+        }
+
+        for (ice::arctic::OperandReplacement& replacement : replacements)
+        {
+            ice::arctic::SyntaxNode const* const first = items[terms[replacement.term].first].node;
+            replacement.node = create_literal(values[replacement.term].value, ice::arctic::operand_location(first));
+        }
+
+        std::vector<ice::arctic::OperandItem> removed;
+        list.replace(replacements, removed);
+        for (ice::arctic::OperandItem const& item : removed)
+        {
+            release(item.node, item.kind == OperandItemKind::Operand);
+        }
+
+        _folded_count += ice::u32(replacements.size());
+        out_value = root.value;
+        return root.constant;
+    }
+
+    bool ConstantFolder::evaluate_operand(ice::arctic::SyntaxNode const* node, ice::arctic::ConstantValue& out_value) noexcept
+    {
+        auto const it = _constants.find(node);
+        if (it != _constants.end())
+        {
+            out_value = it->second;
+            return true;
+        }
+
+        if (node->entity == SyntaxEntity::EXP_ExplicitScope)
+        {
+            return node->child != nullptr && node->child->sibling == nullptr && evaluate_operand(node->child, out_value);
+        }
+
+        // Member accesses are never constant, there are no constant structs or vectors.
+        if (node->entity != SyntaxEntity::EXP_Value || node->child != nullptr)
+        {
+            return false;
+        }
+
+        ice::arctic::SyntaxNode_ExpressionValue const* const value = static_cast<SyntaxNode_ExpressionValue const*>(node);
+        if (value->value.type != TokenType::CT_Symbol)
+        {
+            return evaluate_literal(value, out_value);
+        }
+
+        ice::arctic::Symbol const* const symbol = _model.symbol_of(node);
+        if (symbol == nullptr || symbol->kind != SymbolKind::Constant)
+        {
+            return false;
+        }
+
+        fold_global_constant(symbol->definition, value->value);
+
+        ice::arctic::ConstantValue const* const constant = constant_of(symbol->definition);
+        if (constant != nullptr)
+        {
+            out_value = *constant;
+        }
+        return constant != nullptr;
+    }
+
+    bool ConstantFolder::evaluate_literal(
+        ice::arctic::SyntaxNode_ExpressionValue const* node,
+        ice::arctic::ConstantValue& out_value
+    ) const noexcept
+    {
+        ice::arctic::TypeHandle const type = _model.type_of(node);
+        if (type == nullptr || type->kind != TypeKind::Scalar)
+        {
+            return false;
+        }
+
+        out_value.type = type;
+
+        ice::String const text = node->value.value;
+        ice::u64 integer = 0;
+        bool parsed = false;
+        switch (node->value.type)
+        {
+        case TokenType::KW_True:
+        case TokenType::KW_False:
+            out_value.boolean = node->value.type == TokenType::KW_True;
+            return type->scalar == TokenType::NT_Bool;
+        case TokenType::CT_NumberFloat:
+            if (type->scalar == TokenType::NT_f32)
+            {
+                return detail::parse_float_literal<ice::f32>(text, out_value.floating);
+            }
+            return type->scalar == TokenType::NT_f64 && detail::parse_float_literal<ice::f64>(text, out_value.floating);
+        case TokenType::CT_Number:
+            parsed = detail::parse_integer_literal(text, 10, integer);
+            break;
+        case TokenType::CT_NumberHex:
+            parsed = text.size() > 2 && detail::parse_integer_literal(text.substr(2), 16, integer);
+            break;
+        case TokenType::CT_NumberBin:
+            parsed = text.size() > 2 && detail::parse_integer_literal(text.substr(2), 2, integer);
+            break;
+        case TokenType::CT_NumberOct:
+            parsed = detail::parse_integer_literal(text.substr(1), 8, integer);
+            break;
+        default:
+            return false;
+        }
+
+        ice::u32 const bits = detail::integer_bits(type->scalar);
+        if (parsed == false || bits == 0)
+        {
+            return false;
+        }
+
+        // Literals out of range for their type are left for the target compiler to report.
+        ice::u32 const value_bits = detail::is_signed_integer(type->scalar) ? bits - 1 : bits;
+        if (value_bits < 64 && integer >= (ice::u64{ 1 } << value_bits))
+        {
+            return false;
+        }
+
+        out_value.integer = ice::i64(integer);
+        return true;
+    }
+
+    bool ConstantFolder::evaluate_binary(
+        ice::arctic::ConstantValue const& left,
+        ice::arctic::Token const& operation,
+        ice::arctic::ConstantValue const& right,
+        ice::arctic::ConstantValue& out_value
+    ) noexcept
+    {
+        ice::arctic::TypeHandle const type = left.type;
+        if (type->kind != TypeKind::Scalar || right.type->kind != TypeKind::Scalar)
+        {
+            return false;
+        }
+
+        // Scalars are never converted implicitly, the same as for the semantic model.
+        if (type != right.type)
+        {
+            report(ParseState::Error_Semantic_TypeMismatch, operation);
+            return false;
+        }
+
+        bool const is_float = type->scalar == TokenType::NT_f32 || type->scalar == TokenType::NT_f64;
+        if (is_float && operation.type == TokenType::OP_Div && right.floating == 0.0)
+        {
+            report(ParseState::Error_Semantic_DivisionByZero, operation);
+            return false;
+        }
+
+        out_value.type = type;
+        switch (type->scalar)
+        {
+        case TokenType::NT_Bool:
+            if (operation.type == TokenType::OP_And || operation.type == TokenType::OP_Or)
+            {
+                out_value.boolean = operation.type == TokenType::OP_And
+                    ? (left.boolean && right.boolean)
+                    : (left.boolean || right.boolean);
+                return true;
+            }
+            return false;
+        case TokenType::NT_f32:
+            return detail::fold_float_operation<ice::f32>(
+                operation.type, ice::f32(left.floating), ice::f32(right.floating), out_value.floating
+            );
+        case TokenType::NT_f64:
+            return detail::fold_float_operation<ice::f64>(operation.type, left.floating, right.floating, out_value.floating);
+        default:
+            break;
+        }
+
+        if (detail::integer_bits(type->scalar) == 0)
+        {
+            return false;
+        }
+
+        ice::u64 const left_bits = ice::u64(left.integer);
+        ice::u64 const right_bits = ice::u64(right.integer);
+        switch (operation.type)
+        {
+        case TokenType::OP_Plus:
+            out_value.integer = detail::wrap_integer(left_bits + right_bits, type->scalar);
+            return true;
+        case TokenType::OP_Minus:
+            out_value.integer = detail::wrap_integer(left_bits - right_bits, type->scalar);
+            return true;
+        case TokenType::OP_Mul:
+            out_value.integer = detail::wrap_integer(left_bits * right_bits, type->scalar);
+            return true;
+        case TokenType::OP_Div:
+            if (right_bits == 0)
+            {
+                report(ParseState::Error_Semantic_DivisionByZero, operation);
+                return false;
+            }
+
+            if (detail::is_signed_integer(type->scalar) == false)
+            {
+                out_value.integer = detail::wrap_integer(left_bits / right_bits, type->scalar);
+            }
+            else if (left.integer == std::numeric_limits<ice::i64>::min() && right.integer == -1)
+            {
+                // Only reachable for 'i64', narrower types are sign-extended and can't overflow.
+                out_value.integer = left.integer;
+            }
+            else
+            {
+                out_value.integer = detail::wrap_integer(ice::u64(left.integer / right.integer), type->scalar);
+            }
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    auto ConstantFolder::create_literal(
+        ice::arctic::ConstantValue const& value,
+        ice::arctic::TokenLocation location
+    ) noexcept -> ice::arctic::SyntaxNode*
+    {
+        ice::arctic::TokenType const scalar = value.type->scalar;
+
+        std::string text;
+        ice::arctic::TokenType token_type = TokenType::CT_Number;
+        if (scalar == TokenType::NT_Bool)
+        {
+            text = value.boolean ? "true" : "false";
+            token_type = value.boolean ? TokenType::KW_True : TokenType::KW_False;
+        }
+        else if (scalar == TokenType::NT_f32 || scalar == TokenType::NT_f64)
+        {
+            // Shortest representation that reads back as the same value, it needs to stay a floating point literal.
+            text = scalar == TokenType::NT_f32
+                ? fmt::format("{}", ice::f32(value.floating))
+                : fmt::format("{}", value.floating);
+            if (text.find_first_of(".e") == std::string::npos)
+            {
+                text += ".0";
+            }
+            token_type = TokenType::CT_NumberFloat;
+        }
+        else if (detail::is_signed_integer(scalar))
+        {
+            text = fmt::format("{}", value.integer);
+        }
+        else
+        {
+            text = fmt::format("{}", ice::u64(value.integer));
+        }
+
+        std::u8string const& literal_text = _literals.emplace_back(text.begin(), text.end());
+
+        ice::arctic::SyntaxNode_ExpressionValue* const literal = _alloc.create<SyntaxNode_ExpressionValue>();
+        literal->value = ice::arctic::Token{ .value = literal_text, .type = token_type, .location = location };
+        _constants.emplace(literal, value);
+        return literal;
+    }
+
+    void ConstantFolder::release(ice::arctic::SyntaxNode* node, bool with_children) noexcept
+    {
+        if (with_children)
+        {
+            ice::arctic::SyntaxNode* child = node->child;
+            while (child != nullptr)
+            {
+                ice::arctic::SyntaxNode* const next = child->sibling;
+                release(child, true);
+                child = next;
+            }
+        }
+
+        _constants.erase(node);
+        _alloc.destroy(node);
+    }
+
+    void ConstantFolder::report(ice::arctic::ParseState state, ice::arctic::Token const& token) noexcept
+    {
+        _diagnostics.push_back(ParseDiagnostic{ .state = state, .token = token, .expected = { }, .expected_count = 0 });
+    }
+
+} // namespace ice::arctic
@@ -0,0 +1,776 @@
+#include <ice/arctic_function_inliner.hxx>
+#include <ice/arctic_syntax_walker.hxx>
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <cassert>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        //! \returns 'true' for nodes that can be copied into the body of another function.
+        constexpr bool is_inlinable_entity(ice::arctic::SyntaxEntity entity) noexcept
+        {
+            switch (entity)
+            {
+            case SyntaxEntity::DEF_Variable:
+            case SyntaxEntity::DEF_ExplicitScope:
+            case SyntaxEntity::EXP_Value:
+            case SyntaxEntity::EXP_GetMember:
+            case SyntaxEntity::EXP_Call:
+            case SyntaxEntity::EXP_CallArg:
+            case SyntaxEntity::EXP_Expression:
+            case SyntaxEntity::EXP_UnaryOperation:
+            case SyntaxEntity::EXP_BinaryOperation:
+            case SyntaxEntity::EXP_ExplicitScope:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        inline bool is_inliner_assignment(ice::arctic::SyntaxNode const* node) noexcept
+        {
+            return node != nullptr
+                && node->entity == SyntaxEntity::EXP_BinaryOperation
+                && static_cast<SyntaxNode_ExpressionBinaryOperation const*>(node)->operation.type == TokenType::OP_Assign;
+        }
+
+        inline auto inliner_declared_name(ice::arctic::SyntaxNode const* node) noexcept -> ice::String
+        {
+            switch (node->entity)
+            {
+            case SyntaxEntity::DEF_Variable: return static_cast<SyntaxNode_Variable const*>(node)->name.value;
+            case SyntaxEntity::DEF_FunctionArgument: return static_cast<SyntaxNode_FunctionArgument const*>(node)->name.value;
+            case SyntaxEntity::DEF_Function: return static_cast<SyntaxNode_Function const*>(node)->name.value;
+            default: return { };
+            }
+        }
+
+        //! \brief Collects arguments and locals of a function, including locals of nested scopes.
+        struct InlinerDeclarations
+        {
+            std::vector<ice::arctic::SyntaxNode const*>& declarations;
+            std::unordered_set<ice::String>& names;
+
+            void enter(ice::arctic::SyntaxNode_Variable const* node) noexcept
+            {
+                declarations.push_back(node);
+                names.insert(node->name.value);
+            }
+
+            void enter(ice::arctic::SyntaxNode_FunctionArgument const* node) noexcept
+            {
+                declarations.push_back(node);
+                names.insert(node->name.value);
+            }
+        };
+
+    } // namespace detail
+
+    FunctionInliner::FunctionInliner(
+        ice::arctic::SyntaxNodeAllocator& alloc,
+        ice::arctic::SemanticModel const& model,
+        ice::arctic::InlinerOptions const& options
+    ) noexcept
+        : _alloc{ alloc }
+        , _model{ model }
+        , _options{ options }
+    {
+    }
+
+    FunctionInliner::~FunctionInliner() noexcept
+    {
+        for (auto& [definition, summary] : _functions)
+        {
+            if (summary.body != nullptr)
+            {
+                release(summary.body);
+            }
+        }
+    }
+
+    auto FunctionInliner::inline_calls(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept -> ice::u32
+    {
+        _globals.insert(definitions.begin(), definitions.end());
+        for (ice::arctic::SyntaxNode const* definition : definitions)
+        {
+            if (definition->entity == SyntaxEntity::DEF_Function && _functions.contains(definition) == false)
+            {
+                summarize(static_cast<ice::arctic::SyntaxNode_Function const*>(definition));
+            }
+        }
+        propagate_effects();
+
+        // Bodies are copied before any call is inlined, so later copies don't contain locals of earlier inlined calls.
+        for (auto& [definition, summary] : _functions)
+        {
+            if (summary.body == nullptr
+                && summary.is_supported
+                && summary.is_recursive == false
+                && summary.cost <= _options.max_cost)
+            {
+                summary.body = clone(definition->sibling);
+                summary.result_value = result_value_of(summary);
+            }
+        }
+
+        ice::u32 const first_inlined = _inlined_count;
+        for (ice::arctic::SyntaxNode const* definition : definitions)
+        {
+            ice::arctic::SyntaxNode const* const body = definition->sibling;
+            if (definition->entity != SyntaxEntity::DEF_Function || body == nullptr || body->entity != SyntaxEntity::DEF_FunctionBody)
+            {
+                continue;
+            }
+
+            // New locals only need to differ from names used by this function.
+            std::vector<ice::arctic::SyntaxNode const*> declarations;
+            _local_names.clear();
+            if (ice::arctic::walk(definition, ice::arctic::detail::InlinerDeclarations{ declarations, _local_names }) == WalkResult::DepthExceeded)
+            {
+                declarations.clear();
+                ice::arctic::walk_unbounded(definition, ice::arctic::detail::InlinerDeclarations{ declarations, _local_names });
+            }
+
+            // The tree is owned by the allocator, definitions are only const for visitors.
+            _function_inlined_count = 0;
+            inline_block(const_cast<ice::arctic::SyntaxNode*>(body));
+        }
+        return _inlined_count - first_inlined;
+    }
+
+    auto FunctionInliner::inline_cost(ice::arctic::SyntaxNode const* function) const noexcept -> ice::u32
+    {
+        auto const it = _functions.find(function);
+        if (it == _functions.end() || it->second.is_supported == false || it->second.is_recursive)
+        {
+            return Constant_NotInlinable;
+        }
+        return it->second.cost;
+    }
+
+    void FunctionInliner::summarize(ice::arctic::SyntaxNode_Function const* definition) noexcept
+    {
+        FunctionSummary& summary = _functions[definition];
+        summary.definition = definition;
+
+        // Entry functions are called by the pipeline, their result is not a value.
+        ice::arctic::Symbol const* const symbol = _model.symbol_of(definition);
+        ice::arctic::SyntaxNode const* const body = definition->sibling;
+        summary.is_supported = symbol != nullptr
+            && symbol->type != nullptr
+            && symbol->type->kind != TypeKind::Stage
+            && body != nullptr
+            && body->entity == SyntaxEntity::DEF_FunctionBody;
+
+        if (summary.is_supported == false)
+        {
+            // Nothing is known about functions without a body, so these could have any effect.
+            summary.writes_globals = true;
+            summary.reads_globals = true;
+            return;
+        }
+
+        // Locals missing from the declarations would be treated as globals, deep functions are walked again without a depth limit.
+        std::unordered_set<ice::String> declared_names;
+        WalkResult const declarations_result = ice::arctic::walk(
+            static_cast<ice::arctic::SyntaxNode const*>(definition),
+            ice::arctic::detail::InlinerDeclarations{ summary.declarations, declared_names }
+        );
+        if (declarations_result == WalkResult::DepthExceeded)
+        {
+            summary.declarations.clear();
+            ice::arctic::walk_unbounded(
+                static_cast<ice::arctic::SyntaxNode const*>(definition),
+                ice::arctic::detail::InlinerDeclarations{ summary.declarations, declared_names }
+            );
+        }
+
+        summary.argument_count = ice::u32(std::count_if(summary.declarations.begin(), summary.declarations.end(),
+            [](ice::arctic::SyntaxNode const* node) noexcept { return node->entity == SyntaxEntity::DEF_FunctionArgument; }
+        ));
+
+        summary.has_result = symbol->type->kind != TypeKind::Void;
+        summarize_children(summary, body);
+
+        // Results of functions not assigning their name are undefined, calls of these are kept as they are.
+        summary.is_supported &= summary.has_result == false || summary.result_assignments > 0;
+    }
+
+    void FunctionInliner::summarize_children(FunctionSummary& summary, ice::arctic::SyntaxNode const* parent) noexcept
+    {
+        auto const is_local = [&summary](ice::arctic::SyntaxNode const* definition) noexcept
+        {
+            return definition == summary.definition
+                || std::find(summary.declarations.begin(), summary.declarations.end(), definition) != summary.declarations.end();
+        };
+
+        for (ice::arctic::SyntaxNode const* node = parent->child; node != nullptr; node = node->sibling)
+        {
+            summary.cost += 1;
+            summary.is_supported &= ice::arctic::detail::is_inlinable_entity(node->entity) && node->annotation == nullptr;
+
+            if (node->entity == SyntaxEntity::EXP_Value
+                && static_cast<SyntaxNode_ExpressionValue const*>(node)->value.type == TokenType::CT_Symbol)
+            {
+                ice::arctic::Symbol const* const symbol = _model.symbol_of(node);
+                if (symbol == nullptr)
+                {
+                    summary.is_supported = false;
+                }
+                else if (is_local(symbol->definition) == false)
+                {
+                    summary.free_names.insert(symbol->name);
+                    summary.reads_globals |= symbol->kind == SymbolKind::Variable || symbol->kind == SymbolKind::ContextVariable;
+                }
+                else if (symbol->kind == SymbolKind::FunctionArgument && node->child != nullptr)
+                {
+                    summary.accessed_arguments.insert(symbol->definition);
+                }
+
+                // Operand lists are stored as siblings, each value followed by an assignment is a target, ex.: 'a = b = c'.
+                if (symbol != nullptr && ice::arctic::detail::is_inliner_assignment(node->sibling))
+                {
+                    if (symbol->definition == summary.definition)
+                    {
+                        summary.result_assignments += 1;
+                    }
+                    else if (symbol->kind == SymbolKind::FunctionArgument)
+                    {
+                        summary.assigned_arguments.insert(symbol->definition);
+                    }
+                    else if (is_local(symbol->definition) == false)
+                    {
+                        summary.writes_globals = true;
+                    }
+                }
+            }
+            else if (node->entity == SyntaxEntity::EXP_Call)
+            {
+                // Constructors are found by name as well, so they can't be shadowed by locals of the caller either.
+                summary.free_names.insert(static_cast<SyntaxNode_ExpressionCall const*>(node)->function.value);
+
+                ice::arctic::Symbol const* const symbol = _model.symbol_of(node);
+                if (symbol != nullptr && symbol->kind == SymbolKind::Function)
+                {
+                    summary.callees.push_back(symbol->definition);
+                }
+                else if (symbol == nullptr && _model.type_of(node) == nullptr)
+                {
+                    summary.is_supported = false;
+                }
+            }
+
+            summarize_children(summary, node);
+        }
+    }
+
+    void FunctionInliner::propagate_effects() noexcept
+    {
+        // Functions on a cycle of calls reach themselves, no matter how many calls are in between.
+        for (auto& [definition, summary] : _functions)
+        {
+            std::unordered_set<ice::arctic::SyntaxNode const*> visited;
+            std::vector<ice::arctic::SyntaxNode const*> pending{ summary.callees.begin(), summary.callees.end() };
+            while (pending.empty() == false && summary.is_recursive == false)
+            {
+                ice::arctic::SyntaxNode const* const callee = pending.back();
+                pending.pop_back();
+
+                summary.is_recursive = callee == definition;
+                auto const it = _functions.find(callee);
+                if (it != _functions.end() && visited.insert(callee).second)
+                {
+                    pending.insert(pending.end(), it->second.callees.begin(), it->second.callees.end());
+                }
+            }
+        }
+
+        // Effects of callees are effects of their callers, repeated until no summary changes.
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (auto& [definition, summary] : _functions)
+            {
+                for (ice::arctic::SyntaxNode const* callee : summary.callees)
+                {
+                    auto const it = _functions.find(callee);
+                    bool const writes = it == _functions.end() || it->second.writes_globals;
+                    bool const reads = it == _functions.end() || it->second.reads_globals;
+
+                    changed |= (writes && summary.writes_globals == false) || (reads && summary.reads_globals == false);
+                    summary.writes_globals |= writes;
+                    summary.reads_globals |= reads;
+                }
+            }
+        }
+    }
+
+    auto FunctionInliner::result_value_of(FunctionSummary const& summary) const noexcept -> ice::arctic::SyntaxNode const*
+    {
+        ice::arctic::SyntaxNode const* last = summary.body->child;
+        while (last != nullptr && last->sibling != nullptr)
+        {
+            last = last->sibling;
+        }
+
+        if (summary.result_assignments != 1 || last == nullptr || last->entity != SyntaxEntity::EXP_Expression)
+        {
+            return nullptr;
+        }
+
+        ice::arctic::SyntaxNode const* const target = last->child;
+        if (target == nullptr
+            || target->entity != SyntaxEntity::EXP_Value
+            || target->child != nullptr
+            || ice::arctic::detail::is_inliner_assignment(target->sibling) == false
+            || target->sibling->sibling == nullptr)
+        {
+            return nullptr;
+        }
+
+        ice::arctic::Symbol const* const symbol = _model.symbol_of(origin_of(target));
+        if (symbol == nullptr || symbol->definition != summary.definition)
+        {
+            return nullptr;
+        }
+
+        // Chained assignments, ex.: 'Fn = a = b', also write other variables and are kept as a statement.
+        for (ice::arctic::SyntaxNode const* node = target->sibling->sibling; node != nullptr; node = node->sibling)
+        {
+            if (ice::arctic::detail::is_inliner_assignment(node))
+            {
+                return nullptr;
+            }
+        }
+        return target->sibling->sibling;
+    }
+
+    void FunctionInliner::inline_block(ice::arctic::SyntaxNode* block) noexcept
+    {
+        ice::arctic::SyntaxNode** link = &block->child;
+        while (*link != nullptr)
+        {
+            // Statements created for an inlined call are visited next, so calls in arguments and copied bodies are inlined too.
+            if (_function_inlined_count < _options.max_inlined_calls && inline_first_call(link))
+            {
+                continue;
+            }
+
+            if ((*link)->entity == SyntaxEntity::DEF_ExplicitScope)
+            {
+                inline_block(*link);
+            }
+            link = &(*link)->sibling;
+        }
+    }
+
+    bool FunctionInliner::inline_first_call(ice::arctic::SyntaxNode** statement) noexcept
+    {
+        ice::arctic::SyntaxNode* const node = *statement;
+        if (node->entity == SyntaxEntity::DEF_ExplicitScope)
+        {
+            return false;
+        }
+
+        ice::arctic::SyntaxNode** const call = find_call(statement, true, has_effects(node));
+        if (call == nullptr)
+        {
+            return false;
+        }
+
+        // Nothing else is evaluated by the statement, the result is discarded.
+        bool const is_statement = call == statement
+            || (node->entity == SyntaxEntity::EXP_Expression && call == &node->child && (*call)->sibling == nullptr);
+
+        expand(statement, call, is_statement);
+        _function_inlined_count += 1;
+        _inlined_count += 1;
+        return true;
+    }
+
+    auto FunctionInliner::find_call(
+        ice::arctic::SyntaxNode** link,
+        bool is_statement,
+        bool statement_effects
+    ) const noexcept -> ice::arctic::SyntaxNode**
+    {
+        ice::arctic::SyntaxNode* const node = *link;
+        if (node->entity == SyntaxEntity::EXP_Call && can_inline(node, is_statement, statement_effects))
+        {
+            return link;
+        }
+
+        // An expression holding a single operand is still the whole statement.
+        bool const is_single = is_statement
+            && node->entity == SyntaxEntity::EXP_Expression
+            && node->child != nullptr
+            && node->child->sibling == nullptr;
+
+        for (ice::arctic::SyntaxNode** child = &node->child; *child != nullptr; child = &(*child)->sibling)
+        {
+            if (ice::arctic::SyntaxNode** const result = find_call(child, is_single, statement_effects); result != nullptr)
+            {
+                return result;
+            }
+        }
+        return nullptr;
+    }
+
+    bool FunctionInliner::can_inline(ice::arctic::SyntaxNode const* call, bool is_statement, bool statement_effects) const noexcept
+    {
+        FunctionSummary const* const summary = summary_of(call);
+        if (summary == nullptr || summary->body == nullptr)
+        {
+            return false;
+        }
+
+        // Copies are evaluated before the statement, other calls of the statement could observe the changed order.
+        if (is_statement == false && (summary->writes_globals || summary->has_result == false))
+        {
+            return false;
+        }
+        if (is_statement == false && summary->reads_globals && statement_effects)
+        {
+            return false;
+        }
+
+        ice::u32 argument_count = 0;
+        for (ice::arctic::SyntaxNode const* child = call->child; child != nullptr; child = child->sibling)
+        {
+            if (child->entity == SyntaxEntity::EXP_CallArg)
+            {
+                if (child->child == nullptr)
+                {
+                    return false;
+                }
+                argument_count += 1;
+            }
+        }
+
+        return argument_count == summary->argument_count
+            && std::none_of(summary->free_names.begin(), summary->free_names.end(),
+                [this](ice::String name) noexcept { return _local_names.contains(name); }
+            );
+    }
+
+    bool FunctionInliner::has_effects(ice::arctic::SyntaxNode const* node) const noexcept
+    {
+        if (node->entity == SyntaxEntity::EXP_Call)
+        {
+            ice::arctic::Symbol const* const symbol = _model.symbol_of(origin_of(node));
+            if (symbol != nullptr && symbol->kind == SymbolKind::Function)
+            {
+                auto const it = _functions.find(symbol->definition);
+                if (it == _functions.end() || it->second.writes_globals)
+                {
+                    return true;
+                }
+            }
+        }
+
+        for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+        {
+            if (has_effects(child))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void FunctionInliner::expand(
+        ice::arctic::SyntaxNode** statement,
+        ice::arctic::SyntaxNode** call_link,
+        bool is_statement
+    ) noexcept
+    {
+        auto* const call = static_cast<ice::arctic::SyntaxNode_ExpressionCall*>(*call_link);
+        FunctionSummary const& summary = *summary_of(call);
+        ice::arctic::SyntaxNode_Function const* const function = summary.definition;
+        ice::arctic::TokenLocation const location = call->function.location;
+
+        std::vector<ice::arctic::SyntaxNode const*> declarations{ summary.declarations };
+        declarations.push_back(function);
+
+        // All names of a copy share a prefix, chosen so none of them collides with a global or a local of the caller.
+        std::u8string prefix;
+        auto const prefixed = [&prefix](ice::arctic::SyntaxNode const* node) noexcept -> std::u8string
+        {
+            return prefix + std::u8string{ ice::arctic::detail::inliner_declared_name(node) };
+        };
+
+        bool has_collision = true;
+        while (has_collision)
+        {
+            std::string const text = fmt::format("inlined_{}_", _name_index++);
+            prefix.assign(text.begin(), text.end());
+
+            has_collision = std::any_of(declarations.begin(), declarations.end(),
+                [&](ice::arctic::SyntaxNode const* node) noexcept
+                {
+                    std::u8string const name = prefixed(node);
+                    return _model.globals().find(name) != nullptr || _local_names.contains(name);
+                }
+            );
+        }
+
+        _renames.clear();
+        for (ice::arctic::SyntaxNode const* node : declarations)
+        {
+            ice::String const name = _names.emplace_back(prefixed(node));
+            _local_names.insert(name);
+            _renames.emplace(node, name);
+        }
+
+        ice::arctic::SyntaxNode* first = nullptr;
+        ice::arctic::SyntaxNode** tail = &first;
+        auto const append = [&tail](ice::arctic::SyntaxNode* node) noexcept
+        {
+            *tail = node;
+            tail = &node->sibling;
+        };
+
+        // Arguments are bound in order, each initialized with the expression moved out of the call.
+        _substitutions.clear();
+        ice::arctic::SyntaxNode const* parameter = function->child;
+        for (ice::arctic::SyntaxNode* argument = call->child; argument != nullptr; argument = argument->sibling)
+        {
+            if (argument->entity != SyntaxEntity::EXP_CallArg)
+            {
+                continue;
+            }
+
+            while (parameter->entity != SyntaxEntity::DEF_FunctionArgument)
+            {
+                parameter = parameter->sibling;
+            }
+
+            // Single values can't change while the body is evaluated, unless the body writes globals.
+            //   Literals can't be followed by member accesses of the argument, ex.: '1.0.x'.
+            ice::arctic::SyntaxNode const* const value = argument->child;
+            if (value->entity == SyntaxEntity::EXP_Value
+                && value->sibling == nullptr
+                && summary.writes_globals == false
+                && summary.assigned_arguments.contains(parameter) == false
+                && (static_cast<ice::arctic::SyntaxNode_ExpressionValue const*>(value)->value.type == TokenType::CT_Symbol
+                    || summary.accessed_arguments.contains(parameter) == false))
+            {
+                _substitutions.emplace(parameter, value);
+                parameter = parameter->sibling;
+                continue;
+            }
+
+            append(create_variable(
+                _renames[parameter],
+                static_cast<ice::arctic::SyntaxNode_FunctionArgument const*>(parameter)->type,
+                std::exchange(argument->child, nullptr),
+                location
+            ));
+            parameter = parameter->sibling;
+        }
+
+        ice::String const result_name = _renames[function];
+        if (summary.has_result && summary.result_value == nullptr)
+        {
+            append(create_variable(result_name, function->result_type, nullptr, location));
+        }
+
+        for (ice::arctic::SyntaxNode const* node = summary.body->child; node != nullptr; node = node->sibling)
+        {
+            // The last statement assigns the result, its value becomes the initializer of the result local.
+            if (summary.result_value != nullptr && node->sibling == nullptr)
+            {
+                append(create_variable(result_name, function->result_type, clone_list(summary.result_value), location));
+                break;
+            }
+            append(clone(node));
+        }
+
+        if (is_statement)
+        {
+            ice::arctic::SyntaxNode* const removed = *statement;
+            *statement = removed->sibling;
+            release(removed);
+        }
+        else
+        {
+            ice::arctic::SyntaxNode_ExpressionValue* const reference = _alloc.create<SyntaxNode_ExpressionValue>();
+            reference->value = ice::arctic::Token{ .value = result_name, .type = TokenType::CT_Symbol, .location = location };
+
+            // Member accesses are kept on the reference, ex.: 'Shade(light).color', the emptied arguments are released.
+            ice::arctic::SyntaxNode** members = &reference->child;
+            ice::arctic::SyntaxNode* child = std::exchange(call->child, nullptr);
+            while (child != nullptr)
+            {
+                ice::arctic::SyntaxNode* const next = std::exchange(child->sibling, nullptr);
+                if (child->entity == SyntaxEntity::EXP_GetMember)
+                {
+                    *members = child;
+                    members = &child->sibling;
+                }
+                else
+                {
+                    release(child);
+                }
+                child = next;
+            }
+
+            reference->sibling = call->sibling;
+            *call_link = reference;
+            release(call);
+        }
+
+        *tail = *statement;
+        *statement = first;
+    }
+
+    auto FunctionInliner::clone(ice::arctic::SyntaxNode const* node) noexcept -> ice::arctic::SyntaxNode*
+    {
+        ice::arctic::SyntaxNode* const result = ice::arctic::dispatch_syntax_node(node,
+            [this](auto const* typed_node) noexcept -> ice::arctic::SyntaxNode*
+            {
+                using NodeType = std::remove_cvref_t<decltype(*typed_node)>;
+                if constexpr (std::is_same_v<NodeType, ice::arctic::SyntaxNode>)
+                {
+                    // Bodies with nodes without a dedicated type are not supported by 'summarize'.
+                    assert(false);
+                    return nullptr;
+                }
+                else
+                {
+                    return _alloc.create<NodeType>(*typed_node);
+                }
+            }
+        );
+
+        ice::arctic::SyntaxNode const* const origin = origin_of(node);
+        _origins[result] = origin;
+        result->child = clone_list(node->child);
+        result->sibling = nullptr;
+        result->annotation = nullptr;
+
+        if (result->entity == SyntaxEntity::EXP_Value)
+        {
+            auto* const value = static_cast<ice::arctic::SyntaxNode_ExpressionValue*>(result);
+            ice::arctic::Symbol const* const symbol = value->value.type == TokenType::CT_Symbol ? _model.symbol_of(origin) : nullptr;
+            if (auto const it = symbol != nullptr ? _substitutions.find(symbol->definition) : _substitutions.end(); it != _substitutions.end())
+            {
+                ice::arctic::SyntaxNode* const substituted = substitute(it->second, result);
+                release(result);
+                return substituted;
+            }
+
+            if (auto const it = symbol != nullptr ? _renames.find(symbol->definition) : _renames.end(); it != _renames.end())
+            {
+                value->value.value = it->second;
+            }
+        }
+        else if (result->entity == SyntaxEntity::DEF_Variable)
+        {
+            if (auto const it = _renames.find(origin); it != _renames.end())
+            {
+                static_cast<ice::arctic::SyntaxNode_Variable*>(result)->name.value = it->second;
+            }
+        }
+        return result;
+    }
+
+    auto FunctionInliner::clone_list(ice::arctic::SyntaxNode const* first) noexcept -> ice::arctic::SyntaxNode*
+    {
+        ice::arctic::SyntaxNode* result = nullptr;
+        ice::arctic::SyntaxNode** tail = &result;
+        for (ice::arctic::SyntaxNode const* node = first; node != nullptr; node = node->sibling)
+        {
+            *tail = clone(node);
+            tail = &(*tail)->sibling;
+        }
+        return result;
+    }
+
+    auto FunctionInliner::substitute(
+        ice::arctic::SyntaxNode const* argument,
+        ice::arctic::SyntaxNode* node
+    ) noexcept -> ice::arctic::SyntaxNode*
+    {
+        // Arguments belong to the caller, their names are never renamed and their nodes don't need an origin.
+        ice::arctic::SyntaxNode_ExpressionValue* const result = _alloc.create<SyntaxNode_ExpressionValue>();
+        result->value = static_cast<ice::arctic::SyntaxNode_ExpressionValue const*>(argument)->value;
+
+        // Member accesses of the argument come first, ex.: 'light.color' passed as 'color' and read as 'color.x'.
+        ice::arctic::SyntaxNode** tail = &result->child;
+        for (ice::arctic::SyntaxNode const* member = argument->child; member != nullptr; member = member->sibling)
+        {
+            auto* const copy = _alloc.create<SyntaxNode_ExpressionGetMember>(*static_cast<ice::arctic::SyntaxNode_ExpressionGetMember const*>(member));
+            copy->sibling = nullptr;
+            *tail = copy;
+            tail = &copy->sibling;
+        }
+        *tail = std::exchange(node->child, nullptr);
+        return result;
+    }
+
+    auto FunctionInliner::create_variable(
+        ice::String name,
+        ice::arctic::Token const& type,
+        ice::arctic::SyntaxNode* initializer,
+        ice::arctic::TokenLocation location
+    ) noexcept -> ice::arctic::SyntaxNode_Variable*
+    {
+        ice::arctic::SyntaxNode_Variable* const variable = _alloc.create<SyntaxNode_Variable>();
+        variable->name = ice::arctic::Token{ .value = name, .type = TokenType::CT_Symbol, .location = location };
+        variable->type = type;
+        variable->is_const = false;
+
+        // Initializers are stored as an expression starting with the assignment operation.
+        if (initializer != nullptr)
+        {
+            ice::arctic::SyntaxNode_ExpressionBinaryOperation* const assignment = _alloc.create<SyntaxNode_ExpressionBinaryOperation>();
+            assignment->operation = ice::arctic::Token{ .value = u8"=", .type = TokenType::OP_Assign, .location = location };
+            assignment->sibling = initializer;
+
+            ice::arctic::SyntaxNode_Expression* const expression = _alloc.create<SyntaxNode_Expression>();
+            expression->child = assignment;
+            variable->child = expression;
+        }
+        return variable;
+    }
+
+    auto FunctionInliner::summary_of(ice::arctic::SyntaxNode const* call) const noexcept -> FunctionSummary const*
+    {
+        ice::arctic::Symbol const* const symbol = _model.symbol_of(origin_of(call));
+        if (symbol == nullptr || symbol->kind != SymbolKind::Function)
+        {
+            return nullptr;
+        }
+
+        auto const it = _functions.find(symbol->definition);
+        return it != _functions.end() ? &it->second : nullptr;
+    }
+
+    auto FunctionInliner::origin_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::SyntaxNode const*
+    {
+        auto const it = _origins.find(node);
+        return it != _origins.end() ? it->second : node;
+    }
+
+    void FunctionInliner::release(ice::arctic::SyntaxNode* node) noexcept
+    {
+        ice::arctic::SyntaxNode* child = node->child;
+        while (child != nullptr)
+        {
+            ice::arctic::SyntaxNode* const next = child->sibling;
+            release(child);
+            child = next;
+        }
+
+        _origins.erase(node);
+        _alloc.destroy(node);
+    }
+
+} // namespace ice::arctic
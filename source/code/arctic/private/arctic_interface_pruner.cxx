@@ -0,0 +1,279 @@
+#include <ice/arctic_interface_pruner.hxx>
+#include <ice/arctic_syntax_walker.hxx>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        //! \returns The first token of the definition, which is the name of all prunable definitions.
+        inline auto pruned_definition_name(ice::arctic::SyntaxNode const* node) noexcept -> ice::arctic::Token
+        {
+            ice::arctic::Token const* result = nullptr;
+            ice::arctic::for_each_syntax_token(node, [&result](ice::arctic::Token const& token) noexcept
+                {
+                    result = result == nullptr ? &token : result;
+                }
+            );
+            return result != nullptr ? *result : ice::arctic::Token{ };
+        }
+
+        //! \brief Collects everything referenced by the walked nodes.
+        struct ReachabilityMarker
+        {
+            ice::arctic::SemanticModel const& model;
+            std::unordered_set<ice::arctic::SyntaxNode const*> const& globals;
+            std::unordered_set<ice::arctic::SyntaxNode const*>& reachable;
+            std::unordered_set<ice::arctic::TypeHandle>& whole_types;
+            std::vector<ice::arctic::SyntaxNode const*>& pending;
+
+            void enter(ice::arctic::SyntaxNode_ExpressionValue const* node) noexcept
+            {
+                reference(node);
+            }
+
+            void enter(ice::arctic::SyntaxNode_ExpressionCall const* node) noexcept
+            {
+                reference(node);
+            }
+
+            void reference(ice::arctic::SyntaxNode const* node) noexcept
+            {
+                ice::arctic::Symbol const* const symbol = model.symbol_of(node);
+                if (symbol != nullptr && symbol->kind == SymbolKind::Type)
+                {
+                    // Constructors of structs take all members.
+                    whole_types.insert(symbol->type);
+                }
+                else if (symbol != nullptr && globals.contains(symbol->definition))
+                {
+                    pending.push_back(symbol->definition);
+                }
+
+                for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+                {
+                    ice::arctic::TypeMember const* const member = child->entity == SyntaxEntity::EXP_GetMember
+                        ? model.member_of(child)
+                        : nullptr;
+
+                    if (member != nullptr)
+                    {
+                        reachable.insert(member->node);
+                    }
+                }
+
+                // A struct value not followed by a member access is copied or passed as a whole.
+                ice::arctic::TypeHandle const type = model.operand_type_of(node);
+                if (type != nullptr && type->kind == TypeKind::Struct)
+                {
+                    whole_types.insert(type);
+                }
+            }
+        };
+
+    } // namespace detail
+
+    InterfacePruner::InterfacePruner(
+        ice::arctic::SyntaxNodeAllocator& alloc,
+        ice::arctic::SemanticModel const& model,
+        ice::arctic::AnnotationTables const& annotations
+    ) noexcept
+        : _alloc{ alloc }
+        , _model{ model }
+        , _annotations{ annotations }
+    {
+    }
+
+    auto InterfacePruner::prune(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept -> ice::u32
+    {
+        _reachable.clear();
+        _whole_types.clear();
+        _definitions.clear();
+        _pruned.clear();
+
+        mark_reachable(definitions);
+        if (_reachable.empty())
+        {
+            _definitions.assign(definitions.begin(), definitions.end());
+            return 0;
+        }
+
+        std::unordered_set<ice::arctic::SyntaxNode const*> pruned_annotations;
+        for (ice::arctic::SyntaxNode const* definition : definitions)
+        {
+            switch (definition->entity)
+            {
+            case SyntaxEntity::DEF_Function:
+            case SyntaxEntity::DEF_Variable:
+            case SyntaxEntity::DEF_ContextVariable:
+                if (_reachable.contains(definition) == false)
+                {
+                    _pruned.push_back({
+                        .kind = pruned_kind(definition),
+                        .name = ice::arctic::detail::pruned_definition_name(definition),
+                        .owner = { },
+                        .binding = { }
+                    });
+
+                    ice::arctic::AnnotationTable const table = _annotations.find(definition);
+                    for (ice::arctic::AttributeKey const key : { AttributeKey::In, AttributeKey::Out })
+                    {
+                        if (ice::arctic::Attribute const* const attribute = table.find(key); attribute != nullptr)
+                        {
+                            _pruned.back().binding = attribute->text;
+                        }
+                    }
+
+                    pruned_annotations.insert(definition->annotation);
+                    continue;
+                }
+                break;
+            case SyntaxEntity::DEF_Struct:
+                // The tree is owned by the allocator, definitions are only const for visitors.
+                prune_members(static_cast<ice::arctic::SyntaxNode_Struct*>(const_cast<ice::arctic::SyntaxNode*>(definition)));
+                break;
+            default:
+                break;
+            }
+            _definitions.push_back(definition);
+        }
+
+        // Annotations are separate definitions, but they only describe the definition following them.
+        std::erase_if(_definitions, [&pruned_annotations](ice::arctic::SyntaxNode const* definition) noexcept
+            {
+                return definition->entity == SyntaxEntity::DEF_Annotation && pruned_annotations.contains(definition);
+            }
+        );
+        return ice::u32(_pruned.size());
+    }
+
+    bool InterfacePruner::is_reachable(ice::arctic::SyntaxNode const* node) const noexcept
+    {
+        return _reachable.empty() || _reachable.contains(node);
+    }
+
+    void InterfacePruner::mark_reachable(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept
+    {
+        std::unordered_set<ice::arctic::SyntaxNode const*> const globals{ definitions.begin(), definitions.end() };
+
+        std::vector<ice::arctic::SyntaxNode const*> pending;
+        for (ice::arctic::SyntaxNode const* definition : definitions)
+        {
+            ice::arctic::Symbol const* const symbol = _model.symbol_of(definition);
+            if (definition->entity == SyntaxEntity::DEF_Function
+                && symbol != nullptr
+                && symbol->type != nullptr
+                && symbol->type->kind == TypeKind::Stage)
+            {
+                pending.push_back(definition);
+            }
+        }
+
+        ice::arctic::detail::ReachabilityMarker marker{
+            .model = _model,
+            .globals = globals,
+            .reachable = _reachable,
+            .whole_types = _whole_types,
+            .pending = pending
+        };
+
+        // Functions and initializers of globals are walked once, when they are reached for the first time.
+        while (pending.empty() == false)
+        {
+            ice::arctic::SyntaxNode const* const definition = pending.back();
+            pending.pop_back();
+
+            if (_reachable.insert(definition).second && definition->entity != SyntaxEntity::DEF_ContextVariable)
+            {
+                // Marking is idempotent, so nodes marked before the walk stopped are only marked again.
+                if (ice::arctic::walk(definition, marker) == WalkResult::DepthExceeded)
+                {
+                    ice::arctic::walk_unbounded(definition, marker);
+                }
+            }
+        }
+
+        std::vector<ice::arctic::TypeHandle> const whole_types{ _whole_types.begin(), _whole_types.end() };
+        for (ice::arctic::TypeHandle const type : whole_types)
+        {
+            mark_whole(type);
+        }
+    }
+
+    void InterfacePruner::mark_whole(ice::arctic::TypeHandle type) noexcept
+    {
+        for (ice::arctic::TypeMember const& member : type->members)
+        {
+            _reachable.insert(member.node);
+            if (member.type != nullptr && member.type->kind == TypeKind::Struct && _whole_types.insert(member.type).second)
+            {
+                mark_whole(member.type);
+            }
+        }
+    }
+
+    auto InterfacePruner::pruned_kind(ice::arctic::SyntaxNode const* definition) const noexcept -> ice::arctic::PrunedKind
+    {
+        switch (definition->entity)
+        {
+        case SyntaxEntity::DEF_ContextVariable:
+        {
+            ice::arctic::AnnotationTable const table = _annotations.find(definition);
+            if (table.find(AttributeKey::In) != nullptr)
+            {
+                return PrunedKind::Input;
+            }
+            if (table.find(AttributeKey::Out) != nullptr)
+            {
+                return PrunedKind::Output;
+            }
+            return table.find(AttributeKey::Constant) != nullptr ? PrunedKind::Constant : PrunedKind::ContextVariable;
+        }
+        case SyntaxEntity::DEF_Variable:
+            return static_cast<SyntaxNode_Variable const*>(definition)->is_const ? PrunedKind::Constant : PrunedKind::Variable;
+        default:
+            return PrunedKind::Function;
+        }
+    }
+
+    auto InterfacePruner::prune_members(ice::arctic::SyntaxNode_Struct* node) noexcept -> ice::u32
+    {
+        // Structs without any reachable member are not used by entry functions at all, their layout is kept.
+        bool has_reachable_member = false;
+        for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+        {
+            has_reachable_member |= _reachable.contains(child);
+        }
+
+        if (has_reachable_member == false)
+        {
+            return 0;
+        }
+
+        ice::u32 result = 0;
+        ice::arctic::SyntaxNode** link = &node->child;
+        while (*link != nullptr)
+        {
+            ice::arctic::SyntaxNode* const child = *link;
+            if (child->entity != SyntaxEntity::DEF_StructMember || _reachable.contains(child))
+            {
+                link = &child->sibling;
+                continue;
+            }
+
+            _pruned.push_back({
+                .kind = PrunedKind::Member,
+                .name = static_cast<SyntaxNode_StructMember const*>(child)->name,
+                .owner = node->name.value,
+                .binding = { }
+            });
+
+            *link = child->sibling;
+            _alloc.destroy(child);
+            result += 1;
+        }
+        return result;
+    }
+
+} // namespace ice::arctic
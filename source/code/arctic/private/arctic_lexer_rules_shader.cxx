@@ -79,6 +79,11 @@ namespace ice::arctic
                 out_result.type = TokenType::KW_TypeOf;
                 out_result.value = word.value;
             }
+            else if (word.value == u8"import")
+            {
+                out_result.type = TokenType::KW_Import;
+                out_result.value = word.value;
+            }
             break;
         case 7:
             if (word.value == u8"context")
@@ -0,0 +1,221 @@
+#include <ice/arctic_memory_stats.hxx>
+#include <ice/arctic_syntax_node.hxx>
+
+#include <fmt/format.h>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        auto memory_counters_json(ice::arctic::MemoryCounters const& counters) noexcept -> std::string
+        {
+            return fmt::format(
+                "{{ \"allocations\": {}, \"deallocations\": {}, \"allocated_bytes\": {}, \"live_bytes\": {}, \"peak_bytes\": {} }}",
+                counters.allocations,
+                counters.deallocations,
+                counters.allocated_bytes,
+                counters.live_bytes,
+                counters.peak_bytes
+            );
+        }
+
+    } // namespace detail
+
+    auto to_string(ice::arctic::MemoryPhase phase) noexcept -> char const*
+    {
+        switch (phase)
+        {
+        case MemoryPhase::Other: return "other";
+        case MemoryPhase::WordProcessing: return "word_processing";
+        case MemoryPhase::Lexing: return "lexing";
+        case MemoryPhase::Parsing: return "parsing";
+        case MemoryPhase::Visiting: return "visiting";
+        }
+        return "?";
+    }
+
+    void MemoryStats::merge(ice::arctic::MemoryStats const& other) noexcept
+    {
+        total.merge(other.total);
+        for (ice::u32 idx = 0; idx < Constant_MemoryPhaseCount; ++idx)
+        {
+            phases[idx].merge(other.phases[idx]);
+        }
+        for (ice::u32 idx = 0; idx < Constant_SyntaxEntityCount; ++idx)
+        {
+            entities[idx].merge(other.entities[idx]);
+        }
+
+        if (visitors.size() < other.visitors.size())
+        {
+            visitors.resize(other.visitors.size());
+        }
+        for (ice::u32 idx = 0; idx < other.visitors.size(); ++idx)
+        {
+            visitors[idx].merge(other.visitors[idx]);
+        }
+    }
+
+    auto memory_stats_json(ice::arctic::MemoryStats const& stats) noexcept -> std::string
+    {
+        using ice::arctic::detail::memory_counters_json;
+
+        std::string result = fmt::format(
+            "{{\n  \"enabled\": {},\n  \"total\": {},\n  \"phases\": {{",
+            ICE_ARCTIC_MEMORY_TRACKING != 0,
+            memory_counters_json(stats.total)
+        );
+
+        for (ice::u32 idx = 0; idx < Constant_MemoryPhaseCount; ++idx)
+        {
+            result += fmt::format(
+                "{}\n    \"{}\": {}",
+                idx == 0 ? "" : ",",
+                ice::arctic::to_string(MemoryPhase(idx)),
+                memory_counters_json(stats.phases[idx])
+            );
+        }
+
+        result += "\n  },\n  \"entities\": {";
+        bool first_entity = true;
+        for (ice::u32 idx = 0; idx < Constant_SyntaxEntityCount; ++idx)
+        {
+            if (stats.entities[idx].allocations == 0)
+            {
+                continue;
+            }
+
+            result += fmt::format(
+                "{}\n    \"{}\": {}",
+                first_entity ? "" : ",",
+                ice::arctic::to_string(SyntaxEntity(idx)),
+                memory_counters_json(stats.entities[idx])
+            );
+            first_entity = false;
+        }
+
+        result += "\n  },\n  \"visitors\": [";
+        for (ice::u32 idx = 0; idx < stats.visitors.size(); ++idx)
+        {
+            result += fmt::format("{}\n    {}", idx == 0 ? "" : ",", memory_counters_json(stats.visitors[idx]));
+        }
+        return result + "\n  ]\n}\n";
+    }
+
+#if ICE_ARCTIC_MEMORY_TRACKING
+
+    MemoryScope::MemoryScope(ice::arctic::MemoryStats& scope_stats, ice::arctic::MemoryPhase scope_phase) noexcept
+        : stats{ &scope_stats }
+        , visitor{ nullptr }
+        , phase{ scope_phase }
+        , parent{ detail::memory_scope }
+    {
+        detail::memory_scope = this;
+    }
+
+    MemoryScope::MemoryScope(ice::arctic::MemoryStats& scope_stats, ice::u32 visitor_index) noexcept
+        : stats{ &scope_stats }
+        , visitor{ &scope_stats.visitors[visitor_index] }
+        , phase{ MemoryPhase::Visiting }
+        , parent{ detail::memory_scope }
+    {
+        detail::memory_scope = this;
+    }
+
+    MemoryScope::MemoryScope(ice::arctic::MemoryPhase scope_phase) noexcept
+        : stats{ detail::memory_scope != nullptr ? detail::memory_scope->stats : nullptr }
+        , visitor{ detail::memory_scope != nullptr ? detail::memory_scope->visitor : nullptr }
+        , phase{ scope_phase }
+        , parent{ detail::memory_scope }
+    {
+        detail::memory_scope = this;
+    }
+
+    MemoryScope::~MemoryScope() noexcept
+    {
+        detail::memory_scope = parent;
+    }
+
+    void track_allocation(ice::u64 size) noexcept
+    {
+        ice::arctic::MemoryScope* const scope = detail::memory_scope;
+        if (scope != nullptr && scope->stats != nullptr)
+        {
+            scope->stats->total.add_allocation(size);
+            scope->stats->phases[static_cast<ice::u32>(scope->phase)].add_allocation(size);
+            if (scope->visitor != nullptr)
+            {
+                scope->visitor->add_allocation(size);
+            }
+        }
+    }
+
+    void track_deallocation(ice::u64 size) noexcept
+    {
+        ice::arctic::MemoryScope* const scope = detail::memory_scope;
+        if (scope != nullptr && scope->stats != nullptr)
+        {
+            scope->stats->total.add_deallocation(size);
+            scope->stats->phases[static_cast<ice::u32>(scope->phase)].add_deallocation(size);
+            if (scope->visitor != nullptr)
+            {
+                scope->visitor->add_deallocation(size);
+            }
+        }
+    }
+
+    void detail::track_phase_allocation(ice::arctic::MemoryPhase phase, ice::u64 size) noexcept
+    {
+        ice::arctic::MemoryScope* const scope = detail::memory_scope;
+        if (scope != nullptr && scope->stats != nullptr)
+        {
+            scope->stats->total.add_allocation(size);
+            scope->stats->phases[static_cast<ice::u32>(phase)].add_allocation(size);
+        }
+    }
+
+    void detail::track_phase_deallocation(ice::arctic::MemoryPhase phase, ice::u64 size) noexcept
+    {
+        ice::arctic::MemoryScope* const scope = detail::memory_scope;
+        if (scope != nullptr && scope->stats != nullptr)
+        {
+            scope->stats->total.add_deallocation(size);
+            scope->stats->phases[static_cast<ice::u32>(phase)].add_deallocation(size);
+        }
+    }
+
+    void detail::track_node_allocation(ice::arctic::SyntaxEntity entity, ice::u64 size) noexcept
+    {
+        ice::arctic::MemoryScope* const scope = detail::memory_scope;
+        if (scope != nullptr && scope->stats != nullptr)
+        {
+            scope->stats->entities[static_cast<ice::u32>(entity)].add_allocation(size);
+            ice::arctic::track_allocation(size);
+        }
+    }
+
+    void detail::track_node_deallocation(ice::arctic::SyntaxEntity entity, ice::u64 size) noexcept
+    {
+        ice::arctic::MemoryScope* const scope = detail::memory_scope;
+        if (scope != nullptr && scope->stats != nullptr)
+        {
+            scope->stats->entities[static_cast<ice::u32>(entity)].add_deallocation(size);
+            ice::arctic::track_deallocation(size);
+        }
+    }
+
+    void detail::track_node_deallocation(ice::arctic::SyntaxNode const* node) noexcept
+    {
+        ice::u64 const size = ice::arctic::dispatch_syntax_node(node, [](auto const* typed_node) noexcept -> ice::u64
+            {
+                return sizeof(*typed_node);
+            }
+        );
+        detail::track_node_deallocation(node->entity, size);
+    }
+
+#endif // #if ICE_ARCTIC_MEMORY_TRACKING
+
+} // namespace ice::arctic
@@ -0,0 +1,182 @@
+#include <ice/arctic_module.hxx>
+#include <ice/arctic_word_processor.hxx>
+#include <ice/arctic_lexer.hxx>
+
+#include <cstdio>
+#include <unordered_set>
+
+namespace ice::arctic
+{
+
+    ModuleCache::ModuleCache(
+        std::filesystem::path directory,
+        ice::arctic::ParserOptions options
+    ) noexcept
+        : _directory{ std::move(directory) }
+        , _options{ options }
+        , _matcher{ }
+    {
+        _options.modules = this;
+        ice::arctic::initialize_ascii_matcher(&_matcher);
+    }
+
+    ModuleCache::~ModuleCache() noexcept
+    {
+        _modules.clear();
+        ice::arctic::shutdown_matcher(&_matcher);
+    }
+
+    auto ModuleCache::load(
+        ice::String path,
+        ice::String directory
+    ) noexcept -> ice::arctic::ParseResult<ice::arctic::Module const*>
+    {
+        std::filesystem::path const base = directory.empty() ? _directory : std::filesystem::path{ directory };
+        std::string const key = (base / std::filesystem::path{ path }).lexically_normal().generic_string();
+
+        auto const module_result = [](ice::arctic::Module const* module) noexcept -> ice::arctic::ParseResult<ice::arctic::Module const*>
+        {
+            // A cycle is reported by each module on the way back to the first import of the cycle.
+            if (module->_state == ParseState::Error_Import_NotFound || module->_state == ParseState::Error_Import_Cycle)
+            {
+                return module->_state;
+            }
+            if (ice::arctic::is_error(module->_state))
+            {
+                return ParseState::Error_Import_ModuleFailed;
+            }
+            return module;
+        };
+
+        // Fast path, the module was already loaded.
+        ice::arctic::Module* module = find(key);
+        if (module != nullptr && module->_loaded.load(std::memory_order_acquire))
+        {
+            return module_result(module);
+        }
+
+        bool is_new = false;
+        {
+            std::unique_lock const lock{ _mutex };
+            std::unique_ptr<ice::arctic::Module>& entry = _modules[key];
+            if (entry == nullptr)
+            {
+                entry.reset(new ice::arctic::Module{ key, _options });
+                is_new = true;
+            }
+            module = entry.get();
+        }
+
+        if (is_new == false)
+        {
+            return wait_until_loaded(*module) ? module_result(module) : ParseState::Error_Import_Cycle;
+        }
+
+        load_module(*module);
+        {
+            std::scoped_lock const lock{ _wait_mutex };
+            module->_loaded.store(true, std::memory_order_release);
+        }
+        _loaded_condition.notify_all();
+        return module_result(module);
+    }
+
+    auto ModuleCache::module_count() const noexcept -> ice::u32
+    {
+        std::shared_lock const lock{ _mutex };
+        return ice::u32(_modules.size());
+    }
+
+    auto ModuleCache::global() noexcept -> ice::arctic::ModuleCache&
+    {
+        static ice::arctic::ModuleCache global_cache{ };
+        return global_cache;
+    }
+
+    auto ModuleCache::find(std::string const& key) const noexcept -> ice::arctic::Module*
+    {
+        std::shared_lock const lock{ _mutex };
+        auto const it = _modules.find(key);
+        return it != _modules.end() ? it->second.get() : nullptr;
+    }
+
+    bool ModuleCache::wait_until_loaded(ice::arctic::Module const& module) noexcept
+    {
+        std::thread::id const current_thread = std::this_thread::get_id();
+
+        std::unique_lock lock{ _wait_mutex };
+        while (module._loaded.load(std::memory_order_acquire) == false)
+        {
+            // Follow the modules the loading threads wait for, reaching this thread means none of them would finish.
+            ice::arctic::Module const* blocking = &module;
+            while (blocking != nullptr && blocking->_loaded.load(std::memory_order_acquire) == false)
+            {
+                if (blocking->_loading_thread == current_thread)
+                {
+                    return false;
+                }
+
+                auto const it = _waiting.find(blocking->_loading_thread);
+                blocking = it != _waiting.end() ? it->second : nullptr;
+            }
+
+            _waiting[current_thread] = &module;
+            _loaded_condition.wait(lock);
+            _waiting.erase(current_thread);
+        }
+        return true;
+    }
+
+    void ModuleCache::load_module(ice::arctic::Module& module) noexcept
+    {
+        std::FILE* const file = std::fopen(module._path.string().c_str(), "rb");
+        if (file == nullptr)
+        {
+            module._state = ParseState::Error_Import_NotFound;
+            return;
+        }
+
+        std::error_code error;
+        ice::u64 const file_size = std::filesystem::file_size(module._path, error);
+        if (error == std::error_code{ })
+        {
+            // The word processor expects a null-terminated source, which the string provides.
+            module._source.resize(file_size);
+            module._source.resize(std::fread(module._source.data(), 1, file_size, file));
+        }
+        std::fclose(file);
+
+        if (error || module._source.size() != file_size)
+        {
+            module._state = ParseState::Error_Import_NotFound;
+            return;
+        }
+
+        ice::arctic::Lexer lexer = ice::arctic::create_lexer(
+            ice::arctic::create_word_processor(module._source, &_matcher)
+        );
+        module._state = module._parser.parse(lexer);
+
+        // A missing nested import fails this module, the file itself was found.
+        if (module._state == ParseState::Error_Import_NotFound)
+        {
+            module._state = ParseState::Error_Import_ModuleFailed;
+        }
+
+        ice::arctic::Parser const& parser = module._parser;
+        std::unordered_set<ice::arctic::SyntaxNode const*> imported_nodes;
+        for (ice::arctic::Module const* imported : parser.imports())
+        {
+            imported_nodes.insert(imported->definitions().begin(), imported->definitions().end());
+        }
+
+        for (ice::arctic::SyntaxNode const* node : parser.definitions())
+        {
+            if (imported_nodes.contains(node) == false)
+            {
+                module._definitions.push_back(node);
+            }
+        }
+    }
+
+} // namespace ice::arctic
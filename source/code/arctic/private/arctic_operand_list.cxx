@@ -0,0 +1,260 @@
+#include <ice/arctic_operand_list.hxx>
+
+#include <algorithm>
+
+namespace ice::arctic
+{
+
+    auto operation_precedence(ice::arctic::TokenType operation) noexcept -> ice::u32
+    {
+        switch (operation)
+        {
+        case TokenType::OP_Assign: return 1;
+        case TokenType::OP_Or: return 2;
+        case TokenType::OP_And: return 3;
+        case TokenType::OP_Plus:
+        case TokenType::OP_Minus: return 4;
+        case TokenType::OP_Mul:
+        case TokenType::OP_Div: return 5;
+        default: return 0;
+        }
+    }
+
+    auto operand_location(ice::arctic::SyntaxNode const* node) noexcept -> ice::arctic::TokenLocation
+    {
+        for (; node != nullptr; node = node->child)
+        {
+            ice::arctic::Token const* first_token = nullptr;
+            ice::arctic::for_each_syntax_token(node, [&first_token](ice::arctic::Token const& token) noexcept
+                {
+                    if (first_token == nullptr)
+                    {
+                        first_token = &token;
+                    }
+                }
+            );
+
+            if (first_token != nullptr)
+            {
+                return first_token->location;
+            }
+        }
+        return { };
+    }
+
+    bool OperandList::build(ice::arctic::SyntaxNode* parent) noexcept
+    {
+        _parent = parent;
+        _items.clear();
+        _terms.clear();
+        flatten(parent->child);
+
+        // Leading operations, like the assignment of initializers, are not part of any term.
+        ice::u32 position = 0;
+        while (position < _items.size() && _items[position].kind == OperandItemKind::Operation)
+        {
+            position += 1;
+        }
+
+        if (position == _items.size() || build_term(position, 1) == Constant_None || position != _items.size())
+        {
+            _terms.clear();
+            return false;
+        }
+        return true;
+    }
+
+    auto OperandList::link_term(ice::u32 term) noexcept -> ice::arctic::SyntaxNode*
+    {
+        ice::arctic::OperandTerm const& linked = _terms[term];
+
+        ice::arctic::SyntaxNode* first = nullptr;
+        ice::arctic::SyntaxNode** link = &first;
+
+        ice::u32 replacement_idx = 0;
+        for (ice::u32 idx = linked.first; idx <= linked.last;)
+        {
+            ice::arctic::SyntaxNode* node = _items[idx].node;
+            if (_items[idx].kind == OperandItemKind::Operation)
+            {
+                idx += 1;
+            }
+            else
+            {
+                node = link_operand(idx, { }, replacement_idx, idx);
+            }
+
+            *link = node;
+            link = &node->sibling;
+        }
+        *link = nullptr;
+        return first;
+    }
+
+    void OperandList::replace(
+        ice::Span<ice::arctic::OperandReplacement const> replacements,
+        std::vector<ice::arctic::OperandItem>& out_removed
+    ) noexcept
+    {
+        if (replacements.empty())
+        {
+            return;
+        }
+
+        std::vector<ice::arctic::OperandReplacement> sorted{ replacements.begin(), replacements.end() };
+        std::sort(sorted.begin(), sorted.end(),
+            [this](ice::arctic::OperandReplacement const& left, ice::arctic::OperandReplacement const& right) noexcept
+            {
+                return _terms[left.term].first < _terms[right.term].first;
+            }
+        );
+
+        for (ice::arctic::OperandReplacement const& replacement : sorted)
+        {
+            ice::arctic::OperandTerm const& term = _terms[replacement.term];
+            out_removed.insert(out_removed.end(), _items.begin() + term.first, _items.begin() + term.last + 1);
+        }
+
+        ice::u32 replacement_idx = 0;
+        ice::arctic::SyntaxNode** link = &_parent->child;
+        for (ice::u32 idx = 0; idx < _items.size();)
+        {
+            ice::arctic::SyntaxNode* node = _items[idx].node;
+            if (_items[idx].kind == OperandItemKind::Operation)
+            {
+                idx += 1;
+            }
+            else
+            {
+                node = link_operand(idx, sorted, replacement_idx, idx);
+            }
+
+            *link = node;
+            link = &node->sibling;
+        }
+        *link = nullptr;
+    }
+
+    void OperandList::flatten(ice::arctic::SyntaxNode* first) noexcept
+    {
+        for (ice::arctic::SyntaxNode* node = first; node != nullptr; node = node->sibling)
+        {
+            if (node->entity == SyntaxEntity::EXP_UnaryOperation)
+            {
+                // The parser stores everything following a unary minus as its children, these are part of the same list.
+                _items.push_back({ .node = node, .kind = OperandItemKind::Negate });
+                flatten(node->child);
+            }
+            else if (node->entity == SyntaxEntity::EXP_BinaryOperation)
+            {
+                _items.push_back({ .node = node, .kind = OperandItemKind::Operation });
+            }
+            else
+            {
+                _items.push_back({ .node = node, .kind = OperandItemKind::Operand });
+            }
+        }
+    }
+
+    auto OperandList::build_term(ice::u32& position, ice::u32 min_precedence) noexcept -> ice::u32
+    {
+        ice::u32 left = build_operand(position);
+        while (left != Constant_None && position < _items.size() && _items[position].kind == OperandItemKind::Operation)
+        {
+            ice::arctic::TokenType const operation = static_cast<SyntaxNode_ExpressionBinaryOperation const*>(
+                _items[position].node
+            )->operation.type;
+
+            ice::u32 const precedence = operation_precedence(operation);
+            if (precedence == 0 || precedence < min_precedence)
+            {
+                break;
+            }
+
+            ice::u32 const operation_item = position++;
+            ice::u32 const right = build_term(position, operation == TokenType::OP_Assign ? precedence : precedence + 1);
+            if (right == Constant_None)
+            {
+                return Constant_None;
+            }
+
+            _terms.push_back({
+                .kind = OperandTermKind::Binary,
+                .item = operation_item,
+                .first = _terms[left].first,
+                .last = _terms[right].last,
+                .left = left,
+                .right = right
+            });
+            left = ice::u32(_terms.size()) - 1;
+        }
+        return left;
+    }
+
+    auto OperandList::build_operand(ice::u32& position) noexcept -> ice::u32
+    {
+        if (position >= _items.size() || _items[position].kind == OperandItemKind::Operation)
+        {
+            return Constant_None;
+        }
+
+        ice::u32 const item = position++;
+        if (_items[item].kind == OperandItemKind::Operand)
+        {
+            _terms.push_back({
+                .kind = OperandTermKind::Operand,
+                .item = item,
+                .first = item,
+                .last = item,
+                .left = Constant_None,
+                .right = Constant_None
+            });
+            return ice::u32(_terms.size()) - 1;
+        }
+
+        // The unary minus binds stronger than any binary operation.
+        ice::u32 const operand = build_operand(position);
+        if (operand == Constant_None)
+        {
+            return Constant_None;
+        }
+
+        _terms.push_back({
+            .kind = OperandTermKind::Negate,
+            .item = item,
+            .first = item,
+            .last = _terms[operand].last,
+            .left = operand,
+            .right = Constant_None
+        });
+        return ice::u32(_terms.size()) - 1;
+    }
+
+    auto OperandList::link_operand(
+        ice::u32 idx,
+        ice::Span<ice::arctic::OperandReplacement const> replacements,
+        ice::u32& replacement_idx,
+        ice::u32& out_next
+    ) noexcept -> ice::arctic::SyntaxNode*
+    {
+        if (replacement_idx < replacements.size() && _terms[replacements[replacement_idx].term].first == idx)
+        {
+            ice::arctic::OperandReplacement const& replacement = replacements[replacement_idx++];
+            out_next = _terms[replacement.term].last + 1;
+            return replacement.node;
+        }
+
+        ice::arctic::SyntaxNode* const node = _items[idx].node;
+        if (_items[idx].kind == OperandItemKind::Negate)
+        {
+            node->child = link_operand(idx + 1, replacements, replacement_idx, out_next);
+            node->child->sibling = nullptr;
+        }
+        else
+        {
+            out_next = idx + 1;
+        }
+        return node;
+    }
+
+} // namespace ice::arctic
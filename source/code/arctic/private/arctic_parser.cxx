@@ -1,20 +1,44 @@
 #include <ice/arctic_parser.hxx>
+#include <ice/arctic_module.hxx>
 #include <ice/arctic_parser_logic.hxx>
 #include <ice/arctic_parser_utils.hxx>
+#include <ice/arctic_trace.hxx>
+#include <algorithm>
 
 namespace ice::arctic
 {
 
-    auto parse_block(
-        ice::arctic::SyntaxNodeAllocator& alloc,
+    namespace detail
+    {
+
+        constexpr bool is_recovery_token(ice::arctic::TokenType type, bool inside_block) noexcept
+        {
+            switch (type)
+            {
+            case TokenType::KW_Def:
+            case TokenType::KW_Ctx:
+            case TokenType::KW_Const:
+                return inside_block == false;
+            case TokenType::KW_Fn:
+            case TokenType::KW_Let:
+            case TokenType::CT_SquareBracketOpen:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+    } // namespace detail
+
+    auto Parser::parse_block(
         ice::arctic::Token& token,
-        ice::arctic::Lexer& lexer,
-        ice::Span<ice::arctic::SyntaxVisitorBase*> visitors
+        ice::arctic::Lexer& lexer
     ) noexcept -> ice::arctic::ParseState
     {
         token = (lexer.next(), lexer.next());
         if (token.type != TokenType::CT_BracketOpen)
         {
+            ice::arctic::expect_token(token, TokenType::CT_BracketOpen);
             return ParseState::Error_TypeOf_MissingBracketOpen;
         }
 
@@ -23,16 +47,38 @@ namespace ice::arctic
         token = lexer.next();
         while(token.type != TokenType::CT_BracketClose)
         {
+            if (token.type == TokenType::ST_EndOfFile)
+            {
+                ice::arctic::expect_token(token, TokenType::CT_BracketClose);
+                return ParseState::Error_TypeOf_MissingBracketClose;
+            }
+
             ice::arctic::ParseResult<ice::arctic::SyntaxNode*> result = ParseState::Success;
+            ice::arctic::TokenLocation const definition_location = token.location;
+            ice::arctic::TraceScope definition_trace{ token.type != TokenType::ST_EndOfLine ? "parse.definition" : nullptr };
 
             if (token.type != TokenType::ST_EndOfLine)
             {
-                result = parse_context_block(alloc, token, lexer);
+                result = parse_context_block(*this, token, lexer);
+            }
+
+            if (check_limits() != ParseState::Success)
+            {
+                return _limit_state;
             }
 
             if (result.has_error())
             {
-                return result._state;
+                // Without recovery the error is reported for the whole block.
+                if (_options.recover_from_errors == false)
+                {
+                    return result._state;
+                }
+
+                report_error(result._state, lexer, definition_location);
+                recover(token, lexer, definition_location, true);
+                annotation = nullptr;
+                continue;
             }
 
             if (result._value != nullptr)
@@ -50,10 +96,8 @@ namespace ice::arctic
 
             if (result._value != nullptr)
             {
-                for (ice::arctic::SyntaxVisitorBase* visitor : visitors)
-                {
-                    visitor->visit(result);
-                }
+                definition_trace.set_detail(ice::arctic::detail::definition_name(result._value));
+                on_definition(result);
             }
 
             token = lexer.next();
@@ -67,25 +111,96 @@ namespace ice::arctic
         return ParseState::Success;
     }
 
-    void Parser::parse(ice::arctic::Lexer& lexer) noexcept
+    auto Parser::parse(ice::arctic::Lexer& lexer) noexcept -> ice::arctic::ParseState
     {
-        ice::arctic::Token token = lexer.next();
+        ice::arctic::MemoryScope const memory_scope{ _memory_stats, MemoryPhase::Parsing };
+        ice::arctic::TraceScope const trace_scope{ "parse" };
+        if (_options.pipelined)
+        {
+            return parse_pipelined(lexer);
+        }
 
         ice::arctic::SyntaxNode root{ .entity = SyntaxEntity::ROOT };
-        ice::arctic::ParseResult result = &root;
-        for (ice::arctic::SyntaxVisitorBase* visitor : _visitors)
+        for (ice::u32 idx = 0; idx < _visitors.size(); ++idx)
+        {
+            if (_visitors[idx]->accepts(SyntaxEntity::ROOT))
+            {
+                ice::arctic::MemoryScope const visitor_scope{ _memory_stats, idx };
+                ice::arctic::TraceScope const visitor_trace{ "visit", to_string(SyntaxEntity::ROOT), idx };
+                _visitors[idx]->visit(&root);
+            }
+        }
+
+        return parse_tokens(lexer);
+    }
+
+    auto Parser::parse_tokens(ice::arctic::Lexer& lexer) noexcept -> ice::arctic::ParseState
+    {
+        ice::arctic::TokenExpectations expectations{ };
+        ice::arctic::detail::TokenExpectationsScope const expectations_scope{ expectations };
+
+        ice::arctic::detail::NestingBudgetScope const nesting_scope{ _options.limits.max_expression_depth };
+
+        _diagnostics.clear();
+        reset_limits();
+
+        ice::arctic::ParseResult<ice::arctic::SyntaxNode*> result = ParseState::Success;
+        if (_options.limits.enabled())
         {
-            visitor->visit(result);
+            ice::arctic::Lexer limited_lexer = limit_lexer(lexer);
+            ice::arctic::Token token = limited_lexer.next();
+            result = parse_units(token, limited_lexer, nullptr);
         }
+        else
+        {
+            ice::arctic::Token token = lexer.next();
+            result = parse_units(token, lexer, nullptr);
+        }
+        return result._state;
+    }
+
+    auto Parser::parse_units(
+        ice::arctic::Token& token,
+        ice::arctic::Lexer& lexer,
+        ice::utf8 const* units_end
+    ) noexcept -> ice::arctic::ParseResult<ice::arctic::SyntaxNode*>
+    {
+        ice::arctic::ParseResult<ice::arctic::SyntaxNode*> result = ParseState::Success;
+        ice::u64 const first_diagnostic = _diagnostics.size();
 
         ice::arctic::SyntaxNode* annotation = nullptr;
-        while (result.has_error() == false && token.type != ice::arctic::TokenType::ST_EndOfFile)
+        ice::arctic::TokenLocation definition_location{ };
+        while (result.has_error() == false
+            && token.type != ice::arctic::TokenType::ST_EndOfFile
+            && (units_end == nullptr || token.value.data() < units_end))
         {
+            if (token.type != TokenType::ST_EndOfLine)
+            {
+                definition_location = token.location;
+            }
+
+            // Annotations are part of the unit of the definition they are attached to.
+            if (annotation == nullptr && token.type != TokenType::ST_EndOfLine)
+            {
+                _units.push_back(
+                    SyntaxUnit{
+                        .begin = token.value.data(),
+                        .location = token.location,
+                        .first_definition = ice::u32(_definitions.size()),
+                        .definition_count = 0
+                    }
+                );
+            }
+
+            // Empty lines are skipped without tracing them as definitions.
+            ice::arctic::TraceScope definition_trace{ token.type != TokenType::ST_EndOfLine ? "parse.definition" : nullptr };
+
             switch (token.type)
             {
             case TokenType::KW_Fn:
             case TokenType::KW_Def:
             case TokenType::KW_Let:
+            case TokenType::KW_Const:
                 result = parse_definition(*this, token, lexer);
                 if (result.has_error() == false)
                 {
@@ -95,12 +210,12 @@ namespace ice::arctic
                 break;
             case TokenType::KW_Ctx:
             {
-                if (ice::arctic::ParseState state = parse_block(*this, token, lexer, _visitors); state != ParseState::Success)
-                {
-                    result = state;
-                }
+                result = parse_block(token, lexer);
                 break;
             }
+            case TokenType::KW_Import:
+                result = parse_import(token, lexer);
+                break;
             case TokenType::CT_SquareBracketOpen:
                 result = parse_definition(*this, token, lexer);
                 if (result.has_error() == false)
@@ -112,29 +227,276 @@ namespace ice::arctic
                 token = lexer.next();
                 continue;
             default:
+                // Stray tokens are skipped, the result can't keep the previous definition or it's passed on a second time.
                 //result = parse_expression(*this, token, lexer);
+                result = ParseState::Success;
                 break;
             }
 
-            if (result.has_error() == false && result._value != nullptr)
+            // Nothing parsed after a limit was hit is passed to visitors.
+            if (check_limits() != ParseState::Success)
             {
-                for (ice::arctic::SyntaxVisitorBase* visitor : _visitors)
+                result = _limit_state;
+            }
+
+            if (result.has_error())
+            {
+                report_error(result._state, lexer, definition_location);
+                if (_options.recover_from_errors && _limit_state == ParseState::Success)
                 {
-                    visitor->visit(result);
+                    recover(token, lexer, definition_location, false);
+                    annotation = nullptr;
+                    result = ParseState::Success;
                 }
+                continue;
+            }
+
+            if (result._value != nullptr)
+            {
+                definition_trace.set_detail(ice::arctic::detail::definition_name(result._value));
+                on_definition(result);
             }
 
             token = lexer.next();
         }
 
-        if (result.has_error())
+        // When recovering we still report the first error.
+        if (result.has_error() == false && _diagnostics.size() > first_diagnostic)
         {
-            printf("Error while parsing: %s\n", result.error_string().data());
+            result = _diagnostics[first_diagnostic].state;
+        }
+        return result;
+    }
+
+    void Parser::report_error(
+        ice::arctic::ParseState state,
+        ice::arctic::Lexer const& lexer,
+        ice::arctic::TokenLocation definition_location
+    ) noexcept
+    {
+        // Without expectations the error is reported at the furthest token the failed definition consumed.
+        ice::arctic::ParseDiagnostic diagnostic{
+            .state = state,
+            .token = lexer.current(),
+            .expected = { },
+            .expected_count = 0
+        };
+
+        // Only use expectations recorded while parsing the failed definition.
+        ice::arctic::TokenExpectations* const expectations = ice::arctic::detail::token_expectations;
+        if (expectations != nullptr && expectations->count > 0)
+        {
+            if (TokenExpectations::is_before(expectations->token.location, definition_location) == false)
+            {
+                diagnostic.token = expectations->token;
+                diagnostic.expected_count = expectations->count;
+                std::copy_n(expectations->types, expectations->count, diagnostic.expected);
+            }
+            expectations->count = 0;
         }
+
+        _diagnostics.push_back(diagnostic);
+    }
+
+    void Parser::recover(
+        ice::arctic::Token& token,
+        ice::arctic::Lexer& lexer,
+        ice::arctic::TokenLocation definition_location,
+        bool inside_block
+    ) noexcept
+    {
+        // Resume from the furthest token the failed definition consumed, if it's the start of the definition we need to move forward.
+        token = lexer.current();
+        if (TokenExpectations::is_before(definition_location, token.location) == false)
+        {
+            token = lexer.next();
+        }
+
+        // Skip nested blocks entirely, definitions are only expected at or before the column of the failed one.
+        ice::u32 depth = 0;
+        while (token.type != TokenType::ST_EndOfFile)
+        {
+            if (depth == 0
+                && token.location.column <= definition_location.column
+                && ice::arctic::detail::is_recovery_token(token.type, inside_block))
+            {
+                break;
+            }
+
+            if (token.type == TokenType::CT_BracketOpen)
+            {
+                depth += 1;
+            }
+            else if (token.type == TokenType::CT_BracketClose)
+            {
+                if (depth == 0 && inside_block)
+                {
+                    break;
+                }
+
+                depth -= ice::u32(depth > 0);
+            }
+
+            token = lexer.next();
+        }
+    }
+
+    auto Parser::parse_import(
+        ice::arctic::Token& token,
+        ice::arctic::Lexer& lexer
+    ) noexcept -> ice::arctic::ParseState
+    {
+        token = lexer.next();
+        if (token.type != TokenType::CT_String)
+        {
+            ice::arctic::expect_token(token, TokenType::CT_String);
+            return ParseState::Error_Import_MissingPath;
+        }
+
+        ice::arctic::ModuleCache& cache = _options.modules != nullptr
+            ? *_options.modules
+            : ice::arctic::ModuleCache::global();
+
+        // The token value still contains the quotes.
+        ice::arctic::ParseResult<ice::arctic::Module const*> const module = cache.load(
+            token.value.substr(1, token.value.size() - 2),
+            _options.import_directory
+        );
+        if (module.has_error())
+        {
+            return module._state;
+        }
+
+        _units.back().is_import = true;
+        on_import(module._value);
+        return ParseState::Success;
+    }
+
+    void Parser::on_import(ice::arctic::Module const* module) noexcept
+    {
+        auto const import_once = [this](ice::arctic::Module const* imported) noexcept
+        {
+            if (std::find(_imports.begin(), _imports.end(), imported) != _imports.end())
+            {
+                return;
+            }
+
+            _imports.push_back(imported);
+            for (ice::arctic::SyntaxNode const* node : imported->definitions())
+            {
+                _definitions.push_back(node);
+                _units.back().definition_count += 1;
+                publish(node);
+            }
+        };
+
+        // Imports of a module are already ordered so that dependencies come first.
+        for (ice::arctic::Module const* nested_module : module->imports())
+        {
+            import_once(nested_module);
+        }
+        import_once(module);
+    }
+
+    void Parser::on_definition(ice::arctic::SyntaxNode* node) noexcept
+    {
+        _definitions.push_back(node);
+        _units.back().definition_count += 1;
+
+        if (_options.build_node_index)
+        {
+            _node_index.add_definition(node);
+        }
+
+        if (_options.decode_annotations)
+        {
+            _annotation_tables.add_definition(node);
+        }
+
+        publish(node);
+    }
+
+    auto Parser::limit_lexer(ice::arctic::Lexer& lexer) noexcept -> ice::arctic::Lexer
+    {
+        ice::arctic::ParserLimits const& limits = _options.limits;
+        ice::u32 token_count = 0;
+
+        ice::arctic::Token token = lexer.next();
+        while (token.type != TokenType::ST_EndOfFile)
+        {
+            token_count += 1;
+
+            if (limits.max_tokens != 0 && token_count > limits.max_tokens)
+            {
+                _limit_state = ParseState::Error_Limit_TokenCount;
+            }
+            // Checking the clock on each token would be noticeable for large sources.
+            else if (limits.max_time_ms != 0 && (token_count % 64) == 0 && std::chrono::steady_clock::now() > _deadline)
+            {
+                _limit_state = ParseState::Error_Limit_Time;
+            }
+
+            if (check_limits() != ParseState::Success)
+            {
+                co_return Token{
+                    .value = { },
+                    .type = TokenType::ST_EndOfFile,
+                    .location = token.location
+                };
+            }
+
+            co_yield token;
+            token = lexer.next();
+        }
+
+        co_return token;
+    }
+
+    void Parser::reset_limits() noexcept
+    {
+        _allocated_bytes = 0;
+        _allocated_nodes = 0;
+        _limit_state = ParseState::Success;
+        _deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{ _options.limits.max_time_ms };
+
+        if (ice::arctic::detail::nesting_budget != nullptr)
+        {
+            ice::arctic::detail::nesting_budget->depth = 0;
+            ice::arctic::detail::nesting_budget->exceeded = false;
+        }
+    }
+
+    auto Parser::check_limits() noexcept -> ice::arctic::ParseState
+    {
+        // The depth is tracked by the rules themselves, we only pick up the result.
+        if (_limit_state == ParseState::Success
+            && ice::arctic::detail::nesting_budget != nullptr
+            && ice::arctic::detail::nesting_budget->exceeded)
+        {
+            _limit_state = ParseState::Error_Limit_ExpressionDepth;
+        }
+        return _limit_state;
     }
 
     auto Parser::allocate(ice::u64 size, ice::u64 align) noexcept -> void*
     {
+        _allocated_bytes += size;
+        _allocated_nodes += 1;
+
+        // The allocation is still served, the parser stops at the next token.
+        if (_limit_state == ParseState::Success)
+        {
+            ice::arctic::ParserLimits const& limits = _options.limits;
+            if (limits.max_allocated_bytes != 0 && _allocated_bytes > limits.max_allocated_bytes)
+            {
+                _limit_state = ParseState::Error_Limit_AllocatedBytes;
+            }
+            else if (limits.max_nodes != 0 && _allocated_nodes > limits.max_nodes)
+            {
+                _limit_state = ParseState::Error_Limit_NodeCount;
+            }
+        }
+
         return _aligned_malloc(size, align);
     }
 
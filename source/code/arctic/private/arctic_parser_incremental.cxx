@@ -0,0 +1,438 @@
+#include <ice/arctic_parser.hxx>
+#include <ice/arctic_parser_utils.hxx>
+#include <ice/arctic_trace.hxx>
+#include <ice/arctic_word_matcher.hxx>
+#include <ice/arctic_word_processor.hxx>
+
+#include <algorithm>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        //! \brief Calls 'fn' for the definition and every node owned by it.
+        //! \note Annotations and sibling definitions are separate definitions and are not followed.
+        template<typename Fn>
+        void for_each_definition_node(ice::arctic::SyntaxNode* definition, Fn&& fn) noexcept
+        {
+            std::vector<ice::arctic::SyntaxNode*> pending;
+            pending.push_back(definition->child);
+
+            // The function body is stored as the sibling of the function node.
+            if (definition->entity == SyntaxEntity::DEF_Function)
+            {
+                pending.push_back(definition->sibling);
+            }
+
+            fn(definition);
+
+            while (pending.empty() == false)
+            {
+                ice::arctic::SyntaxNode* const node = pending.back();
+                pending.pop_back();
+
+                if (node != nullptr)
+                {
+                    pending.push_back(node->sibling);
+                    pending.push_back(node->child);
+                    fn(node);
+                }
+            }
+        }
+
+        constexpr bool is_unit_separator(ice::utf8 character) noexcept
+        {
+            return character == u8' ' || character == u8'\t' || character == u8'\r' || character == u8'\n';
+        }
+
+        auto count_lines(ice::String text) noexcept -> ice::i32
+        {
+            return ice::i32(std::count(text.begin(), text.end(), u8'\n'));
+        }
+
+    } // namespace detail
+
+    auto Parser::reparse(
+        ice::arctic::WordMatcher const* matcher,
+        ice::String previous_source,
+        ice::String source,
+        ice::arctic::TextEdit edit,
+        ice::arctic::LexerOptions options
+    ) noexcept -> ice::arctic::ParseState
+    {
+        ice::arctic::MemoryScope const memory_scope{ _memory_stats, MemoryPhase::Parsing };
+        ice::arctic::TraceScope const trace_scope{ "reparse" };
+        ice::arctic::ParseState const result = reparse_units(matcher, previous_source, source, edit, options);
+
+        // Rebuilding drops released nodes and keeps the reparsed regions in source order.
+        if (_options.build_node_index)
+        {
+            _node_index.clear();
+        }
+        if (_options.decode_annotations)
+        {
+            _annotation_tables.clear();
+        }
+
+        for (ice::arctic::SyntaxUnit const& unit : _units)
+        {
+            for (ice::u32 idx = unit.first_definition; unit.is_import == false && idx < unit.first_definition + unit.definition_count; ++idx)
+            {
+                if (_options.build_node_index)
+                {
+                    _node_index.add_definition(_definitions[idx]);
+                }
+                if (_options.decode_annotations)
+                {
+                    _annotation_tables.add_definition(_definitions[idx]);
+                }
+            }
+        }
+        return result;
+    }
+
+    auto Parser::reparse_units(
+        ice::arctic::WordMatcher const* matcher,
+        ice::String previous_source,
+        ice::String source,
+        ice::arctic::TextEdit edit,
+        ice::arctic::LexerOptions options
+    ) noexcept -> ice::arctic::ParseState
+    {
+        using ice::arctic::detail::for_each_definition_node;
+
+        assert(options.rules != LexerRules::Provided);
+
+        ice::arctic::TokenExpectations expectations{ };
+        ice::arctic::detail::TokenExpectationsScope const expectations_scope{ expectations };
+        ice::arctic::detail::NestingBudgetScope const nesting_scope{ _options.limits.max_expression_depth };
+
+        _diagnostics.clear();
+        reset_limits();
+
+        ice::utf8 const* const previous_begin = previous_source.data();
+        ice::u64 const edit_begin = edit.offset;
+        ice::u64 const edit_end = edit.offset + edit.removed_size;
+        ice::i64 const size_delta = ice::i64(edit.inserted_size) - ice::i64(edit.removed_size);
+
+        auto const unit_offset = [&](ice::u64 unit_idx) noexcept -> ice::u64
+        {
+            return unit_idx < _units.size() ? ice::u64(_units[unit_idx].begin - previous_begin) : previous_source.size();
+        };
+
+        auto const release_definition = [this](ice::arctic::SyntaxNode const* definition) noexcept
+        {
+            for_each_definition_node(
+                const_cast<ice::arctic::SyntaxNode*>(definition),
+                [this](ice::arctic::SyntaxNode* node) noexcept
+                {
+                    ice::arctic::detail::track_node_deallocation(node);
+                    deallocate(node);
+                }
+            );
+        };
+
+        // Definitions of 'import' statements are owned by the imported modules.
+        auto const release_units = [&release_definition](
+            ice::Span<ice::arctic::SyntaxUnit const> units,
+            ice::Span<ice::arctic::SyntaxNode const* const> definitions
+        ) noexcept
+        {
+            for (ice::arctic::SyntaxUnit const& unit : units)
+            {
+                for (ice::u32 idx = unit.first_definition; unit.is_import == false && idx < unit.first_definition + unit.definition_count; ++idx)
+                {
+                    release_definition(definitions[idx]);
+                }
+            }
+        };
+
+        auto const has_import = [](ice::Span<ice::arctic::SyntaxUnit const> units) noexcept -> bool
+        {
+            return std::any_of(units.begin(), units.end(), [](ice::arctic::SyntaxUnit const& unit) noexcept { return unit.is_import; });
+        };
+
+        auto const parse_from = [&](ice::u64 offset, ice::arctic::TokenLocation location, ice::utf8 const* units_end) noexcept
+        {
+            ice::arctic::Lexer lexer = ice::arctic::create_lexer(
+                ice::arctic::create_word_processor(
+                    source.substr(offset),
+                    matcher,
+                    ice::arctic::WordLocation{ .line = location.line - 1u, .character = 0 }
+                ),
+                options
+            );
+
+            auto const parse_region = [&](ice::arctic::Lexer& region_lexer) noexcept -> ice::arctic::ParseState
+            {
+                ice::arctic::Token token = region_lexer.next();
+                ice::arctic::ParseResult<ice::arctic::SyntaxNode*> const result = parse_units(token, region_lexer, units_end);
+                if (result.has_error() == false && token.type != TokenType::ST_EndOfFile && token.value.data() != units_end)
+                {
+                    // The last reparsed unit extended into the next one.
+                    return ParseState::Error;
+                }
+                return result._state;
+            };
+
+            if (_options.limits.enabled())
+            {
+                ice::arctic::Lexer limited_lexer = limit_lexer(lexer);
+                return parse_region(limited_lexer);
+            }
+            return parse_region(lexer);
+        };
+
+        auto const full_reparse = [&]() noexcept -> ice::arctic::ParseState
+        {
+            for (ice::arctic::SyntaxNode const* definition : _definitions)
+            {
+                for (ice::u32 visitor_idx = 0; visitor_idx < _visitors.size(); ++visitor_idx)
+                {
+                    if (_visitors[visitor_idx]->accepts(definition->entity))
+                    {
+                        ice::arctic::MemoryScope const visitor_scope{ _memory_stats, visitor_idx };
+                        ice::arctic::TraceScope const visitor_trace{ "visit_removed", to_string(definition->entity), visitor_idx };
+                        _visitors[visitor_idx]->visit_removed(definition);
+                    }
+                }
+            }
+            release_units(_units, _definitions);
+
+            // The source header is only skipped by the lexer when the rules are not provided explicitly.
+            bool const has_header = _units.empty() == false && edit_begin >= unit_offset(0);
+            ice::u64 const first_offset = has_header ? unit_offset(0) : 0;
+            ice::arctic::TokenLocation const first_location = has_header
+                ? _units[0].location
+                : ice::arctic::TokenLocation{ .line = 1, .column = 1 };
+
+            // Imports are resolved again, so their definitions are part of the new units.
+            _definitions.clear();
+            _units.clear();
+            _imports.clear();
+            _diagnostics.clear();
+            reset_limits();
+
+            if (has_header == false)
+            {
+                options.rules = LexerRules::Provided;
+            }
+
+            return parse_from(first_offset, first_location, nullptr);
+        };
+
+        if (_units.empty() || edit_begin < unit_offset(0))
+        {
+            return full_reparse();
+        }
+
+        // Find the units touched by the edit.
+        auto const find_unit = [&](ice::u64 offset) noexcept -> ice::u64
+        {
+            auto const it = std::upper_bound(
+                _units.begin(), _units.end(), offset,
+                [previous_begin](ice::u64 value, ice::arctic::SyntaxUnit const& unit) noexcept
+                {
+                    return value < ice::u64(unit.begin - previous_begin);
+                }
+            );
+            return ice::u64(it - _units.begin()) - 1;
+        };
+
+        // Units own the whitespace after their last token, an edit at the start of a unit can only extend the
+        // previous unit if it directly follows one of its tokens.
+        ice::u64 first_unit = find_unit(edit_begin);
+        if (unit_offset(first_unit) == edit_begin && first_unit > 0
+            && ice::arctic::detail::is_unit_separator(previous_source[edit_begin - 1]) == false)
+        {
+            first_unit -= 1;
+        }
+
+        ice::u64 const last_unit = std::max(first_unit, find_unit(edit.removed_size > 0 ? edit_end - 1 : edit_begin));
+
+        // Modules imported more than once only add their definitions at the first import, this depends on all previous units.
+        if (has_import(ice::Span<ice::arctic::SyntaxUnit const>{ _units }.subspan(first_unit, last_unit + 1 - first_unit)))
+        {
+            return full_reparse();
+        }
+
+        ice::u64 const region_begin = unit_offset(first_unit);
+        ice::u64 const previous_region_end = unit_offset(last_unit + 1);
+        ice::u64 const region_end = ice::u64(ice::i64(previous_region_end) + size_delta);
+
+        ice::u32 const first_definition = _units[first_unit].first_definition;
+        ice::u32 const end_definition = _units[last_unit].first_definition + _units[last_unit].definition_count;
+
+        // Parse the edited region in isolation, visitors are notified after we know what changed.
+        std::vector<ice::arctic::SyntaxVisitorBase*> visitors = std::exchange(_visitors, { });
+        std::vector<ice::arctic::SyntaxNode const*> definitions = std::exchange(_definitions, { });
+        std::vector<ice::arctic::SyntaxUnit> units = std::exchange(_units, { });
+
+        ice::arctic::ParseState const region_state = parse_from(
+            region_begin,
+            units[first_unit].location,
+            last_unit + 1 < units.size() ? source.data() + region_end : nullptr
+        );
+
+        std::vector<ice::arctic::SyntaxNode const*> new_definitions = std::exchange(_definitions, std::move(definitions));
+        std::vector<ice::arctic::SyntaxUnit> new_units = std::exchange(_units, std::move(units));
+        _visitors = std::move(visitors);
+
+        if (region_state != ParseState::Success || has_import(new_units))
+        {
+            release_units(new_units, new_definitions);
+            return full_reparse();
+        }
+
+        // Move the tokens of all kept nodes into the new source.
+        ice::i32 const line_delta = ice::arctic::detail::count_lines(source.substr(region_begin, region_end - region_begin))
+            - ice::arctic::detail::count_lines(previous_source.substr(region_begin, previous_region_end - region_begin));
+
+        auto const rebase_unit = [&](ice::arctic::SyntaxUnit& unit, ice::i64 offset_delta, ice::i32 unit_line_delta) noexcept
+        {
+            auto const rebase_token = [&](ice::arctic::Token& token) noexcept
+            {
+                if (token.value.empty() == false)
+                {
+                    ice::u64 const offset = ice::u64(ice::i64(token.value.data() - previous_begin) + offset_delta);
+                    token.value = ice::String{ source.data() + offset, token.value.size() };
+                    token.location.line = ice::u32(ice::i32(token.location.line) + unit_line_delta);
+                }
+            };
+
+            for (ice::u32 idx = 0; unit.is_import == false && idx < unit.definition_count; ++idx)
+            {
+                for_each_definition_node(
+                    const_cast<ice::arctic::SyntaxNode*>(_definitions[unit.first_definition + idx]),
+                    [&](ice::arctic::SyntaxNode* node) noexcept { ice::arctic::for_each_syntax_token(node, rebase_token); }
+                );
+            }
+
+            unit.begin = source.data() + ice::i64(unit.begin - previous_begin) + offset_delta;
+            unit.location.line = ice::u32(ice::i32(unit.location.line) + unit_line_delta);
+        };
+
+        if (source.data() != previous_begin)
+        {
+            for (ice::u64 unit_idx = 0; unit_idx < first_unit; ++unit_idx)
+            {
+                rebase_unit(_units[unit_idx], 0, 0);
+            }
+        }
+
+        if (source.data() != previous_begin || size_delta != 0 || line_delta != 0)
+        {
+            for (ice::u64 unit_idx = last_unit + 1; unit_idx < _units.size(); ++unit_idx)
+            {
+                rebase_unit(_units[unit_idx], size_delta, line_delta);
+            }
+        }
+
+        // Splice the reparsed units and definitions in place of the old ones.
+        ice::i64 const definition_delta = ice::i64(new_definitions.size()) - ice::i64(end_definition - first_definition);
+        for (ice::u64 unit_idx = last_unit + 1; unit_idx < _units.size(); ++unit_idx)
+        {
+            _units[unit_idx].first_definition = ice::u32(_units[unit_idx].first_definition + definition_delta);
+        }
+        for (ice::arctic::SyntaxUnit& unit : new_units)
+        {
+            unit.first_definition += first_definition;
+        }
+
+        std::vector<ice::arctic::SyntaxNode const*> removed_definitions{
+            _definitions.begin() + first_definition,
+            _definitions.begin() + end_definition
+        };
+
+        _definitions.erase(_definitions.begin() + first_definition, _definitions.begin() + end_definition);
+        _definitions.insert(_definitions.begin() + first_definition, new_definitions.begin(), new_definitions.end());
+        _units.erase(_units.begin() + first_unit, _units.begin() + last_unit + 1);
+        _units.insert(_units.begin() + first_unit, new_units.begin(), new_units.end());
+
+        // Pair new definitions with removed ones of the same entity and name, so visitors can treat them as changes.
+        std::vector<ice::arctic::SyntaxNode const*> previous_definitions(new_definitions.size(), nullptr);
+        for (ice::u64 idx = 0; idx < new_definitions.size(); ++idx)
+        {
+            ice::arctic::SyntaxNode const* const node = new_definitions[idx];
+            ice::String const name = ice::arctic::detail::definition_name(node);
+
+            auto const it = std::find_if(
+                removed_definitions.begin(), removed_definitions.end(),
+                [&](ice::arctic::SyntaxNode const* removed) noexcept
+                {
+                    return removed != nullptr
+                        && removed->entity == node->entity
+                        && name.empty() == false
+                        && ice::arctic::detail::definition_name(removed) == name;
+                }
+            );
+
+            if (it != removed_definitions.end())
+            {
+                previous_definitions[idx] = std::exchange(*it, nullptr);
+            }
+        }
+
+        for (ice::arctic::SyntaxNode const* removed : removed_definitions)
+        {
+            if (removed != nullptr)
+            {
+                for (ice::u32 visitor_idx = 0; visitor_idx < _visitors.size(); ++visitor_idx)
+                {
+                    if (_visitors[visitor_idx]->accepts(removed->entity))
+                    {
+                        ice::arctic::MemoryScope const visitor_scope{ _memory_stats, visitor_idx };
+                        ice::arctic::TraceScope const visitor_trace{ "visit_removed", to_string(removed->entity), visitor_idx };
+                        _visitors[visitor_idx]->visit_removed(removed);
+                    }
+                }
+            }
+        }
+
+        for (ice::u64 idx = 0; idx < new_definitions.size(); ++idx)
+        {
+            for (ice::u32 visitor_idx = 0; visitor_idx < _visitors.size(); ++visitor_idx)
+            {
+                ice::arctic::SyntaxVisitorBase* const visitor = _visitors[visitor_idx];
+
+                // Changed nodes are only paired with nodes of the same entity.
+                if (visitor->accepts(new_definitions[idx]->entity) == false)
+                {
+                    continue;
+                }
+
+                ice::arctic::MemoryScope const visitor_scope{ _memory_stats, visitor_idx };
+                ice::arctic::TraceScope const visitor_trace{ "visit", to_string(new_definitions[idx]->entity), visitor_idx };
+                if (previous_definitions[idx] != nullptr)
+                {
+                    visitor->visit_changed(previous_definitions[idx], new_definitions[idx]);
+                }
+                else
+                {
+                    visitor->visit(new_definitions[idx]);
+                }
+            }
+        }
+
+        // Only release the replaced nodes after all visitors had a chance to look at them.
+        for (ice::u64 idx = first_definition; idx < first_definition + new_definitions.size(); ++idx)
+        {
+            if (previous_definitions[idx - first_definition] != nullptr)
+            {
+                release_definition(previous_definitions[idx - first_definition]);
+            }
+        }
+        for (ice::arctic::SyntaxNode const* removed : removed_definitions)
+        {
+            if (removed != nullptr)
+            {
+                release_definition(removed);
+            }
+        }
+
+        return ParseState::Success;
+    }
+
+} // namespace ice::arctic
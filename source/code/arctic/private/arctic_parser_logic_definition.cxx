@@ -19,6 +19,17 @@ namespace ice::arctic
             ice::arctic::Token matched_token;
         };
 
+        static ice::arctic::ParserRuleProfile Profile_Def_TypeOf{ "definition.typeof" };
+        static ice::arctic::ParserRuleProfile Profile_Def_Struct{ "definition.struct" };
+        static ice::arctic::ParserRuleProfile Profile_Def_StructMember{ "definition.struct_member" };
+        static ice::arctic::ParserRuleProfile Profile_Def_Header{ "definition.header" };
+        static ice::arctic::ParserRuleProfile Profile_Def_Function{ "definition.function" };
+        static ice::arctic::ParserRuleProfile Profile_Def_FunctionArg{ "definition.function_arg" };
+        static ice::arctic::ParserRuleProfile Profile_Def_Annotation{ "definition.annotation" };
+        static ice::arctic::ParserRuleProfile Profile_Def_AnnotationAttribute{ "definition.annotation_attribute" };
+        static ice::arctic::ParserRuleProfile Profile_Def_AttributeValue{ "definition.attribute_value" };
+        static ice::arctic::ParserRuleProfile Profile_Def_Variable{ "definition.variable" };
+
         namespace typeof
         {
 
@@ -47,7 +58,8 @@ namespace ice::arctic
                 ice::arctic::Lexer& lexer
             ) noexcept -> ice::arctic::ParseResult<ice::arctic::SyntaxNode*>
             {
-                static TokenRule const match_typeof = TokenGroup_MatchAll{ MatchRules_Definition_TypeOf };
+                static TokenRule constexpr match_typeof = TokenGroup_MatchAll{ MatchRules_Definition_TypeOf }
+                    .profiled(Profile_Def_TypeOf);
                 variable->entity = SyntaxEntity::DEF_TypeDef;
 
                 ice::arctic::ParseResult<ice::arctic::SyntaxNode*> result = match_typeof(nullptr, variable, token, lexer);
@@ -75,7 +87,8 @@ namespace ice::arctic
                 TokenRule_MatchType<TokenType::CT_SquareBracketOpen>{}
                     .fail_with(ParseState::Error_TypeOf_MissingBracketOpen),
                 TokenRule_MatchType<TokenType::ST_EndOfLine>{},
-                TokenGroup_MatchChild{ SyntaxNode_StructMember{}, MatchRules_Definition_StructMember, true, true },
+                TokenGroup_MatchChild{ SyntaxNode_StructMember{}, MatchRules_Definition_StructMember, true, true }
+                    .profiled(Profile_Def_StructMember),
                 TokenRule_MatchType<TokenType::CT_SquareBracketClose>{}
                     .fail_with(ParseState::Error_TypeOf_MissingBracketClose)
             };
@@ -87,7 +100,8 @@ namespace ice::arctic
                 ice::arctic::Lexer& lexer
             ) noexcept -> ice::arctic::ParseResult<ice::arctic::SyntaxNode*>
             {
-                static TokenRule const match_struct = TokenGroup_MatchAll{ MatchRules_Definition_Struct };
+                static TokenRule constexpr match_struct = TokenGroup_MatchAll{ MatchRules_Definition_Struct }
+                    .profiled(Profile_Def_Struct);
 
                 ice::arctic::ParseResult<ice::arctic::SyntaxNode*> result = match_struct(&alloc, node, token, lexer);
                 if (result.has_error() == false)
@@ -146,7 +160,8 @@ namespace ice::arctic
             ice::arctic::Lexer& lexer
         ) noexcept -> ice::arctic::ParseResult<ice::arctic::SyntaxNode*>
         {
-            static TokenRule const match_definition = TokenGroup_MatchAll{ MatchRules_Definition };
+            static TokenRule constexpr match_definition = TokenGroup_MatchAll{ MatchRules_Definition }
+                .profiled(Profile_Def_Header);
 
             ice::arctic::rules::TempNode temp_node;
             ice::arctic::Token token = lexer.next();
@@ -177,6 +192,9 @@ namespace ice::arctic
                 }
                 else
                 {
+                    ice::arctic::expect_token(token, TokenType::KW_Struct);
+                    ice::arctic::expect_token(token, TokenType::KW_TypeOf);
+                    ice::arctic::expect_token(token, TokenType::KW_Alias);
                     result = ParseState::Error_Definition_UnknownToken;
                 }
             }
@@ -199,7 +217,8 @@ namespace ice::arctic
             static ice::arctic::TokenRule constexpr MatchRules_Function[]{
                 TokenRule_MatchType<TokenType::CT_Symbol, TokenRule_StoreToken<&SyntaxNode_Function::name>>{},
                 TokenRule_MatchType<TokenType::CT_ParenOpen>{}.fail_with(ParseState::Error_UnexpectedToken),
-                TokenGroup_MatchChild{ SyntaxNode_FunctionArgument{}, MatchRules_FunctionArg, true, true },
+                TokenGroup_MatchChild{ SyntaxNode_FunctionArgument{}, MatchRules_FunctionArg, true, true }
+                    .profiled(Profile_Def_FunctionArg),
                 TokenRule_MatchType<TokenType::CT_ParenClose>{}.fail_with(ParseState::Error_UnexpectedToken),
                 TokenRule_MatchType<TokenType::CT_Colon>{},
                 TokenRule_MatchType<TokenType::CT_Symbol, TokenRule_StoreToken<&SyntaxNode_Function::result_type>>{},
@@ -213,7 +232,8 @@ namespace ice::arctic
             ice::arctic::Lexer& lexer
         ) noexcept -> ice::arctic::ParseResult<ice::arctic::SyntaxNode*>
         {
-            static TokenRule const match_function = TokenGroup_MatchAll{ func::MatchRules_Function };
+            static TokenRule constexpr match_function = TokenGroup_MatchAll{ func::MatchRules_Function }
+                .profiled(Profile_Def_Function);
 
             ice::arctic::SyntaxNode_Function* node = alloc.create<SyntaxNode_Function>();
 
@@ -226,6 +246,7 @@ namespace ice::arctic
 
             if (token.type != TokenType::CT_BracketOpen)
             {
+                ice::arctic::expect_token(token, TokenType::CT_BracketOpen);
                 return ParseState::Error_UnexpectedToken;
             }
 
@@ -255,7 +276,7 @@ namespace ice::arctic
 
             static ice::arctic::TokenRule constexpr MatchRules_AttributeAssignValue[]{
                 TokenRule_MatchType<TokenType::OP_Assign>{},
-                TokenGroup_MatchFirst{ MatchRules_AttributeValue }
+                TokenGroup_MatchFirst{ MatchRules_AttributeValue }.profiled(Profile_Def_AttributeValue)
             };
 
             static ice::arctic::TokenRule constexpr MatchRules_AttributeFirst[]{
@@ -270,8 +291,10 @@ namespace ice::arctic
             };
 
             static ice::arctic::TokenRule constexpr MatchRules_Attributes[]{
-                TokenGroup_MatchChild{ SyntaxNode_AnnotationAttribute{}, MatchRules_AttributeFirst },
-                TokenGroup_MatchChild{ SyntaxNode_AnnotationAttribute{}, MatchRules_Attribute, /*.optional =*/ true, /*.repeat =*/ true },
+                TokenGroup_MatchChild{ SyntaxNode_AnnotationAttribute{}, MatchRules_AttributeFirst }
+                    .profiled(Profile_Def_AnnotationAttribute),
+                TokenGroup_MatchChild{ SyntaxNode_AnnotationAttribute{}, MatchRules_Attribute, /*.optional =*/ true, /*.repeat =*/ true }
+                    .profiled(Profile_Def_AnnotationAttribute),
             };
 
             static ice::arctic::TokenRule constexpr MatchRules_Annotation[]{
@@ -286,7 +309,8 @@ namespace ice::arctic
                 ice::arctic::Lexer& lexer
             ) noexcept -> ice::arctic::ParseResult<ice::arctic::SyntaxNode*>
             {
-                static TokenRule const match_annotation = TokenGroup_MatchAll{ MatchRules_Annotation, false, false };
+                static TokenRule constexpr match_annotation = TokenGroup_MatchAll{ MatchRules_Annotation, false, false }
+                    .profiled(Profile_Def_Annotation);
 
                 ice::arctic::SyntaxNode_Annotation* node = alloc.create<SyntaxNode_Annotation>();
                 ice::arctic::ParseResult<ice::arctic::SyntaxNode*> result = match_annotation(&alloc, node, token, lexer);
@@ -309,6 +333,19 @@ namespace ice::arctic
                 TokenRule_MatchType<TokenType::CT_Symbol, TokenRule_StoreToken<&SyntaxNode_Variable::type>>{},
             };
 
+            // Context variables can't be constants, so only plain variables have the 'is_const' flag.
+            static ice::arctic::TokenRule constexpr MatchRules_VariableQualifier[]{
+                TokenRule_MatchType<TokenType::KW_Let, TokenRule_StoreBool<&SyntaxNode_Variable::is_const, false>>{},
+                TokenRule_MatchType<TokenType::KW_Const, TokenRule_StoreBool<&SyntaxNode_Variable::is_const, true>>{},
+            };
+
+            static ice::arctic::TokenRule constexpr MatchRules_VariableOrConstant[]{
+                TokenGroup_MatchFirst{ MatchRules_VariableQualifier },
+                TokenRule_MatchType<TokenType::CT_Symbol, TokenRule_StoreToken<&SyntaxNode_Variable::name>>{},
+                TokenRule_MatchType<TokenType::CT_Colon>{},
+                TokenRule_MatchType<TokenType::CT_Symbol, TokenRule_StoreToken<&SyntaxNode_Variable::type>>{},
+            };
+
             template<typename VariableType>
             auto parse_variable_definition(
                 ice::arctic::SyntaxNodeAllocator& alloc,
@@ -316,7 +353,9 @@ namespace ice::arctic
                 ice::arctic::Lexer& lexer
             ) noexcept -> ice::arctic::ParseResult<ice::arctic::SyntaxNode*>
             {
-                static TokenRule const match_variable = TokenGroup_MatchAll{ MatchRules_Variable, false, false };
+                static TokenRule constexpr match_variable = std::is_same_v<VariableType, SyntaxNode_Variable>
+                    ? TokenGroup_MatchAll{ MatchRules_VariableOrConstant, false, false }.profiled(Profile_Def_Variable)
+                    : TokenGroup_MatchAll{ MatchRules_Variable, false, false }.profiled(Profile_Def_Variable);
 
                 VariableType* node = alloc.create<VariableType>();
                 ice::arctic::ParseResult<ice::arctic::SyntaxNode*> result = match_variable(&alloc, node, token, lexer);
@@ -325,6 +364,14 @@ namespace ice::arctic
                     return result;
                 }
 
+                if constexpr (std::is_same_v<VariableType, SyntaxNode_Variable>)
+                {
+                    if (node->is_const && token.type != TokenType::OP_Assign)
+                    {
+                        return ParseState::Error_Definition_MissingAssignmentOperator;
+                    }
+                }
+
                 if (token.type == TokenType::OP_Assign)
                 {
                     ice::arctic::Token const saved_token = token;
@@ -357,6 +404,12 @@ namespace ice::arctic
             ice::arctic::Lexer& lexer
         ) noexcept -> ice::arctic::ParseResult<ice::arctic::SyntaxNode*>
         {
+            ice::arctic::NestingScope const nesting{ };
+            if (nesting.exceeded())
+            {
+                return ParseState::Error_Limit_ExpressionDepth;
+            }
+
             ice::arctic::SyntaxNode* child = nullptr;
 
             const auto append_child = [&parent_node, &child](ice::arctic::SyntaxNode* new_child) noexcept -> void
@@ -382,6 +435,7 @@ namespace ice::arctic
                 switch (token.type)
                 {
                 case TokenType::KW_Let:
+                case TokenType::KW_Const:
                 {
                     auto var_result = rules::variable::parse_variable_definition<SyntaxNode_Variable>(alloc, token, lexer);
                     if (var_result.has_error())
@@ -469,6 +523,7 @@ namespace ice::arctic
             result = rules::parse_node_definition(alloc, lexer);
             break;
         case TokenType::KW_Let:
+        case TokenType::KW_Const:
             result = rules::variable::parse_variable_definition<SyntaxNode_Variable>(alloc, token, lexer);
             break;
         case TokenType::CT_SquareBracketOpen:
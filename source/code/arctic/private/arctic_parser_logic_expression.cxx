@@ -20,6 +20,13 @@ namespace ice::arctic::rules
         }
     };
 
+    static ice::arctic::ParserRuleProfile Profile_Exp_Value{ "expression.value" };
+    static ice::arctic::ParserRuleProfile Profile_Exp_BinaryOperation{ "expression.binary_operation" };
+    static ice::arctic::ParserRuleProfile Profile_Exp_BinaryChain{ "expression.binary_chain" };
+    static ice::arctic::ParserRuleProfile Profile_Exp_PostBinary{ "expression.post_binary" };
+    static ice::arctic::ParserRuleProfile Profile_Exp_Subexpression{ "expression.subexpression" };
+    static ice::arctic::ParserRuleProfile Profile_Exp_Expression{ "expression" };
+
     static ice::arctic::TokenRule constexpr MatchRules_ExpValues[]{
         TokenRule_MatchType<TokenType::CT_Number, TokenRule_StoreToken<&SyntaxNode_ExpressionValue::value>>{},
         TokenRule_MatchType<TokenType::CT_NumberBin, TokenRule_StoreToken<&SyntaxNode_ExpressionValue::value>>{},
@@ -34,7 +41,7 @@ namespace ice::arctic::rules
     };
 
     static ice::arctic::TokenRule constexpr MatchRules_ExpValue[]{
-        TokenGroup_MatchFirst{ MatchRules_ExpValues }
+        TokenGroup_MatchFirst{ MatchRules_ExpValues }.profiled(Profile_Exp_Value)
     };
 
     static ice::arctic::TokenRule constexpr MatchRules_ExpBinaryOperations[]{
@@ -48,7 +55,7 @@ namespace ice::arctic::rules
     };
 
     static ice::arctic::TokenRule constexpr MatchRules_ExpBinaryOperation[]{
-        TokenGroup_MatchFirst{ MatchRules_ExpBinaryOperations }
+        TokenGroup_MatchFirst{ MatchRules_ExpBinaryOperations }.profiled(Profile_Exp_BinaryOperation)
     };
 
 
@@ -78,7 +85,7 @@ namespace ice::arctic::rules
     };
 
     static ice::arctic::TokenRule constexpr MatchRules_ExpBinary[]{
-        TokenGroup_MatchAll{ MatchRules_ExpBinaryLeftAndOperation, false, true }
+        TokenGroup_MatchAll{ MatchRules_ExpBinaryLeftAndOperation, false, true }.profiled(Profile_Exp_BinaryChain)
     };
 
     static ice::arctic::TokenRule constexpr MatchRules_ExpBinaryAll =
@@ -101,7 +108,7 @@ namespace ice::arctic::rules
             .fail_state = ParseState::Error,
             .userdata = nullptr,
             .func = match_subexpression_recursive
-        }
+        }.profiled(Profile_Exp_Subexpression)
     };
 
     static ice::arctic::TokenRule constexpr MatchRules_RecursiveExpressionRepeat[]{
@@ -111,7 +118,7 @@ namespace ice::arctic::rules
             .fail_state = ParseState::Error,
             .userdata = nullptr,
             .func = match_subexpression_recursive
-        }
+        }.profiled(Profile_Exp_Subexpression)
     };
 
     auto match_subexpression_recursive(
@@ -123,8 +130,15 @@ namespace ice::arctic::rules
         ice::arctic::Lexer& lexer
     ) noexcept -> ice::arctic::ParseState
     {
-        static ice::arctic::TokenRule const match_rec = TokenGroup_MatchAll{ MatchRules_RecursiveExpression };
-        static ice::arctic::TokenRule constexpr match_post_binary = TokenGroup_MatchSibling{ SyntaxNode_ExpressionBinaryOperation{}, MatchRules_ExpBinaryOperation, true };
+        static ice::arctic::TokenRule constexpr match_rec = TokenGroup_MatchAll{ MatchRules_RecursiveExpression };
+        static ice::arctic::TokenRule constexpr match_post_binary = TokenGroup_MatchSibling{ SyntaxNode_ExpressionBinaryOperation{}, MatchRules_ExpBinaryOperation, true }
+            .profiled(Profile_Exp_PostBinary);
+
+        ice::arctic::NestingScope const nesting{ };
+        if (nesting.exceeded())
+        {
+            return ParseState::Error_Limit_ExpressionDepth;
+        }
 
         ice::arctic::ParseState result = ParseState::Success;
 
@@ -383,7 +397,8 @@ namespace ice::arctic::rules
         ice::arctic::Lexer& lexer
     ) noexcept -> ice::arctic::ParseResult<ice::arctic::SyntaxNode*>
     {
-        static ice::arctic::TokenRule const match_exp = TokenGroup_MatchAll{ MatchRules_RecursiveExpressionRepeat };
+        static ice::arctic::TokenRule constexpr match_exp = TokenGroup_MatchAll{ MatchRules_RecursiveExpressionRepeat }
+            .profiled(Profile_Exp_Expression);
 
         return match_exp(&alloc, parent_node, token, lexer);
     }
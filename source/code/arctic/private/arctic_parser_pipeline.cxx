@@ -0,0 +1,148 @@
+#include <ice/arctic_parser.hxx>
+#include <ice/arctic_parallel.hxx>
+#include <ice/arctic_trace.hxx>
+
+#include <thread>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        static constexpr ice::u32 Constant_PipelineTokenCapacity = 1024;
+        static constexpr ice::u32 Constant_PipelineNodeCapacity = 256;
+
+        struct ParserPipeline
+        {
+            ice::arctic::detail::SpscQueue<ice::arctic::Token, Constant_PipelineTokenCapacity> tokens;
+
+            //! \brief Finished top-level nodes, a 'nullptr' marks the end of parsing.
+            ice::arctic::detail::SpscQueue<ice::arctic::SyntaxNode const*, Constant_PipelineNodeCapacity> nodes;
+
+            //! \brief Annotations are still linked to following annotations after being reported, so they are held back
+            //!   until the definition they belong to is finished.
+            std::vector<ice::arctic::SyntaxNode const*> pending_annotations;
+        };
+
+        auto create_pipeline_lexer(ice::arctic::detail::ParserPipeline& pipeline) noexcept -> ice::arctic::Lexer
+        {
+            ice::arctic::Token token = pipeline.tokens.pop();
+            while (token.type != TokenType::ST_EndOfFile)
+            {
+                co_yield token;
+                token = pipeline.tokens.pop();
+            }
+
+            co_return token;
+        }
+
+    } // namespace detail
+
+    auto Parser::parse_pipelined(ice::arctic::Lexer& lexer) noexcept -> ice::arctic::ParseState
+    {
+        ice::arctic::detail::ParserPipeline pipeline{ };
+
+        // Each thread is charged to its own stats, so counters are never shared between threads.
+        ice::arctic::MemoryStats lexer_stats{ };
+        ice::arctic::MemoryStats visitor_stats{ .visitors = std::vector<ice::arctic::MemoryCounters>(_visitors.size()) };
+
+        std::thread lexer_thread{ [&pipeline, &lexer, &lexer_stats]() noexcept
+            {
+                ice::arctic::MemoryScope const memory_scope{ lexer_stats, MemoryPhase::Lexing };
+                ice::arctic::trace_thread_name("arctic.lexer");
+                ice::arctic::TraceScope const trace_scope{ "lexing" };
+                ice::arctic::Token token = lexer.next();
+                while (pipeline.tokens.push(token) && token.type != TokenType::ST_EndOfFile)
+                {
+                    token = lexer.next();
+                }
+            }
+        };
+
+        std::thread visitor_thread{ [&pipeline, &visitor_stats, this]() noexcept
+            {
+                ice::arctic::trace_thread_name("arctic.visitor");
+                ice::arctic::SyntaxNode root{ .entity = SyntaxEntity::ROOT };
+                for (ice::u32 idx = 0; idx < _visitors.size(); ++idx)
+                {
+                    if (_visitors[idx]->accepts(SyntaxEntity::ROOT))
+                    {
+                        ice::arctic::MemoryScope const visitor_scope{ visitor_stats, idx };
+                        ice::arctic::TraceScope const visitor_trace{ "visit", to_string(SyntaxEntity::ROOT), idx };
+                        _visitors[idx]->visit(&root);
+                    }
+                }
+
+                ice::arctic::SyntaxNode const* node = pipeline.nodes.pop();
+                while (node != nullptr)
+                {
+                    for (ice::u32 idx = 0; idx < _visitors.size(); ++idx)
+                    {
+                        if (_visitors[idx]->accepts(node->entity))
+                        {
+                            ice::arctic::MemoryScope const visitor_scope{ visitor_stats, idx };
+                            ice::arctic::TraceScope const visitor_trace{ "visit", to_string(node->entity), idx };
+                            _visitors[idx]->visit(node);
+                        }
+                    }
+                    node = pipeline.nodes.pop();
+                }
+            }
+        };
+
+        _pipeline = &pipeline;
+
+        ice::arctic::Lexer pipeline_lexer = ice::arctic::detail::create_pipeline_lexer(pipeline);
+        ice::arctic::ParseState const result = parse_tokens(pipeline_lexer);
+
+        for (ice::arctic::SyntaxNode const* annotation : pipeline.pending_annotations)
+        {
+            pipeline.nodes.push(annotation);
+        }
+        pipeline.nodes.push(nullptr);
+
+        // The parser might stop before the end of the source, so the lexer thread can be blocked on a full queue.
+        pipeline.tokens.close();
+
+        lexer_thread.join();
+        visitor_thread.join();
+
+        _memory_stats.merge(lexer_stats);
+        _memory_stats.merge(visitor_stats);
+
+        _pipeline = nullptr;
+        return result;
+    }
+
+    void Parser::publish(ice::arctic::SyntaxNode const* node) noexcept
+    {
+        if (_pipeline == nullptr)
+        {
+            for (ice::u32 idx = 0; idx < _visitors.size(); ++idx)
+            {
+                if (_visitors[idx]->accepts(node->entity))
+                {
+                    ice::arctic::MemoryScope const visitor_scope{ _memory_stats, idx };
+                    ice::arctic::TraceScope const visitor_trace{ "visit", to_string(node->entity), idx };
+                    _visitors[idx]->visit(node);
+                }
+            }
+            return;
+        }
+
+        if (node->entity == SyntaxEntity::DEF_Annotation)
+        {
+            _pipeline->pending_annotations.push_back(node);
+            return;
+        }
+
+        for (ice::arctic::SyntaxNode const* annotation : _pipeline->pending_annotations)
+        {
+            _pipeline->nodes.push(annotation);
+        }
+        _pipeline->pending_annotations.clear();
+        _pipeline->nodes.push(node);
+    }
+
+} // namespace ice::arctic
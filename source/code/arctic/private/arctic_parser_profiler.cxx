@@ -0,0 +1,155 @@
+#include <ice/arctic_parser_profiler.hxx>
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <vector>
+
+namespace ice::arctic
+{
+
+#if ICE_ARCTIC_PARSER_PROFILING
+
+    namespace detail
+    {
+
+        static std::atomic<ice::arctic::ParserRuleProfile*> registered_rule_profiles = nullptr;
+
+        void register_rule_profile(ice::arctic::ParserRuleProfile& profile) noexcept
+        {
+            if (profile.registered.exchange(true, std::memory_order_acq_rel) == false)
+            {
+                profile.next = registered_rule_profiles.load(std::memory_order_relaxed);
+                while (registered_rule_profiles.compare_exchange_weak(profile.next, &profile, std::memory_order_release) == false)
+                {
+                }
+            }
+        }
+
+        ParserRuleScope::ParserRuleScope(ice::arctic::ParserRuleProfile& rule_profile) noexcept
+            : profile{ rule_profile }
+            , parent{ parser_rule_scope }
+            , start{ std::chrono::steady_clock::now() }
+            , recursive{ false }
+        {
+            ice::arctic::detail::register_rule_profile(profile);
+
+            // Recursive invocations are already included in the time of the outermost one.
+            for (ParserRuleScope const* scope = parent; scope != nullptr && recursive == false; scope = scope->parent)
+            {
+                recursive = &scope->profile == &profile;
+            }
+
+            parser_rule_scope = this;
+        }
+
+        ParserRuleScope::~ParserRuleScope() noexcept
+        {
+            if (recursive == false)
+            {
+                ice::u64 const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start
+                ).count();
+
+                profile.inclusive_ns.fetch_add(elapsed, std::memory_order_relaxed);
+            }
+
+            parser_rule_scope = parent;
+        }
+
+        auto sorted_rule_profiles() noexcept -> std::vector<ice::arctic::ParserRuleProfile const*>
+        {
+            std::vector<ice::arctic::ParserRuleProfile const*> result;
+            for (ParserRuleProfile const* profile = registered_rule_profiles.load(std::memory_order_acquire); profile != nullptr; profile = profile->next)
+            {
+                result.push_back(profile);
+            }
+
+            std::sort(result.begin(), result.end(), [](ParserRuleProfile const* left, ParserRuleProfile const* right) noexcept
+                {
+                    return left->inclusive_ns.load(std::memory_order_relaxed) > right->inclusive_ns.load(std::memory_order_relaxed);
+                }
+            );
+            return result;
+        }
+
+    } // namespace detail
+
+    auto parser_profile_table() noexcept -> std::string
+    {
+        std::string result = fmt::format(
+            "{:<32} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>12}\n",
+            "rule", "calls", "success", "failed", "repeats", "nodes+", "nodes-", "time [us]"
+        );
+
+        for (ice::arctic::ParserRuleProfile const* profile : ice::arctic::detail::sorted_rule_profiles())
+        {
+            result += fmt::format(
+                "{:<32} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>12.3f}\n",
+                profile->name,
+                profile->invocations.load(std::memory_order_relaxed),
+                profile->successes.load(std::memory_order_relaxed),
+                profile->failures.load(std::memory_order_relaxed),
+                profile->repeats.load(std::memory_order_relaxed),
+                profile->nodes_allocated.load(std::memory_order_relaxed),
+                profile->nodes_destroyed.load(std::memory_order_relaxed),
+                profile->inclusive_ns.load(std::memory_order_relaxed) / 1000.0
+            );
+        }
+        return result;
+    }
+
+    auto parser_profile_json() noexcept -> std::string
+    {
+        std::string result = "[";
+        for (ice::arctic::ParserRuleProfile const* profile : ice::arctic::detail::sorted_rule_profiles())
+        {
+            result += fmt::format(
+                "{}\n  {{ \"rule\": \"{}\", \"invocations\": {}, \"successes\": {}, \"failures\": {}, \"repeats\": {}, "
+                "\"nodes_allocated\": {}, \"nodes_destroyed\": {}, \"inclusive_ns\": {} }}",
+                result.size() > 1 ? "," : "",
+                profile->name,
+                profile->invocations.load(std::memory_order_relaxed),
+                profile->successes.load(std::memory_order_relaxed),
+                profile->failures.load(std::memory_order_relaxed),
+                profile->repeats.load(std::memory_order_relaxed),
+                profile->nodes_allocated.load(std::memory_order_relaxed),
+                profile->nodes_destroyed.load(std::memory_order_relaxed),
+                profile->inclusive_ns.load(std::memory_order_relaxed)
+            );
+        }
+        return result + "\n]\n";
+    }
+
+    void parser_profile_reset() noexcept
+    {
+        for (ParserRuleProfile* profile = detail::registered_rule_profiles.load(std::memory_order_acquire); profile != nullptr; profile = profile->next)
+        {
+            profile->invocations.store(0, std::memory_order_relaxed);
+            profile->successes.store(0, std::memory_order_relaxed);
+            profile->failures.store(0, std::memory_order_relaxed);
+            profile->repeats.store(0, std::memory_order_relaxed);
+            profile->nodes_allocated.store(0, std::memory_order_relaxed);
+            profile->nodes_destroyed.store(0, std::memory_order_relaxed);
+            profile->inclusive_ns.store(0, std::memory_order_relaxed);
+        }
+    }
+
+#else // #if ICE_ARCTIC_PARSER_PROFILING
+
+    auto parser_profile_table() noexcept -> std::string
+    {
+        return { };
+    }
+
+    auto parser_profile_json() noexcept -> std::string
+    {
+        return "[]\n";
+    }
+
+    void parser_profile_reset() noexcept
+    {
+    }
+
+#endif // #if ICE_ARCTIC_PARSER_PROFILING
+
+} // namespace ice::arctic
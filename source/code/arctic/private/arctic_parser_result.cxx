@@ -17,6 +17,28 @@ namespace ice::arctic
             CASE(Error_TypeOf_MissingTypeName);
             CASE(Error_TypeOf_MissingBracketOpen);
             CASE(Error_TypeOf_MissingBracketClose);
+            CASE(Error_Import_MissingPath);
+            CASE(Error_Import_NotFound);
+            CASE(Error_Import_Cycle);
+            CASE(Error_Import_ModuleFailed);
+            CASE(Error_Semantic_UnknownType);
+            CASE(Error_Semantic_UnknownSymbol);
+            CASE(Error_Semantic_UnknownMember);
+            CASE(Error_Semantic_DuplicateSymbol);
+            CASE(Error_Semantic_RecursiveType);
+            CASE(Error_Semantic_TypeMismatch);
+            CASE(Error_Semantic_NotConstant);
+            CASE(Error_Semantic_DivisionByZero);
+            CASE(Error_Bytecode_UnsupportedType);
+            CASE(Error_Bytecode_UnsupportedExpression);
+            CASE(Error_Bytecode_RecursiveCall);
+            CASE(Error_Bytecode_RegisterLimit);
+            CASE(Error_Bytecode_TableLimit);
+            CASE(Error_Limit_AllocatedBytes);
+            CASE(Error_Limit_NodeCount);
+            CASE(Error_Limit_ExpressionDepth);
+            CASE(Error_Limit_TokenCount);
+            CASE(Error_Limit_Time);
 #undef CASE
         }
         return "<???>";
@@ -0,0 +1,839 @@
+#include <ice/arctic_semantic.hxx>
+#include <ice/arctic_operand_list.hxx>
+
+#include <algorithm>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        struct BuiltinTypeInfo
+        {
+            ice::String name;
+            ice::arctic::TypeKind kind;
+            ice::arctic::TokenType scalar;
+            ice::u8 rows;
+            ice::u8 columns;
+        };
+
+        //! \note The first name of each type is used as its display name, ex.: 'f32' instead of 'float'.
+        static constexpr ice::arctic::detail::BuiltinTypeInfo Constant_BuiltinTypes[]{
+            { u8"void", TypeKind::Void, TokenType::NT_Void, 0, 0 },
+            { u8"bool", TypeKind::Scalar, TokenType::NT_Bool, 1, 1 },
+            { u8"f32", TypeKind::Scalar, TokenType::NT_f32, 1, 1 },
+            { u8"float", TypeKind::Scalar, TokenType::NT_f32, 1, 1 },
+            { u8"f64", TypeKind::Scalar, TokenType::NT_f64, 1, 1 },
+            { u8"double", TypeKind::Scalar, TokenType::NT_f64, 1, 1 },
+            { u8"i8", TypeKind::Scalar, TokenType::NT_i8, 1, 1 },
+            { u8"i16", TypeKind::Scalar, TokenType::NT_i16, 1, 1 },
+            { u8"i32", TypeKind::Scalar, TokenType::NT_i32, 1, 1 },
+            { u8"int", TypeKind::Scalar, TokenType::NT_i32, 1, 1 },
+            { u8"i64", TypeKind::Scalar, TokenType::NT_i64, 1, 1 },
+            { u8"u8", TypeKind::Scalar, TokenType::NT_u8, 1, 1 },
+            { u8"u16", TypeKind::Scalar, TokenType::NT_u16, 1, 1 },
+            { u8"u32", TypeKind::Scalar, TokenType::NT_u32, 1, 1 },
+            { u8"uint", TypeKind::Scalar, TokenType::NT_u32, 1, 1 },
+            { u8"u64", TypeKind::Scalar, TokenType::NT_u64, 1, 1 },
+
+            { u8"vec2b", TypeKind::Vector, TokenType::NT_Bool, 2, 1 },
+            { u8"vec3b", TypeKind::Vector, TokenType::NT_Bool, 3, 1 },
+            { u8"vec4b", TypeKind::Vector, TokenType::NT_Bool, 4, 1 },
+            { u8"vec2i", TypeKind::Vector, TokenType::NT_i32, 2, 1 },
+            { u8"vec3i", TypeKind::Vector, TokenType::NT_i32, 3, 1 },
+            { u8"vec4i", TypeKind::Vector, TokenType::NT_i32, 4, 1 },
+            { u8"vec2u", TypeKind::Vector, TokenType::NT_u32, 2, 1 },
+            { u8"vec3u", TypeKind::Vector, TokenType::NT_u32, 3, 1 },
+            { u8"vec4u", TypeKind::Vector, TokenType::NT_u32, 4, 1 },
+            { u8"vec2f", TypeKind::Vector, TokenType::NT_f32, 2, 1 },
+            { u8"vec3f", TypeKind::Vector, TokenType::NT_f32, 3, 1 },
+            { u8"vec4f", TypeKind::Vector, TokenType::NT_f32, 4, 1 },
+            { u8"vec2d", TypeKind::Vector, TokenType::NT_f64, 2, 1 },
+            { u8"vec3d", TypeKind::Vector, TokenType::NT_f64, 3, 1 },
+            { u8"vec4d", TypeKind::Vector, TokenType::NT_f64, 4, 1 },
+
+            { u8"mtx2f", TypeKind::Matrix, TokenType::NT_f32, 2, 2 },
+            { u8"mtx3f", TypeKind::Matrix, TokenType::NT_f32, 3, 3 },
+            { u8"mtx4f", TypeKind::Matrix, TokenType::NT_f32, 4, 4 },
+            { u8"mtx2d", TypeKind::Matrix, TokenType::NT_f64, 2, 2 },
+            { u8"mtx3d", TypeKind::Matrix, TokenType::NT_f64, 3, 3 },
+            { u8"mtx4d", TypeKind::Matrix, TokenType::NT_f64, 4, 4 },
+
+            { u8"VertexShader", TypeKind::Stage, TokenType::NT_Void, 0, 0 },
+            { u8"PixelShader", TypeKind::Stage, TokenType::NT_Void, 0, 0 },
+        };
+
+        constexpr auto structural_type_key(ice::arctic::TypeDesc const& desc) noexcept -> ice::u64
+        {
+            return (ice::u64(desc.kind) << 48)
+                | (ice::u64(desc.rows) << 40)
+                | (ice::u64(desc.columns) << 32)
+                | ice::u64(desc.scalar);
+        }
+
+        //! \returns The component index of a swizzle character or '4' if the character is not valid.
+        constexpr auto swizzle_component(ice::utf8 character) noexcept -> ice::u32
+        {
+            switch (character)
+            {
+            case u8'x': case u8'r': return 0;
+            case u8'y': case u8'g': return 1;
+            case u8'z': case u8'b': return 2;
+            case u8'w': case u8'a': return 3;
+            default: return 4;
+            }
+        }
+
+        //! \brief Token used to combine operands that follow each other without a binary operation.
+        //! \details Happens after unary operations, which store the following operation as their own child.
+        static constexpr ice::arctic::Token Constant_ImplicitOperation{
+            .value = u8"+",
+            .type = TokenType::OP_Plus,
+            .location = { }
+        };
+
+    } // namespace detail
+
+    auto TypeDesc::find_member(ice::String member_name) const noexcept -> ice::arctic::TypeMember const*
+    {
+        for (ice::arctic::TypeMember const& member : members)
+        {
+            if (member.name == member_name)
+            {
+                return &member;
+            }
+        }
+        return nullptr;
+    }
+
+    TypeTable::TypeTable() noexcept
+    {
+        for (ice::arctic::detail::BuiltinTypeInfo const& info : detail::Constant_BuiltinTypes)
+        {
+            ice::arctic::TypeHandle type = nullptr;
+            if (info.kind == TypeKind::Stage)
+            {
+                // Stages are distinct types sharing the same structure, so they can't be interned.
+                type = &_types.emplace_back(TypeDesc{ .kind = info.kind, .scalar = info.scalar, .name = info.name });
+            }
+            else
+            {
+                type = intern(TypeDesc{
+                    .kind = info.kind,
+                    .scalar = info.scalar,
+                    .rows = info.rows,
+                    .columns = info.columns,
+                    .name = info.name
+                });
+            }
+            _builtins.emplace(info.name, type);
+        }
+    }
+
+    auto TypeTable::scalar(ice::arctic::TokenType scalar) noexcept -> ice::arctic::TypeHandle
+    {
+        return intern(TypeDesc{ .kind = TypeKind::Scalar, .scalar = scalar, .rows = 1, .columns = 1 });
+    }
+
+    auto TypeTable::vector(ice::arctic::TokenType scalar, ice::u32 size) noexcept -> ice::arctic::TypeHandle
+    {
+        if (size == 1)
+        {
+            return this->scalar(scalar);
+        }
+        return intern(TypeDesc{ .kind = TypeKind::Vector, .scalar = scalar, .rows = ice::u8(size), .columns = 1 });
+    }
+
+    auto TypeTable::matrix(ice::arctic::TokenType scalar, ice::u32 rows, ice::u32 columns) noexcept -> ice::arctic::TypeHandle
+    {
+        if (columns == 1)
+        {
+            return this->vector(scalar, rows);
+        }
+        return intern(TypeDesc{ .kind = TypeKind::Matrix, .scalar = scalar, .rows = ice::u8(rows), .columns = ice::u8(columns) });
+    }
+
+    auto TypeTable::named(
+        ice::arctic::TypeKind kind,
+        ice::arctic::SyntaxNode const* definition,
+        ice::String name,
+        ice::arctic::TypeHandle base_type
+    ) noexcept -> ice::arctic::TypeHandle
+    {
+        auto const it = _named.find(definition);
+        if (it != _named.end())
+        {
+            return it->second;
+        }
+
+        ice::arctic::TypeDesc desc{ .kind = kind, .scalar = TokenType::NT_Void, .name = name, .definition = definition };
+        if (base_type != nullptr)
+        {
+            desc.scalar = base_type->scalar;
+            desc.rows = base_type->rows;
+            desc.columns = base_type->columns;
+            desc.members = base_type->members;
+        }
+
+        ice::arctic::TypeDesc* const result = &_types.emplace_back(desc);
+        _named.emplace(definition, result);
+        return result;
+    }
+
+    void TypeTable::set_members(ice::arctic::TypeHandle type, std::vector<ice::arctic::TypeMember> members) noexcept
+    {
+        auto const it = _named.find(type->definition);
+        if (it != _named.end())
+        {
+            it->second->members = _members.emplace_back(std::move(members));
+        }
+    }
+
+    auto TypeTable::find_builtin(ice::String name) const noexcept -> ice::arctic::TypeHandle
+    {
+        auto const it = _builtins.find(name);
+        return it == _builtins.end() ? nullptr : it->second;
+    }
+
+    auto TypeTable::intern(ice::arctic::TypeDesc const& desc) noexcept -> ice::arctic::TypeHandle
+    {
+        ice::u64 const key = detail::structural_type_key(desc);
+        auto const it = _structural.find(key);
+        if (it != _structural.end())
+        {
+            return it->second;
+        }
+
+        ice::arctic::TypeDesc* const result = &_types.emplace_back(desc);
+        _structural.emplace(key, result);
+        return result;
+    }
+
+    void SemanticModel::add_definitions(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept
+    {
+        for (ice::arctic::SyntaxNode const* definition : definitions)
+        {
+            if (definition != nullptr && definition->entity != SyntaxEntity::DEF_Annotation)
+            {
+                _definitions.push_back(definition);
+            }
+        }
+    }
+
+    auto SemanticModel::resolve() noexcept -> ice::arctic::ParseState
+    {
+        // Declare all globals first, definitions can reference each other in any order.
+        for (ice::arctic::SyntaxNode const* definition : _definitions)
+        {
+            switch (definition->entity)
+            {
+            case SyntaxEntity::DEF_Struct:
+            {
+                auto const* const node = static_cast<SyntaxNode_Struct const*>(definition);
+                ice::arctic::TypeHandle const type = _types.named(TypeKind::Struct, node, node->name.value);
+                declare(_globals, Symbol{ SymbolKind::Type, node->name.value, type, node }, node->name);
+                break;
+            }
+            case SyntaxEntity::DEF_TypeDef:
+            {
+                auto const* const node = static_cast<SyntaxNode_TypeDef const*>(definition);
+                declare(_globals, Symbol{ SymbolKind::Type, node->name.value, nullptr, node }, node->name);
+                break;
+            }
+            case SyntaxEntity::DEF_ContextVariable:
+            {
+                auto const* const node = static_cast<SyntaxNode_ContextVariable const*>(definition);
+                declare(_globals, Symbol{ SymbolKind::ContextVariable, node->name.value, nullptr, node }, node->name);
+                break;
+            }
+            case SyntaxEntity::DEF_Variable:
+            {
+                auto const* const node = static_cast<SyntaxNode_Variable const*>(definition);
+                SymbolKind const kind = node->is_const ? SymbolKind::Constant : SymbolKind::Variable;
+                declare(_globals, Symbol{ kind, node->name.value, nullptr, node }, node->name);
+                break;
+            }
+            case SyntaxEntity::DEF_Function:
+            {
+                auto const* const node = static_cast<SyntaxNode_Function const*>(definition);
+                declare(_globals, Symbol{ SymbolKind::Function, node->name.value, nullptr, node }, node->name);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        // Resolve all global types, function bodies can call any function so results need to be known first.
+        for (ice::arctic::SyntaxNode const* definition : _definitions)
+        {
+            auto const it = _node_symbols.find(definition);
+            if (it == _node_symbols.end())
+            {
+                continue;
+            }
+
+            ice::arctic::Symbol* const symbol = it->second;
+            switch (definition->entity)
+            {
+            case SyntaxEntity::DEF_Struct:
+                resolve_struct(static_cast<SyntaxNode_Struct const*>(definition));
+                break;
+            case SyntaxEntity::DEF_TypeDef:
+                resolve_typedef(static_cast<SyntaxNode_TypeDef const*>(definition));
+                break;
+            case SyntaxEntity::DEF_ContextVariable:
+                symbol->type = resolve_type_name(static_cast<SyntaxNode_ContextVariable const*>(definition)->type);
+                _node_types[definition] = symbol->type;
+                break;
+            case SyntaxEntity::DEF_Variable:
+                symbol->type = resolve_type_name(static_cast<SyntaxNode_Variable const*>(definition)->type);
+                _node_types[definition] = symbol->type;
+                break;
+            case SyntaxEntity::DEF_Function:
+                symbol->type = resolve_type_name(static_cast<SyntaxNode_Function const*>(definition)->result_type);
+                _node_types[definition] = symbol->type;
+                break;
+            default:
+                break;
+            }
+        }
+
+        for (ice::arctic::SyntaxNode const* definition : _definitions)
+        {
+            if (definition->entity == SyntaxEntity::DEF_Function)
+            {
+                resolve_function(static_cast<SyntaxNode_Function const*>(definition));
+            }
+            else if (definition->entity == SyntaxEntity::DEF_Variable)
+            {
+                resolve_initializer(static_cast<SyntaxNode_Variable const*>(definition), type_of(definition), _globals);
+            }
+        }
+
+        return _diagnostics.empty() ? ParseState::Success : _diagnostics.front().state;
+    }
+
+    auto SemanticModel::type_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::TypeHandle
+    {
+        auto const it = _node_types.find(node);
+        return it == _node_types.end() ? nullptr : it->second;
+    }
+
+    auto SemanticModel::operand_type_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::TypeHandle
+    {
+        ice::arctic::TypeHandle result = type_of(node);
+        for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+        {
+            if (child->entity == SyntaxEntity::EXP_GetMember)
+            {
+                result = type_of(child);
+            }
+        }
+        return result;
+    }
+
+    auto SemanticModel::symbol_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::Symbol const*
+    {
+        auto const it = _node_symbols.find(node);
+        return it == _node_symbols.end() ? nullptr : it->second;
+    }
+
+    auto SemanticModel::member_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::TypeMember const*
+    {
+        auto const it = _node_members.find(node);
+        return it == _node_members.end() ? nullptr : it->second;
+    }
+
+    auto SemanticModel::declare(
+        ice::arctic::SymbolScope& scope,
+        ice::arctic::Symbol symbol,
+        ice::arctic::Token const& name
+    ) noexcept -> ice::arctic::Symbol*
+    {
+        ice::arctic::Symbol* const result = &_symbols.emplace_back(symbol);
+        if (scope.declare(result) == false)
+        {
+            report(ParseState::Error_Semantic_DuplicateSymbol, name);
+        }
+        _node_symbols[symbol.definition] = result;
+        return result;
+    }
+
+    auto SemanticModel::resolve_type_name(ice::arctic::Token const& name) noexcept -> ice::arctic::TypeHandle
+    {
+        // User types are always global and can shadow builtin types.
+        ice::arctic::Symbol const* const symbol = _globals.find(name.value);
+        if (symbol != nullptr && symbol->kind == SymbolKind::Type)
+        {
+            ice::arctic::SyntaxNode const* const definition = symbol->definition;
+            if (_node_types.contains(definition) == false)
+            {
+                if (std::find(_resolving.begin(), _resolving.end(), definition) != _resolving.end())
+                {
+                    report(ParseState::Error_Semantic_RecursiveType, name);
+                    return nullptr;
+                }
+
+                if (definition->entity == SyntaxEntity::DEF_Struct)
+                {
+                    resolve_struct(static_cast<SyntaxNode_Struct const*>(definition));
+                }
+                else
+                {
+                    resolve_typedef(static_cast<SyntaxNode_TypeDef const*>(definition));
+                }
+            }
+            return symbol->type;
+        }
+
+        ice::arctic::TypeHandle const builtin = _types.find_builtin(name.value);
+        if (builtin == nullptr)
+        {
+            report(ParseState::Error_Semantic_UnknownType, name);
+        }
+        return builtin;
+    }
+
+    auto SemanticModel::resolve_typedef(ice::arctic::SyntaxNode_TypeDef const* node) noexcept -> ice::arctic::TypeHandle
+    {
+        ice::arctic::Symbol* const symbol = _node_symbols[node];
+        if (_node_types.contains(node))
+        {
+            return symbol->type;
+        }
+
+        _resolving.push_back(node);
+        ice::arctic::TypeHandle const base_type = resolve_type_name(node->base_type);
+        _resolving.pop_back();
+
+        // Aliases are the same type, 'typeof' creates a new type with the structure of the base type.
+        ice::arctic::TypeHandle type = base_type;
+        if (base_type != nullptr && node->is_alias == false)
+        {
+            type = _types.named(base_type->kind, node, node->name.value, base_type);
+        }
+
+        symbol->type = type;
+        _node_types[node] = type;
+        return type;
+    }
+
+    void SemanticModel::resolve_struct(ice::arctic::SyntaxNode_Struct const* node) noexcept
+    {
+        if (_node_types.contains(node))
+        {
+            return;
+        }
+
+        // Members are stored by value, so any struct reachable from its own members is an error.
+        _resolving.push_back(node);
+        std::vector<ice::arctic::TypeMember> members;
+        for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+        {
+            if (child->entity == SyntaxEntity::DEF_StructMember)
+            {
+                auto const* const member = static_cast<SyntaxNode_StructMember const*>(child);
+                ice::arctic::TypeHandle const member_type = resolve_type_name(member->type);
+                members.push_back(TypeMember{ member->name.value, member_type, member });
+                _node_types[member] = member_type;
+            }
+        }
+        _resolving.pop_back();
+
+        ice::arctic::TypeHandle const type = _node_symbols[node]->type;
+        _types.set_members(type, std::move(members));
+        _node_types[node] = type;
+    }
+
+    void SemanticModel::resolve_function(ice::arctic::SyntaxNode_Function const* node) noexcept
+    {
+        ice::arctic::SymbolScope& scope = _scopes.emplace_back(&_globals);
+        for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+        {
+            if (child->entity == SyntaxEntity::DEF_FunctionArgument)
+            {
+                auto const* const argument = static_cast<SyntaxNode_FunctionArgument const*>(child);
+                ice::arctic::TypeHandle const argument_type = resolve_type_name(argument->type);
+                declare(scope, Symbol{ SymbolKind::FunctionArgument, argument->name.value, argument_type, argument }, argument->name);
+                _node_types[argument] = argument_type;
+            }
+        }
+
+        ice::arctic::SyntaxNode const* const body = node->sibling;
+        if (body != nullptr && body->entity == SyntaxEntity::DEF_FunctionBody)
+        {
+            resolve_statements(body->child, scope);
+        }
+    }
+
+    void SemanticModel::resolve_statements(ice::arctic::SyntaxNode const* first, ice::arctic::SymbolScope& scope) noexcept
+    {
+        for (ice::arctic::SyntaxNode const* node = first; node != nullptr; node = node->sibling)
+        {
+            switch (node->entity)
+            {
+            case SyntaxEntity::DEF_Variable:
+            {
+                auto const* const variable = static_cast<SyntaxNode_Variable const*>(node);
+
+                // The initializer is resolved before the variable is declared, so it can't reference itself.
+                ice::arctic::TypeHandle const variable_type = resolve_type_name(variable->type);
+                resolve_initializer(variable, variable_type, scope);
+
+                SymbolKind const kind = variable->is_const ? SymbolKind::Constant : SymbolKind::Variable;
+                declare(scope, Symbol{ kind, variable->name.value, variable_type, variable }, variable->name);
+                _node_types[variable] = variable_type;
+                break;
+            }
+            case SyntaxEntity::DEF_ExplicitScope:
+                resolve_statements(node->child, _scopes.emplace_back(&scope));
+                break;
+            default:
+                resolve_operand(node, scope);
+                break;
+            }
+        }
+    }
+
+    void SemanticModel::resolve_initializer(
+        ice::arctic::SyntaxNode_Variable const* node,
+        ice::arctic::TypeHandle variable_type,
+        ice::arctic::SymbolScope const& scope
+    ) noexcept
+    {
+        if (node->child == nullptr)
+        {
+            return;
+        }
+
+        // Initializers are stored as an expression starting with the assignment operation.
+        ice::arctic::TypeHandle const initializer_type = resolve_operand(node->child, scope);
+        ice::arctic::SyntaxNode const* const assignment = node->child->child;
+        if (assignment != nullptr && assignment->entity == SyntaxEntity::EXP_BinaryOperation)
+        {
+            combine(variable_type, static_cast<SyntaxNode_ExpressionBinaryOperation const*>(assignment)->operation, initializer_type);
+        }
+    }
+
+    auto SemanticModel::resolve_expression(
+        ice::arctic::SyntaxNode const* parent,
+        ice::arctic::SymbolScope const& scope
+    ) noexcept -> ice::arctic::TypeHandle
+    {
+        // Building terms only reads the list, the tree is not modified.
+        ice::arctic::OperandList list;
+        if (list.build(const_cast<ice::arctic::SyntaxNode*>(parent)) == false)
+        {
+            return resolve_sequence(parent->child, scope);
+        }
+
+        // Terms are stored in evaluation order, so operand types are known before the terms using them.
+        ice::Span<ice::arctic::OperandTerm const> const terms = list.terms();
+        std::vector<ice::arctic::TypeHandle> types(terms.size(), nullptr);
+        for (ice::u32 idx = 0; idx < terms.size(); ++idx)
+        {
+            ice::arctic::OperandTerm const& term = terms[idx];
+            ice::arctic::SyntaxNode const* const node = list.items()[term.item].node;
+            switch (term.kind)
+            {
+            case OperandTermKind::Operand:
+                types[idx] = resolve_operand(node, scope);
+                break;
+            case OperandTermKind::Negate:
+                types[idx] = types[term.left];
+                _node_types[node] = types[idx];
+                break;
+            default:
+                // Assignments are right-associative, so the target is checked against the whole right side.
+                types[idx] = combine(
+                    types[term.left],
+                    static_cast<SyntaxNode_ExpressionBinaryOperation const*>(node)->operation,
+                    types[term.right]
+                );
+                break;
+            }
+        }
+        return types[list.root()];
+    }
+
+    auto SemanticModel::resolve_sequence(
+        ice::arctic::SyntaxNode const* first,
+        ice::arctic::SymbolScope const& scope
+    ) noexcept -> ice::arctic::TypeHandle
+    {
+        ice::arctic::TypeHandle result = nullptr;
+        ice::arctic::Token const* operation = nullptr;
+        bool has_operand = false;
+
+        for (ice::arctic::SyntaxNode const* node = first; node != nullptr; node = node->sibling)
+        {
+            if (node->entity == SyntaxEntity::EXP_BinaryOperation)
+            {
+                // Initializers start with the assignment operation, without a left operand.
+                if (has_operand)
+                {
+                    operation = &static_cast<SyntaxNode_ExpressionBinaryOperation const*>(node)->operation;
+                }
+                continue;
+            }
+
+            // All operands are resolved, even if the expression already failed, so each error is reported.
+            ice::arctic::TypeHandle const operand = resolve_operand(node, scope);
+            if (has_operand == false)
+            {
+                result = operand;
+                has_operand = true;
+            }
+            else
+            {
+                result = combine(result, operation != nullptr ? *operation : detail::Constant_ImplicitOperation, operand);
+            }
+            operation = nullptr;
+        }
+        return result;
+    }
+
+    auto SemanticModel::resolve_operand(
+        ice::arctic::SyntaxNode const* node,
+        ice::arctic::SymbolScope const& scope
+    ) noexcept -> ice::arctic::TypeHandle
+    {
+        switch (node->entity)
+        {
+        case SyntaxEntity::EXP_Value:
+        {
+            auto const* const value = static_cast<SyntaxNode_ExpressionValue const*>(node);
+
+            ice::arctic::TypeHandle type = nullptr;
+            if (value->value.type == TokenType::CT_Symbol)
+            {
+                ice::arctic::Symbol const* const symbol = scope.find(value->value.value);
+                if (symbol == nullptr)
+                {
+                    report(ParseState::Error_Semantic_UnknownSymbol, value->value);
+                    return nullptr;
+                }
+
+                _node_symbols[value] = _node_symbols[symbol->definition];
+                type = symbol->type;
+            }
+            else
+            {
+                type = literal_type(value->value);
+            }
+
+            _node_types[value] = type;
+            return resolve_members(value, type);
+        }
+        case SyntaxEntity::EXP_Call:
+        {
+            auto const* const call = static_cast<SyntaxNode_ExpressionCall const*>(node);
+            for (ice::arctic::SyntaxNode const* child = call->child; child != nullptr; child = child->sibling)
+            {
+                if (child->entity == SyntaxEntity::EXP_CallArg)
+                {
+                    _node_types[child] = resolve_expression(child, scope);
+                }
+            }
+
+            // Calls of types are constructors, ex.: 'vec4f(pos, 1)'.
+            ice::arctic::TypeHandle type = nullptr;
+            ice::arctic::Symbol const* const symbol = scope.find(call->function.value);
+            if (symbol != nullptr && (symbol->kind == SymbolKind::Function || symbol->kind == SymbolKind::Type))
+            {
+                _node_symbols[call] = _node_symbols[symbol->definition];
+                type = symbol->kind == SymbolKind::Type ? resolve_type_name(call->function) : symbol->type;
+            }
+            else if (symbol == nullptr)
+            {
+                type = _types.find_builtin(call->function.value);
+            }
+
+            if (type == nullptr)
+            {
+                report(ParseState::Error_Semantic_UnknownSymbol, call->function);
+                return nullptr;
+            }
+
+            _node_types[call] = type;
+            return resolve_members(call, type);
+        }
+        case SyntaxEntity::EXP_GetMember:
+        case SyntaxEntity::EXP_CallArg:
+            return nullptr;
+        default:
+        {
+            // Nested expressions, scopes, unary operations and branches only group other operands.
+            ice::arctic::TypeHandle const type = resolve_expression(node, scope);
+            _node_types[node] = type;
+            return type;
+        }
+        }
+    }
+
+    auto SemanticModel::resolve_members(
+        ice::arctic::SyntaxNode const* value,
+        ice::arctic::TypeHandle type
+    ) noexcept -> ice::arctic::TypeHandle
+    {
+        for (ice::arctic::SyntaxNode const* child = value->child; child != nullptr; child = child->sibling)
+        {
+            if (child->entity != SyntaxEntity::EXP_GetMember || type == nullptr)
+            {
+                continue;
+            }
+
+            auto const* const get_member = static_cast<SyntaxNode_ExpressionGetMember const*>(child);
+            ice::String const name = get_member->member.value;
+
+            ice::arctic::TypeHandle member_type = nullptr;
+            if (type->kind == TypeKind::Struct)
+            {
+                ice::arctic::TypeMember const* const member = type->find_member(name);
+                if (member != nullptr)
+                {
+                    _node_members[get_member] = member;
+                    member_type = member->type;
+                }
+            }
+            else if ((type->kind == TypeKind::Vector || type->kind == TypeKind::Scalar) && name.size() <= 4)
+            {
+                bool valid_swizzle = true;
+                for (ice::utf8 const character : name)
+                {
+                    valid_swizzle &= detail::swizzle_component(character) < type->rows;
+                }
+
+                if (valid_swizzle)
+                {
+                    member_type = _types.vector(type->scalar, ice::u32(name.size()));
+                }
+            }
+
+            if (member_type == nullptr)
+            {
+                report(ParseState::Error_Semantic_UnknownMember, get_member->member);
+            }
+
+            _node_types[get_member] = member_type;
+            type = member_type;
+        }
+        return type;
+    }
+
+    auto SemanticModel::result_type(
+        ice::arctic::TypeHandle left,
+        ice::arctic::TokenType operation,
+        ice::arctic::TypeHandle right
+    ) noexcept -> ice::arctic::TypeHandle
+    {
+        if (left == nullptr || right == nullptr)
+        {
+            return nullptr;
+        }
+
+        bool const left_scalar = left->kind == TypeKind::Scalar;
+        bool const right_scalar = right->kind == TypeKind::Scalar;
+
+        if (operation == TokenType::OP_Assign)
+        {
+            // Stage results are assigned from the value the stage outputs, ex.: 'VertexMain = vec4f(...)'.
+            // Other values need to have the same type, conversions are written as constructors, ex.: 'f32(count)'.
+            if (left != right && left->kind != TypeKind::Stage)
+            {
+                return nullptr;
+            }
+            return left;
+        }
+
+        if (operation == TokenType::OP_And || operation == TokenType::OP_Or)
+        {
+            return _types.scalar(TokenType::NT_Bool);
+        }
+
+        if (left == right)
+        {
+            return left;
+        }
+
+        // Scalars are never converted implicitly, the same as for the constant folder.
+        if (left_scalar && right_scalar)
+        {
+            return nullptr;
+        }
+
+        bool const left_numeric = left->kind == TypeKind::Vector || left->kind == TypeKind::Matrix;
+        bool const right_numeric = right->kind == TypeKind::Vector || right->kind == TypeKind::Matrix;
+        if (left_scalar && right_numeric && left->scalar == right->scalar)
+        {
+            return right;
+        }
+        if (left_numeric && right_scalar && left->scalar == right->scalar)
+        {
+            return left;
+        }
+
+        // Vectors are columns, so 'mtx * vec' transforms the vector and 'vec * mtx' multiplies with the transpose.
+        if (operation == TokenType::OP_Mul && left_numeric && right_numeric && left->scalar == right->scalar)
+        {
+            if (left->kind == TypeKind::Vector && right->kind == TypeKind::Matrix && left->rows == right->rows)
+            {
+                return _types.vector(left->scalar, right->columns);
+            }
+            if (left->kind == TypeKind::Matrix && left->columns == right->rows)
+            {
+                return _types.matrix(left->scalar, left->rows, right->columns);
+            }
+        }
+        return nullptr;
+    }
+
+    auto SemanticModel::combine(
+        ice::arctic::TypeHandle left,
+        ice::arctic::Token const& operation,
+        ice::arctic::TypeHandle right
+    ) noexcept -> ice::arctic::TypeHandle
+    {
+        // Errors of unresolved operands where already reported.
+        if (left == nullptr || right == nullptr)
+        {
+            return nullptr;
+        }
+
+        ice::arctic::TypeHandle const result = result_type(left, operation.type, right);
+        if (result == nullptr)
+        {
+            report(ParseState::Error_Semantic_TypeMismatch, operation);
+        }
+
+        // Mismatched assignments still have the type of their target, so following operands are checked against it.
+        return operation.type == TokenType::OP_Assign ? left : result;
+    }
+
+    auto SemanticModel::literal_type(ice::arctic::Token const& value) noexcept -> ice::arctic::TypeHandle
+    {
+        switch (value.type)
+        {
+        case TokenType::CT_Number:
+        case TokenType::CT_NumberHex:
+        case TokenType::CT_NumberOct:
+        case TokenType::CT_NumberBin:
+            return _types.scalar(TokenType::NT_i32);
+        case TokenType::CT_NumberFloat:
+            return _types.scalar(TokenType::NT_f32);
+        case TokenType::KW_True:
+        case TokenType::KW_False:
+            return _types.scalar(TokenType::NT_Bool);
+        default:
+            return nullptr;
+        }
+    }
+
+    void SemanticModel::report(ice::arctic::ParseState state, ice::arctic::Token const& token) noexcept
+    {
+        _diagnostics.push_back(ParseDiagnostic{ .state = state, .token = token, .expected = { }, .expected_count = 0 });
+    }
+
+} // namespace ice::arctic
@@ -0,0 +1,349 @@
+#include <ice/arctic_struct_layout.hxx>
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <unordered_set>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        constexpr auto layout_align_up(ice::u32 value, ice::u32 alignment) noexcept -> ice::u32
+        {
+            return alignment == 0 ? value : ((value + alignment - 1) / alignment) * alignment;
+        }
+
+        //! \brief Size of a register of HLSL constant buffers and the base alignment of 'Std140' arrays and structs.
+        static constexpr ice::u32 Constant_LayoutRegisterSize = 16;
+
+        inline auto layout_text(ice::String text) noexcept -> std::string_view
+        {
+            return { reinterpret_cast<char const*>(text.data()), text.size() };
+        }
+
+        constexpr auto layout_scalar_name(ice::arctic::TokenType scalar, ice::arctic::LayoutRules rules) noexcept -> std::string_view
+        {
+            switch (scalar)
+            {
+            case TokenType::NT_Bool: return rules == LayoutRules::Host ? "bool" : "ice::u32";
+            case TokenType::NT_f32: return "ice::f32";
+            case TokenType::NT_f64: return "ice::f64";
+            case TokenType::NT_i8: return "ice::i8";
+            case TokenType::NT_i16: return "ice::i16";
+            case TokenType::NT_i32: return "ice::i32";
+            case TokenType::NT_i64: return "ice::i64";
+            case TokenType::NT_u8:
+            case TokenType::NT_Utf8: return "ice::u8";
+            case TokenType::NT_u16: return "ice::u16";
+            case TokenType::NT_u32: return "ice::u32";
+            case TokenType::NT_u64: return "ice::u64";
+            default: return "ice::u8";
+            }
+        }
+
+        struct LayoutHeaderWriter
+        {
+            ice::arctic::StructLayoutTable& table;
+            std::u8string& out;
+            std::unordered_set<ice::arctic::TypeHandle> written;
+
+            template<typename... Args>
+            void append(fmt::format_string<Args...> format, Args&&... args) noexcept
+            {
+                std::string const text = fmt::format(format, std::forward<Args>(args)...);
+                out.append(reinterpret_cast<ice::utf8 const*>(text.data()), text.size());
+            }
+
+            void write(ice::arctic::TypeHandle type) noexcept
+            {
+                ice::arctic::StructLayout const* const layout = table.struct_layout(type);
+                if (layout == nullptr || written.insert(type).second == false)
+                {
+                    return;
+                }
+
+                // Nested structs need to be defined before they are used.
+                for (ice::arctic::MemberLayout const& member : layout->members)
+                {
+                    write(member.member->type);
+                }
+
+                std::string_view const suffix = ice::arctic::detail::layout_text(ice::arctic::layout_rules_suffix(table.rules()));
+                std::string_view const name = ice::arctic::detail::layout_text(type->name);
+                if (table.rules() == LayoutRules::Host)
+                {
+                    append("struct {}\n{{\n", name);
+                }
+                else
+                {
+                    append("struct alignas({}) {}{}\n{{\n", layout->layout.alignment, name, suffix);
+                }
+
+                ice::u32 offset = 0;
+                ice::u32 padding_count = 0;
+                for (ice::arctic::MemberLayout const& member : layout->members)
+                {
+                    if (member.offset > offset)
+                    {
+                        append("    ice::u8 _padding{}[{}];\n", padding_count++, member.offset - offset);
+                    }
+                    write_member(member);
+                    offset = member.offset + member.layout.size;
+                }
+
+                if (layout->layout.size > offset)
+                {
+                    append("    ice::u8 _padding{}[{}];\n", padding_count++, layout->layout.size - offset);
+                }
+
+                append("}};\n\n");
+                append("static_assert(sizeof({}{}) == {});\n", name, suffix, layout->layout.size);
+                append("static_assert(alignof({}{}) == {});\n", name, suffix, layout->layout.alignment);
+                for (ice::arctic::MemberLayout const& member : layout->members)
+                {
+                    append("static_assert(offsetof({}{}, {}) == {});\n",
+                        name, suffix, ice::arctic::detail::layout_text(member.member->name), member.offset
+                    );
+                }
+                append("\n");
+            }
+
+            void write_member(ice::arctic::MemberLayout const& member) noexcept
+            {
+                ice::arctic::TypeHandle const type = member.member->type;
+                std::string_view const member_name = ice::arctic::detail::layout_text(member.member->name);
+                std::string_view const scalar = ice::arctic::detail::layout_scalar_name(type->scalar, table.rules());
+
+                switch (type->kind)
+                {
+                case TypeKind::Scalar:
+                    append("    {} {};\n", scalar, member_name);
+                    break;
+                case TypeKind::Vector:
+                    append("    {} {}[{}];\n", scalar, member_name, type->rows);
+                    break;
+                case TypeKind::Matrix:
+                {
+                    ice::u32 const scalar_size = table.scalar_size(type->scalar);
+                    append("    {} {}[{}]; //!< {} columns, {} bytes apart.\n",
+                        scalar, member_name, member.layout.size / scalar_size, type->columns, member.column_stride
+                    );
+                    break;
+                }
+                default:
+                    append("    {}{} {};\n",
+                        ice::arctic::detail::layout_text(type->name),
+                        ice::arctic::detail::layout_text(ice::arctic::layout_rules_suffix(table.rules())),
+                        member_name
+                    );
+                    break;
+                }
+            }
+        };
+
+    } // namespace detail
+
+    StructLayoutTable::StructLayoutTable(ice::arctic::LayoutRules rules) noexcept
+        : _rules{ rules }
+    {
+    }
+
+    auto StructLayoutTable::type_layout(ice::arctic::TypeHandle type) noexcept -> ice::arctic::TypeLayout
+    {
+        if (type == nullptr)
+        {
+            return { };
+        }
+
+        switch (type->kind)
+        {
+        case TypeKind::Scalar:
+            return vector_layout(type->scalar, 1);
+        case TypeKind::Vector:
+            return vector_layout(type->scalar, type->rows);
+        case TypeKind::Matrix:
+        {
+            ice::arctic::TypeLayout const column = vector_layout(type->scalar, type->rows);
+            ice::u32 const stride = column_stride(type);
+            switch (_rules)
+            {
+            case LayoutRules::Std140:
+                return { type->columns * stride, std::max(column.alignment, detail::Constant_LayoutRegisterSize) };
+            case LayoutRules::HlslCBuffer:
+                // The last column doesn't need to fill its register, following values can be packed after it.
+                return { (type->columns - 1) * stride + column.size, detail::Constant_LayoutRegisterSize };
+            default:
+                return { type->columns * stride, column.alignment };
+            }
+        }
+        case TypeKind::Struct:
+        {
+            ice::arctic::StructLayout const* const layout = struct_layout(type);
+            return layout != nullptr ? layout->layout : ice::arctic::TypeLayout{ };
+        }
+        default:
+            return { };
+        }
+    }
+
+    auto StructLayoutTable::struct_layout(ice::arctic::TypeHandle type) noexcept -> ice::arctic::StructLayout const*
+    {
+        if (type == nullptr || type->kind != TypeKind::Struct)
+        {
+            return nullptr;
+        }
+
+        auto const it = _layouts.find(type);
+        if (it != _layouts.end())
+        {
+            return it->second;
+        }
+
+        if (std::find(_visiting.begin(), _visiting.end(), type) != _visiting.end())
+        {
+            return nullptr;
+        }
+
+        _visiting.push_back(type);
+        std::vector<ice::arctic::MemberLayout> members;
+        ice::u32 offset = 0;
+        ice::u32 alignment = 1;
+        bool is_valid = type->members.empty() == false;
+        for (ice::arctic::TypeMember const& member : type->members)
+        {
+            ice::arctic::TypeLayout const layout = type_layout(member.type);
+            if (layout.size == 0)
+            {
+                is_valid = false;
+                break;
+            }
+
+            ice::u32 const member_offset = place(offset, member.type, layout);
+            members.push_back({
+                .member = &member,
+                .offset = member_offset,
+                .layout = layout,
+                .column_stride = column_stride(member.type)
+            });
+
+            offset = member_offset + layout.size;
+            alignment = std::max(alignment, layout.alignment);
+        }
+        _visiting.pop_back();
+
+        ice::arctic::StructLayout const* result = nullptr;
+        if (is_valid)
+        {
+            // Values following a struct start at a new register, in both 'Std140' and constant buffers.
+            if (_rules == LayoutRules::Std140 || _rules == LayoutRules::HlslCBuffer)
+            {
+                alignment = std::max(alignment, detail::Constant_LayoutRegisterSize);
+            }
+
+            result = &_structs.emplace_back(StructLayout{
+                .type = type,
+                .rules = _rules,
+                .layout = { detail::layout_align_up(offset, alignment), alignment },
+                .members = _members.emplace_back(std::move(members))
+            });
+        }
+
+        _layouts.emplace(type, result);
+        return result;
+    }
+
+    auto StructLayoutTable::column_stride(ice::arctic::TypeHandle type) const noexcept -> ice::u32
+    {
+        if (type == nullptr || type->kind != TypeKind::Matrix)
+        {
+            return 0;
+        }
+
+        ice::arctic::TypeLayout const column = vector_layout(type->scalar, type->rows);
+        switch (_rules)
+        {
+        case LayoutRules::Host:
+            return column.size;
+        case LayoutRules::Std140:
+        case LayoutRules::HlslCBuffer:
+            return detail::layout_align_up(column.size, std::max(column.alignment, detail::Constant_LayoutRegisterSize));
+        default:
+            return detail::layout_align_up(column.size, column.alignment);
+        }
+    }
+
+    auto StructLayoutTable::scalar_size(ice::arctic::TokenType scalar) const noexcept -> ice::u32
+    {
+        switch (scalar)
+        {
+        case TokenType::NT_Bool: return _rules == LayoutRules::Host ? 1 : 4;
+        case TokenType::NT_i8:
+        case TokenType::NT_u8:
+        case TokenType::NT_Utf8: return 1;
+        case TokenType::NT_i16:
+        case TokenType::NT_u16: return 2;
+        case TokenType::NT_f32:
+        case TokenType::NT_i32:
+        case TokenType::NT_u32: return 4;
+        case TokenType::NT_f64:
+        case TokenType::NT_i64:
+        case TokenType::NT_u64: return 8;
+        default: return 0;
+        }
+    }
+
+    auto StructLayoutTable::vector_layout(ice::arctic::TokenType scalar, ice::u32 size) const noexcept -> ice::arctic::TypeLayout
+    {
+        ice::u32 const component = scalar_size(scalar);
+        if (_rules == LayoutRules::Host || _rules == LayoutRules::HlslCBuffer || size == 1)
+        {
+            return { component * size, component };
+        }
+
+        // GLSL aligns three component vectors like four component ones.
+        return { component * size, component * (size == 2 ? 2 : 4) };
+    }
+
+    auto StructLayoutTable::place(
+        ice::u32 offset,
+        ice::arctic::TypeHandle type,
+        ice::arctic::TypeLayout layout
+    ) const noexcept -> ice::u32
+    {
+        ice::u32 result = detail::layout_align_up(offset, layout.alignment);
+        if (_rules == LayoutRules::HlslCBuffer
+            && (type->kind == TypeKind::Scalar || type->kind == TypeKind::Vector)
+            && (result % detail::Constant_LayoutRegisterSize) + layout.size > detail::Constant_LayoutRegisterSize)
+        {
+            result = detail::layout_align_up(result, detail::Constant_LayoutRegisterSize);
+        }
+        return result;
+    }
+
+    auto layout_rules_suffix(ice::arctic::LayoutRules rules) noexcept -> ice::String
+    {
+        switch (rules)
+        {
+        case LayoutRules::Std140: return u8"_std140";
+        case LayoutRules::Std430: return u8"_std430";
+        case LayoutRules::HlslCBuffer: return u8"_cbuffer";
+        default: return u8"";
+        }
+    }
+
+    void write_layout_header(
+        ice::arctic::StructLayoutTable& table,
+        ice::Span<ice::arctic::TypeHandle const> types,
+        std::u8string& out
+    ) noexcept
+    {
+        ice::arctic::detail::LayoutHeaderWriter writer{ .table = table, .out = out, .written = { } };
+        for (ice::arctic::TypeHandle const type : types)
+        {
+            writer.write(type);
+        }
+    }
+
+} // namespace ice::arctic
@@ -0,0 +1,630 @@
+#include <ice/arctic_subexpression_eliminator.hxx>
+#include <ice/arctic_syntax_walker.hxx>
+
+#include <fmt/format.h>
+#include <algorithm>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        enum class ValueKey : char
+        {
+            Literal = 'L',
+            Symbol = 'S',
+            Call = 'C',
+            Member = 'M',
+            Negate = 'N',
+            Binary = 'B',
+        };
+
+        template<typename T>
+        void append_value_key(std::string& key, T value) noexcept
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            key.append(reinterpret_cast<char const*>(&value), sizeof(T));
+        }
+
+        void append_value_key_text(std::string& key, ice::String text) noexcept
+        {
+            ice::arctic::detail::append_value_key(key, ice::u32(text.size()));
+            key.append(reinterpret_cast<char const*>(text.data()), text.size());
+        }
+
+        //! \returns 'true' for calls of builtin or named types, these only construct values from their arguments.
+        bool is_constructor_call(ice::arctic::SemanticModel const& model, ice::arctic::SyntaxNode const* call) noexcept
+        {
+            ice::arctic::Symbol const* const symbol = model.symbol_of(call);
+            return symbol != nullptr ? symbol->kind == SymbolKind::Type : model.type_of(call) != nullptr;
+        }
+
+        //! \brief Finds the assigned variables and function calls of a statement, including nested scopes.
+        struct StatementEffects
+        {
+            ice::arctic::SemanticModel const& model;
+            std::vector<ice::arctic::SyntaxNode const*> targets;
+            bool has_calls = false;
+
+            void enter(ice::arctic::SyntaxNode_ExpressionCall const* node) noexcept
+            {
+                has_calls |= ice::arctic::detail::is_constructor_call(model, node) == false;
+                find_targets(node);
+            }
+
+            template<typename Node>
+            void enter(Node const* node) noexcept
+            {
+                find_targets(node);
+            }
+
+            // Operand lists are stored as siblings, each value followed by an assignment is a target, ex.: 'a = b = c'.
+            void find_targets(ice::arctic::SyntaxNode const* node) noexcept
+            {
+                for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+                {
+                    ice::arctic::SyntaxNode const* const next = child->sibling;
+                    if (child->entity == SyntaxEntity::EXP_Value
+                        && next != nullptr
+                        && next->entity == SyntaxEntity::EXP_BinaryOperation
+                        && static_cast<SyntaxNode_ExpressionBinaryOperation const*>(next)->operation.type == TokenType::OP_Assign)
+                    {
+                        targets.push_back(child);
+                    }
+                }
+            }
+        };
+
+        struct LocalNames
+        {
+            std::unordered_set<ice::String>& names;
+
+            void enter(ice::arctic::SyntaxNode_Variable const* node) noexcept
+            {
+                names.insert(node->name.value);
+            }
+
+            void enter(ice::arctic::SyntaxNode_FunctionArgument const* node) noexcept
+            {
+                names.insert(node->name.value);
+            }
+        };
+
+        //! \brief Value number and type of a single term of an operand list.
+        struct NumberedTerm
+        {
+            ice::u32 value;
+            ice::arctic::TypeHandle type;
+
+            //! \brief Set if the term contains an operation, a constructor call or a member access.
+            bool has_work;
+        };
+
+    } // namespace detail
+
+    SubexpressionEliminator::SubexpressionEliminator(
+        ice::arctic::SyntaxNodeAllocator& alloc,
+        ice::arctic::SemanticModel& model
+    ) noexcept
+        : _alloc{ alloc }
+        , _model{ model }
+    {
+    }
+
+    auto SubexpressionEliminator::eliminate(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept -> ice::u32
+    {
+        _globals.insert(definitions.begin(), definitions.end());
+
+        ice::u32 const first_variable = _variable_count;
+        for (ice::arctic::SyntaxNode const* definition : definitions)
+        {
+            if (definition->entity != SyntaxEntity::DEF_Function || definition->sibling == nullptr)
+            {
+                continue;
+            }
+
+            // New variables are local, they only need to differ from names used by this function.
+            _local_names.clear();
+            if (ice::arctic::walk(definition, ice::arctic::detail::LocalNames{ _local_names }) == WalkResult::DepthExceeded)
+            {
+                ice::arctic::walk_unbounded(definition, ice::arctic::detail::LocalNames{ _local_names });
+            }
+
+            // The tree is owned by the allocator, definitions are only const for visitors.
+            eliminate_block(const_cast<ice::arctic::SyntaxNode*>(definition->sibling));
+        }
+        return _variable_count - first_variable;
+    }
+
+    void SubexpressionEliminator::eliminate_block(ice::arctic::SyntaxNode* block) noexcept
+    {
+        // Each pass replaces the largest repeated term, smaller terms can repeat in the new initializer.
+        while (eliminate_once(block))
+        {
+        }
+
+        for (ice::arctic::SyntaxNode* node = block->child; node != nullptr; node = node->sibling)
+        {
+            if (node->entity == SyntaxEntity::DEF_ExplicitScope)
+            {
+                eliminate_block(node);
+            }
+        }
+    }
+
+    bool SubexpressionEliminator::eliminate_once(ice::arctic::SyntaxNode* block) noexcept
+    {
+        _lists.clear();
+        _keys.clear();
+        _occurrences.clear();
+        _versions.clear();
+        _next_value = 0;
+        _call_epoch = 0;
+
+        std::vector<ice::arctic::SyntaxNode**> statements;
+        for (ice::arctic::SyntaxNode** link = &block->child; *link != nullptr; link = &(*link)->sibling)
+        {
+            ice::arctic::SyntaxNode* const node = *link;
+            ice::u32 const statement = ice::u32(statements.size());
+            statements.push_back(link);
+
+            // Missing a single assignment would merge values across it, deep statements are walked again without a depth limit.
+            ice::arctic::detail::StatementEffects effects{ .model = _model, .targets = { }, .has_calls = false };
+            if (ice::arctic::walk(static_cast<ice::arctic::SyntaxNode const*>(node), effects) == WalkResult::DepthExceeded)
+            {
+                effects.targets.clear();
+                effects.has_calls = false;
+                ice::arctic::walk_unbounded(static_cast<ice::arctic::SyntaxNode const*>(node), effects);
+            }
+
+            // Globals read in the same statement as a call could be written by it before or after the read.
+            _opaque_globals = effects.has_calls;
+            switch (node->entity)
+            {
+            case SyntaxEntity::DEF_Variable:
+                if (node->child != nullptr)
+                {
+                    number_list(node->child, statement, static_cast<ice::arctic::SyntaxNode_Variable const*>(node));
+                }
+                break;
+            case SyntaxEntity::EXP_Expression:
+                number_list(node, statement);
+                break;
+            case SyntaxEntity::DEF_ExplicitScope:
+                // Nested blocks are handled on their own, only their assignments matter here.
+                break;
+            default:
+                number_operand(node, statement);
+                break;
+            }
+            _opaque_globals = false;
+
+            for (ice::arctic::SyntaxNode const* target : effects.targets)
+            {
+                ice::arctic::SyntaxNode const* const definition = definition_of(target);
+                if (definition != nullptr)
+                {
+                    _versions[definition] += 1;
+                }
+            }
+
+            if (effects.has_calls)
+            {
+                _call_epoch += 1;
+            }
+        }
+
+        // Values are only numbered once per block, pick the largest repeated term and start over after replacing it.
+        std::vector<Occurrence> const* best = nullptr;
+        for (auto const& [value, occurrences] : _occurrences)
+        {
+            if (occurrences.size() < 2)
+            {
+                continue;
+            }
+
+            if (best == nullptr
+                || occurrences[0].size > (*best)[0].size
+                || (occurrences[0].size == (*best)[0].size && occurrences[0].list < (*best)[0].list)
+                || (occurrences[0].size == (*best)[0].size && occurrences[0].list == (*best)[0].list && occurrences[0].term < (*best)[0].term))
+            {
+                best = &occurrences;
+            }
+        }
+
+        if (best == nullptr)
+        {
+            return false;
+        }
+
+        rewrite(*best, statements);
+        return true;
+    }
+
+    auto SubexpressionEliminator::number_list(
+        ice::arctic::SyntaxNode* parent,
+        ice::u32 statement,
+        ice::arctic::SyntaxNode_Variable const* holder
+    ) noexcept -> ice::u32
+    {
+        ice::u32 const list_idx = ice::u32(_lists.size());
+        NumberedList& numbered = _lists.emplace_back(NumberedList{ .list = { }, .statement = statement });
+
+        ice::arctic::OperandList& list = numbered.list;
+        if (list.build(parent) == false)
+        {
+            for (ice::arctic::OperandItem const& item : list.items())
+            {
+                if (item.kind == OperandItemKind::Operand)
+                {
+                    number_operand(item.node, statement);
+                }
+            }
+            return number_unique();
+        }
+
+        ice::Span<ice::arctic::OperandItem const> const items = list.items();
+        ice::Span<ice::arctic::OperandTerm const> const terms = list.terms();
+
+        // Targets of assignments are written, not read, so they are never shared.
+        std::vector<bool> targets(items.size(), false);
+        for (ice::arctic::OperandTerm const& term : terms)
+        {
+            if (term.kind == OperandTermKind::Binary
+                && static_cast<SyntaxNode_ExpressionBinaryOperation const*>(items[term.item].node)->operation.type == TokenType::OP_Assign)
+            {
+                ice::arctic::OperandTerm const& target = terms[term.left];
+                std::fill(targets.begin() + target.first, targets.begin() + target.last + 1, true);
+            }
+        }
+
+        std::vector<ice::arctic::detail::NumberedTerm> values(terms.size());
+        for (ice::u32 idx = 0; idx < terms.size(); ++idx)
+        {
+            ice::arctic::OperandTerm const& term = terms[idx];
+            ice::arctic::detail::NumberedTerm& result = values[idx];
+
+            std::string key;
+            bool is_nested = false;
+            if (term.kind == OperandTermKind::Operand)
+            {
+                ice::arctic::SyntaxNode* const node = items[term.item].node;
+                result.value = targets[term.item] ? number_unique() : number_operand(node, statement);
+                result.type = operand_type(node);
+                result.has_work = (node->entity == SyntaxEntity::EXP_Call && ice::arctic::detail::is_constructor_call(_model, node))
+                    || node->entity == SyntaxEntity::EXP_Expression
+                    || node->entity == SyntaxEntity::EXP_ExplicitScope
+                    || (node->entity == SyntaxEntity::EXP_Value && node->child != nullptr);
+
+                // Nested lists share the number of their own root term, which is already recorded.
+                is_nested = node->entity == SyntaxEntity::EXP_Expression || node->entity == SyntaxEntity::EXP_ExplicitScope;
+            }
+            else if (term.kind == OperandTermKind::Negate)
+            {
+                ice::arctic::detail::append_value_key(key, detail::ValueKey::Negate);
+                ice::arctic::detail::append_value_key(key, values[term.left].value);
+                result.value = number_key(key);
+                result.type = values[term.left].type;
+                result.has_work = values[term.left].has_work;
+            }
+            else
+            {
+                ice::arctic::TokenType const operation = static_cast<SyntaxNode_ExpressionBinaryOperation const*>(
+                    items[term.item].node
+                )->operation.type;
+
+                ice::arctic::detail::NumberedTerm const& left = values[term.left];
+                ice::arctic::detail::NumberedTerm const& right = values[term.right];
+                if (operation == TokenType::OP_Assign)
+                {
+                    result.value = number_unique();
+                    result.type = nullptr;
+                    result.has_work = false;
+                }
+                else
+                {
+                    ice::arctic::detail::append_value_key(key, detail::ValueKey::Binary);
+                    ice::arctic::detail::append_value_key(key, operation);
+                    ice::arctic::detail::append_value_key(key, left.value);
+                    ice::arctic::detail::append_value_key(key, right.value);
+                    result.value = number_key(key);
+                    result.type = _model.result_type(left.type, operation, right.type);
+                    result.has_work = true;
+                }
+            }
+
+            bool const is_shareable = result.has_work
+                && is_nested == false
+                && targets[term.first] == false
+                && result.type != nullptr
+                && result.type->kind != TypeKind::Void
+                && result.type->kind != TypeKind::Stage
+                && result.type->name.empty() == false;
+
+            if (is_shareable)
+            {
+                // Only the local initialized with the whole list holds the value of a term.
+                ice::arctic::SyntaxNode_Variable const* const term_holder = idx == list.root() ? holder : nullptr;
+
+                std::vector<Occurrence>& occurrences = _occurrences[result.value];
+                ice::arctic::SyntaxNode_Variable const* const first_holder = occurrences.empty()
+                    ? term_holder
+                    : occurrences[0].holder;
+
+                occurrences.push_back({
+                    .list = list_idx,
+                    .term = idx,
+                    .size = term.last - term.first + 1,
+                    .type = result.type,
+                    .holder = term_holder,
+                    .holder_valid = first_holder != nullptr && _versions[first_holder] == 0,
+                });
+            }
+        }
+        return values[list.root()].value;
+    }
+
+    auto SubexpressionEliminator::number_operand(ice::arctic::SyntaxNode* node, ice::u32 statement) noexcept -> ice::u32
+    {
+        std::string key;
+        switch (node->entity)
+        {
+        case SyntaxEntity::EXP_Value:
+        {
+            ice::arctic::Token const& value = static_cast<SyntaxNode_ExpressionValue const*>(node)->value;
+            if (value.type == TokenType::CT_Symbol)
+            {
+                return number_symbol(node);
+            }
+
+            ice::arctic::detail::append_value_key(key, detail::ValueKey::Literal);
+            ice::arctic::detail::append_value_key(key, value.type);
+            ice::arctic::detail::append_value_key_text(key, value.value);
+            return number_key(key);
+        }
+        case SyntaxEntity::EXP_Call:
+        {
+            // Arguments are numbered even for function calls, so repeated arguments can be shared.
+            std::vector<ice::u32> arguments;
+            for (ice::arctic::SyntaxNode* argument = node->child; argument != nullptr; argument = argument->sibling)
+            {
+                if (argument->entity == SyntaxEntity::EXP_CallArg)
+                {
+                    arguments.push_back(number_list(argument, statement));
+                }
+            }
+
+            if (ice::arctic::detail::is_constructor_call(_model, node) == false)
+            {
+                return number_unique();
+            }
+
+            // Types are hash-consed, so constructors of the same type share the handle.
+            ice::arctic::detail::append_value_key(key, detail::ValueKey::Call);
+            ice::arctic::detail::append_value_key(key, _model.type_of(node));
+            for (ice::u32 const argument : arguments)
+            {
+                ice::arctic::detail::append_value_key(key, argument);
+            }
+            break;
+        }
+        case SyntaxEntity::EXP_Expression:
+        case SyntaxEntity::EXP_ExplicitScope:
+            // Parentheses don't change the value, the list is shared on its own.
+            return number_list(node, statement);
+        default:
+            return number_unique();
+        }
+
+        for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+        {
+            if (child->entity == SyntaxEntity::EXP_GetMember)
+            {
+                ice::arctic::detail::append_value_key(key, detail::ValueKey::Member);
+                ice::arctic::detail::append_value_key_text(key, static_cast<SyntaxNode_ExpressionGetMember const*>(child)->member.value);
+            }
+        }
+        return number_key(key);
+    }
+
+    auto SubexpressionEliminator::number_symbol(ice::arctic::SyntaxNode const* node) noexcept -> ice::u32
+    {
+        ice::arctic::SyntaxNode const* const definition = definition_of(node);
+        if (definition == nullptr)
+        {
+            return number_unique();
+        }
+
+        // Global constants never change, other globals can be written by any called function.
+        ice::arctic::Symbol const* const symbol = _model.symbol_of(node);
+        bool const is_shared = _globals.contains(definition) && (symbol == nullptr || symbol->kind != SymbolKind::Constant);
+        if (is_shared && _opaque_globals)
+        {
+            return number_unique();
+        }
+
+        auto const version = _versions.find(definition);
+
+        std::string key;
+        ice::arctic::detail::append_value_key(key, detail::ValueKey::Symbol);
+        ice::arctic::detail::append_value_key(key, definition);
+        ice::arctic::detail::append_value_key(key, version != _versions.end() ? version->second : 0u);
+        ice::arctic::detail::append_value_key(key, is_shared ? _call_epoch : 0u);
+        for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+        {
+            if (child->entity == SyntaxEntity::EXP_GetMember)
+            {
+                ice::arctic::detail::append_value_key(key, detail::ValueKey::Member);
+                ice::arctic::detail::append_value_key_text(key, static_cast<SyntaxNode_ExpressionGetMember const*>(child)->member.value);
+            }
+        }
+        return number_key(key);
+    }
+
+    auto SubexpressionEliminator::number_key(std::string const& key) noexcept -> ice::u32
+    {
+        auto const [it, inserted] = _keys.emplace(key, _next_value);
+        if (inserted)
+        {
+            _next_value += 1;
+        }
+        return it->second;
+    }
+
+    auto SubexpressionEliminator::number_unique() noexcept -> ice::u32
+    {
+        return _next_value++;
+    }
+
+    auto SubexpressionEliminator::operand_type(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::TypeHandle
+    {
+        auto const it = _references.find(node);
+        return it != _references.end() ? it->second.type : _model.operand_type_of(node);
+    }
+
+    auto SubexpressionEliminator::definition_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::SyntaxNode const*
+    {
+        auto const it = _references.find(node);
+        if (it != _references.end())
+        {
+            return it->second.definition;
+        }
+
+        ice::arctic::Symbol const* const symbol = _model.symbol_of(node);
+        return symbol != nullptr ? symbol->definition : nullptr;
+    }
+
+    void SubexpressionEliminator::rewrite(
+        std::vector<Occurrence> const& occurrences,
+        std::vector<ice::arctic::SyntaxNode**> const& statements
+    ) noexcept
+    {
+        Occurrence const& first = occurrences[0];
+        ice::arctic::OperandList& first_list = _lists[first.list].list;
+        ice::arctic::OperandTerm const first_term = first_list.terms()[first.term];
+        ice::arctic::TokenLocation const location = ice::arctic::operand_location(first_list.items()[first_term.first].node);
+
+        bool const use_holder = first.holder != nullptr && std::all_of(occurrences.begin() + 1, occurrences.end(),
+            [](Occurrence const& occurrence) noexcept { return occurrence.holder_valid; }
+        );
+
+        // Items of the first occurrence are moved into the new variable, all others are released.
+        std::unordered_set<ice::arctic::SyntaxNode const*> moved;
+        ice::arctic::SyntaxNode const* definition = first.holder;
+        ice::String name;
+        if (use_holder)
+        {
+            name = first.holder->name.value;
+        }
+        else
+        {
+            for (ice::u32 idx = first_term.first; idx <= first_term.last; ++idx)
+            {
+                moved.insert(first_list.items()[idx].node);
+            }
+
+            ice::arctic::SyntaxNode_Variable* const variable = create_variable(first_list.link_term(first.term), first.type, location);
+            ice::arctic::SyntaxNode** const link = statements[_lists[first.list].statement];
+            variable->sibling = *link;
+            *link = variable;
+
+            definition = variable;
+            name = variable->name.value;
+        }
+
+        std::unordered_map<ice::u32, std::vector<ice::arctic::OperandReplacement>> replacements;
+        for (Occurrence const& occurrence : occurrences)
+        {
+            if (use_holder && &occurrence == &first)
+            {
+                continue;
+            }
+
+            replacements[occurrence.list].push_back({
+                .term = occurrence.term,
+                .node = create_reference(definition, name, occurrence.type, location)
+            });
+        }
+
+        std::vector<ice::arctic::OperandItem> removed;
+        for (auto const& [list, list_replacements] : replacements)
+        {
+            _lists[list].list.replace(list_replacements, removed);
+            _replaced_count += ice::u32(list_replacements.size());
+        }
+
+        for (ice::arctic::OperandItem const& item : removed)
+        {
+            if (moved.contains(item.node) == false)
+            {
+                release(item.node, item.kind == OperandItemKind::Operand);
+            }
+        }
+    }
+
+    auto SubexpressionEliminator::create_reference(
+        ice::arctic::SyntaxNode const* definition,
+        ice::String name,
+        ice::arctic::TypeHandle type,
+        ice::arctic::TokenLocation location
+    ) noexcept -> ice::arctic::SyntaxNode*
+    {
+        ice::arctic::SyntaxNode_ExpressionValue* const reference = _alloc.create<SyntaxNode_ExpressionValue>();
+        reference->value = ice::arctic::Token{ .value = name, .type = TokenType::CT_Symbol, .location = location };
+        _references.emplace(reference, Reference{ .definition = definition, .type = type });
+        return reference;
+    }
+
+    auto SubexpressionEliminator::create_variable(
+        ice::arctic::SyntaxNode* initializer,
+        ice::arctic::TypeHandle type,
+        ice::arctic::TokenLocation location
+    ) noexcept -> ice::arctic::SyntaxNode_Variable*
+    {
+        std::u8string name;
+        do
+        {
+            std::string const text = fmt::format("common_value_{}", _name_index++);
+            name.assign(text.begin(), text.end());
+        } while (_model.globals().find(name) != nullptr || _local_names.contains(name));
+
+        std::u8string const& stored_name = _names.emplace_back(std::move(name));
+        _local_names.insert(stored_name);
+
+        // Initializers are stored as an expression starting with the assignment operation.
+        ice::arctic::SyntaxNode_ExpressionBinaryOperation* const assignment = _alloc.create<SyntaxNode_ExpressionBinaryOperation>();
+        assignment->operation = ice::arctic::Token{ .value = u8"=", .type = TokenType::OP_Assign, .location = location };
+        assignment->sibling = initializer;
+
+        ice::arctic::SyntaxNode_Expression* const expression = _alloc.create<SyntaxNode_Expression>();
+        expression->child = assignment;
+
+        ice::arctic::SyntaxNode_Variable* const variable = _alloc.create<SyntaxNode_Variable>();
+        variable->name = ice::arctic::Token{ .value = stored_name, .type = TokenType::CT_Symbol, .location = location };
+        variable->type = ice::arctic::Token{ .value = type->name, .type = TokenType::CT_Symbol, .location = location };
+        variable->is_const = false;
+        variable->child = expression;
+
+        _variable_count += 1;
+        return variable;
+    }
+
+    void SubexpressionEliminator::release(ice::arctic::SyntaxNode* node, bool with_children) noexcept
+    {
+        if (with_children)
+        {
+            ice::arctic::SyntaxNode* child = node->child;
+            while (child != nullptr)
+            {
+                ice::arctic::SyntaxNode* const next = child->sibling;
+                release(child, true);
+                child = next;
+            }
+        }
+
+        _references.erase(node);
+        _alloc.destroy(node);
+    }
+
+} // namespace ice::arctic
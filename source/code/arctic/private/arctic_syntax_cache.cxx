@@ -0,0 +1,362 @@
+#include <ice/arctic_syntax_cache.hxx>
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        static constexpr ice::u32 Constant_SyntaxBlobMagic = 0x5443'5241; // 'ARCT'
+        static constexpr ice::u32 Constant_SyntaxBlobVersion = 2;
+
+        struct SyntaxBlobHeader
+        {
+            ice::u32 magic;
+            ice::u32 version;
+            ice::u64 source_hash;
+            ice::u64 blob_size;
+            ice::u32 definition_count;
+            ice::u32 node_count;
+        };
+
+        constexpr auto align_blob_offset(ice::u64 offset) noexcept -> ice::u64
+        {
+            return (offset + (alignof(ice::u64) - 1)) & ~ice::u64(alignof(ice::u64) - 1);
+        }
+
+        inline auto syntax_node_size(ice::arctic::SyntaxNode const* node) noexcept -> ice::u64
+        {
+            return ice::arctic::dispatch_syntax_node(node, [](auto const* typed_node) noexcept -> ice::u64
+                {
+                    return sizeof(*typed_node);
+                }
+            );
+        }
+
+        template<typename T>
+        inline auto encode_offset(ice::u64 offset) noexcept -> T*
+        {
+            return reinterpret_cast<T*>(static_cast<ice::uptr>(offset));
+        }
+
+        //! \returns The node at the offset, offsets are only valid if they point at the start of one of the stored nodes.
+        inline auto decode_node_offset(
+            ice::u8* blob,
+            ice::Span<ice::u64 const> node_offsets,
+            ice::arctic::SyntaxNode* encoded,
+            bool& valid
+        ) noexcept -> ice::arctic::SyntaxNode*
+        {
+            ice::u64 const offset = reinterpret_cast<ice::uptr>(encoded);
+            if (offset == 0)
+            {
+                return nullptr;
+            }
+
+            valid &= std::binary_search(node_offsets.begin(), node_offsets.end(), offset);
+            return valid ? reinterpret_cast<ice::arctic::SyntaxNode*>(blob + offset) : nullptr;
+        }
+
+        //! \returns The token text at the offset, texts are stored after all nodes.
+        inline auto decode_string_offset(
+            ice::u8* blob,
+            ice::u64 strings_offset,
+            ice::u64 blob_size,
+            ice::String encoded,
+            bool& valid
+        ) noexcept -> ice::String
+        {
+            ice::u64 const offset = reinterpret_cast<ice::uptr>(encoded.data());
+            valid &= offset >= strings_offset && offset <= blob_size && encoded.size() <= blob_size - offset;
+            return valid ? ice::String{ reinterpret_cast<ice::utf8 const*>(blob + offset), encoded.size() } : ice::String{ };
+        }
+
+    } // namespace detail
+
+    auto hash_source(ice::String source) noexcept -> ice::u64
+    {
+        // FNV-1a
+        ice::u64 hash = 0xcbf2'9ce4'8422'2325;
+        for (ice::utf8 const character : source)
+        {
+            hash ^= ice::u64(character);
+            hash *= 0x0000'0100'0000'01b3;
+        }
+        return hash;
+    }
+
+    void serialize_syntax_tree(
+        ice::Span<ice::arctic::SyntaxNode const* const> definitions,
+        ice::u64 source_hash,
+        std::vector<ice::u64>& out_blob
+    ) noexcept
+    {
+        using namespace ice::arctic::detail;
+
+        std::vector<ice::arctic::SyntaxNode const*> nodes;
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::u64> node_offsets;
+        std::unordered_map<ice::String, ice::u64> string_offsets;
+
+        ice::u64 offset = align_blob_offset(sizeof(SyntaxBlobHeader) + sizeof(ice::u64) * definitions.size());
+
+        // Assign offsets to all reachable nodes, annotations and function bodies can be reached from multiple places.
+        std::vector<ice::arctic::SyntaxNode const*> pending{ definitions.rbegin(), definitions.rend() };
+        while (pending.empty() == false)
+        {
+            ice::arctic::SyntaxNode const* const node = pending.back();
+            pending.pop_back();
+
+            if (node == nullptr || node_offsets.contains(node))
+            {
+                continue;
+            }
+
+            node_offsets[node] = offset;
+            nodes.push_back(node);
+            offset = align_blob_offset(offset + syntax_node_size(node));
+
+            pending.push_back(node->annotation);
+            pending.push_back(node->sibling);
+            pending.push_back(node->child);
+        }
+
+        // Token values are stored after all nodes, identical values are only stored once.
+        for (ice::arctic::SyntaxNode const* node : nodes)
+        {
+            ice::arctic::for_each_syntax_token(node, [&](ice::arctic::Token const& token) noexcept
+                {
+                    if (token.value.empty() == false && string_offsets.contains(token.value) == false)
+                    {
+                        string_offsets[token.value] = offset;
+                        offset += token.value.size();
+                    }
+                }
+            );
+        }
+
+        ice::u64 const blob_size = align_blob_offset(offset);
+        out_blob.assign(blob_size / sizeof(ice::u64), 0);
+
+        ice::u8* const blob = reinterpret_cast<ice::u8*>(out_blob.data());
+
+        SyntaxBlobHeader const header{
+            .magic = Constant_SyntaxBlobMagic,
+            .version = Constant_SyntaxBlobVersion,
+            .source_hash = source_hash,
+            .blob_size = blob_size,
+            .definition_count = ice::u32(definitions.size()),
+            .node_count = ice::u32(nodes.size()),
+        };
+        std::memcpy(blob, &header, sizeof(header));
+
+        ice::u64* const definitions_table = reinterpret_cast<ice::u64*>(blob + sizeof(SyntaxBlobHeader));
+        for (ice::u64 idx = 0; idx < definitions.size(); ++idx)
+        {
+            definitions_table[idx] = node_offsets[definitions[idx]];
+        }
+
+        auto const node_reference = [&](ice::arctic::SyntaxNode const* node) noexcept -> ice::arctic::SyntaxNode*
+        {
+            return encode_offset<ice::arctic::SyntaxNode>(node == nullptr ? 0 : node_offsets[node]);
+        };
+
+        for (ice::arctic::SyntaxNode const* node : nodes)
+        {
+            ice::u64 const node_offset = node_offsets[node];
+            std::memcpy(blob + node_offset, node, syntax_node_size(node));
+
+            ice::arctic::SyntaxNode* const blob_node = reinterpret_cast<ice::arctic::SyntaxNode*>(blob + node_offset);
+            blob_node->child = node_reference(node->child);
+            blob_node->sibling = node_reference(node->sibling);
+            blob_node->annotation = node_reference(node->annotation);
+
+            ice::arctic::for_each_syntax_token(blob_node, [&](ice::arctic::Token& token) noexcept
+                {
+                    if (token.value.empty() == false)
+                    {
+                        ice::u64 const string_offset = string_offsets[token.value];
+                        std::memcpy(blob + string_offset, token.value.data(), token.value.size());
+
+                        token.value = ice::String{ encode_offset<ice::utf8 const>(string_offset), token.value.size() };
+                    }
+                    else
+                    {
+                        token.value = { };
+                    }
+                }
+            );
+        }
+    }
+
+    auto SyntaxTreeImage::load(
+        std::unique_ptr<ice::u64[]> blob_data,
+        ice::u64 blob_size,
+        ice::u64 expected_hash
+    ) noexcept -> ice::arctic::SyntaxTreeImage
+    {
+        using namespace ice::arctic::detail;
+
+        if (blob_data == nullptr || blob_size < sizeof(SyntaxBlobHeader))
+        {
+            return { };
+        }
+
+        ice::u8* const blob = reinterpret_cast<ice::u8*>(blob_data.get());
+
+        SyntaxBlobHeader header;
+        std::memcpy(&header, blob, sizeof(header));
+
+        if (header.magic != Constant_SyntaxBlobMagic
+            || header.version != Constant_SyntaxBlobVersion
+            || header.source_hash != expected_hash
+            || header.blob_size != blob_size)
+        {
+            return { };
+        }
+
+        // Definitions are stored as 64bit offsets, so they can be relocated in-place.
+        ice::u64 const definitions_offset = sizeof(SyntaxBlobHeader);
+        ice::u64 const nodes_offset = align_blob_offset(definitions_offset + sizeof(ice::u64) * ice::u64{ header.definition_count });
+        if (nodes_offset > blob_size)
+        {
+            return { };
+        }
+
+        // Nodes are laid out linearly, the layout is checked before any node is read past its base header.
+        std::vector<ice::u64> node_offsets;
+        node_offsets.reserve(std::min<ice::u64>(header.node_count, blob_size / sizeof(ice::arctic::SyntaxNode)));
+
+        ice::u64 node_offset = nodes_offset;
+        for (ice::u32 idx = 0; idx < header.node_count; ++idx)
+        {
+            if (blob_size - node_offset < sizeof(ice::arctic::SyntaxNode))
+            {
+                return { };
+            }
+
+            ice::arctic::SyntaxNode const* const node = reinterpret_cast<ice::arctic::SyntaxNode const*>(blob + node_offset);
+            if (static_cast<ice::u32>(node->entity) >= Constant_SyntaxEntityCount)
+            {
+                return { };
+            }
+
+            ice::u64 const node_size = syntax_node_size(node);
+            if (blob_size - node_offset < node_size)
+            {
+                return { };
+            }
+
+            node_offsets.push_back(node_offset);
+            node_offset = std::min(align_blob_offset(node_offset + node_size), blob_size);
+        }
+
+        // Node references can only point at stored nodes and token texts only into the texts following them.
+        bool valid = true;
+        ice::u64 const strings_offset = node_offset;
+        for (ice::u64 const offset : node_offsets)
+        {
+            ice::arctic::SyntaxNode* const node = reinterpret_cast<ice::arctic::SyntaxNode*>(blob + offset);
+            node->child = decode_node_offset(blob, node_offsets, node->child, valid);
+            node->sibling = decode_node_offset(blob, node_offsets, node->sibling, valid);
+            node->annotation = decode_node_offset(blob, node_offsets, node->annotation, valid);
+
+            ice::arctic::for_each_syntax_token(node, [&](ice::arctic::Token& token) noexcept
+                {
+                    if (token.value.empty() == false)
+                    {
+                        token.value = decode_string_offset(blob, strings_offset, blob_size, token.value, valid);
+                    }
+                }
+            );
+        }
+
+        ice::arctic::SyntaxNode** const definitions = reinterpret_cast<ice::arctic::SyntaxNode**>(blob + definitions_offset);
+        for (ice::u32 idx = 0; idx < header.definition_count; ++idx)
+        {
+            definitions[idx] = decode_node_offset(blob, node_offsets, definitions[idx], valid);
+            valid &= definitions[idx] != nullptr;
+        }
+
+        if (valid == false)
+        {
+            return { };
+        }
+
+        SyntaxTreeImage result;
+        result._blob = std::move(blob_data);
+        result._definitions = { definitions, header.definition_count };
+        return result;
+    }
+
+    SyntaxTreeCache::SyntaxTreeCache(std::filesystem::path directory) noexcept
+        : _directory{ std::move(directory) }
+    {
+    }
+
+    bool SyntaxTreeCache::store(
+        ice::String source,
+        ice::Span<ice::arctic::SyntaxNode const* const> definitions
+    ) const noexcept
+    {
+        ice::u64 const source_hash = ice::arctic::hash_source(source);
+
+        std::vector<ice::u64> blob;
+        ice::arctic::serialize_syntax_tree(definitions, source_hash, blob);
+
+        std::error_code error;
+        std::filesystem::create_directories(_directory, error);
+
+        std::FILE* const file = std::fopen(entry_path(source_hash).string().c_str(), "wb");
+        if (file == nullptr)
+        {
+            return false;
+        }
+
+        ice::u64 const written = std::fwrite(blob.data(), sizeof(ice::u64), blob.size(), file);
+        std::fclose(file);
+        return written == blob.size();
+    }
+
+    auto SyntaxTreeCache::load(ice::String source) const noexcept -> ice::arctic::SyntaxTreeImage
+    {
+        ice::u64 const source_hash = ice::arctic::hash_source(source);
+
+        std::error_code error;
+        std::filesystem::path const path = entry_path(source_hash);
+        ice::u64 const file_size = std::filesystem::file_size(path, error);
+        if (error || file_size == 0 || (file_size % sizeof(ice::u64)) != 0)
+        {
+            return { };
+        }
+
+        std::FILE* const file = std::fopen(path.string().c_str(), "rb");
+        if (file == nullptr)
+        {
+            return { };
+        }
+
+        // The whole entry is read with a single call, relocation happens in-place afterwards.
+        std::unique_ptr<ice::u64[]> blob{ new ice::u64[file_size / sizeof(ice::u64)] };
+        ice::u64 const read = std::fread(blob.get(), 1, file_size, file);
+        std::fclose(file);
+
+        if (read != file_size)
+        {
+            return { };
+        }
+
+        return SyntaxTreeImage::load(std::move(blob), file_size, source_hash);
+    }
+
+    auto SyntaxTreeCache::entry_path(ice::u64 source_hash) const noexcept -> std::filesystem::path
+    {
+        return _directory / fmt::format("{:016x}.arctic_ast", source_hash);
+    }
+
+} // namespace ice::arctic
@@ -0,0 +1,130 @@
+#include <ice/arctic_syntax_hash.hxx>
+#include <ice/arctic_syntax_walker.hxx>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        //! \brief Deeper trees are hashed again with a heap allocated stack.
+        static constexpr ice::u32 Constant_SyntaxHashMaxDepth = 1024;
+
+        constexpr auto fnv1a_append(ice::u64 hash, ice::u64 value, ice::u32 byte_count) noexcept -> ice::u64
+        {
+            for (ice::u32 idx = 0; idx < byte_count; ++idx)
+            {
+                hash ^= (value >> (idx * 8)) & 0xff;
+                hash *= 0x0000'0100'0000'01b3;
+            }
+            return hash;
+        }
+
+        //! \brief Spreads the bits of a finished node hash, FNV-1a alone mixes the last bytes poorly.
+        constexpr auto finalize_node_hash(ice::u64 hash) noexcept -> ice::u64
+        {
+            hash ^= hash >> 33;
+            hash *= 0xff51'afd7'ed55'8ccd;
+            hash ^= hash >> 33;
+            hash *= 0xc4ce'b9fe'1a85'ec53;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        //! \brief Keeps a running hash for each node on the path to the current node, children are mixed into their parent when left.
+        struct SyntaxHashWalker
+        {
+            std::vector<ice::u64> pending;
+            std::unordered_map<ice::arctic::SyntaxNode const*, ice::u64>* out_hashes;
+            ice::u64 result = 0;
+
+            void enter(ice::arctic::SyntaxNode const* node) noexcept
+            {
+                ice::u64 hash = 0xcbf2'9ce4'8422'2325;
+                hash = fnv1a_append(hash, static_cast<ice::u64>(node->entity), 4);
+
+                // Sizes are included so tokens can't be shifted between each other without changing the hash.
+                ice::arctic::for_each_syntax_token(node, [&hash](ice::arctic::Token const& token) noexcept
+                    {
+                        hash = fnv1a_append(hash, static_cast<ice::u64>(token.type), 4);
+                        hash = fnv1a_append(hash, token.value.size(), 4);
+                        for (ice::utf8 const character : token.value)
+                        {
+                            hash = fnv1a_append(hash, character, 1);
+                        }
+                    }
+                );
+
+                if (node->entity == SyntaxEntity::DEF_TypeDef)
+                {
+                    hash = fnv1a_append(hash, static_cast<SyntaxNode_TypeDef const*>(node)->is_alias, 1);
+                }
+                else if (node->entity == SyntaxEntity::DEF_Variable)
+                {
+                    hash = fnv1a_append(hash, static_cast<SyntaxNode_Variable const*>(node)->is_const, 1);
+                }
+                pending.push_back(hash);
+            }
+
+            void leave(ice::arctic::SyntaxNode const* node) noexcept
+            {
+                ice::u64 const hash = finalize_node_hash(pending.back());
+                pending.pop_back();
+
+                if (out_hashes != nullptr)
+                {
+                    out_hashes->insert_or_assign(node, hash);
+                }
+
+                if (pending.empty())
+                {
+                    result = hash;
+                }
+                else
+                {
+                    pending.back() = fnv1a_append(pending.back(), hash, 8);
+                }
+            }
+        };
+
+        auto hash_syntax_subtree(
+            ice::arctic::SyntaxNode const* node,
+            std::unordered_map<ice::arctic::SyntaxNode const*, ice::u64>* out_hashes
+        ) noexcept -> ice::u64
+        {
+            ice::arctic::detail::SyntaxHashWalker walker{ .pending = { }, .out_hashes = out_hashes };
+            if (ice::arctic::walk<Constant_SyntaxHashMaxDepth>(node, walker) == WalkResult::Completed)
+            {
+                return walker.result;
+            }
+
+            // Hashes of nodes left before the walk stopped are already final, they are replaced by the same values.
+            ice::arctic::detail::SyntaxHashWalker unbounded_walker{ .pending = { }, .out_hashes = out_hashes };
+            ice::arctic::walk_unbounded(node, unbounded_walker);
+            return unbounded_walker.result;
+        }
+
+    } // namespace detail
+
+    auto SyntaxTreeHashes::add_definition(ice::arctic::SyntaxNode const* definition) noexcept -> ice::u64
+    {
+        return ice::arctic::detail::hash_syntax_subtree(definition, &_hashes);
+    }
+
+    auto SyntaxTreeHashes::hash(ice::arctic::SyntaxNode const* node) const noexcept -> ice::u64
+    {
+        auto const it = _hashes.find(node);
+        return it != _hashes.end() ? it->second : 0;
+    }
+
+    void SyntaxTreeHashes::clear() noexcept
+    {
+        _hashes.clear();
+    }
+
+    auto hash_syntax_tree(ice::arctic::SyntaxNode const* node) noexcept -> ice::u64
+    {
+        return ice::arctic::detail::hash_syntax_subtree(node, nullptr);
+    }
+
+} // namespace ice::arctic
@@ -0,0 +1,57 @@
+#include <ice/arctic_syntax_index.hxx>
+#include <ice/arctic_syntax_walker.hxx>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        //! \brief Deeper trees can only be created with 'max_expression_depth' disabled, those are walked with a heap allocated stack.
+        static constexpr ice::u32 Constant_SyntaxIndexMaxDepth = 1024;
+
+        struct SyntaxIndexWalker
+        {
+            std::vector<ice::arctic::SyntaxNode const*>* nodes;
+
+            void enter(ice::arctic::SyntaxNode const* node) noexcept
+            {
+                nodes[static_cast<ice::u32>(node->entity)].push_back(node);
+            }
+        };
+
+    } // namespace detail
+
+    void SyntaxNodeIndex::add_definition(ice::arctic::SyntaxNode const* definition) noexcept
+    {
+        ice::u64 group_sizes[Constant_SyntaxEntityCount];
+        for (ice::u32 idx = 0; idx < Constant_SyntaxEntityCount; ++idx)
+        {
+            group_sizes[idx] = _nodes[idx].size();
+        }
+
+        ice::arctic::WalkResult const result = ice::arctic::walk<detail::Constant_SyntaxIndexMaxDepth>(
+            definition, ice::arctic::detail::SyntaxIndexWalker{ _nodes }
+        );
+
+        // Drop the nodes added before the walk stopped and index the definition again without a depth limit.
+        if (result == WalkResult::DepthExceeded)
+        {
+            for (ice::u32 idx = 0; idx < Constant_SyntaxEntityCount; ++idx)
+            {
+                _nodes[idx].resize(group_sizes[idx]);
+            }
+
+            ice::arctic::walk_unbounded(definition, ice::arctic::detail::SyntaxIndexWalker{ _nodes });
+        }
+    }
+
+    void SyntaxNodeIndex::clear() noexcept
+    {
+        for (std::vector<ice::arctic::SyntaxNode const*>& nodes : _nodes)
+        {
+            nodes.clear();
+        }
+    }
+
+} // namespace ice::arctic
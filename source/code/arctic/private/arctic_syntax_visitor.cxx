@@ -0,0 +1,31 @@
+#include <ice/arctic_syntax_visitor.hxx>
+#include <ice/arctic_parallel.hxx>
+#include <ice/arctic_trace.hxx>
+
+namespace ice::arctic
+{
+
+    void visit_definitions_parallel(
+        ice::Span<ice::arctic::SyntaxNode const* const> definitions,
+        ice::Span<ice::arctic::SyntaxVisitorBase* const> visitors,
+        ice::u32 jobs
+    ) noexcept
+    {
+        // Each visitor is a single work item, so no visitor is ever called from two threads.
+        ice::arctic::detail::parallel_for(
+            ice::u32(visitors.size()),
+            jobs,
+            [&](ice::u32 /*worker_idx*/, ice::u32 visitor_idx) noexcept
+            {
+                ice::arctic::TraceScope const trace_scope{ "visit_definitions", nullptr, visitor_idx };
+                ice::arctic::visit_definitions(definitions, visitors.subspan(visitor_idx, 1));
+            }
+        );
+
+        for (ice::arctic::SyntaxVisitorBase* visitor : visitors)
+        {
+            visitor->merge_results();
+        }
+    }
+
+} // namespace ice::arctic
@@ -0,0 +1,206 @@
+#include <ice/arctic_trace.hxx>
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ice::arctic
+{
+
+#if ICE_ARCTIC_TRACING
+
+    namespace detail
+    {
+
+        struct TraceEvent
+        {
+            char const* name;
+            ice::u64 start_ns;
+            ice::u64 duration_ns;
+            ice::u32 index;
+            char detail[TraceScope::Constant_MaxDetailSize + 1];
+        };
+
+        //! \brief Events of a single thread, buffers are owned by the registry so they outlive their threads.
+        struct TraceBuffer
+        {
+            ice::u32 thread_id;
+            char const* thread_name;
+            std::vector<ice::arctic::detail::TraceEvent> events;
+        };
+
+        struct TraceRegistry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ice::arctic::detail::TraceBuffer>> buffers;
+            std::chrono::steady_clock::time_point const epoch = std::chrono::steady_clock::now();
+        };
+
+        auto trace_registry() noexcept -> ice::arctic::detail::TraceRegistry&
+        {
+            static ice::arctic::detail::TraceRegistry registry{ };
+            return registry;
+        }
+
+        thread_local ice::arctic::detail::TraceBuffer* trace_buffer = nullptr;
+
+        auto current_trace_buffer() noexcept -> ice::arctic::detail::TraceBuffer&
+        {
+            if (trace_buffer == nullptr)
+            {
+                ice::arctic::detail::TraceRegistry& registry = trace_registry();
+
+                std::lock_guard const lock{ registry.mutex };
+                registry.buffers.push_back(std::make_unique<TraceBuffer>(TraceBuffer{
+                    .thread_id = ice::u32(registry.buffers.size() + 1),
+                    .thread_name = nullptr,
+                    .events = { }
+                }));
+                trace_buffer = registry.buffers.back().get();
+            }
+            return *trace_buffer;
+        }
+
+        auto trace_now_ns() noexcept -> ice::u64
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - trace_registry().epoch
+            ).count();
+        }
+
+        //! \brief Escapes the few characters that can't appear in a JSON string, source text can contain any of them.
+        void append_json_string(std::string& out, char const* text) noexcept
+        {
+            for (; *text != '\0'; ++text)
+            {
+                char const character = *text;
+                if (character == '"' || character == '\\')
+                {
+                    out += '\\';
+                    out += character;
+                }
+                else if (static_cast<unsigned char>(character) < 0x20)
+                {
+                    out += fmt::format("\\u{:04x}", character);
+                }
+                else
+                {
+                    out += character;
+                }
+            }
+        }
+
+    } // namespace detail
+
+    TraceScope::TraceScope(char const* name, char const* detail_text, ice::u32 index) noexcept
+        : _name{ name }
+        , _start_ns{ name != nullptr ? detail::trace_now_ns() : 0 }
+        , _index{ index }
+        , _detail{ }
+    {
+        if (detail_text != nullptr)
+        {
+            std::strncpy(_detail, detail_text, Constant_MaxDetailSize);
+        }
+    }
+
+    TraceScope::~TraceScope() noexcept
+    {
+        if (_name == nullptr)
+        {
+            return;
+        }
+
+        ice::u64 const end_ns = detail::trace_now_ns();
+        ice::arctic::detail::TraceEvent& event = detail::current_trace_buffer().events.emplace_back(
+            detail::TraceEvent{ .name = _name, .start_ns = _start_ns, .duration_ns = end_ns - _start_ns, .index = _index }
+        );
+        std::memcpy(event.detail, _detail, sizeof(_detail));
+    }
+
+    void TraceScope::set_detail(ice::String detail_text) noexcept
+    {
+        ice::u64 const size = std::min<ice::u64>(detail_text.size(), Constant_MaxDetailSize);
+        std::memcpy(_detail, detail_text.data(), size);
+        _detail[size] = '\0';
+    }
+
+    void trace_thread_name(char const* name) noexcept
+    {
+        detail::current_trace_buffer().thread_name = name;
+    }
+
+    auto trace_json() noexcept -> std::string
+    {
+        ice::arctic::detail::TraceRegistry& registry = detail::trace_registry();
+        std::lock_guard const lock{ registry.mutex };
+
+        std::string result = "{ \"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+        bool first_event = true;
+        for (std::unique_ptr<detail::TraceBuffer> const& buffer : registry.buffers)
+        {
+            if (buffer->thread_name != nullptr)
+            {
+                result += fmt::format(
+                    "{}\n  {{ \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": {}, \"args\": {{ \"name\": \"{}\" }} }}",
+                    first_event ? "" : ",",
+                    buffer->thread_id,
+                    buffer->thread_name
+                );
+                first_event = false;
+            }
+
+            for (detail::TraceEvent const& event : buffer->events)
+            {
+                result += fmt::format(
+                    "{}\n  {{ \"name\": \"{}\", \"cat\": \"arctic\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, \"ts\": {:.3f}, \"dur\": {:.3f}, \"args\": {{ ",
+                    first_event ? "" : ",",
+                    event.name,
+                    buffer->thread_id,
+                    event.start_ns / 1000.0,
+                    event.duration_ns / 1000.0
+                );
+
+                result += "\"detail\": \"";
+                detail::append_json_string(result, event.detail);
+                result += '"';
+                if (event.index != TraceScope::Constant_NoIndex)
+                {
+                    result += fmt::format(", \"index\": {}", event.index);
+                }
+                result += " } }";
+                first_event = false;
+            }
+        }
+        return result + "\n] }\n";
+    }
+
+    void trace_reset() noexcept
+    {
+        ice::arctic::detail::TraceRegistry& registry = detail::trace_registry();
+        std::lock_guard const lock{ registry.mutex };
+
+        for (std::unique_ptr<detail::TraceBuffer> const& buffer : registry.buffers)
+        {
+            buffer->events.clear();
+        }
+    }
+
+#else // #if ICE_ARCTIC_TRACING
+
+    auto trace_json() noexcept -> std::string
+    {
+        return "{ \"displayTimeUnit\": \"ns\", \"traceEvents\": [] }\n";
+    }
+
+    void trace_reset() noexcept
+    {
+    }
+
+#endif // #if ICE_ARCTIC_TRACING
+
+} // namespace ice::arctic
@@ -0,0 +1,453 @@
+#include <ice/arctic_uniformity.hxx>
+#include <ice/arctic_operand_list.hxx>
+
+#include <fmt/format.h>
+#include <algorithm>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        //! \brief Uniformity and type of a single term of an operand list.
+        struct HoistValue
+        {
+            ice::arctic::Uniformity uniformity;
+            ice::arctic::TypeHandle type;
+
+            //! \brief Set if the term contains an operation or a call, hoisting single values doesn't save any work.
+            bool has_work;
+        };
+
+        constexpr auto combine_uniformity(ice::arctic::Uniformity left, ice::arctic::Uniformity right) noexcept -> ice::arctic::Uniformity
+        {
+            return std::max(left, right);
+        }
+
+    } // namespace detail
+
+    UniformityAnalysis::UniformityAnalysis(
+        ice::arctic::SemanticModel const& model,
+        ice::arctic::AnnotationTables const& annotations
+    ) noexcept
+        : _model{ model }
+        , _annotations{ annotations }
+    {
+    }
+
+    void UniformityAnalysis::analyze(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept
+    {
+        _globals.insert(definitions.begin(), definitions.end());
+
+        for (ice::arctic::SyntaxNode const* definition : definitions)
+        {
+            if (definition->entity != SyntaxEntity::DEF_Function || definition->sibling == nullptr)
+            {
+                continue;
+            }
+
+            // Locals start as batch uniform and are only raised, so this ends after each local changed at most twice.
+            bool changed = true;
+            while (changed)
+            {
+                changed = false;
+                classify_statements(definition->sibling->child, changed);
+            }
+        }
+    }
+
+    auto UniformityAnalysis::uniformity_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::Uniformity
+    {
+        auto const it = _nodes.find(node);
+        return it != _nodes.end() ? it->second : Uniformity::Varying;
+    }
+
+    void UniformityAnalysis::classify_statements(ice::arctic::SyntaxNode const* first, bool& out_changed) noexcept
+    {
+        for (ice::arctic::SyntaxNode const* node = first; node != nullptr; node = node->sibling)
+        {
+            switch (node->entity)
+            {
+            case SyntaxEntity::DEF_Variable:
+                // Variables without an initializer only hold the values assigned later.
+                assign_local(node, node->child != nullptr ? classify_list(node->child) : Uniformity::Batch, out_changed);
+                break;
+            case SyntaxEntity::DEF_ExplicitScope:
+                classify_statements(node->child, out_changed);
+                break;
+            case SyntaxEntity::EXP_Expression:
+            {
+                classify_list(node);
+
+                // Assignments to locals are stored as '<target> = <value>', members of the target are assigned as well.
+                ice::arctic::SyntaxNode const* const target = node->child;
+                ice::arctic::SyntaxNode const* const assignment = target != nullptr ? target->sibling : nullptr;
+                if (target == nullptr
+                    || target->entity != SyntaxEntity::EXP_Value
+                    || assignment == nullptr
+                    || assignment->entity != SyntaxEntity::EXP_BinaryOperation
+                    || static_cast<SyntaxNode_ExpressionBinaryOperation const*>(assignment)->operation.type != TokenType::OP_Assign)
+                {
+                    break;
+                }
+
+                ice::arctic::Symbol const* const symbol = _model.symbol_of(target);
+                if (symbol != nullptr && symbol->kind == SymbolKind::Variable && _globals.contains(symbol->definition) == false)
+                {
+                    ice::arctic::Uniformity value = Uniformity::Batch;
+                    for (ice::arctic::SyntaxNode const* operand = assignment->sibling; operand != nullptr; operand = operand->sibling)
+                    {
+                        if (operand->entity != SyntaxEntity::EXP_BinaryOperation)
+                        {
+                            value = detail::combine_uniformity(value, uniformity_of(operand));
+                        }
+                    }
+                    assign_local(symbol->definition, value, out_changed);
+                }
+                break;
+            }
+            default:
+                classify_operand(node);
+                break;
+            }
+        }
+    }
+
+    auto UniformityAnalysis::classify_list(ice::arctic::SyntaxNode const* parent) noexcept -> ice::arctic::Uniformity
+    {
+        // Operations don't change the uniformity of their operands, so precedence doesn't matter here.
+        ice::arctic::Uniformity result = Uniformity::Batch;
+        for (ice::arctic::SyntaxNode const* node = parent->child; node != nullptr; node = node->sibling)
+        {
+            if (node->entity == SyntaxEntity::EXP_UnaryOperation)
+            {
+                result = detail::combine_uniformity(result, classify_list(node));
+            }
+            else if (node->entity != SyntaxEntity::EXP_BinaryOperation)
+            {
+                result = detail::combine_uniformity(result, classify_operand(node));
+            }
+        }
+
+        _nodes[parent] = result;
+        return result;
+    }
+
+    auto UniformityAnalysis::classify_operand(ice::arctic::SyntaxNode const* node) noexcept -> ice::arctic::Uniformity
+    {
+        ice::arctic::Uniformity result = Uniformity::Varying;
+        switch (node->entity)
+        {
+        case SyntaxEntity::EXP_Value:
+            if (static_cast<SyntaxNode_ExpressionValue const*>(node)->value.type != TokenType::CT_Symbol)
+            {
+                result = Uniformity::Batch;
+            }
+            else
+            {
+                result = classify_symbol(_model.symbol_of(node));
+            }
+            break;
+        case SyntaxEntity::EXP_Call:
+        {
+            // Arguments are classified even for function calls, so hoisting can look into them.
+            result = Uniformity::Batch;
+            for (ice::arctic::SyntaxNode const* argument = node->child; argument != nullptr; argument = argument->sibling)
+            {
+                if (argument->entity == SyntaxEntity::EXP_CallArg)
+                {
+                    result = detail::combine_uniformity(result, classify_list(argument));
+                }
+            }
+
+            ice::arctic::Symbol const* const symbol = _model.symbol_of(node);
+            if (symbol != nullptr && symbol->kind == SymbolKind::Function)
+            {
+                result = Uniformity::Varying;
+            }
+            break;
+        }
+        case SyntaxEntity::EXP_Expression:
+        case SyntaxEntity::EXP_ExplicitScope:
+            result = classify_list(node);
+            break;
+        default:
+            break;
+        }
+
+        _nodes[node] = result;
+        return result;
+    }
+
+    auto UniformityAnalysis::classify_symbol(ice::arctic::Symbol const* symbol) const noexcept -> ice::arctic::Uniformity
+    {
+        if (symbol == nullptr)
+        {
+            return Uniformity::Varying;
+        }
+
+        bool const is_global = _globals.contains(symbol->definition);
+        switch (symbol->kind)
+        {
+        case SymbolKind::ContextVariable:
+            return _annotations.find(symbol->definition).find(AttributeKey::Constant) != nullptr
+                ? Uniformity::Batch
+                : Uniformity::Varying;
+        case SymbolKind::Constant:
+        case SymbolKind::Variable:
+            if (is_global)
+            {
+                // Global variables can be written by any function, only constants stay the same.
+                return symbol->kind == SymbolKind::Constant ? Uniformity::Batch : Uniformity::Varying;
+            }
+
+            // Locals are only known inside the function, so their values can't be read before it runs.
+            return detail::combine_uniformity(Uniformity::Uniform, uniformity_of(symbol->definition));
+        default:
+            return Uniformity::Varying;
+        }
+    }
+
+    void UniformityAnalysis::assign_local(
+        ice::arctic::SyntaxNode const* variable,
+        ice::arctic::Uniformity uniformity,
+        bool& out_changed
+    ) noexcept
+    {
+        auto const [it, inserted] = _nodes.emplace(variable, uniformity);
+        if (inserted == false && it->second < uniformity)
+        {
+            it->second = uniformity;
+            out_changed = true;
+        }
+    }
+
+    UniformHoister::UniformHoister(
+        ice::arctic::SyntaxNodeAllocator& alloc,
+        ice::arctic::SemanticModel& model,
+        ice::arctic::UniformityAnalysis const& analysis
+    ) noexcept
+        : _alloc{ alloc }
+        , _model{ model }
+        , _analysis{ analysis }
+    {
+    }
+
+    auto UniformHoister::hoist(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept -> ice::u32
+    {
+        ice::u32 const first_variable = ice::u32(_prologue.size());
+        for (ice::arctic::SyntaxNode const* definition : definitions)
+        {
+            // The tree is owned by the allocator, definitions are only const for visitors.
+            if (definition->entity == SyntaxEntity::DEF_Function && definition->sibling != nullptr)
+            {
+                hoist_statements(const_cast<ice::arctic::SyntaxNode*>(definition->sibling->child));
+            }
+        }
+        return ice::u32(_prologue.size()) - first_variable;
+    }
+
+    void UniformHoister::hoist_statements(ice::arctic::SyntaxNode* first) noexcept
+    {
+        for (ice::arctic::SyntaxNode* node = first; node != nullptr; node = node->sibling)
+        {
+            switch (node->entity)
+            {
+            case SyntaxEntity::DEF_Variable:
+                if (node->child != nullptr)
+                {
+                    hoist_list(node->child);
+                }
+                break;
+            case SyntaxEntity::DEF_ExplicitScope:
+                hoist_statements(node->child);
+                break;
+            case SyntaxEntity::EXP_Expression:
+                hoist_list(node);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    void UniformHoister::hoist_nested(ice::arctic::SyntaxNode* node) noexcept
+    {
+        switch (node->entity)
+        {
+        case SyntaxEntity::EXP_Call:
+            for (ice::arctic::SyntaxNode* argument = node->child; argument != nullptr; argument = argument->sibling)
+            {
+                if (argument->entity == SyntaxEntity::EXP_CallArg)
+                {
+                    hoist_list(argument);
+                }
+            }
+            break;
+        case SyntaxEntity::EXP_Expression:
+        case SyntaxEntity::EXP_ExplicitScope:
+            hoist_list(node);
+            break;
+        default:
+            break;
+        }
+    }
+
+    void UniformHoister::hoist_list(ice::arctic::SyntaxNode* parent) noexcept
+    {
+        ice::arctic::OperandList list;
+        if (list.build(parent) == false)
+        {
+            for (ice::arctic::OperandItem const& item : list.items())
+            {
+                if (item.kind == OperandItemKind::Operand)
+                {
+                    hoist_nested(item.node);
+                }
+            }
+            return;
+        }
+
+        ice::Span<ice::arctic::OperandItem const> const items = list.items();
+        ice::Span<ice::arctic::OperandTerm const> const terms = list.terms();
+
+        std::vector<ice::arctic::detail::HoistValue> values(terms.size());
+        for (ice::u32 idx = 0; idx < terms.size(); ++idx)
+        {
+            ice::arctic::OperandTerm const& term = terms[idx];
+            ice::arctic::detail::HoistValue& result = values[idx];
+
+            if (term.kind == OperandTermKind::Operand)
+            {
+                ice::arctic::SyntaxNode const* const node = items[term.item].node;
+                result.uniformity = _analysis.uniformity_of(node);
+                result.type = _model.operand_type_of(node);
+                result.has_work = node->entity == SyntaxEntity::EXP_Call || node->entity == SyntaxEntity::EXP_ExplicitScope;
+            }
+            else if (term.kind == OperandTermKind::Negate)
+            {
+                result = values[term.left];
+            }
+            else
+            {
+                ice::arctic::TokenType const operation = static_cast<SyntaxNode_ExpressionBinaryOperation const*>(
+                    items[term.item].node
+                )->operation.type;
+
+                ice::arctic::detail::HoistValue const& left = values[term.left];
+                ice::arctic::detail::HoistValue const& right = values[term.right];
+                result.uniformity = detail::combine_uniformity(left.uniformity, right.uniformity);
+                result.type = _model.result_type(left.type, operation, right.type);
+                result.has_work = true;
+
+                // Assignments need to happen for each entity.
+                if (operation == TokenType::OP_Assign)
+                {
+                    result.uniformity = Uniformity::Varying;
+                }
+            }
+        }
+
+        auto const is_hoistable = [&values](ice::u32 term) noexcept -> bool
+        {
+            ice::arctic::detail::HoistValue const& value = values[term];
+            return value.uniformity == Uniformity::Batch
+                && value.has_work
+                && value.type != nullptr
+                && value.type->kind != TypeKind::Void
+                && value.type->kind != TypeKind::Stage
+                && value.type->name.empty() == false;
+        };
+
+        // Only the largest hoistable terms are moved, hoistable operands of terms that stay are moved on their own.
+        std::vector<ice::arctic::OperandReplacement> replacements;
+        for (ice::u32 idx = 0; idx < terms.size(); ++idx)
+        {
+            if (terms[idx].kind != OperandTermKind::Operand && is_hoistable(idx) == false)
+            {
+                for (ice::u32 const operand : { terms[idx].left, terms[idx].right })
+                {
+                    if (operand != OperandList::Constant_None && is_hoistable(operand))
+                    {
+                        replacements.push_back({ .term = operand, .node = nullptr });
+                    }
+                }
+            }
+        }
+
+        if (is_hoistable(list.root()))
+        {
+            replacements.push_back({ .term = list.root(), .node = nullptr });
+        }
+
+        // Operands that stay in place can still contain hoistable arguments.
+        std::vector<bool> hoisted(items.size(), false);
+        for (ice::arctic::OperandReplacement const& replacement : replacements)
+        {
+            std::fill(hoisted.begin() + terms[replacement.term].first, hoisted.begin() + terms[replacement.term].last + 1, true);
+        }
+
+        for (ice::u32 idx = 0; idx < items.size(); ++idx)
+        {
+            if (hoisted[idx] == false && items[idx].kind == OperandItemKind::Operand)
+            {
+                hoist_nested(items[idx].node);
+            }
+        }
+
+        for (ice::arctic::OperandReplacement& replacement : replacements)
+        {
+            ice::arctic::TokenLocation const location = ice::arctic::operand_location(items[terms[replacement.term].first].node);
+            ice::arctic::SyntaxNode_Variable* const variable = create_variable(
+                list.link_term(replacement.term),
+                values[replacement.term].type,
+                location
+            );
+
+            ice::arctic::SyntaxNode_ExpressionValue* const reference = _alloc.create<SyntaxNode_ExpressionValue>();
+            reference->value = ice::arctic::Token{ .value = variable->name.value, .type = TokenType::CT_Symbol, .location = location };
+            replacement.node = reference;
+        }
+
+        // Replaced items are now owned by the prologue variables.
+        std::vector<ice::arctic::OperandItem> moved;
+        list.replace(replacements, moved);
+    }
+
+    auto UniformHoister::create_variable(
+        ice::arctic::SyntaxNode* initializer,
+        ice::arctic::TypeHandle type,
+        ice::arctic::TokenLocation location
+    ) noexcept -> ice::arctic::SyntaxNode_Variable*
+    {
+        // Names are chosen to not shadow any global, locals can't be referenced by the prologue anyway.
+        std::u8string name;
+        do
+        {
+            std::string const text = fmt::format("batch_uniform_{}", _names.size());
+            name.assign(text.begin(), text.end());
+            _names.emplace_back();
+        } while (_model.globals().find(name) != nullptr);
+
+        std::u8string const& stored_name = _names.back() = std::move(name);
+
+        // Initializers are stored as an expression starting with the assignment operation.
+        ice::arctic::SyntaxNode_ExpressionBinaryOperation* const assignment = _alloc.create<SyntaxNode_ExpressionBinaryOperation>();
+        assignment->operation = ice::arctic::Token{ .value = u8"=", .type = TokenType::OP_Assign, .location = location };
+        assignment->sibling = initializer;
+
+        ice::arctic::SyntaxNode_Expression* const expression = _alloc.create<SyntaxNode_Expression>();
+        expression->child = assignment;
+
+        ice::arctic::SyntaxNode_Variable* const variable = _alloc.create<SyntaxNode_Variable>();
+        variable->name = ice::arctic::Token{ .value = stored_name, .type = TokenType::CT_Symbol, .location = location };
+        variable->type = ice::arctic::Token{ .value = type->name, .type = TokenType::CT_Symbol, .location = location };
+        variable->is_const = false;
+        variable->child = expression;
+
+        _prologue.push_back(variable);
+        return variable;
+    }
+
+} // namespace ice::arctic
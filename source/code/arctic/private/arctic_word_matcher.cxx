@@ -1,6 +1,8 @@
 #include <ice/arctic_word_matcher.hxx>
+#include <ice/arctic_memory_stats.hxx>
+#include <ice/arctic_trace.hxx>
 #include <cassert>
-#include <cctype>
+#include <cstdlib>
 
 namespace ice::arctic
 {
@@ -60,6 +62,7 @@ namespace ice::arctic
     {
         assert(matcher->_dispatch_table == nullptr);
         assert(matcher->_dispatch_fn == nullptr);
+        ice::arctic::TraceScope const trace_scope{ "matcher.init" };
 
         static ice::arctic::WordMatcher::MatcherFn* const available_matchers[]{
             word_match_endofline,
@@ -71,7 +74,9 @@ namespace ice::arctic
         };
 
         matcher->_dispatch_fn = word_matcher_dispatch;
-        matcher->_dispatch_table = new WordMatcher::MatcherFn*[128];
+        // Allocated with 'malloc' for the same reason as generator frames, see 'Generator::Promise::operator new'.
+        matcher->_dispatch_table = static_cast<WordMatcher::MatcherFn**>(std::malloc(sizeof(WordMatcher::MatcherFn*) * 128));
+        ice::arctic::detail::track_phase_allocation(MemoryPhase::WordProcessing, sizeof(WordMatcher::MatcherFn*) * 128);
 
         ice::utf8 test_str[3]{ u8'\0', u8'\0', u8'\0' };
 
@@ -117,7 +122,8 @@ namespace ice::arctic
 
     void shutdown_matcher(ice::arctic::WordMatcher* matcher) noexcept
     {
-        delete[] matcher->_dispatch_table;
+        std::free(matcher->_dispatch_table);
+        ice::arctic::detail::track_phase_deallocation(MemoryPhase::WordProcessing, sizeof(WordMatcher::MatcherFn*) * 128);
 
         matcher->_dispatch_table = nullptr;
         matcher->_dispatch_fn = nullptr;
@@ -182,7 +188,8 @@ namespace ice::arctic
     {
         out_end_it = it + 1;
 
-        while (std::isspace(*out_end_it))
+        // Line breaks are matched separately so they are counted as lines.
+        while (*out_end_it == ' ' || *out_end_it == '\t')
         {
             out_end_it += 1;
         }
@@ -215,12 +222,12 @@ namespace ice::arctic
     ) noexcept -> ice::arctic::WordCategory
     {
         out_end_it = it + 1;
-        characters_out = ice::u32(*out_end_it == '\n');
+        characters_out = ice::u32(*it == '\n');
 
         while (*out_end_it == '\n' || *out_end_it == '\r')
         {
-            out_end_it += 1;
             characters_out += ice::u32(*out_end_it == '\n');
+            out_end_it += 1;
         }
 
         return WordCategory::EndOfLine;
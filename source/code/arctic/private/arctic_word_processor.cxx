@@ -8,7 +8,8 @@ namespace ice::arctic
 
     auto create_word_processor(
         ice::String script_data,
-        ice::arctic::WordMatcher const* matcher
+        ice::arctic::WordMatcher const* matcher,
+        ice::arctic::WordLocation start_location
     ) noexcept -> ice::arctic::WordProcessor
     {
         assert(matcher->_dispatch_table != nullptr);
@@ -17,10 +18,7 @@ namespace ice::arctic
         ice::utf8 const* it = script_data.data();
         ice::utf8 const* end = it;
 
-        ice::arctic::WordLocation current_location{
-            .line = 0,
-            .character = 0
-        };
+        ice::arctic::WordLocation current_location = start_location;
 
         bool stop = false;
         while (stop == false)
@@ -0,0 +1,119 @@
+#pragma once
+#include <ice/arctic_syntax_node.hxx>
+#include <unordered_map>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    //! \brief Interned name of an annotation attribute, names used by the engine are interned up-front.
+    enum class AttributeKey : ice::u32
+    {
+        In,
+        Out,
+        Constant,
+
+        Invalid = 0xffff'ffff,
+    };
+
+    //! \returns The key for the given attribute name, the name is interned on first use.
+    //! \note Keys are process-wide and can be interned from any thread.
+    auto intern_attribute_key(ice::String name) noexcept -> ice::arctic::AttributeKey;
+
+    //! \returns The key for the given attribute name or 'Invalid' if the name was never interned.
+    auto find_attribute_key(ice::String name) noexcept -> ice::arctic::AttributeKey;
+
+    enum class AttributeValueType : ice::u8
+    {
+        //! \brief The attribute was given without a value, ex.: '[constant]'.
+        None,
+        Bool,
+        Integer,
+        Float,
+
+        //! \brief A string or character literal, the stored text has the quotes removed.
+        String,
+        Symbol,
+    };
+
+    //! \brief A decoded annotation attribute, numbers and booleans are parsed once when decoding.
+    struct Attribute
+    {
+        ice::arctic::AttributeKey key;
+        ice::arctic::AttributeValueType type;
+
+        //! \brief Set for 'Integer' and 'Bool' values, also set to the truncated value of 'Float' values.
+        ice::i64 integer;
+        ice::f64 floating;
+
+        //! \brief The value as written in the source, without quotes for 'String' values.
+        ice::String text;
+
+        ice::arctic::SyntaxNode_AnnotationAttribute const* node;
+    };
+
+    //! \brief All attributes of the annotations attached to a single definition.
+    class AnnotationTable
+    {
+    public:
+        static constexpr ice::u32 Constant_MaxIndexedKey = 64;
+
+        AnnotationTable() noexcept = default;
+
+        AnnotationTable(
+            ice::u64 key_mask,
+            ice::Span<ice::arctic::Attribute const> attributes
+        ) noexcept
+            : _key_mask{ key_mask }
+            , _attributes{ attributes }
+        {
+        }
+
+        //! \returns The first attribute with the given key, or 'nullptr'.
+        //! \note Keys below 'Constant_MaxIndexedKey' are found without searching, others are compared one by one.
+        auto find(ice::arctic::AttributeKey key) const noexcept -> ice::arctic::Attribute const*;
+
+        auto find(ice::String name) const noexcept -> ice::arctic::Attribute const*
+        {
+            return find(ice::arctic::find_attribute_key(name));
+        }
+
+        //! \brief Attributes with indexed keys come first ordered by key, followed by all remaining attributes in source order.
+        auto attributes() const noexcept -> ice::Span<ice::arctic::Attribute const>
+        {
+            return _attributes;
+        }
+
+        bool empty() const noexcept { return _attributes.empty(); }
+
+    private:
+        ice::u64 _key_mask = 0;
+        ice::Span<ice::arctic::Attribute const> _attributes;
+    };
+
+    //! \brief Decoded annotations of parsed definitions.
+    class AnnotationTables
+    {
+    public:
+        //! \brief Decodes all annotations attached to the definition, definitions without annotations are skipped.
+        void add_definition(ice::arctic::SyntaxNode const* definition) noexcept;
+
+        //! \returns The table of the definition, empty if the definition has no annotations.
+        //! \note The returned table is invalidated by the next call to 'add_definition' or 'clear'.
+        auto find(ice::arctic::SyntaxNode const* definition) const noexcept -> ice::arctic::AnnotationTable;
+
+        void clear() noexcept;
+
+    private:
+        struct TableRange
+        {
+            ice::u64 key_mask;
+            ice::u32 first;
+            ice::u32 count;
+        };
+
+        std::vector<ice::arctic::Attribute> _attributes;
+        std::unordered_map<ice::arctic::SyntaxNode const*, TableRange> _tables;
+    };
+
+} // namespace ice::arctic
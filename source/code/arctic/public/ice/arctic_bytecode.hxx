@@ -1,6 +1,261 @@
 #pragma once
+#include <ice/arctic_types.hxx>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 namespace ice::arctic
 {
 
+    //! \brief Operations of the register machine, each opcode works on a single type of lanes.
+    //!
+    //! \details Registers hold 32-bit lanes, values occupy consecutive registers: vectors one per component,
+    //!   matrices one per component in column-major order and structs the registers of their members.
+    //!   Booleans are stored as '0' or '1'. Unless noted otherwise instructions work on 'width' lanes,
+    //!   all source lanes are read before any destination lane is written.
+    enum class Opcode : ice::u8
+    {
+        Nop,
+
+        //! \brief Returns to the caller, the result is stored in the registers following the arguments.
+        Return,
+
+        //! \brief A = B
+        Move,
+
+        //! \brief A = constants[Bx]
+        LoadConstant,
+
+        //! \brief A = constants[Bx], the single constant is written to all lanes of A.
+        LoadConstantSplat,
+
+        //! \brief A = data of data_refs[Bx], the data of each binding is provided by the VM for each entity.
+        LoadData,
+
+        //! \brief data of data_refs[Bx] = A
+        StoreData,
+
+        //! \brief A = B, the single lane of B is written to all lanes of A.
+        Splat,
+
+        //! \brief A[i] = B[C >> (i * 2) & 3]
+        Swizzle,
+
+        //! \brief Calls functions[Bx], arguments are passed in the registers starting at A.
+        //! \details The registers of the callee start at A, so after it returns its result follows the arguments.
+        Call,
+
+        ConvertF32FromI32,
+        ConvertF32FromU32,
+        ConvertI32FromF32,
+        ConvertU32FromF32,
+
+        //! \brief A = B op C
+        AddF32,
+        SubF32,
+        MulF32,
+        DivF32,
+
+        //! \brief A = -B
+        NegF32,
+
+        //! \brief Also used to negate 'u32' values, the result has the same bits.
+        AddI32,
+        SubI32,
+        MulI32,
+        DivI32,
+        NegI32,
+
+        AddU32,
+        SubU32,
+        MulU32,
+        DivU32,
+
+        AndBool,
+        OrBool,
+
+        //! \brief A = B * C, with square matrices of 'width' columns. The destination may not overlap the sources.
+        MulMatrixVectorF32,
+        MulVectorMatrixF32,
+        MulMatrixMatrixF32,
+
+        Count
+    };
+
+    //! \brief Operands used by an opcode, used to decode instructions.
+    enum class InstructionFormat : ice::u8
+    {
+        None,
+        AB,
+        ABC,
+        ABx,
+    };
+
+    struct OpcodeInfo
+    {
+        ice::String name;
+        ice::arctic::InstructionFormat format;
+
+        //! \brief Set if each destination lane only depends on the same lane of the sources.
+        bool is_lane_wise;
+    };
+
+    auto opcode_info(ice::arctic::Opcode opcode) noexcept -> ice::arctic::OpcodeInfo const&;
+
+    //! \brief A single fixed-width instruction.
+    //!
+    //! \details Bits [0, 6) hold the opcode, bits [6, 8) the lane count minus one and the remaining bytes
+    //!   hold the A, B and C operands. Instructions using a table index store it in 'Bx', replacing B and C.
+    struct Instruction
+    {
+        ice::u32 value;
+
+        constexpr auto opcode() const noexcept -> ice::arctic::Opcode { return ice::arctic::Opcode(value & 0x3f); }
+        constexpr auto width() const noexcept -> ice::u32 { return ((value >> 6) & 0x3) + 1; }
+        constexpr auto a() const noexcept -> ice::u32 { return (value >> 8) & 0xff; }
+        constexpr auto b() const noexcept -> ice::u32 { return (value >> 16) & 0xff; }
+        constexpr auto c() const noexcept -> ice::u32 { return (value >> 24) & 0xff; }
+        constexpr auto bx() const noexcept -> ice::u32 { return value >> 16; }
+    };
+
+    static_assert(sizeof(ice::arctic::Instruction) == 4);
+    static_assert(ice::u32(ice::arctic::Opcode::Count) <= 64, "Opcodes are stored in six bits.");
+
+    //! \param width Number of lanes, between '1' and '4'.
+    constexpr auto make_instruction(
+        ice::arctic::Opcode opcode,
+        ice::u32 width,
+        ice::u32 a,
+        ice::u32 b = 0,
+        ice::u32 c = 0
+    ) noexcept -> ice::arctic::Instruction
+    {
+        return { ice::u32(opcode) | ((width - 1) << 6) | (a << 8) | (b << 16) | (c << 24) };
+    }
+
+    constexpr auto make_instruction_bx(
+        ice::arctic::Opcode opcode,
+        ice::u32 width,
+        ice::u32 a,
+        ice::u32 bx
+    ) noexcept -> ice::arctic::Instruction
+    {
+        return { ice::u32(opcode) | ((width - 1) << 6) | (a << 8) | (bx << 16) };
+    }
+
+    struct BytecodeFunction
+    {
+        //! \brief Offset of the name in the string table.
+        ice::u32 name;
+        ice::u32 first_instruction;
+        ice::u32 instruction_count;
+
+        ice::u16 register_count;
+
+        //! \brief Registers required to run the function including all functions called by it.
+        ice::u16 stack_size;
+
+        ice::u8 argument_size;
+        ice::u8 result_size;
+
+        //! \brief Set for functions with a stage result type, ex.: 'VertexShader'.
+        ice::u8 is_entry;
+        ice::u8 reserved;
+    };
+
+    //! \brief Data of a context variable, laid out with 'std430' rules.
+    struct BytecodeBinding
+    {
+        ice::u32 name;
+        ice::u32 size;
+    };
+
+    //! \brief A location in the data of a binding, accessed with 'LoadData' and 'StoreData'.
+    struct BytecodeDataRef
+    {
+        ice::u32 binding;
+        ice::u32 offset;
+    };
+
+    struct BytecodeHeader
+    {
+        static constexpr ice::u32 Constant_Magic = 0x4342'4341; // "ACBC"
+        static constexpr ice::u32 Constant_Version = 2;
+
+        ice::u32 magic;
+        ice::u32 version;
+        ice::u32 instruction_count;
+        ice::u32 constant_count;
+        ice::u32 function_count;
+        ice::u32 binding_count;
+        ice::u32 data_ref_count;
+
+        //! \brief Size of the string table in bytes, including the terminator of each string.
+        ice::u32 string_size;
+    };
+
+    static_assert(sizeof(ice::arctic::BytecodeFunction) % 4 == 0 && std::is_trivially_copyable_v<ice::arctic::BytecodeFunction>);
+    static_assert(sizeof(ice::arctic::BytecodeBinding) % 4 == 0 && std::is_trivially_copyable_v<ice::arctic::BytecodeBinding>);
+    static_assert(sizeof(ice::arctic::BytecodeDataRef) % 4 == 0 && std::is_trivially_copyable_v<ice::arctic::BytecodeDataRef>);
+    static_assert(sizeof(ice::arctic::BytecodeHeader) % 4 == 0 && std::is_trivially_copyable_v<ice::arctic::BytecodeHeader>);
+
+    //! \brief Read-only access to the sections of a bytecode blob.
+    //!
+    //! \details The blob is never modified after it was created, so a single blob can be shared by any number of
+    //!   threads and entity batches. All per-entity state, registers and the data of bindings, is owned by the VM.
+    class BytecodeView
+    {
+    public:
+        static constexpr ice::u32 Constant_None = 0xffff'ffff;
+
+        BytecodeView() noexcept = default;
+
+        //! \returns A view of the blob, or an empty view if the header doesn't match the size of the blob.
+        static auto from_words(ice::Span<ice::u32 const> words) noexcept -> ice::arctic::BytecodeView;
+
+        bool is_valid() const noexcept { return _header != nullptr; }
+
+        auto instructions() const noexcept -> ice::Span<ice::arctic::Instruction const> { return _instructions; }
+        auto constants() const noexcept -> ice::Span<ice::u32 const> { return _constants; }
+        auto functions() const noexcept -> ice::Span<ice::arctic::BytecodeFunction const> { return _functions; }
+        auto bindings() const noexcept -> ice::Span<ice::arctic::BytecodeBinding const> { return _bindings; }
+        auto data_refs() const noexcept -> ice::Span<ice::arctic::BytecodeDataRef const> { return _data_refs; }
+
+        //! \returns The string at the given offset of the string table, empty if the offset is out of range.
+        auto string(ice::u32 offset) const noexcept -> ice::String;
+
+        //! \returns The index of the function with the given name or 'Constant_None'.
+        auto find_function(ice::String name) const noexcept -> ice::u32;
+
+    private:
+        ice::arctic::BytecodeHeader const* _header = nullptr;
+        ice::Span<ice::arctic::Instruction const> _instructions;
+        ice::Span<ice::u32 const> _constants;
+        ice::Span<ice::arctic::BytecodeFunction const> _functions;
+        ice::Span<ice::arctic::BytecodeBinding const> _bindings;
+        ice::Span<ice::arctic::BytecodeDataRef const> _data_refs;
+        ice::String _strings;
+    };
+
+    //! \brief Owns a bytecode blob, stored as the header followed by the instructions, the constant pool,
+    //!   the function, binding and data reference tables and the string table.
+    class Bytecode
+    {
+    public:
+        Bytecode() noexcept = default;
+        explicit Bytecode(std::vector<ice::u32> words) noexcept
+            : _words{ std::move(words) }
+        {
+        }
+
+        auto words() const noexcept -> ice::Span<ice::u32 const> { return _words; }
+        auto view() const noexcept -> ice::arctic::BytecodeView { return ice::arctic::BytecodeView::from_words(_words); }
+
+    private:
+        std::vector<ice::u32> _words;
+    };
+
+    //! \brief Writes all tables and the instructions of each function as text, used to check the output of the compiler.
+    void disassemble(ice::arctic::BytecodeView bytecode, std::u8string& out) noexcept;
+
 } // namespace ice::arctic
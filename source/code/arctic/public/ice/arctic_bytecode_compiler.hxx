@@ -0,0 +1,236 @@
+#pragma once
+#include <ice/arctic_bytecode.hxx>
+#include <ice/arctic_operand_list.hxx>
+#include <ice/arctic_semantic.hxx>
+#include <ice/arctic_struct_layout.hxx>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    //! \brief Compiles resolved definitions into a single bytecode blob.
+    //!
+    //! \details Each function gets its own register frame: arguments are stored in the first registers, followed by
+    //!   the result and the locals. Locals are freed at the end of their scope and temporary values at the end of
+    //!   each statement, results of operations, constructors and calls reuse the temporary values of their operands.
+    //!   Calls pass arguments in the free registers above the caller's values, the frame of the
+    //!   callee starts at the first argument. Functions with a stage result type are entry functions, their result
+    //!   is the value assigned to the function name.
+    //!
+    //!   Context variables become bindings, their data is read and written with 'std430' offsets. Only the data of
+    //!   bindings changes between entities, the blob itself is never modified. Locals and results are cleared before
+    //!   they are used, so no values of a previous entity can be observed.
+    //!   References to global 'const' definitions are compiled from their initializer, literals go into the constant pool.
+    //!   Each bit pattern is stored once, values with the same constant in all lanes are loaded with 'LoadConstantSplat'.
+    //!
+    //! \note Only 32-bit scalars, vectors and matrices of 'f32' and structs of these are supported. Matrix products
+    //!   are limited to square 'f32' matrices. Recursive calls and writes to global variables are reported as errors.
+    class BytecodeCompiler
+    {
+    public:
+        //! \brief Limit of registers in a single frame, register operands are stored in a single byte.
+        static constexpr ice::u32 Constant_MaxRegisters = 256;
+
+        //! \brief Limit of entries in each table accessed by instructions, indices are stored in 16 bits.
+        static constexpr ice::u32 Constant_MaxTableSize = 0x1'0000;
+
+        //! \param model The model used to resolve the definitions, result types of operations are created with it.
+        explicit BytecodeCompiler(ice::arctic::SemanticModel& model) noexcept;
+
+        BytecodeCompiler(BytecodeCompiler const&) noexcept = delete;
+        auto operator=(BytecodeCompiler const&) noexcept -> BytecodeCompiler& = delete;
+
+        //! \brief Compiles all functions of the definitions, definitions need to be resolved by the model.
+        //! \returns The state of the first error, all errors can be accessed using 'diagnostics'.
+        //!   The bytecode is only written if no error was found.
+        auto compile(
+            ice::Span<ice::arctic::SyntaxNode const* const> definitions,
+            ice::arctic::Bytecode& out_bytecode
+        ) noexcept -> ice::arctic::ParseState;
+
+        auto diagnostics() const noexcept -> ice::Span<ice::arctic::ParseDiagnostic const>
+        {
+            return _diagnostics;
+        }
+
+    private:
+        static constexpr ice::u32 Constant_None = 0xffff'ffff;
+
+        struct FunctionEntry
+        {
+            ice::arctic::SyntaxNode_Function const* definition;
+
+            //! \brief The type stored in the result registers, for entry functions the type assigned to the function name.
+            ice::arctic::TypeHandle result_type;
+            ice::u32 name;
+            ice::u32 first_instruction;
+            ice::u32 instruction_count;
+            ice::u32 register_count;
+            ice::u32 stack_size;
+            ice::u32 argument_size;
+            ice::u32 result_size;
+
+            //! \brief Calls made by the function, stored in 'calls'.
+            ice::u32 first_call;
+            ice::u32 call_count;
+
+            bool is_entry;
+
+            //! \brief Cleared if the signature uses unsupported types, the body is not compiled.
+            bool is_valid;
+
+            //! \brief Set while the stack size is computed, used to detect recursive calls.
+            bool is_visiting;
+        };
+
+        struct CallSite
+        {
+            ice::u32 callee;
+
+            //! \brief Register of the first argument, the frame of the callee starts at it.
+            ice::u32 base;
+            ice::arctic::Token token;
+        };
+
+        //! \brief A value stored in registers, or a scalar constant not loaded yet.
+        struct Value
+        {
+            ice::arctic::TypeHandle type;
+            ice::u32 reg;
+            ice::u32 constant;
+            bool is_constant;
+
+            //! \brief The only instruction writing a new temporary value, its destination can be replaced.
+            ice::u32 producer;
+        };
+
+        //! \brief A location read or written by an operand, either registers or the data of a binding.
+        struct Place
+        {
+            ice::arctic::TypeHandle type;
+
+            //! \brief The value of operands not stored in a variable, ex.: literals or results of calls.
+            Value value;
+            bool is_value;
+            bool is_readonly;
+
+            //! \brief The first register, or the byte offset in the data of the binding.
+            ice::u32 location;
+            ice::u32 binding;
+
+            //! \brief The vector selected from by a swizzle, 'nullptr' if the place has no swizzle.
+            ice::arctic::TypeHandle swizzled;
+            ice::u8 components[4];
+            ice::u32 component_count;
+        };
+
+        void declare_function(ice::arctic::SyntaxNode_Function const* definition) noexcept;
+        void compile_function(ice::u32 function) noexcept;
+        auto compute_stack_size(ice::u32 function) noexcept -> ice::u32;
+        auto write_words() const noexcept -> std::vector<ice::u32>;
+
+        void compile_statements(ice::arctic::SyntaxNode const* first) noexcept;
+        void compile_variable(ice::arctic::SyntaxNode_Variable const* variable) noexcept;
+
+        auto compile_list(ice::arctic::SyntaxNode const* parent) noexcept -> Value;
+        auto compile_term(ice::arctic::OperandList const& list, ice::u32 term) noexcept -> Value;
+        auto compile_assignment(ice::arctic::OperandList const& list, ice::arctic::OperandTerm const& term) noexcept -> Value;
+        auto compile_operand(ice::arctic::SyntaxNode const* node) noexcept -> Value;
+        auto compile_literal(ice::arctic::SyntaxNode_ExpressionValue const* node) noexcept -> Value;
+        auto compile_constant(ice::arctic::Symbol const* symbol, ice::arctic::Token const& token) noexcept -> Value;
+        auto compile_call(ice::arctic::SyntaxNode_ExpressionCall const* node) noexcept -> Value;
+        auto compile_function_call(ice::arctic::SyntaxNode_ExpressionCall const* node, ice::u32 callee) noexcept -> Value;
+        auto compile_constructor(ice::arctic::SyntaxNode_ExpressionCall const* node, ice::arctic::TypeHandle type) noexcept -> Value;
+
+        auto place_of(ice::arctic::SyntaxNode const* node) noexcept -> Place;
+        void apply_members(Place& place, ice::arctic::SyntaxNode const* node) noexcept;
+        auto read(Place const& place) noexcept -> Value;
+        auto write(Place const& place, Value value, ice::arctic::Token const& token) noexcept -> Value;
+
+        //! \param first_temporary The first register allocated for the operands, registers above it can hold the result.
+        auto binary(Value left, ice::arctic::Token const& operation, Value right, ice::u32 first_temporary) noexcept -> Value;
+        auto negate(Value value, ice::arctic::Token const& token, ice::u32 first_temporary) noexcept -> Value;
+        auto convert(Value value, ice::arctic::TypeHandle type, ice::arctic::Token const& token) noexcept -> Value;
+        auto convert_lanes(Value value, ice::arctic::TypeHandle type, ice::arctic::Token const& token) noexcept -> Value;
+        auto materialize(Value value) noexcept -> Value;
+
+        //! \brief Stores the value in the given registers, replacing the destination of its producer if possible.
+        void store_value(ice::u32 reg, Value const& value) noexcept;
+        void clear_registers(ice::u32 reg, ice::u32 size) noexcept;
+
+        //! \brief Loads the words into consecutive registers, a single constant is loaded into all of them if the words are equal.
+        //! \returns The producer of the registers, if a single instruction was emitted.
+        auto load_constants(ice::u32 reg, ice::Span<ice::u32 const> words) noexcept -> ice::u32;
+        auto load_splat_constant(ice::u32 reg, ice::u32 size, ice::u32 bits) noexcept -> ice::u32;
+
+        //! \brief Loads or stores a value of the given type from the data of a binding, one instruction per column or member.
+        void transfer_data(
+            ice::arctic::Opcode opcode,
+            ice::arctic::TypeHandle type,
+            ice::u32 binding,
+            ice::u32 offset,
+            ice::u32 reg
+        ) noexcept;
+
+        //! \brief Emits the operation for each group of up to four lanes.
+        //! \returns The producer of the destination, if a single instruction was emitted.
+        auto emit_lanes(ice::arctic::Opcode opcode, ice::u32 size, ice::u32 a, ice::u32 b, ice::u32 c) noexcept -> ice::u32;
+        auto emit(ice::arctic::Instruction instruction) noexcept -> ice::u32;
+
+        auto allocate(ice::u32 size) noexcept -> ice::u32;
+
+        //! \brief Allocates a block the values are stored into one after another, starting at the temporary values
+        //!   holding them if storing them in order overwrites none of them before it's stored.
+        auto pack_registers(ice::u32 first_temporary, ice::Span<Value const> values, ice::u32 size) noexcept -> ice::u32;
+        auto add_constants(ice::Span<ice::u32 const> words) noexcept -> ice::u32;
+        auto add_data_ref(ice::u32 binding, ice::u32 offset) noexcept -> ice::u32;
+        auto add_string(ice::String text) noexcept -> ice::u32;
+
+        //! \returns The number of registers used by a value of the type, '0' for unsupported types.
+        auto register_size(ice::arctic::TypeHandle type) const noexcept -> ice::u32;
+        auto member_register_offset(ice::arctic::TypeHandle type, ice::u32 member) const noexcept -> ice::u32;
+
+        //! \brief Type of the first value assigned to the function name, entry functions don't declare their result.
+        auto entry_result_type(ice::arctic::SyntaxNode_Function const* definition) noexcept -> ice::arctic::TypeHandle;
+        auto term_type(ice::arctic::OperandList const& list, ice::u32 term) noexcept -> ice::arctic::TypeHandle;
+        auto operand_type(ice::arctic::SyntaxNode const* node) noexcept -> ice::arctic::TypeHandle;
+
+        void report(ice::arctic::ParseState state, ice::arctic::Token const& token) noexcept;
+
+    private:
+        ice::arctic::SemanticModel& _model;
+        ice::arctic::StructLayoutTable _layouts;
+        std::vector<ice::arctic::ParseDiagnostic> _diagnostics;
+
+        std::vector<ice::arctic::Instruction> _code;
+        std::vector<ice::u32> _constants;
+        std::vector<FunctionEntry> _functions;
+        std::vector<ice::arctic::BytecodeBinding> _bindings;
+        std::vector<ice::arctic::BytecodeDataRef> _data_refs;
+        std::vector<CallSite> _calls;
+        std::u8string _strings;
+
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::u32> _function_indices;
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::u32> _binding_indices;
+        std::unordered_map<ice::String, ice::u32> _string_offsets;
+
+        //! \brief Index of the first constant with the given bits.
+        std::unordered_map<ice::u32, ice::u32> _constant_indices;
+
+        // State of the function currently compiled.
+        ice::u32 _function = 0;
+        ice::u32 _result_register = 0;
+        ice::u32 _register_top = 0;
+        ice::u32 _register_count = 0;
+        bool _register_limit_reported = false;
+        bool _table_limit_reported = false;
+        ice::arctic::Token _statement{ };
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::u32> _registers;
+
+        //! \brief Global constants compiled from their initializer, used to detect constants referencing themselves.
+        std::vector<ice::arctic::SyntaxNode const*> _expanding;
+    };
+
+} // namespace ice::arctic
@@ -0,0 +1,51 @@
+#pragma once
+#include <ice/arctic_lexer.hxx>
+#include <ice/arctic_parser.hxx>
+#include <ice/arctic_syntax_visitor.hxx>
+
+namespace ice::arctic
+{
+
+    struct WordMatcher;
+
+    struct SourceDesc
+    {
+        //! \brief The script contents, needs to be null-terminated and stay valid until the batch finishes.
+        ice::String source;
+
+        ice::arctic::LexerOptions lexer_options = { };
+
+        ice::arctic::ParserOptions parser_options = { };
+
+        //! \brief Visitors called for this script only.
+        //! \note Visitors are called from the worker compiling the script and should not be shared between sources.
+        ice::Span<ice::arctic::SyntaxVisitorBase* const> visitors = { };
+    };
+
+    struct CompileResult
+    {
+        ice::arctic::ParseState state = ParseState::Success;
+
+        //! \brief All errors found in the source, contains more than one entry only if recovery was enabled.
+        std::vector<ice::arctic::ParseDiagnostic> diagnostics;
+    };
+
+    //! \brief Compiles all given sources using up to 'jobs' threads, each with its own parser.
+    //! \note The matcher is only read during compilation and is shared between all workers.
+    //! \returns The number of sources that failed to compile.
+    auto compile_batch(
+        ice::arctic::WordMatcher const* matcher,
+        ice::Span<ice::arctic::SourceDesc const> sources,
+        ice::Span<ice::arctic::CompileResult> out_results,
+        ice::u32 jobs = 0
+    ) noexcept -> ice::u32;
+
+    //! \copydoc compile_batch
+    //! \note Initializes an ascii word matcher for the duration of the batch.
+    auto compile_batch(
+        ice::Span<ice::arctic::SourceDesc const> sources,
+        ice::Span<ice::arctic::CompileResult> out_results,
+        ice::u32 jobs = 0
+    ) noexcept -> ice::u32;
+
+} // namespace ice::arctic
@@ -0,0 +1,100 @@
+#pragma once
+#include <ice/arctic_semantic.hxx>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    //! \brief A value of a scalar type known at compile time.
+    struct ConstantValue
+    {
+        ice::arctic::TypeHandle type;
+
+        //! \brief The member used depends on the scalar type, integers are stored sign- or zero-extended to 64 bits.
+        union
+        {
+            bool boolean;
+            ice::i64 integer;
+            ice::f64 floating;
+        };
+    };
+
+    //! \brief Evaluates constant subexpressions and replaces each of them with a single literal value.
+    //!
+    //! \details Operations are only evaluated if both operands have the same type, there are no implicit conversions,
+    //!   constant operands of different scalar types and divisions by a constant zero are reported at the operator.
+    //!   Integer operations wrap around at the width of their type, floating point operations are evaluated with the
+    //!   precision of their type and are only folded if the result is finite. Operator precedence is applied to the
+    //!   flat operand lists of expressions, so only complete subexpressions are replaced.
+    //!   References to 'const' definitions are replaced with their value, the initializer of each such definition needs to be constant.
+    //!
+    //! \note The syntax tree is modified in place, replaced nodes are released with the allocator that created them.
+    //!   Texts of new literals are owned by the folder, so it needs to outlive the tree.
+    //!   Semantic information of released nodes is no longer valid, values of new literals are available with 'constant_of'.
+    class ConstantFolder
+    {
+    public:
+        ConstantFolder(ice::arctic::SyntaxNodeAllocator& alloc, ice::arctic::SemanticModel const& model) noexcept;
+
+        ConstantFolder(ConstantFolder const&) noexcept = delete;
+        auto operator=(ConstantFolder const&) noexcept -> ConstantFolder& = delete;
+
+        //! \brief Folds all definitions, they need to be resolved by the semantic model and owned by the allocator.
+        //! \returns The state of the first error, all errors can be accessed using 'diagnostics'.
+        auto fold(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept -> ice::arctic::ParseState;
+
+        //! \returns The value of a 'const' definition or of a literal created by the folder, 'nullptr' for any other node.
+        auto constant_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::ConstantValue const*;
+
+        //! \brief Number of subexpressions and constant references replaced with literals.
+        auto folded_count() const noexcept -> ice::u32 { return _folded_count; }
+
+        auto diagnostics() const noexcept -> ice::Span<ice::arctic::ParseDiagnostic const>
+        {
+            return _diagnostics;
+        }
+
+    private:
+        void fold_constant(ice::arctic::SyntaxNode_Variable* node) noexcept;
+        void fold_global_constant(ice::arctic::SyntaxNode const* node, ice::arctic::Token const& reference) noexcept;
+        void fold_statements(ice::arctic::SyntaxNode* first) noexcept;
+        void fold_nested(ice::arctic::SyntaxNode* node) noexcept;
+
+        //! \brief Folds the operand list of the given node, leading operations like the assignment of initializers are kept.
+        //! \returns 'true' if the whole list is constant, the value is stored in 'out_value'.
+        bool fold_list(ice::arctic::SyntaxNode* parent, ice::arctic::ConstantValue& out_value) noexcept;
+
+        bool evaluate_operand(ice::arctic::SyntaxNode const* node, ice::arctic::ConstantValue& out_value) noexcept;
+        bool evaluate_literal(ice::arctic::SyntaxNode_ExpressionValue const* node, ice::arctic::ConstantValue& out_value) const noexcept;
+        bool evaluate_binary(
+            ice::arctic::ConstantValue const& left,
+            ice::arctic::Token const& operation,
+            ice::arctic::ConstantValue const& right,
+            ice::arctic::ConstantValue& out_value
+        ) noexcept;
+
+        auto create_literal(ice::arctic::ConstantValue const& value, ice::arctic::TokenLocation location) noexcept -> ice::arctic::SyntaxNode*;
+
+        //! \brief Releases the node and, if requested, all nodes owned by it. Siblings are never released.
+        void release(ice::arctic::SyntaxNode* node, bool with_children) noexcept;
+
+        void report(ice::arctic::ParseState state, ice::arctic::Token const& token) noexcept;
+
+    private:
+        ice::arctic::SyntaxNodeAllocator& _alloc;
+        ice::arctic::SemanticModel const& _model;
+
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::arctic::ConstantValue> _constants;
+        std::deque<std::u8string> _literals;
+        std::vector<ice::arctic::ParseDiagnostic> _diagnostics;
+
+        //! \brief Global 'const' definitions not evaluated yet, they are evaluated when first referenced.
+        //! \details The value is set while the definition is evaluated, to detect definitions referencing themselves.
+        std::unordered_map<ice::arctic::SyntaxNode const*, bool> _pending_globals;
+        ice::u32 _folded_count = 0;
+    };
+
+} // namespace ice::arctic
@@ -0,0 +1,151 @@
+#pragma once
+#include <ice/arctic_semantic.hxx>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    struct InlinerOptions
+    {
+        //! \brief Functions with a higher cost are never inlined, the cost is the number of nodes in the function body.
+        ice::u32 max_cost = 32;
+
+        //! \brief Limits the number of calls inlined into a single function, including calls of inlined bodies.
+        ice::u32 max_inlined_calls = 64;
+    };
+
+    //! \brief Replaces calls of small functions with a copy of their body, before the tree is passed to any backend.
+    //!
+    //! \details Each argument is bound to a new local initialized with the argument expression, followed by a local
+    //!   holding the result and a copy of the body. Arguments passing a single variable or literal are substituted
+    //!   instead, if the body doesn't assign them. All locals and arguments of the copied body are renamed, assignments
+    //!   to the function name write the result local instead. The call is then replaced by a reference to the result.
+    //!   Copies are placed before the statement of the call, so arguments are still evaluated once and in order.
+    //!
+    //!   Functions are inlined if they are not recursive, not an entry function, assign their result and their cost is
+    //!   within the limit. Functions writing globals are only inlined if their call is the whole statement, reading
+    //!   globals is only allowed if no other call of the statement could write them before the original call.
+    //!   Calls are also kept if a name read by the body would be shadowed by a local of the caller.
+    //!
+    //! \note The syntax tree is modified in place, new nodes are created with the given allocator and names of new
+    //!   locals are owned by the inliner. Inlined functions are not removed, see 'InterfacePruner' for unused functions.
+    //!   The semantic model is not updated, a new model needs to be resolved to check the modified definitions.
+    class FunctionInliner
+    {
+    public:
+        static constexpr ice::u32 Constant_NotInlinable = 0xffff'ffff;
+
+        FunctionInliner(
+            ice::arctic::SyntaxNodeAllocator& alloc,
+            ice::arctic::SemanticModel const& model,
+            ice::arctic::InlinerOptions const& options = { }
+        ) noexcept;
+
+        ~FunctionInliner() noexcept;
+
+        FunctionInliner(FunctionInliner const&) noexcept = delete;
+        auto operator=(FunctionInliner const&) noexcept -> FunctionInliner& = delete;
+
+        //! \brief Inlines calls in all function bodies, definitions need to be resolved by the model.
+        //! \returns The number of inlined calls.
+        auto inline_calls(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept -> ice::u32;
+
+        //! \returns The cost of the function body, or 'Constant_NotInlinable' for entry functions, recursive functions
+        //!   and functions that can't be copied. Costs above the limit and of functions with side effects are returned as well.
+        //! \note Only valid after calling 'inline_calls'.
+        auto inline_cost(ice::arctic::SyntaxNode const* function) const noexcept -> ice::u32;
+
+    private:
+        struct FunctionSummary
+        {
+            ice::arctic::SyntaxNode_Function const* definition;
+            ice::u32 cost;
+            ice::u32 argument_count;
+            ice::u32 result_assignments;
+
+            //! \brief Set if the body only contains copyable nodes and the result is assigned, if it isn't 'void'.
+            bool is_supported;
+            bool is_recursive;
+            bool has_result;
+            bool writes_globals;
+            bool reads_globals;
+
+            //! \brief See 'result_value_of', points into the copied body.
+            ice::arctic::SyntaxNode const* result_value;
+
+            //! \brief Copy of the body taken before any call was inlined, only set for functions that can be inlined.
+            ice::arctic::SyntaxNode* body;
+
+            //! \brief Arguments and locals declared by the function, these are renamed in each copy.
+            std::vector<ice::arctic::SyntaxNode const*> declarations;
+            std::vector<ice::arctic::SyntaxNode const*> callees;
+
+            //! \brief Arguments assigned by the body and arguments followed by a member access.
+            std::unordered_set<ice::arctic::SyntaxNode const*> assigned_arguments;
+            std::unordered_set<ice::arctic::SyntaxNode const*> accessed_arguments;
+
+            //! \brief Names read by the body that are not declared by it, these can't be shadowed at the call site.
+            std::unordered_set<ice::String> free_names;
+        };
+
+        void summarize(ice::arctic::SyntaxNode_Function const* definition) noexcept;
+        void summarize_children(FunctionSummary& summary, ice::arctic::SyntaxNode const* parent) noexcept;
+        void propagate_effects() noexcept;
+
+        //! \returns The operands assigned to the function name by the last statement of the copied body, if the result
+        //!   is only assigned once. These initialize the result local directly.
+        auto result_value_of(FunctionSummary const& summary) const noexcept -> ice::arctic::SyntaxNode const*;
+
+        void inline_block(ice::arctic::SyntaxNode* block) noexcept;
+        bool inline_first_call(ice::arctic::SyntaxNode** statement) noexcept;
+
+        //! \returns The link to the first call that can be inlined, or 'nullptr'.
+        //! \param is_statement Set if the node is the whole statement, calls of functions with side effects need to be.
+        auto find_call(ice::arctic::SyntaxNode** link, bool is_statement, bool statement_effects) const noexcept -> ice::arctic::SyntaxNode**;
+        bool can_inline(ice::arctic::SyntaxNode const* call, bool is_statement, bool statement_effects) const noexcept;
+        bool has_effects(ice::arctic::SyntaxNode const* node) const noexcept;
+
+        void expand(ice::arctic::SyntaxNode** statement, ice::arctic::SyntaxNode** call_link, bool is_statement) noexcept;
+        auto clone(ice::arctic::SyntaxNode const* node) noexcept -> ice::arctic::SyntaxNode*;
+        auto clone_list(ice::arctic::SyntaxNode const* first) noexcept -> ice::arctic::SyntaxNode*;
+        auto substitute(ice::arctic::SyntaxNode const* argument, ice::arctic::SyntaxNode* node) noexcept -> ice::arctic::SyntaxNode*;
+
+        auto create_variable(
+            ice::String name,
+            ice::arctic::Token const& type,
+            ice::arctic::SyntaxNode* initializer,
+            ice::arctic::TokenLocation location
+        ) noexcept -> ice::arctic::SyntaxNode_Variable*;
+
+        auto summary_of(ice::arctic::SyntaxNode const* call) const noexcept -> FunctionSummary const*;
+        auto origin_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::SyntaxNode const*;
+
+        void release(ice::arctic::SyntaxNode* node) noexcept;
+
+    private:
+        ice::arctic::SyntaxNodeAllocator& _alloc;
+        ice::arctic::SemanticModel const& _model;
+        ice::arctic::InlinerOptions const _options;
+
+        std::unordered_set<ice::arctic::SyntaxNode const*> _globals;
+        std::unordered_map<ice::arctic::SyntaxNode const*, FunctionSummary> _functions;
+        std::deque<std::u8string> _names;
+
+        //! \brief Copied nodes mapped to the nodes they were copied from, only these are known to the semantic model.
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::arctic::SyntaxNode const*> _origins;
+
+        // State of the function currently inlined into.
+        std::unordered_set<ice::String> _local_names;
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::String> _renames;
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::arctic::SyntaxNode const*> _substitutions;
+        ice::u32 _function_inlined_count = 0;
+
+        ice::u32 _name_index = 0;
+        ice::u32 _inlined_count = 0;
+    };
+
+} // namespace ice::arctic
@@ -1,11 +1,18 @@
 #pragma once
 #include <ice/arctic_context.hxx>
+#include <ice/arctic_memory_stats.hxx>
+#include <ice/arctic_trace.hxx>
 #include <coroutine>
 #include <cassert>
+#include <cstdlib>
 
 namespace ice::arctic::detail
 {
 
+    //! \brief The phase coroutine frames and resumptions of a generator are charged to, specialized next to each generator type.
+    template<typename Result>
+    constexpr ice::arctic::MemoryPhase Constant_GeneratorMemoryPhase = MemoryPhase::Other;
+
     template<typename Result>
     class Generator
     {
@@ -23,6 +30,9 @@ namespace ice::arctic::detail
 
         auto next() noexcept -> Result;
 
+        //! \returns The last value returned by 'next()'.
+        auto current() const noexcept -> Result const&;
+
     public:
         struct Promise
         {
@@ -38,6 +48,26 @@ namespace ice::arctic::detail
 
             auto get_return_object() noexcept -> Generator<Result>;
 
+#if ICE_ARCTIC_MEMORY_TRACKING
+            // Frames bypass 'operator new', so applications forwarding it to 'track_allocation' don't count them twice.
+            static auto operator new(std::size_t size) noexcept -> void*
+            {
+                ice::arctic::detail::track_phase_allocation(Constant_GeneratorMemoryPhase<Result>, size);
+                return std::malloc(size);
+            }
+
+            static void operator delete(void* ptr, std::size_t size) noexcept
+            {
+                ice::arctic::detail::track_phase_deallocation(Constant_GeneratorMemoryPhase<Result>, size);
+                std::free(ptr);
+            }
+
+            static auto get_return_object_on_allocation_failure() noexcept -> Generator<Result>
+            {
+                return Generator<Result>{ nullptr };
+            }
+#endif
+
             Result _value;
         };
 
@@ -89,12 +119,22 @@ namespace ice::arctic::detail
     template<typename Result>
     inline auto Generator<Result>::next() noexcept -> Result
     {
+        ice::arctic::MemoryScope const memory_scope{ Constant_GeneratorMemoryPhase<Result> };
+#if ICE_ARCTIC_TRACING >= 2
+        ice::arctic::TraceScope const trace_scope{ ice::arctic::to_string(Constant_GeneratorMemoryPhase<Result>) };
+#endif
         if (!_coro.done())
         {
             _coro.resume();
         }
 
-        return std::move(_coro.promise()._value);
+        return _coro.promise()._value;
+    }
+
+    template<typename Result>
+    inline auto Generator<Result>::current() const noexcept -> Result const&
+    {
+        return _coro.promise()._value;
     }
 
     template<typename Result>
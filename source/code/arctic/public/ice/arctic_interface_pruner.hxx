@@ -0,0 +1,97 @@
+#pragma once
+#include <ice/arctic_semantic.hxx>
+#include <ice/arctic_annotation_table.hxx>
+#include <unordered_set>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    enum class PrunedKind : ice::u8
+    {
+        //! \brief A context variable annotated with 'in'.
+        Input,
+
+        //! \brief A context variable annotated with 'out'.
+        Output,
+
+        //! \brief A context variable annotated with 'constant' or a global 'const' definition.
+        Constant,
+        ContextVariable,
+        Variable,
+        Function,
+        Member,
+    };
+
+    struct PrunedEntry
+    {
+        ice::arctic::PrunedKind kind;
+        ice::arctic::Token name;
+
+        //! \brief The name of the struct of pruned members, empty for definitions.
+        ice::String owner;
+
+        //! \brief The value of the 'in' or 'out' attribute, ex.: the location of inputs.
+        ice::String binding;
+    };
+
+    //! \brief Removes context variables, globals, functions and struct members not reachable from entry functions.
+    //!
+    //! \details Functions with a stage result type, ex.: 'VertexShader', are entry functions. Everything referenced by
+    //!   their bodies is reachable, including functions they call and initializers of globals they read.
+    //!   Struct members are reachable if they are accessed by name, structs used as a whole value keep all members.
+    //!   If no entry function was found nothing is pruned, the definitions are considered a library.
+    //!
+    //! \note Unused members are removed from the struct nodes and released, so the semantic model needs to be rebuilt
+    //!   from 'definitions' before it is used again. Definitions themselves are only filtered, as they are owned by the parser.
+    class InterfacePruner
+    {
+    public:
+        //! \param annotations Decoded annotations of the definitions, used to report the bindings of pruned variables.
+        InterfacePruner(
+            ice::arctic::SyntaxNodeAllocator& alloc,
+            ice::arctic::SemanticModel const& model,
+            ice::arctic::AnnotationTables const& annotations
+        ) noexcept;
+
+        InterfacePruner(InterfacePruner const&) noexcept = delete;
+        auto operator=(InterfacePruner const&) noexcept -> InterfacePruner& = delete;
+
+        //! \brief Finds all reachable definitions and prunes everything else, definitions need to be resolved by the model.
+        //! \returns The number of pruned definitions and members.
+        auto prune(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept -> ice::u32;
+
+        //! \brief The remaining definitions in source order, annotations of pruned definitions are removed as well.
+        auto definitions() const noexcept -> ice::Span<ice::arctic::SyntaxNode const* const>
+        {
+            return _definitions;
+        }
+
+        //! \brief Pruned definitions and members in source order.
+        auto pruned() const noexcept -> ice::Span<ice::arctic::PrunedEntry const>
+        {
+            return _pruned;
+        }
+
+        //! \returns 'true' if the definition or struct member is used by an entry function.
+        bool is_reachable(ice::arctic::SyntaxNode const* node) const noexcept;
+
+    private:
+        void mark_reachable(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept;
+        void mark_whole(ice::arctic::TypeHandle type) noexcept;
+
+        auto pruned_kind(ice::arctic::SyntaxNode const* definition) const noexcept -> ice::arctic::PrunedKind;
+        auto prune_members(ice::arctic::SyntaxNode_Struct* node) noexcept -> ice::u32;
+
+    private:
+        ice::arctic::SyntaxNodeAllocator& _alloc;
+        ice::arctic::SemanticModel const& _model;
+        ice::arctic::AnnotationTables const& _annotations;
+
+        std::unordered_set<ice::arctic::SyntaxNode const*> _reachable;
+        std::unordered_set<ice::arctic::TypeHandle> _whole_types;
+        std::vector<ice::arctic::SyntaxNode const*> _definitions;
+        std::vector<ice::arctic::PrunedEntry> _pruned;
+    };
+
+} // namespace ice::arctic
@@ -7,6 +7,9 @@ namespace ice::arctic
 
     using Lexer = ice::arctic::detail::Generator<ice::arctic::Token>;
 
+    template<>
+    constexpr ice::arctic::MemoryPhase detail::Constant_GeneratorMemoryPhase<ice::arctic::Token> = MemoryPhase::Lexing;
+
     enum class LexerRules
     {
         Provided,
@@ -0,0 +1,156 @@
+#pragma once
+#include <ice/arctic_syntax.hxx>
+#include <string>
+#include <vector>
+
+//! \brief Enables memory accounting, define as '1' to count allocations per phase, syntax entity and visitor.
+//! \note When disabled scopes are empty objects and no counters are touched.
+#ifndef ICE_ARCTIC_MEMORY_TRACKING
+#define ICE_ARCTIC_MEMORY_TRACKING 0
+#endif
+
+namespace ice::arctic
+{
+
+    struct SyntaxNode;
+
+    enum class MemoryPhase : ice::u8
+    {
+        //! \brief Allocations outside of any known phase, ex.: the word matcher table.
+        Other,
+        WordProcessing,
+        Lexing,
+        Parsing,
+        Visiting,
+    };
+
+    static constexpr ice::u32 Constant_MemoryPhaseCount = static_cast<ice::u32>(MemoryPhase::Visiting) + 1;
+
+    auto to_string(ice::arctic::MemoryPhase phase) noexcept -> char const*;
+
+    struct MemoryCounters
+    {
+        ice::u64 allocations = 0;
+        ice::u64 deallocations = 0;
+        ice::u64 allocated_bytes = 0;
+
+        //! \brief Bytes allocated and not yet released, releases of memory allocated outside of the counters are ignored.
+        ice::u64 live_bytes = 0;
+        ice::u64 peak_bytes = 0;
+
+        void add_allocation(ice::u64 size) noexcept
+        {
+            allocations += 1;
+            allocated_bytes += size;
+            live_bytes += size;
+            peak_bytes = live_bytes > peak_bytes ? live_bytes : peak_bytes;
+        }
+
+        void add_deallocation(ice::u64 size) noexcept
+        {
+            deallocations += 1;
+            live_bytes -= size < live_bytes ? size : live_bytes;
+        }
+
+        //! \note The peak of merged counters is the sum of both peaks, so it's an upper bound if both where active at once.
+        void merge(ice::arctic::MemoryCounters const& other) noexcept
+        {
+            allocations += other.allocations;
+            deallocations += other.deallocations;
+            allocated_bytes += other.allocated_bytes;
+            live_bytes += other.live_bytes;
+            peak_bytes += other.peak_bytes;
+        }
+    };
+
+    struct MemoryStats
+    {
+        ice::arctic::MemoryCounters total;
+        ice::arctic::MemoryCounters phases[Constant_MemoryPhaseCount];
+
+        //! \brief Syntax nodes only, indexed by the entity of the node.
+        ice::arctic::MemoryCounters entities[Constant_SyntaxEntityCount];
+
+        //! \brief Allocations made while a visitor handled a node, in the order visitors where added.
+        std::vector<ice::arctic::MemoryCounters> visitors;
+
+        void merge(ice::arctic::MemoryStats const& other) noexcept;
+    };
+
+    //! \brief Returns the stats as a JSON object, entities without allocations are omitted.
+    auto memory_stats_json(ice::arctic::MemoryStats const& stats) noexcept -> std::string;
+
+    //! \brief Charges all tracked allocations made on the current thread to the given stats until the scope ends.
+    //! \details Scopes can be nested, only the innermost scope is charged.
+    class MemoryScope
+    {
+    public:
+        MemoryScope(ice::arctic::MemoryStats& stats, ice::arctic::MemoryPhase phase) noexcept;
+
+        //! \brief Charges allocations to the visitor at the given index and the 'Visiting' phase.
+        MemoryScope(ice::arctic::MemoryStats& stats, ice::u32 visitor_index) noexcept;
+
+        //! \brief Changes only the phase of the enclosing scope, does nothing if there is no enclosing scope.
+        explicit MemoryScope(ice::arctic::MemoryPhase phase) noexcept;
+
+        MemoryScope(MemoryScope const&) noexcept = delete;
+        auto operator=(MemoryScope const&) noexcept -> MemoryScope& = delete;
+
+        ~MemoryScope() noexcept;
+
+#if ICE_ARCTIC_MEMORY_TRACKING
+        ice::arctic::MemoryStats* const stats;
+        ice::arctic::MemoryCounters* const visitor;
+        ice::arctic::MemoryPhase const phase;
+        ice::arctic::MemoryScope* const parent;
+#endif
+    };
+
+    //! \brief Reports an allocation to the innermost scope of the current thread.
+    //! \note Can be called by applications forwarding their own allocations, ex.: from a global 'operator new'.
+    void track_allocation(ice::u64 size) noexcept;
+    void track_deallocation(ice::u64 size) noexcept;
+
+    namespace detail
+    {
+
+        //! \brief Reports an allocation to the given phase instead of the phase of the innermost scope.
+        void track_phase_allocation(ice::arctic::MemoryPhase phase, ice::u64 size) noexcept;
+        void track_phase_deallocation(ice::arctic::MemoryPhase phase, ice::u64 size) noexcept;
+
+        void track_node_allocation(ice::arctic::SyntaxEntity entity, ice::u64 size) noexcept;
+        void track_node_deallocation(ice::arctic::SyntaxEntity entity, ice::u64 size) noexcept;
+
+        //! \brief Same as above for nodes released without knowing their type.
+        void track_node_deallocation(ice::arctic::SyntaxNode const* node) noexcept;
+
+    } // namespace detail
+
+#if ICE_ARCTIC_MEMORY_TRACKING
+
+    namespace detail
+    {
+
+        inline thread_local ice::arctic::MemoryScope* memory_scope = nullptr;
+
+    } // namespace detail
+
+#else // #if ICE_ARCTIC_MEMORY_TRACKING
+
+    inline MemoryScope::MemoryScope(ice::arctic::MemoryStats&, ice::arctic::MemoryPhase) noexcept { }
+    inline MemoryScope::MemoryScope(ice::arctic::MemoryStats&, ice::u32) noexcept { }
+    inline MemoryScope::MemoryScope(ice::arctic::MemoryPhase) noexcept { }
+    inline MemoryScope::~MemoryScope() noexcept { }
+
+    inline void track_allocation(ice::u64) noexcept { }
+    inline void track_deallocation(ice::u64) noexcept { }
+
+    inline void detail::track_phase_allocation(ice::arctic::MemoryPhase, ice::u64) noexcept { }
+    inline void detail::track_phase_deallocation(ice::arctic::MemoryPhase, ice::u64) noexcept { }
+    inline void detail::track_node_allocation(ice::arctic::SyntaxEntity, ice::u64) noexcept { }
+    inline void detail::track_node_deallocation(ice::arctic::SyntaxEntity, ice::u64) noexcept { }
+    inline void detail::track_node_deallocation(ice::arctic::SyntaxNode const*) noexcept { }
+
+#endif // #if ICE_ARCTIC_MEMORY_TRACKING
+
+} // namespace ice::arctic
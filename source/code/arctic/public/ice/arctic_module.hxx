@@ -0,0 +1,137 @@
+#pragma once
+#include <ice/arctic_parser.hxx>
+#include <ice/arctic_word_matcher.hxx>
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    //! \brief A script parsed once and shared by all scripts importing it.
+    //! \note Modules are never modified after loading, their nodes can be read from any thread.
+    class Module
+    {
+    public:
+        auto path() const noexcept -> std::filesystem::path const& { return _path; }
+
+        auto state() const noexcept -> ice::arctic::ParseState { return _state; }
+
+        //! \brief Top-level nodes defined in the module itself, owned by the module.
+        auto definitions() const noexcept -> ice::Span<ice::arctic::SyntaxNode const* const>
+        {
+            return _definitions;
+        }
+
+        //! \brief Modules imported by this module, including their own imports.
+        auto imports() const noexcept -> ice::Span<ice::arctic::Module const* const>
+        {
+            return _parser.imports();
+        }
+
+        auto diagnostics() const noexcept -> ice::Span<ice::arctic::ParseDiagnostic const>
+        {
+            return _parser.diagnostics();
+        }
+
+    private:
+        friend class ModuleCache;
+
+        Module(std::filesystem::path path, ice::arctic::ParserOptions options) noexcept
+            : _path{ std::move(path) }
+            , _directory{ _path.parent_path().generic_u8string() }
+            , _parser{ module_options(options, _directory) }
+            , _loading_thread{ std::this_thread::get_id() }
+        {
+        }
+
+        //! \returns The options used to parse the module, its imports are relative to its own directory.
+        static auto module_options(ice::arctic::ParserOptions options, ice::String directory) noexcept -> ice::arctic::ParserOptions
+        {
+            options.import_directory = directory;
+            return options;
+        }
+
+    private:
+        std::filesystem::path _path;
+        std::u8string _directory;
+
+        //! \brief Token values of all nodes point into the source, so it's kept alive with the module.
+        std::u8string _source;
+        ice::arctic::Parser _parser;
+
+        //! \brief The definitions of the parser without the nodes of imported modules.
+        std::vector<ice::arctic::SyntaxNode const*> _definitions;
+        ice::arctic::ParseState _state = ParseState::Success;
+        std::atomic_bool _loaded = false;
+
+        //! \brief The thread which created the module, only this thread loads it.
+        std::thread::id const _loading_thread;
+    };
+
+    //! \brief Loads and keeps modules imported by scripts, each file is read and parsed once for the lifetime of the cache.
+    //!
+    //! \details Modules already loaded are returned under a shared lock, so parsers on different threads don't wait on each other.
+    //!   Each module is loaded by the thread requesting it first, other threads requesting it wait only for that module.
+    //!   Import cycles are detected when a thread would wait for a module which is, directly or through other threads,
+    //!   waiting for a module loaded by this thread.
+    class ModuleCache
+    {
+    public:
+        //! \param directory Import paths of scripts without an 'import_directory' are resolved relative to this directory.
+        //! \param options Options used to parse each module, 'modules' is always set to this cache.
+        explicit ModuleCache(
+            std::filesystem::path directory = { },
+            ice::arctic::ParserOptions options = { }
+        ) noexcept;
+
+        ~ModuleCache() noexcept;
+
+        ModuleCache(ModuleCache const&) noexcept = delete;
+        auto operator=(ModuleCache const&) noexcept -> ModuleCache& = delete;
+
+        //! \returns The module for the given path, the file is parsed only on the first request.
+        //! \param directory The directory of the importing script, the cache directory is used if empty.
+        //! \note Failed modules are cached as well and return the same error on each request.
+        auto load(
+            ice::String path,
+            ice::String directory = { }
+        ) noexcept -> ice::arctic::ParseResult<ice::arctic::Module const*>;
+
+        auto module_count() const noexcept -> ice::u32;
+
+        //! \brief The process-wide cache used by parsers without an explicitly set cache.
+        //! \note Resolves paths relative to the current working directory.
+        static auto global() noexcept -> ice::arctic::ModuleCache&;
+
+    private:
+        auto find(std::string const& key) const noexcept -> ice::arctic::Module*;
+
+        void load_module(ice::arctic::Module& module) noexcept;
+
+        //! \returns 'false' if waiting for the module would never finish, because it's part of an import cycle.
+        bool wait_until_loaded(ice::arctic::Module const& module) noexcept;
+
+    private:
+        std::filesystem::path _directory;
+        ice::arctic::ParserOptions _options;
+        ice::arctic::WordMatcher _matcher;
+
+        mutable std::shared_mutex _mutex;
+        std::unordered_map<std::string, std::unique_ptr<ice::arctic::Module>> _modules;
+
+        //! \brief Guards the modules each thread waits for, loaded modules are marked under this lock.
+        std::mutex _wait_mutex;
+        std::condition_variable _loaded_condition;
+        std::unordered_map<std::thread::id, ice::arctic::Module const*> _waiting;
+    };
+
+} // namespace ice::arctic
@@ -0,0 +1,112 @@
+#pragma once
+#include <ice/arctic_syntax_node.hxx>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    enum class OperandItemKind : ice::u8
+    {
+        Operand,
+        Operation,
+
+        //! \brief A unary minus, its operand follows as the next item.
+        Negate,
+    };
+
+    //! \brief Single element of a flattened operand list, nested unary operations are stored as prefix items.
+    struct OperandItem
+    {
+        ice::arctic::SyntaxNode* node;
+        ice::arctic::OperandItemKind kind;
+    };
+
+    enum class OperandTermKind : ice::u8
+    {
+        Operand,
+        Negate,
+        Binary,
+    };
+
+    //! \brief A complete subexpression covering a range of items.
+    struct OperandTerm
+    {
+        ice::arctic::OperandTermKind kind;
+
+        //! \brief Index of the item holding the operand, the unary operation or the binary operation.
+        ice::u32 item;
+        ice::u32 first;
+        ice::u32 last;
+
+        //! \brief Indices of the operand terms, the left term is the operand of unary operations.
+        ice::u32 left;
+        ice::u32 right;
+    };
+
+    struct OperandReplacement
+    {
+        ice::u32 term;
+        ice::arctic::SyntaxNode* node;
+    };
+
+    //! \brief Applies operator precedence to the flat operand lists created by the parser.
+    //!
+    //! \details The parser stores operands and binary operations of an expression as a single list of siblings,
+    //!   a unary minus owns everything following it. The list is flattened into items and a tree of terms is built,
+    //!   so passes can work on complete subexpressions. Nested lists, like call arguments, are single operands.
+    class OperandList
+    {
+    public:
+        static constexpr ice::u32 Constant_None = 0xffff'ffff;
+
+        //! \brief Flattens the children of the given node and builds the terms.
+        //! \returns 'false' if the list is malformed or uses operations without a known precedence.
+        //! \note Items are also available if building the terms failed.
+        bool build(ice::arctic::SyntaxNode* parent) noexcept;
+
+        auto items() const noexcept -> ice::Span<ice::arctic::OperandItem const> { return _items; }
+
+        //! \brief All terms in evaluation order, operands come before the terms using them.
+        auto terms() const noexcept -> ice::Span<ice::arctic::OperandTerm const> { return _terms; }
+
+        //! \returns The term of the whole list, only valid if 'build' succeeded.
+        auto root() const noexcept -> ice::u32 { return ice::u32(_terms.size()) - 1; }
+
+        //! \brief Links the items of the term into a new sibling list, unary operations only keep their operand as a child.
+        //! \returns The first node of the list, the items are no longer part of the parent list after calling 'replace'.
+        auto link_term(ice::u32 term) noexcept -> ice::arctic::SyntaxNode*;
+
+        //! \brief Replaces the items of each term with a single node and relinks the list of the parent.
+        //! \note Replacements need to be disjoint, replaced items are appended to 'out_removed' to be released or reused.
+        void replace(
+            ice::Span<ice::arctic::OperandReplacement const> replacements,
+            std::vector<ice::arctic::OperandItem>& out_removed
+        ) noexcept;
+
+    private:
+        void flatten(ice::arctic::SyntaxNode* first) noexcept;
+        auto build_term(ice::u32& position, ice::u32 min_precedence) noexcept -> ice::u32;
+        auto build_operand(ice::u32& position) noexcept -> ice::u32;
+
+        auto link_operand(
+            ice::u32 idx,
+            ice::Span<ice::arctic::OperandReplacement const> replacements,
+            ice::u32& replacement_idx,
+            ice::u32& out_next
+        ) noexcept -> ice::arctic::SyntaxNode*;
+
+    private:
+        ice::arctic::SyntaxNode* _parent = nullptr;
+        std::vector<ice::arctic::OperandItem> _items;
+        std::vector<ice::arctic::OperandTerm> _terms;
+    };
+
+    //! \returns The binding strength of binary operations, higher values bind stronger, '0' for unknown operations.
+    //! \note Assignments have the lowest precedence and are the only right-associative operation.
+    auto operation_precedence(ice::arctic::TokenType operation) noexcept -> ice::u32;
+
+    //! \returns The location of the first token stored in the node or in its first descendants.
+    //! \note Used to place nodes created for a replaced operand, the location is empty if no token was found.
+    auto operand_location(ice::arctic::SyntaxNode const* node) noexcept -> ice::arctic::TokenLocation;
+
+} // namespace ice::arctic
@@ -0,0 +1,144 @@
+#pragma once
+#include <ice/arctic_types.hxx>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace ice::arctic::detail
+{
+
+    //! \brief Returns the number of worker threads to be used for the given job count.
+    //! \note A job count of '0' selects the number of hardware threads.
+    inline auto worker_count(ice::u32 jobs, ice::u32 work_items) noexcept -> ice::u32
+    {
+        if (jobs == 0)
+        {
+            jobs = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        return std::max(std::min(jobs, work_items), 1u);
+    }
+
+    //! \brief Calls 'fn(worker_idx, item_idx)' for each item in the range [0, count).
+    //!
+    //! \details Items are claimed one by one from a shared counter, so uneven work is balanced between workers.
+    //!   The calling thread acts as worker '0' and returns once all items are processed.
+    template<typename Fn>
+    void parallel_for(ice::u32 count, ice::u32 jobs, Fn&& fn) noexcept
+    {
+        ice::u32 const workers = ice::arctic::detail::worker_count(jobs, count);
+        std::atomic_uint32_t next_item = 0;
+
+        auto const worker_fn = [&](ice::u32 worker_idx) noexcept
+        {
+            ice::u32 item_idx = next_item.fetch_add(1, std::memory_order_relaxed);
+            while (item_idx < count)
+            {
+                fn(worker_idx, item_idx);
+                item_idx = next_item.fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (ice::u32 worker_idx = 1; worker_idx < workers; ++worker_idx)
+        {
+            threads.emplace_back(worker_fn, worker_idx);
+        }
+
+        worker_fn(0);
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    //! \brief Busy waits for a short time before giving the core to other threads, used while a queue is full or empty.
+    inline void spin_wait(ice::u32& spin_count) noexcept
+    {
+        static constexpr ice::u32 Constant_MaxSpinCount = 64;
+
+        if (spin_count < Constant_MaxSpinCount)
+        {
+            spin_count += 1;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    //! \brief A bounded lock-free queue for exactly one producer and one consumer thread.
+    //!
+    //! \details Each side caches the last seen index of the other side, so the shared indices are only read
+    //!   when the cached value suggests the queue is full or empty.
+    template<typename Value, ice::u32 Capacity>
+    class SpscQueue
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "The capacity needs to be a power of two.");
+
+        static constexpr ice::u32 Constant_CacheLineSize = 64;
+
+    public:
+        //! \brief Waits until there is space for the value.
+        //! \returns 'false' if the consumer closed the queue, the value is dropped.
+        bool push(Value const& value) noexcept
+        {
+            ice::u32 const tail = _tail.load(std::memory_order_relaxed);
+            ice::u32 spin_count = 0;
+            while (tail - _producer_cached_head == Capacity)
+            {
+                _producer_cached_head = _head.load(std::memory_order_acquire);
+                if (tail - _producer_cached_head == Capacity)
+                {
+                    if (_closed.load(std::memory_order_relaxed))
+                    {
+                        return false;
+                    }
+                    ice::arctic::detail::spin_wait(spin_count);
+                }
+            }
+
+            _values[tail & (Capacity - 1)] = value;
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        //! \brief Waits until a value is available.
+        auto pop() noexcept -> Value
+        {
+            ice::u32 const head = _head.load(std::memory_order_relaxed);
+            ice::u32 spin_count = 0;
+            while (head == _consumer_cached_tail)
+            {
+                _consumer_cached_tail = _tail.load(std::memory_order_acquire);
+                if (head == _consumer_cached_tail)
+                {
+                    ice::arctic::detail::spin_wait(spin_count);
+                }
+            }
+
+            Value const result = _values[head & (Capacity - 1)];
+            _head.store(head + 1, std::memory_order_release);
+            return result;
+        }
+
+        //! \brief Called by the consumer to stop a producer that might be waiting on a full queue.
+        void close() noexcept
+        {
+            _closed.store(true, std::memory_order_relaxed);
+        }
+
+    private:
+        alignas(Constant_CacheLineSize) std::atomic_uint32_t _head = 0;
+        ice::u32 _consumer_cached_tail = 0;
+
+        alignas(Constant_CacheLineSize) std::atomic_uint32_t _tail = 0;
+        ice::u32 _producer_cached_head = 0;
+
+        alignas(Constant_CacheLineSize) std::atomic_bool _closed = false;
+        Value _values[Capacity];
+    };
+
+} // namespace ice::arctic::detail
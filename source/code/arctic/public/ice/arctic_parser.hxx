@@ -1,27 +1,249 @@
 #pragma once
 #include <ice/arctic_syntax_visitor.hxx>
 #include <ice/arctic_lexer.hxx>
+#include <ice/arctic_parser_result.hxx>
+#include <ice/arctic_syntax_index.hxx>
+#include <ice/arctic_annotation_table.hxx>
 
+#include <chrono>
 #include <vector>
 
 namespace ice::arctic
 {
 
+    struct WordMatcher;
+    class Module;
+    class ModuleCache;
+
+    namespace detail
+    {
+
+        struct ParserPipeline;
+
+    } // namespace detail
+
+    //! \brief A single text change, offsets and sizes are given in bytes of the source before the change.
+    struct TextEdit
+    {
+        ice::u32 offset;
+        ice::u32 removed_size;
+        ice::u32 inserted_size;
+    };
+
+    //! \brief A range of source that was parsed into a group of top-level nodes.
+    //! \details A unit is a single definition together with its annotations or an entire 'ctx' block.
+    //!   It spans from its first token up to the first token of the next unit.
+    struct SyntaxUnit
+    {
+        ice::utf8 const* begin;
+        ice::arctic::TokenLocation location;
+        ice::u32 first_definition;
+        ice::u32 definition_count;
+
+        //! \brief Set for 'import' statements, the definitions of such units are owned by the imported modules.
+        bool is_import = false;
+    };
+
+    //! \brief Limits applied to each call of 'parse' or 'reparse', a value of '0' disables the specific limit.
+    //! \details Once a limit is hit the parser stops consuming tokens and fails with the matching 'Error_Limit_*' state.
+    //!   Definitions finished after that point are not passed to visitors.
+    struct ParserLimits
+    {
+        //! \brief Bytes requested for syntax nodes.
+        ice::u64 max_allocated_bytes = 0;
+        ice::u32 max_nodes = 0;
+
+        //! \brief Nesting depth of sub-expressions and scopes.
+        ice::u32 max_expression_depth = 0;
+        ice::u32 max_tokens = 0;
+        ice::u32 max_time_ms = 0;
+
+        constexpr bool enabled() const noexcept
+        {
+            return max_allocated_bytes != 0
+                || (max_nodes | max_expression_depth | max_tokens | max_time_ms) != 0;
+        }
+    };
+
+    struct ParserOptions
+    {
+        //! \brief Keeps parsing after an error, skipping tokens up to the next definition or the end of a 'ctx' block.
+        //! \note Definitions are resynchronized on keywords that are not indented deeper than the failed definition.
+        //!   Hitting a limit always stops the parser.
+        bool recover_from_errors = false;
+
+        //! \brief Limits used when parsing untrusted sources.
+        ice::arctic::ParserLimits limits = { };
+
+        //! \brief Runs the lexer and all visitors on two additional threads, connected to the parser by queues.
+        //! \details Visitors are called on the visitor thread in the same order as without pipelining.
+        //!   The given lexer is only advanced by the lexer thread until 'parse' returns.
+        bool pipelined = false;
+
+        //! \brief Adds the nodes of each finished definition to the index returned by 'node_index'.
+        bool build_node_index = false;
+
+        //! \brief Decodes the annotations of each finished definition into the tables returned by 'annotation_tables'.
+        bool decode_annotations = false;
+
+        //! \brief Cache resolving 'import' statements, the process-wide cache is used if not set.
+        ice::arctic::ModuleCache* modules = nullptr;
+
+        //! \brief Directory of the parsed script, paths of its imports are relative to it.
+        //! \note If empty, paths are relative to the directory of the module cache.
+        ice::String import_directory = { };
+    };
+
     class Parser : public ice::arctic::SyntaxNodeAllocator
     {
     public:
-        void parse(ice::arctic::Lexer& lexer) noexcept;
+        explicit Parser(ice::arctic::ParserOptions options = { }) noexcept
+            : _options{ options }
+        {
+        }
+
+        //! \returns The state of the first error encountered, all errors can be accessed using 'diagnostics'.
+        auto parse(ice::arctic::Lexer& lexer) noexcept -> ice::arctic::ParseState;
+
+        //! \brief Updates the parsed definitions after a text edit, only units touched by the edit are parsed again.
+        //!
+        //! \details Visitors are only notified about the top-level nodes that where removed, changed or added.
+        //!   Nodes of untouched units are kept and their tokens are moved to point into the new source.
+        //!   If the edited units can't be parsed in isolation the whole source is parsed again.
+        //!
+        //! \param options Lexer options, the rules need to be explicitly selected.
+        auto reparse(
+            ice::arctic::WordMatcher const* matcher,
+            ice::String previous_source,
+            ice::String source,
+            ice::arctic::TextEdit edit,
+            ice::arctic::LexerOptions options
+        ) noexcept -> ice::arctic::ParseState;
 
         void add_visitor(ice::arctic::SyntaxVisitorBase& visitor) noexcept
         {
             _visitors.push_back(&visitor);
+            _memory_stats.visitors.resize(_visitors.size());
+        }
+
+        //! \brief All top-level nodes passed to visitors during 'parse', in the order they where visited.
+        //! \note Nodes of imported modules are owned by the module cache and can't be modified, all other nodes are owned by the parser.
+        auto definitions() const noexcept -> ice::Span<ice::arctic::SyntaxNode const* const>
+        {
+            return _definitions;
+        }
+
+        //! \brief Nodes of all definitions grouped by entity, only filled if 'build_node_index' is set.
+        //! \note Imported nodes are not part of the index.
+        auto node_index() const noexcept -> ice::arctic::SyntaxNodeIndex const&
+        {
+            return _node_index;
+        }
+
+        //! \brief Decoded annotations of all definitions, only filled if 'decode_annotations' is set.
+        //! \note When pipelined, the tables are filled on the parser thread and should only be accessed after 'parse' returns.
+        auto annotation_tables() const noexcept -> ice::arctic::AnnotationTables const&
+        {
+            return _annotation_tables;
+        }
+
+        //! \brief Modules imported by the parsed source, in the order their definitions where passed to visitors.
+        //! \note Imported nodes are also part of 'definitions', at the position of the 'import' statement.
+        auto imports() const noexcept -> ice::Span<ice::arctic::Module const* const>
+        {
+            return _imports;
+        }
+
+        //! \brief Memory used by all calls to 'parse' and 'reparse' so far, including lexing and visitors.
+        //! \note Only collected if 'ICE_ARCTIC_MEMORY_TRACKING' is enabled, coroutine frames of the given lexer
+        //!   are only included if the lexer was created inside a 'MemoryScope' for the same stats.
+        auto stats() const noexcept -> ice::arctic::MemoryStats const&
+        {
+            return _memory_stats;
+        }
+
+        //! \brief Errors reported by the last call to 'parse' or 'reparse', in source order.
+        auto diagnostics() const noexcept -> ice::Span<ice::arctic::ParseDiagnostic const>
+        {
+            return _diagnostics;
         }
 
         auto allocate(ice::u64 size, ice::u64 align) noexcept -> void*;
         void deallocate(void* ptr) noexcept;
 
     private:
+        auto reparse_units(
+            ice::arctic::WordMatcher const* matcher,
+            ice::String previous_source,
+            ice::String source,
+            ice::arctic::TextEdit edit,
+            ice::arctic::LexerOptions options
+        ) noexcept -> ice::arctic::ParseState;
+
+        auto parse_tokens(ice::arctic::Lexer& lexer) noexcept -> ice::arctic::ParseState;
+        auto parse_pipelined(ice::arctic::Lexer& lexer) noexcept -> ice::arctic::ParseState;
+
+        auto parse_units(
+            ice::arctic::Token& token,
+            ice::arctic::Lexer& lexer,
+            ice::utf8 const* units_end
+        ) noexcept -> ice::arctic::ParseResult<ice::arctic::SyntaxNode*>;
+
+        auto parse_block(
+            ice::arctic::Token& token,
+            ice::arctic::Lexer& lexer
+        ) noexcept -> ice::arctic::ParseState;
+
+        auto parse_import(
+            ice::arctic::Token& token,
+            ice::arctic::Lexer& lexer
+        ) noexcept -> ice::arctic::ParseState;
+
+        //! \brief Passes definitions of the module and all modules it imports to visitors, each module only once.
+        void on_import(ice::arctic::Module const* module) noexcept;
+
+        void on_definition(ice::arctic::SyntaxNode* node) noexcept;
+
+        //! \brief Passes a top-level node to visitors, or to the visitor thread when pipelined.
+        void publish(ice::arctic::SyntaxNode const* node) noexcept;
+
+        //! \brief Reports the error at the token expected to be different, or the furthest token consumed by the failed definition.
+        void report_error(
+            ice::arctic::ParseState state,
+            ice::arctic::Lexer const& lexer,
+            ice::arctic::TokenLocation definition_location
+        ) noexcept;
+
+        //! \brief Wraps the lexer to stop yielding tokens after a limit was hit.
+        auto limit_lexer(ice::arctic::Lexer& lexer) noexcept -> ice::arctic::Lexer;
+
+        void reset_limits() noexcept;
+        auto check_limits() noexcept -> ice::arctic::ParseState;
+
+        void recover(
+            ice::arctic::Token& token,
+            ice::arctic::Lexer& lexer,
+            ice::arctic::TokenLocation definition_location,
+            bool inside_block
+        ) noexcept;
+
+    private:
+        ice::arctic::ParserOptions _options;
         std::vector<ice::arctic::SyntaxVisitorBase*> _visitors;
+        std::vector<ice::arctic::SyntaxNode const*> _definitions;
+        std::vector<ice::arctic::Module const*> _imports;
+        std::vector<ice::arctic::SyntaxUnit> _units;
+        std::vector<ice::arctic::ParseDiagnostic> _diagnostics;
+        ice::arctic::SyntaxNodeIndex _node_index;
+        ice::arctic::AnnotationTables _annotation_tables;
+        ice::arctic::MemoryStats _memory_stats;
+
+        ice::u64 _allocated_bytes = 0;
+        ice::u32 _allocated_nodes = 0;
+        ice::arctic::ParseState _limit_state = ParseState::Success;
+        std::chrono::steady_clock::time_point _deadline;
+
+        ice::arctic::detail::ParserPipeline* _pipeline = nullptr;
     };
 
 } // namespace ice::arctic
@@ -0,0 +1,103 @@
+#pragma once
+#include <ice/arctic_types.hxx>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+//! \brief Enables per-rule parser counters, define as '1' to collect invocation, node and timing stats for named rules.
+//! \note When disabled named rules are compiled exactly like unnamed ones and no counters are touched.
+#ifndef ICE_ARCTIC_PARSER_PROFILING
+#define ICE_ARCTIC_PARSER_PROFILING 0
+#endif
+
+namespace ice::arctic
+{
+
+    //! \brief Counters of a single named parser rule, shared by all threads using the rule.
+    struct ParserRuleProfile
+    {
+        constexpr ParserRuleProfile(char const* rule_name) noexcept
+            : name{ rule_name }
+        {
+        }
+
+        ParserRuleProfile(ParserRuleProfile const&) noexcept = delete;
+        auto operator=(ParserRuleProfile const&) noexcept -> ParserRuleProfile& = delete;
+
+        char const* const name;
+
+#if ICE_ARCTIC_PARSER_PROFILING
+        std::atomic<ice::u64> invocations = 0;
+        std::atomic<ice::u64> successes = 0;
+        std::atomic<ice::u64> failures = 0;
+        std::atomic<ice::u64> repeats = 0;
+        std::atomic<ice::u64> nodes_allocated = 0;
+        std::atomic<ice::u64> nodes_destroyed = 0;
+        std::atomic<ice::u64> inclusive_ns = 0;
+
+        std::atomic<bool> registered = false;
+        ice::arctic::ParserRuleProfile* next = nullptr;
+#endif
+    };
+
+    //! \brief Returns all profiled rules as a table sorted by inclusive time.
+    //! \note Returns an empty string when profiling is disabled.
+    auto parser_profile_table() noexcept -> std::string;
+
+    //! \brief Returns all profiled rules as a JSON array sorted by inclusive time.
+    auto parser_profile_json() noexcept -> std::string;
+
+    //! \brief Resets the counters of all rules invoked so far.
+    void parser_profile_reset() noexcept;
+
+#if ICE_ARCTIC_PARSER_PROFILING
+
+    namespace detail
+    {
+
+        //! \brief Adds the profile to the list of reported rules, only the first call per profile has an effect.
+        void register_rule_profile(ice::arctic::ParserRuleProfile& profile) noexcept;
+
+        //! \brief Tracks the innermost named rule of the current thread.
+        struct ParserRuleScope
+        {
+            explicit ParserRuleScope(ice::arctic::ParserRuleProfile& rule_profile) noexcept;
+            ~ParserRuleScope() noexcept;
+
+            ice::arctic::ParserRuleProfile& profile;
+            ice::arctic::detail::ParserRuleScope* const parent;
+            std::chrono::steady_clock::time_point const start;
+            bool recursive;
+        };
+
+        inline thread_local ice::arctic::detail::ParserRuleScope* parser_rule_scope = nullptr;
+
+        inline void profile_repeat(ice::arctic::ParserRuleProfile* profile) noexcept
+        {
+            if (profile != nullptr)
+            {
+                profile->repeats.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        inline void profile_node_allocated() noexcept
+        {
+            if (parser_rule_scope != nullptr)
+            {
+                parser_rule_scope->profile.nodes_allocated.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        inline void profile_node_destroyed() noexcept
+        {
+            if (parser_rule_scope != nullptr)
+            {
+                parser_rule_scope->profile.nodes_destroyed.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+    } // namespace detail
+
+#endif // #if ICE_ARCTIC_PARSER_PROFILING
+
+} // namespace ice::arctic
@@ -19,10 +19,61 @@ namespace ice::arctic
         Error_TypeOf_MissingTypeName = Error | 0x0110,
         Error_TypeOf_MissingBracketOpen = Error | 0x0111,
         Error_TypeOf_MissingBracketClose = Error | 0x0112,
+
+        Error_Import_MissingPath = Error | 0x0120,
+        Error_Import_NotFound = Error | 0x0121,
+        Error_Import_Cycle = Error | 0x0122,
+        Error_Import_ModuleFailed = Error | 0x0123,
+
+        Error_Semantic_UnknownType = Error | 0x0301,
+        Error_Semantic_UnknownSymbol = Error | 0x0302,
+        Error_Semantic_UnknownMember = Error | 0x0303,
+        Error_Semantic_DuplicateSymbol = Error | 0x0304,
+        Error_Semantic_RecursiveType = Error | 0x0305,
+        Error_Semantic_TypeMismatch = Error | 0x0306,
+        Error_Semantic_NotConstant = Error | 0x0307,
+        Error_Semantic_DivisionByZero = Error | 0x0308,
+
+        Error_Bytecode_UnsupportedType = Error | 0x0401,
+        Error_Bytecode_UnsupportedExpression = Error | 0x0402,
+        Error_Bytecode_RecursiveCall = Error | 0x0403,
+        Error_Bytecode_RegisterLimit = Error | 0x0404,
+        Error_Bytecode_TableLimit = Error | 0x0405,
+
+        Error_Limit_AllocatedBytes = Error | 0x0201,
+        Error_Limit_NodeCount = Error | 0x0202,
+        Error_Limit_ExpressionDepth = Error | 0x0203,
+        Error_Limit_TokenCount = Error | 0x0204,
+        Error_Limit_Time = Error | 0x0205,
     };
 
     auto to_string(ice::arctic::ParseState state) noexcept -> std::string_view;
 
+    //! \brief A parse error together with the token it was detected at.
+    struct ParseDiagnostic
+    {
+        static constexpr ice::u32 Constant_MaxExpectedTypes = 8;
+
+        ice::arctic::ParseState state;
+
+        //! \brief The furthest token the parser failed to match, the location of the error.
+        ice::arctic::Token token;
+
+        //! \brief Token types that would have been accepted instead of 'token'.
+        ice::arctic::TokenType expected[Constant_MaxExpectedTypes];
+        ice::u32 expected_count;
+
+        auto expected_types() const noexcept -> ice::Span<ice::arctic::TokenType const>
+        {
+            return { expected, expected_count };
+        }
+    };
+
+    constexpr bool is_error(ice::arctic::ParseState state) noexcept
+    {
+        return (static_cast<ice::u32>(state) & static_cast<ice::u32>(ParseState::Error)) != 0;
+    }
+
     template<typename Value>
     struct ParseResult
     {
@@ -69,7 +120,7 @@ namespace ice::arctic
 
         constexpr bool has_error() const noexcept
         {
-            return (static_cast<ice::u32>(_state) & static_cast<ice::u32>(ParseState::Error)) != 0;
+            return ice::arctic::is_error(_state);
         }
 
         constexpr operator Value() const noexcept
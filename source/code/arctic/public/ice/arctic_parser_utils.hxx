@@ -3,12 +3,164 @@
 #include <ice/arctic_token.hxx>
 #include <ice/arctic_lexer.hxx>
 #include <ice/arctic_parser_result.hxx>
+#include <ice/arctic_parser_profiler.hxx>
+#include <utility>
 
 namespace ice::arctic
 {
 
     struct TokenRule;
 
+    //! \brief Collects the token types rules tried to match at the furthest token reached.
+    struct TokenExpectations
+    {
+        ice::arctic::Token token;
+        ice::arctic::TokenType types[ParseDiagnostic::Constant_MaxExpectedTypes];
+        ice::u32 count = 0;
+
+        static constexpr bool is_before(
+            ice::arctic::TokenLocation left,
+            ice::arctic::TokenLocation right
+        ) noexcept
+        {
+            return left.line < right.line || (left.line == right.line && left.column < right.column);
+        }
+
+        void expect(ice::arctic::Token const& failed_token, ice::arctic::TokenType type) noexcept
+        {
+            if (count == 0 || is_before(token.location, failed_token.location))
+            {
+                token = failed_token;
+                count = 0;
+            }
+            else if (is_before(failed_token.location, token.location))
+            {
+                return;
+            }
+
+            for (ice::u32 idx = 0; idx < count; ++idx)
+            {
+                if (types[idx] == type)
+                {
+                    return;
+                }
+            }
+
+            if (count < ParseDiagnostic::Constant_MaxExpectedTypes)
+            {
+                types[count] = type;
+                count += 1;
+            }
+        }
+    };
+
+    namespace detail
+    {
+
+        //! \brief Set by the parser for the duration of a parse, rules record what they expected when failing.
+        inline thread_local ice::arctic::TokenExpectations* token_expectations = nullptr;
+
+        //! \brief Installs the expectations of a parse for the current thread, restoring the previous ones on exit.
+        struct TokenExpectationsScope
+        {
+            explicit TokenExpectationsScope(ice::arctic::TokenExpectations& expectations) noexcept
+                : previous{ std::exchange(token_expectations, &expectations) }
+            {
+            }
+
+            ~TokenExpectationsScope() noexcept
+            {
+                token_expectations = previous;
+            }
+
+            ice::arctic::TokenExpectations* const previous;
+        };
+
+        //! \brief Nesting of recursive rules in the current parse, only set if the depth is limited.
+        struct NestingBudget
+        {
+            ice::u32 depth;
+            ice::u32 max_depth;
+            bool exceeded;
+        };
+
+        inline thread_local ice::arctic::detail::NestingBudget* nesting_budget = nullptr;
+
+        //! \brief Installs a nesting budget for the current thread, a 'max_depth' of '0' disables the limit.
+        struct NestingBudgetScope
+        {
+            explicit NestingBudgetScope(ice::u32 max_depth) noexcept
+                : budget{ .depth = 0, .max_depth = max_depth, .exceeded = false }
+                , previous{ std::exchange(nesting_budget, max_depth != 0 ? &budget : nullptr) }
+            {
+            }
+
+            NestingBudgetScope(NestingBudgetScope const&) noexcept = delete;
+            auto operator=(NestingBudgetScope const&) noexcept -> NestingBudgetScope& = delete;
+
+            ~NestingBudgetScope() noexcept
+            {
+                nesting_budget = previous;
+            }
+
+            ice::arctic::detail::NestingBudget budget;
+            ice::arctic::detail::NestingBudget* const previous;
+        };
+
+        //! \returns The first token value stored in the node, which is the name for all named definitions.
+        inline auto definition_name(ice::arctic::SyntaxNode const* node) noexcept -> ice::String
+        {
+            ice::String result;
+            ice::arctic::for_each_syntax_token(node, [&result](ice::arctic::Token const& token) noexcept
+                {
+                    result = result.empty() ? token.value : result;
+                }
+            );
+            return result;
+        }
+
+    } // namespace detail
+
+    //! \brief Entered by recursive rules, these need to fail with 'Error_Limit_ExpressionDepth' if 'exceeded' returns true.
+    struct NestingScope
+    {
+        NestingScope() noexcept
+            : _budget{ detail::nesting_budget }
+        {
+            if (_budget != nullptr)
+            {
+                _budget->depth += 1;
+                _budget->exceeded |= _budget->depth > _budget->max_depth;
+            }
+        }
+
+        NestingScope(NestingScope const&) noexcept = delete;
+        auto operator=(NestingScope const&) noexcept -> NestingScope& = delete;
+
+        ~NestingScope() noexcept
+        {
+            if (_budget != nullptr)
+            {
+                _budget->depth -= 1;
+            }
+        }
+
+        bool exceeded() const noexcept
+        {
+            return _budget != nullptr && _budget->exceeded;
+        }
+
+        ice::arctic::detail::NestingBudget* const _budget;
+    };
+
+    inline void expect_token(ice::arctic::Token const& token, ice::arctic::TokenType type) noexcept
+    {
+        if (detail::token_expectations != nullptr)
+        {
+            detail::token_expectations->expect(token, type);
+        }
+    }
+
     using TokenRuleFn = auto(
         void const*,
         ice::arctic::ParseState,
@@ -64,6 +216,10 @@ namespace ice::arctic
         void const* userdata = nullptr;
         ice::arctic::TokenRuleFn* func;
 
+#if ICE_ARCTIC_PARSER_PROFILING
+        ice::arctic::ParserRuleProfile* profile = nullptr;
+#endif
+
         auto operator()(
             ice::arctic::SyntaxNodeAllocator* alloc,
             ice::arctic::SyntaxNode* node,
@@ -71,8 +227,36 @@ namespace ice::arctic
             ice::arctic::Lexer& lexer
         ) const noexcept -> ice::arctic::ParseState
         {
+#if ICE_ARCTIC_PARSER_PROFILING
+            if (profile != nullptr)
+            {
+                ice::arctic::detail::ParserRuleScope const scope{ *profile };
+                ice::arctic::ParseState const result = func(userdata, fail_state, alloc, node, token, lexer);
+
+                profile->invocations.fetch_add(1, std::memory_order_relaxed);
+                if (result == ParseState::Success)
+                {
+                    profile->successes.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    profile->failures.fetch_add(1, std::memory_order_relaxed);
+                }
+                return result;
+            }
+#endif
             return func(userdata, fail_state, alloc, node, token, lexer);
         }
+
+        //! \brief Returns a copy of this rule reporting into the given profile, no-op if profiling is disabled.
+        constexpr auto profiled([[maybe_unused]] ice::arctic::ParserRuleProfile& rule_profile) const noexcept -> ice::arctic::TokenRule
+        {
+            TokenRule result = *this;
+#if ICE_ARCTIC_PARSER_PROFILING
+            result.profile = &rule_profile;
+#endif
+            return result;
+        }
     };
 
     template<bool ParentPtr = false>
@@ -151,6 +335,9 @@ namespace ice::arctic
             // Repeat match (if not failing)
             while (result_state == ParseState::Success && it->repeat)
             {
+#if ICE_ARCTIC_PARSER_PROFILING
+                ice::arctic::detail::profile_repeat(it->profile);
+#endif
                 matched_once = true;
                 previous = token.value.data();
                 result_state = (*it)(alloc, node, token, lexer);
@@ -193,6 +380,9 @@ namespace ice::arctic
             // Repeat match (if not failing)
             while (result_state == ParseState::Success && it->repeat)
             {
+#if ICE_ARCTIC_PARSER_PROFILING
+                ice::arctic::detail::profile_repeat(it->profile);
+#endif
                 matched_once = true;
                 previous = token.value.data();
                 result_state = (*it)(alloc, child, token, lexer);
@@ -260,6 +450,9 @@ namespace ice::arctic
             // Repeat match (if not failing)
             while (result_state == ParseState::Success && it->repeat)
             {
+#if ICE_ARCTIC_PARSER_PROFILING
+                ice::arctic::detail::profile_repeat(it->profile);
+#endif
                 matched_once = true;
                 previous = token.value.data();
                 result_state = (*it)(alloc, sibling, token, lexer);
@@ -323,6 +516,9 @@ namespace ice::arctic
             // Repeat match (if not failing)
             while (result_state == ParseState::Success && it->repeat)
             {
+#if ICE_ARCTIC_PARSER_PROFILING
+                ice::arctic::detail::profile_repeat(it->profile);
+#endif
                 result_state = (*it)(alloc, node, token, lexer);
             }
 
@@ -389,6 +585,12 @@ namespace ice::arctic
             result.fail_state = state;
             return result;
         }
+
+        constexpr auto profiled(ice::arctic::ParserRuleProfile& rule_profile) const noexcept -> ice::arctic::TokenRule
+        {
+            TokenRule const result = *this;
+            return result.profiled(rule_profile);
+        }
     };
 
     template<typename ChildType, size_t Count>
@@ -554,6 +756,8 @@ namespace ice::arctic
                 token = lexer.next();
                 return ParseState::Success;
             }
+
+            ice::arctic::expect_token(token, Type);
             return fail_state;
         }
 
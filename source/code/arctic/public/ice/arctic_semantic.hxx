@@ -0,0 +1,243 @@
+#pragma once
+#include <ice/arctic_parser_result.hxx>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    enum class TypeKind : ice::u8
+    {
+        Void,
+        Scalar,
+        Vector,
+        Matrix,
+        Struct,
+
+        //! \brief Result type of shader entry points, ex.: 'VertexShader'.
+        Stage,
+    };
+
+    struct TypeDesc;
+
+    //! \brief Types are hash-consed, two handles describe the same type only if they are equal.
+    using TypeHandle = ice::arctic::TypeDesc const*;
+
+    struct TypeMember
+    {
+        ice::String name;
+        ice::arctic::TypeHandle type;
+        ice::arctic::SyntaxNode_StructMember const* node;
+    };
+
+    struct TypeDesc
+    {
+        ice::arctic::TypeKind kind;
+
+        //! \brief One of the 'NT_*' token types for scalars, vectors and matrices, 'NT_Void' otherwise.
+        ice::arctic::TokenType scalar;
+
+        //! \brief Component count of vectors and rows of matrices, '1' for scalars.
+        ice::u8 rows;
+        ice::u8 columns;
+
+        ice::String name;
+
+        //! \brief The 'DEF_Struct' or 'DEF_TypeDef' node of named types, 'nullptr' for builtin types.
+        ice::arctic::SyntaxNode const* definition;
+        ice::Span<ice::arctic::TypeMember const> members;
+
+        auto find_member(ice::String member_name) const noexcept -> ice::arctic::TypeMember const*;
+    };
+
+    //! \brief Owns all type descriptors, structural types are created once and shared by all users.
+    class TypeTable
+    {
+    public:
+        //! \brief Creates all builtin types, ex.: 'f32', 'vec4f' or 'mtx4f'.
+        TypeTable() noexcept;
+
+        TypeTable(TypeTable const&) noexcept = delete;
+        auto operator=(TypeTable const&) noexcept -> TypeTable& = delete;
+
+        auto scalar(ice::arctic::TokenType scalar) noexcept -> ice::arctic::TypeHandle;
+        auto vector(ice::arctic::TokenType scalar, ice::u32 size) noexcept -> ice::arctic::TypeHandle;
+        auto matrix(ice::arctic::TokenType scalar, ice::u32 rows, ice::u32 columns) noexcept -> ice::arctic::TypeHandle;
+
+        //! \brief Creates the type of a 'DEF_Struct' or a non-alias 'DEF_TypeDef', each definition is a distinct type.
+        //! \details Members are empty until assigned with 'set_members'.
+        auto named(
+            ice::arctic::TypeKind kind,
+            ice::arctic::SyntaxNode const* definition,
+            ice::String name,
+            ice::arctic::TypeHandle base_type = nullptr
+        ) noexcept -> ice::arctic::TypeHandle;
+
+        void set_members(ice::arctic::TypeHandle type, std::vector<ice::arctic::TypeMember> members) noexcept;
+
+        //! \returns The builtin type with the given name or 'nullptr'.
+        auto find_builtin(ice::String name) const noexcept -> ice::arctic::TypeHandle;
+
+    private:
+        auto intern(ice::arctic::TypeDesc const& desc) noexcept -> ice::arctic::TypeHandle;
+
+        std::deque<ice::arctic::TypeDesc> _types;
+        std::deque<std::vector<ice::arctic::TypeMember>> _members;
+        std::unordered_map<ice::u64, ice::arctic::TypeDesc*> _structural;
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::arctic::TypeDesc*> _named;
+        std::unordered_map<ice::String, ice::arctic::TypeHandle> _builtins;
+    };
+
+    enum class SymbolKind : ice::u8
+    {
+        Type,
+        ContextVariable,
+        Variable,
+
+        //! \brief A variable defined with 'const', see 'ConstantFolder' for their values.
+        Constant,
+        Function,
+        FunctionArgument,
+    };
+
+    struct Symbol
+    {
+        ice::arctic::SymbolKind kind;
+        ice::String name;
+
+        //! \brief For functions this is the result type.
+        ice::arctic::TypeHandle type;
+        ice::arctic::SyntaxNode const* definition;
+    };
+
+    //! \brief Symbols declared in a single scope, lookups continue in the parent scope.
+    class SymbolScope
+    {
+    public:
+        explicit SymbolScope(ice::arctic::SymbolScope const* parent = nullptr) noexcept
+            : _parent{ parent }
+        {
+        }
+
+        //! \returns 'false' if a symbol with the same name was already declared in this scope.
+        bool declare(ice::arctic::Symbol const* symbol) noexcept
+        {
+            return _symbols.emplace(symbol->name, symbol).second;
+        }
+
+        auto find(ice::String name) const noexcept -> ice::arctic::Symbol const*
+        {
+            for (ice::arctic::SymbolScope const* scope = this; scope != nullptr; scope = scope->_parent)
+            {
+                auto const it = scope->_symbols.find(name);
+                if (it != scope->_symbols.end())
+                {
+                    return it->second;
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        ice::arctic::SymbolScope const* _parent;
+        std::unordered_map<ice::String, ice::arctic::Symbol const*> _symbols;
+    };
+
+    //! \brief Resolves type names, variable references and member accesses of parsed definitions.
+    //!
+    //! \details Results are kept next to the syntax tree, nodes are never modified.
+    //!   Types of expressions follow operator precedence, assignments are checked against the type of their whole right side.
+    //!   Lists without a known precedence, like operands following each other, are typed in the order they are stored in.
+    class SemanticModel
+    {
+    public:
+        //! \brief Adds definitions to be resolved, imported definitions need to be added before the definitions using them.
+        //! \note Definitions can reference each other in any order within all added definitions.
+        void add_definitions(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept;
+
+        //! \brief Resolves all added definitions.
+        //! \returns The state of the first error, all errors can be accessed using 'diagnostics'.
+        auto resolve() noexcept -> ice::arctic::ParseState;
+
+        //! \returns The type of a definition, type reference or expression node, or 'nullptr' if it was not resolved.
+        //! \note For 'EXP_Value' nodes this is the type of the value itself, member accesses are typed on the 'EXP_GetMember' nodes.
+        auto type_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::TypeHandle;
+
+        //! \returns The type of an operand after all of its member accesses, ex.: 'f32' for 'camera.exposure'.
+        auto operand_type_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::TypeHandle;
+
+        //! \returns The symbol referenced by an 'EXP_Value' or 'EXP_Call' node or declared by a definition node,
+        //!   'nullptr' for literals and unresolved names.
+        auto symbol_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::Symbol const*;
+
+        //! \returns The struct member accessed by an 'EXP_GetMember' node, or 'nullptr' for vector swizzles.
+        auto member_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::TypeMember const*;
+
+        //! \returns The type of the result of a binary operation, or 'nullptr' if the operands can't be combined.
+        //! \note Follows the same rules used to check expressions, but doesn't report errors.
+        auto result_type(
+            ice::arctic::TypeHandle left,
+            ice::arctic::TokenType operation,
+            ice::arctic::TypeHandle right
+        ) noexcept -> ice::arctic::TypeHandle;
+
+        auto types() noexcept -> ice::arctic::TypeTable& { return _types; }
+        auto globals() const noexcept -> ice::arctic::SymbolScope const& { return _globals; }
+
+        auto diagnostics() const noexcept -> ice::Span<ice::arctic::ParseDiagnostic const>
+        {
+            return _diagnostics;
+        }
+
+    private:
+        auto declare(
+            ice::arctic::SymbolScope& scope,
+            ice::arctic::Symbol symbol,
+            ice::arctic::Token const& name
+        ) noexcept -> ice::arctic::Symbol*;
+
+        auto resolve_type_name(ice::arctic::Token const& name) noexcept -> ice::arctic::TypeHandle;
+        auto resolve_typedef(ice::arctic::SyntaxNode_TypeDef const* node) noexcept -> ice::arctic::TypeHandle;
+        void resolve_struct(ice::arctic::SyntaxNode_Struct const* node) noexcept;
+        void resolve_function(ice::arctic::SyntaxNode_Function const* node) noexcept;
+
+        void resolve_initializer(
+            ice::arctic::SyntaxNode_Variable const* node,
+            ice::arctic::TypeHandle variable_type,
+            ice::arctic::SymbolScope const& scope
+        ) noexcept;
+
+        void resolve_statements(ice::arctic::SyntaxNode const* first, ice::arctic::SymbolScope& scope) noexcept;
+        auto resolve_expression(ice::arctic::SyntaxNode const* parent, ice::arctic::SymbolScope const& scope) noexcept -> ice::arctic::TypeHandle;
+        auto resolve_sequence(ice::arctic::SyntaxNode const* first, ice::arctic::SymbolScope const& scope) noexcept -> ice::arctic::TypeHandle;
+        auto resolve_operand(ice::arctic::SyntaxNode const* node, ice::arctic::SymbolScope const& scope) noexcept -> ice::arctic::TypeHandle;
+        auto resolve_members(ice::arctic::SyntaxNode const* value, ice::arctic::TypeHandle type) noexcept -> ice::arctic::TypeHandle;
+
+        auto combine(
+            ice::arctic::TypeHandle left,
+            ice::arctic::Token const& operation,
+            ice::arctic::TypeHandle right
+        ) noexcept -> ice::arctic::TypeHandle;
+
+        auto literal_type(ice::arctic::Token const& value) noexcept -> ice::arctic::TypeHandle;
+
+        void report(ice::arctic::ParseState state, ice::arctic::Token const& token) noexcept;
+
+    private:
+        ice::arctic::TypeTable _types;
+        ice::arctic::SymbolScope _globals;
+        std::deque<ice::arctic::Symbol> _symbols;
+        std::deque<ice::arctic::SymbolScope> _scopes;
+        std::vector<ice::arctic::SyntaxNode const*> _definitions;
+        std::vector<ice::arctic::ParseDiagnostic> _diagnostics;
+
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::arctic::TypeHandle> _node_types;
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::arctic::Symbol*> _node_symbols;
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::arctic::TypeMember const*> _node_members;
+
+        //! \brief Named types currently being resolved, used to detect cycles.
+        std::vector<ice::arctic::SyntaxNode const*> _resolving;
+    };
+
+} // namespace ice::arctic
@@ -0,0 +1,320 @@
+#pragma once
+#include <ice/arctic_static_parser.hxx>
+#include <array>
+#include <tuple>
+#include <utility>
+
+namespace ice::arctic
+{
+
+    namespace detail
+    {
+
+        //! \brief Node types a static syntax tree can hold, each stored in a separate array.
+        using StaticSyntaxNodeTypes = std::tuple<
+            ice::arctic::SyntaxNode_TypeDef,
+            ice::arctic::SyntaxNode_Struct,
+            ice::arctic::SyntaxNode_StructMember,
+            ice::arctic::SyntaxNode_Variable,
+            ice::arctic::SyntaxNode_ContextVariable,
+            ice::arctic::SyntaxNode_Function,
+            ice::arctic::SyntaxNode_FunctionArgument,
+            ice::arctic::SyntaxNode_FunctionBody,
+            ice::arctic::SyntaxNode_Scope,
+            ice::arctic::SyntaxNode_Annotation,
+            ice::arctic::SyntaxNode_AnnotationAttribute,
+            ice::arctic::SyntaxNode_Expression,
+            ice::arctic::SyntaxNode_ExplicitScope,
+            ice::arctic::SyntaxNode_ExpressionCall,
+            ice::arctic::SyntaxNode_ExpressionCallArg,
+            ice::arctic::SyntaxNode_ExpressionValue,
+            ice::arctic::SyntaxNode_ExpressionGetMember,
+            ice::arctic::SyntaxNode_ExpressionUnaryOperation,
+            ice::arctic::SyntaxNode_ExpressionBinaryOperation
+        >;
+
+        static constexpr ice::u32 Constant_StaticSyntaxNodeTypeCount = std::tuple_size_v<StaticSyntaxNodeTypes>;
+
+        template<typename... NodeTypes>
+        constexpr auto static_syntax_node_type_index(
+            ice::arctic::SyntaxEntity entity,
+            std::tuple<NodeTypes...> const*
+        ) noexcept -> ice::u32
+        {
+            ice::u32 result = sizeof...(NodeTypes);
+            ice::u32 idx = 0;
+            ((result = (NodeTypes::RepresentedSyntaxEntity == entity ? idx : result), idx += 1), ...);
+            return result;
+        }
+
+        constexpr auto static_syntax_node_type_index(ice::arctic::SyntaxEntity entity) noexcept -> ice::u32
+        {
+            return static_syntax_node_type_index(entity, static_cast<StaticSyntaxNodeTypes const*>(nullptr));
+        }
+
+        template<typename Node>
+        constexpr auto static_syntax_node_token_count() noexcept -> ice::u32
+        {
+            Node node{ };
+            node.entity = Node::RepresentedSyntaxEntity;
+
+            ice::u32 result = 0;
+            ice::arctic::for_each_syntax_token(static_cast<ice::arctic::SyntaxNode*>(&node), [&result](ice::arctic::Token&) noexcept
+                {
+                    result += 1;
+                }
+            );
+            return result;
+        }
+
+        template<typename... NodeTypes>
+        constexpr auto static_syntax_token_count(
+            ice::arctic::SyntaxEntity entity,
+            std::tuple<NodeTypes...> const*
+        ) noexcept -> ice::u32
+        {
+            ice::u32 result = 0;
+            ((result = (NodeTypes::RepresentedSyntaxEntity == entity ? static_syntax_node_token_count<NodeTypes>() : result)), ...);
+            return result;
+        }
+
+        //! \brief Where each reachable node of an image ends up in the typed node arrays.
+        template<ice::u32 Capacity>
+        struct StaticSyntaxLayout
+        {
+            ice::u32 counts[Constant_StaticSyntaxNodeTypeCount]{ };
+            ice::u32 types[Capacity]{ };
+            ice::u32 slots[Capacity]{ };
+            bool reachable[Capacity]{ };
+        };
+
+        template<ice::u32 Capacity>
+        constexpr auto static_syntax_layout(
+            ice::arctic::StaticSyntaxImage<Capacity> const& image
+        ) noexcept -> ice::arctic::detail::StaticSyntaxLayout<Capacity>
+        {
+            constexpr ice::u32 None = StaticSyntaxNodeData::Constant_None;
+
+            ice::arctic::detail::StaticSyntaxLayout<Capacity> result{ };
+
+            // Nodes can be pushed once from each link, annotations are also definitions.
+            ice::u32 stack[Capacity * 4]{ };
+            ice::u32 stack_size = 0;
+            for (ice::u32 idx = 0; idx < image.definition_count; ++idx)
+            {
+                stack[stack_size++] = image.definitions[idx];
+            }
+
+            while (stack_size > 0)
+            {
+                ice::u32 const idx = stack[--stack_size];
+                if (result.reachable[idx])
+                {
+                    continue;
+                }
+
+                result.reachable[idx] = true;
+
+                StaticSyntaxNodeData const& node = image.nodes[idx];
+                for (ice::u32 const linked : { node.child, node.sibling, node.annotation })
+                {
+                    if (linked != None && result.reachable[linked] == false)
+                    {
+                        stack[stack_size++] = linked;
+                    }
+                }
+            }
+
+            for (ice::u32 idx = 0; idx < image.node_count; ++idx)
+            {
+                if (result.reachable[idx])
+                {
+                    ice::u32 const type = static_syntax_node_type_index(image.nodes[idx].entity);
+                    result.types[idx] = type;
+                    result.slots[idx] = result.counts[type];
+                    result.counts[type] += 1;
+                }
+            }
+            return result;
+        }
+
+        //! \brief Reports a script with syntax errors.
+        //! \note Not a constant expression, compilers show the name of this function in the error.
+        //!   The state and the token of the error are returned by 'static_parse', which can also be called at runtime.
+        inline void static_syntax_error_found_in_compiled_script() noexcept
+        {
+        }
+
+        //! \brief Reports a script needing more nodes than the 'Capacity' it was compiled with.
+        //! \note Not a constant expression, compilers show the name of this function and the capacity in the error.
+        template<ice::u32 Capacity>
+        inline void static_syntax_node_capacity_exceeded_increase_compile_Capacity() noexcept
+        {
+        }
+
+    } // namespace detail
+
+    //! \returns The number of tokens used by nodes of the given entity, the remaining tokens of 'StaticSyntaxNodeData' are empty.
+    constexpr auto static_syntax_token_count(ice::arctic::SyntaxEntity entity) noexcept -> ice::u32
+    {
+        return ice::arctic::detail::static_syntax_token_count(entity, static_cast<ice::arctic::detail::StaticSyntaxNodeTypes const*>(nullptr));
+    }
+
+    //! \brief Compiles an embedded script in a constant evaluation, syntax errors are reported as compilation errors.
+    //!
+    //! \example constexpr auto module = ice::arctic::compile(u8"context Shader\n...");
+    //! \note Use 'static_syntax_tree<module>()' to access the resulting nodes.
+    //!   Syntax errors are reported as a call to 'static_syntax_error_found_in_compiled_script', running out of nodes
+    //!   is reported separately, as a call to 'static_syntax_node_capacity_exceeded_increase_compile_Capacity'.
+    template<ice::u32 Capacity = 512>
+    consteval auto compile(
+        ice::String source,
+        ice::arctic::LexerOptions options = { }
+    ) noexcept -> ice::arctic::StaticSyntaxImage<Capacity>
+    {
+        ice::arctic::StaticSyntaxImage<Capacity> result = ice::arctic::static_parse<Capacity>(source, options);
+        if (result.state == ParseState::Error_Limit_NodeCount)
+        {
+            ice::arctic::detail::static_syntax_node_capacity_exceeded_increase_compile_Capacity<Capacity>();
+        }
+        else if (result.state != ParseState::Success)
+        {
+            ice::arctic::detail::static_syntax_error_found_in_compiled_script();
+        }
+        return result;
+    }
+
+    //! \brief Syntax tree of a compiled image, stored in read-only data with the same node types the runtime parser creates.
+    template<
+        auto const& Image,
+        typename = std::make_index_sequence<ice::arctic::detail::Constant_StaticSyntaxNodeTypeCount>
+    >
+    class StaticSyntaxTree;
+
+    template<auto const& Image, std::size_t... TypeIdx>
+    class StaticSyntaxTree<Image, std::index_sequence<TypeIdx...>>
+    {
+        static_assert(Image.state == ParseState::Success, "Only successfully parsed images can be turned into a syntax tree.");
+
+        static constexpr auto Layout = ice::arctic::detail::static_syntax_layout(Image);
+
+        template<std::size_t Idx>
+        using NodeType = std::tuple_element_t<Idx, ice::arctic::detail::StaticSyntaxNodeTypes>;
+
+    public:
+        //! \param self The address the tree will be stored at, used to link nodes.
+        static consteval auto build(StaticSyntaxTree const* self) noexcept -> StaticSyntaxTree;
+
+        constexpr auto definitions() const noexcept -> ice::Span<ice::arctic::SyntaxNode const* const>
+        {
+            return { _definitions.data(), _definitions.size() };
+        }
+
+    private:
+        constexpr auto node_address(ice::u32 idx) const noexcept -> ice::arctic::SyntaxNode*;
+
+        template<typename Node>
+        static constexpr void initialize_node(
+            Node& node,
+            ice::arctic::StaticSyntaxNodeData const& data,
+            StaticSyntaxTree const* self
+        ) noexcept;
+
+    private:
+        std::tuple<std::array<NodeType<TypeIdx>, Layout.counts[TypeIdx]>...> _nodes;
+        std::array<ice::arctic::SyntaxNode const*, Image.definition_count> _definitions;
+    };
+
+    template<auto const& Image, std::size_t... TypeIdx>
+    constexpr auto StaticSyntaxTree<Image, std::index_sequence<TypeIdx...>>::node_address(
+        ice::u32 idx
+    ) const noexcept -> ice::arctic::SyntaxNode*
+    {
+        if (idx == StaticSyntaxNodeData::Constant_None)
+        {
+            return nullptr;
+        }
+
+        // Nodes are never modified through these pointers, the tree is only exposed as const.
+        ice::arctic::SyntaxNode* result = nullptr;
+        ice::u32 const type = Layout.types[idx];
+        ((type == TypeIdx ? (result = const_cast<NodeType<TypeIdx>*>(&std::get<TypeIdx>(_nodes)[Layout.slots[idx]])) : result), ...);
+        return result;
+    }
+
+    template<auto const& Image, std::size_t... TypeIdx>
+    template<typename Node>
+    constexpr void StaticSyntaxTree<Image, std::index_sequence<TypeIdx...>>::initialize_node(
+        Node& node,
+        ice::arctic::StaticSyntaxNodeData const& data,
+        StaticSyntaxTree const* self
+    ) noexcept
+    {
+        node.entity = data.entity;
+        node.child = self->node_address(data.child);
+        node.sibling = self->node_address(data.sibling);
+        node.annotation = self->node_address(data.annotation);
+
+        ice::u32 token_idx = 0;
+        ice::arctic::for_each_syntax_token(static_cast<ice::arctic::SyntaxNode*>(&node), [&](ice::arctic::Token& token) noexcept
+            {
+                token = data.tokens[token_idx++];
+            }
+        );
+
+        if constexpr (std::is_same_v<Node, ice::arctic::SyntaxNode_TypeDef>)
+        {
+            node.is_alias = data.is_alias;
+        }
+        else if constexpr (std::is_same_v<Node, ice::arctic::SyntaxNode_Variable>)
+        {
+            node.is_const = data.is_const;
+        }
+    }
+
+    template<auto const& Image, std::size_t... TypeIdx>
+    consteval auto StaticSyntaxTree<Image, std::index_sequence<TypeIdx...>>::build(
+        StaticSyntaxTree const* self
+    ) noexcept -> StaticSyntaxTree
+    {
+        StaticSyntaxTree result{ };
+
+        for (ice::u32 idx = 0; idx < Image.node_count; ++idx)
+        {
+            if (Layout.reachable[idx])
+            {
+                ice::u32 const type = Layout.types[idx];
+                ice::u32 const slot = Layout.slots[idx];
+                ((type == TypeIdx ? (initialize_node(std::get<TypeIdx>(result._nodes)[slot], Image.nodes[idx], self), 0) : 0), ...);
+            }
+        }
+
+        for (ice::u32 idx = 0; idx < Image.definition_count; ++idx)
+        {
+            result._definitions[idx] = self->node_address(Image.definitions[idx]);
+        }
+        return result;
+    }
+
+    namespace detail
+    {
+
+        template<auto const& Image>
+        struct StaticSyntaxTreeStorage
+        {
+            static StaticSyntaxTree<Image> const value;
+        };
+
+        template<auto const& Image>
+        constexpr StaticSyntaxTree<Image> StaticSyntaxTreeStorage<Image>::value = StaticSyntaxTree<Image>::build(&value);
+
+    } // namespace detail
+
+    //! \returns The syntax tree of a compiled image, the tree is built once and lives in read-only data.
+    template<auto const& Image>
+    constexpr auto static_syntax_tree() noexcept -> ice::arctic::StaticSyntaxTree<Image> const&
+    {
+        return ice::arctic::detail::StaticSyntaxTreeStorage<Image>::value;
+    }
+
+} // namespace ice::arctic
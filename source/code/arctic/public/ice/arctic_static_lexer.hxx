@@ -0,0 +1,480 @@
+#pragma once
+#include <ice/arctic_lexer.hxx>
+#include <ice/arctic_word.hxx>
+
+namespace ice::arctic
+{
+
+    //! \brief A lexer usable in constant evaluation, produces the same tokens as 'create_lexer' with an ascii word matcher.
+    //! \note Only the 'Shader' rules are supported, sources using the 'Script' rules are reported as invalid.
+    class StaticLexer
+    {
+    public:
+        constexpr StaticLexer(
+            ice::String source,
+            ice::arctic::LexerOptions options = { }
+        ) noexcept;
+
+        constexpr auto next() noexcept -> ice::arctic::Token;
+
+        //! \returns 'false' if the source header is missing or selects rules not supported by this lexer.
+        constexpr bool valid() const noexcept
+        {
+            return _valid;
+        }
+
+    private:
+        constexpr auto char_at(ice::u64 offset) const noexcept -> ice::utf8;
+        constexpr auto next_word() noexcept -> ice::arctic::Word;
+
+        constexpr void tokenize_alphanum(ice::arctic::Token& out_result) const noexcept;
+        constexpr void tokenize_punctuation(ice::arctic::Token& out_result) const noexcept;
+        constexpr void tokenize_uservalues(ice::arctic::Token& out_result, bool& out_skip_next_word) noexcept;
+
+    private:
+        ice::String _source;
+        ice::u64 _offset;
+        bool _finished;
+        bool _valid;
+
+        ice::u32 _tab_size;
+        ice::u32 _column_offset;
+
+        ice::arctic::WordLocation _word_location;
+        ice::arctic::Word _word;
+    };
+
+    namespace detail
+    {
+
+        constexpr bool static_is_digit(ice::utf8 u8char) noexcept
+        {
+            return u8char >= u8'0' && u8char <= u8'9';
+        }
+
+        constexpr bool static_is_alnum(ice::utf8 u8char) noexcept
+        {
+            return static_is_digit(u8char)
+                || (u8char >= u8'a' && u8char <= u8'z')
+                || (u8char >= u8'A' && u8char <= u8'Z');
+        }
+
+        constexpr bool static_is_space(ice::utf8 u8char) noexcept
+        {
+            return u8char == u8' ' || (u8char >= u8'\t' && u8char <= u8'\r');
+        }
+
+        constexpr bool static_is_punct(ice::utf8 u8char) noexcept
+        {
+            return u8char > u8' ' && u8char < 0x7f && static_is_alnum(u8char) == false;
+        }
+
+        //! \brief Selects the same category as the runtime matcher dispatch table.
+        constexpr auto static_word_category(ice::utf8 u8char) noexcept -> ice::arctic::WordCategory
+        {
+            if ((u8char & 0x80) != 0 || static_is_alnum(u8char) || u8char == u8'_')
+            {
+                return WordCategory::AlphaNum;
+            }
+            else if (u8char == u8'\n' || u8char == u8'\r')
+            {
+                return WordCategory::EndOfLine;
+            }
+            else if (static_is_space(u8char))
+            {
+                return WordCategory::Whitespace;
+            }
+            else if (static_is_punct(u8char))
+            {
+                return WordCategory::Punctuation;
+            }
+            return WordCategory::Unknown;
+        }
+
+    } // namespace detail
+
+    constexpr StaticLexer::StaticLexer(
+        ice::String source,
+        ice::arctic::LexerOptions options
+    ) noexcept
+        : _source{ source }
+        , _offset{ 0 }
+        , _finished{ false }
+        , _valid{ true }
+        , _tab_size{ options.tab_size }
+        , _column_offset{ 0 }
+        , _word_location{ }
+        , _word{ }
+    {
+        if (options.rules == LexerRules::Provided)
+        {
+            ice::arctic::Word word = next_word();
+            while (word.category != WordCategory::AlphaNum && word.category != WordCategory::EndOfFile)
+            {
+                word = next_word();
+            }
+
+            _valid = word.value == u8"context";
+            word = next_word();
+            _valid &= word.category == WordCategory::Whitespace;
+            word = next_word();
+            _valid &= word.value == u8"Shader";
+        }
+        else
+        {
+            _valid = options.rules == LexerRules::Shader;
+        }
+
+        _word = next_word();
+    }
+
+    constexpr auto StaticLexer::char_at(ice::u64 offset) const noexcept -> ice::utf8
+    {
+        return offset < _source.size() ? _source[offset] : u8'\0';
+    }
+
+    constexpr auto StaticLexer::next_word() noexcept -> ice::arctic::Word
+    {
+        if (_finished)
+        {
+            return Word{ .value = u8"\0", .category = WordCategory::EndOfFile, .location = _word_location };
+        }
+
+        ice::u64 const begin = _offset;
+        ice::u64 end = _offset;
+        ice::u32 characters = 0;
+
+        ice::arctic::WordCategory const category = ice::arctic::detail::static_word_category(char_at(begin));
+        switch (category)
+        {
+        case WordCategory::AlphaNum:
+            do
+            {
+                ice::utf8 u8char = char_at(end);
+                ice::u32 utf8_child_count = 0;
+
+                while ((u8char & 0xC0) == 0xC0)
+                {
+                    u8char <<= 1;
+                    utf8_child_count += 1;
+                }
+
+                end += 1 + utf8_child_count;
+                characters += 1;
+
+            } while ((char_at(end) & 0xC0) == 0xC0 || ice::arctic::detail::static_is_alnum(char_at(end)) || char_at(end) == u8'_');
+            break;
+        case WordCategory::Punctuation:
+            end += 1;
+            characters = 1;
+            break;
+        case WordCategory::Whitespace:
+            // The runtime matcher also consumes line breaks following a whitespace.
+            end += 1;
+            while (ice::arctic::detail::static_is_space(char_at(end)))
+            {
+                end += 1;
+            }
+            characters = ice::u32(end - begin);
+            break;
+        case WordCategory::EndOfLine:
+            characters = ice::u32(char_at(end) == u8'\n');
+            end += 1;
+            while (char_at(end) == u8'\n' || char_at(end) == u8'\r')
+            {
+                characters += ice::u32(char_at(end) == u8'\n');
+                end += 1;
+            }
+            break;
+        default:
+            break;
+        }
+
+        ice::arctic::Word const result{
+            .value = _source.substr(begin, end - begin),
+            .category = category,
+            .location = _word_location
+        };
+
+        if (category == WordCategory::EndOfLine)
+        {
+            _word_location.line += characters;
+            _word_location.character = 0;
+        }
+        else
+        {
+            _word_location.character += characters;
+        }
+
+        _offset = end;
+        if (char_at(end) == u8'\0' || category == WordCategory::Unknown)
+        {
+            _finished = true;
+            _word_location.character = 0;
+        }
+        return result;
+    }
+
+    constexpr auto StaticLexer::next() noexcept -> ice::arctic::Token
+    {
+        while (_word.category != WordCategory::EndOfFile)
+        {
+            ice::arctic::TokenLocation location{ .line = _word.location.line + 1u, .column = 0 };
+
+            if (_word.category == WordCategory::Whitespace)
+            {
+                for (ice::utf8 const u8char : _word.value)
+                {
+                    _column_offset += u8char == u8'\t' ? _tab_size : 1;
+                }
+
+                _column_offset -= ice::u32(_word.value.size());
+                _word = next_word();
+                _column_offset *= (_word.category != WordCategory::EndOfLine);
+                continue;
+            }
+
+            location.column = 1 + _word.location.character + _column_offset;
+
+            ice::arctic::Token result{
+                .value = { },
+                .type = TokenType::Invalid,
+                .location = location
+            };
+
+            bool skip_next_word = false;
+            switch (_word.category)
+            {
+            case WordCategory::AlphaNum:
+                tokenize_alphanum(result);
+                break;
+            case WordCategory::Punctuation:
+                tokenize_punctuation(result);
+                break;
+            case WordCategory::EndOfLine:
+                result.type = TokenType::ST_EndOfLine;
+                result.value = _word.value;
+                break;
+            default:
+                break;
+            }
+
+            if (result.type == TokenType::Invalid && _word.value.empty() == false)
+            {
+                tokenize_uservalues(result, skip_next_word);
+            }
+
+            if (skip_next_word == false)
+            {
+                _word = next_word();
+            }
+
+            _column_offset *= (_word.category != WordCategory::EndOfLine);
+            return result;
+        }
+
+        return Token{
+            .value = { },
+            .type = TokenType::ST_EndOfFile,
+            .location = { .line = _word.location.line + 1u, .column = 0 }
+        };
+    }
+
+    constexpr void StaticLexer::tokenize_alphanum(ice::arctic::Token& out_result) const noexcept
+    {
+        struct Keyword
+        {
+            ice::String value;
+            ice::arctic::TokenType type;
+        };
+
+        constexpr Keyword keywords[]{
+            { u8"fn", TokenType::KW_Fn },
+            { u8"ctx", TokenType::KW_Ctx },
+            { u8"def", TokenType::KW_Def },
+            { u8"let", TokenType::KW_Let },
+            { u8"mut", TokenType::KW_Mut },
+            { u8"true", TokenType::KW_True },
+            { u8"alias", TokenType::KW_Alias },
+            { u8"const", TokenType::KW_Const },
+            { u8"false", TokenType::KW_False },
+            { u8"struct", TokenType::KW_Struct },
+            { u8"typeof", TokenType::KW_TypeOf },
+            { u8"import", TokenType::KW_Import },
+        };
+
+        for (Keyword const& keyword : keywords)
+        {
+            if (_word.value == keyword.value)
+            {
+                out_result.type = keyword.type;
+                out_result.value = _word.value;
+            }
+        }
+    }
+
+    constexpr void StaticLexer::tokenize_punctuation(ice::arctic::Token& out_result) const noexcept
+    {
+        out_result.value = _word.value;
+        switch (_word.value.front())
+        {
+        case u8'+': out_result.type = TokenType::OP_Plus; break;
+        case u8'-': out_result.type = TokenType::OP_Minus; break;
+        case u8'*': out_result.type = TokenType::OP_Mul; break;
+        case u8'/': out_result.type = TokenType::OP_Div; break;
+        case u8'=': out_result.type = TokenType::OP_Assign; break;
+        case u8'[': out_result.type = TokenType::CT_SquareBracketOpen; break;
+        case u8']': out_result.type = TokenType::CT_SquareBracketClose; break;
+        case u8'(': out_result.type = TokenType::CT_ParenOpen; break;
+        case u8')': out_result.type = TokenType::CT_ParenClose; break;
+        case u8'{': out_result.type = TokenType::CT_BracketOpen; break;
+        case u8'}': out_result.type = TokenType::CT_BracketClose; break;
+        case u8':': out_result.type = TokenType::CT_Colon; break;
+        case u8',': out_result.type = TokenType::CT_Comma; break;
+        case u8'.': out_result.type = TokenType::CT_Dot; break;
+        case u8'#': out_result.type = TokenType::CT_Hash; break;
+        default: break;
+        }
+    }
+
+    constexpr void StaticLexer::tokenize_uservalues(ice::arctic::Token& out_result, bool& out_skip_next_word) noexcept
+    {
+        out_result.value = _word.value;
+
+        ice::utf8 const first_char = _word.value.front();
+        if (first_char == u8'\'' || first_char == u8'"')
+        {
+            ice::u64 const begin = _offset - _word.value.size();
+
+            bool is_end = false;
+            bool is_backslash = false;
+            while (is_end == false)
+            {
+                _word = next_word();
+
+                if (is_backslash)
+                {
+                    is_backslash = false;
+                    continue;
+                }
+
+                if (_word.category == WordCategory::EndOfFile)
+                {
+                    out_result.type = TokenType::Invalid;
+                    return;
+                }
+
+                ice::utf8 const initial_char = _word.value.front();
+                if (initial_char == u8'\\')
+                {
+                    is_backslash = true;
+                }
+                else if (initial_char == first_char)
+                {
+                    is_end = true;
+                }
+            }
+
+            out_result.type = first_char == u8'\'' ? TokenType::CT_Literal : TokenType::CT_String;
+            out_result.value = _source.substr(begin, _offset - begin);
+        }
+        else if (ice::arctic::detail::static_is_digit(first_char))
+        {
+            ice::u64 const begin = _offset - _word.value.size();
+            ice::u64 const word_size = _word.value.size();
+
+            bool is_number = true;
+            bool is_done = false;
+            bool is_quote_separator = false;
+
+            bool const has_representation_prefix = first_char == u8'0' && word_size > 1;
+            bool const is_hex = has_representation_prefix && _word.value[1] == u8'x';
+            bool const is_binary = has_representation_prefix && _word.value[1] == u8'b';
+            bool const is_oct = has_representation_prefix && _word.value[1] != u8'x';
+            bool is_floating_point = false;
+            bool is_next_word = false;
+
+            while (is_done == false)
+            {
+                _word = next_word();
+
+                switch (_word.value.empty() ? u8'\0' : _word.value.front())
+                {
+                case u8'\'':
+                    is_number = is_quote_separator == false;
+                    is_quote_separator = true;
+                    break;
+                case u8'.':
+                    is_number = is_floating_point == false;
+                    is_next_word = true;
+                    is_floating_point = true;
+                    break;
+                default:
+                    is_done = (is_quote_separator == false) && (is_next_word == false);
+                    is_next_word = false;
+                    is_quote_separator = false;
+                    break;
+                }
+
+                is_done |= (is_number == false);
+            }
+
+            if (is_number)
+            {
+                // The terminating word is the start of the next token.
+                ice::u64 const end = _offset - _word.value.size();
+
+                bool const is_float_suffix = _source[end - 1] == u8'f';
+                bool const is_unsigned_suffix = _source[end - 1] == u8'u';
+
+                ice::String const value = _source.substr(begin, (end - begin) - ice::u32(is_unsigned_suffix || is_float_suffix));
+                out_result.value = value;
+                out_skip_next_word = true;
+
+                if (is_binary)
+                {
+                    if (value.find_first_not_of(u8"'01", 2) == ice::String::npos)
+                    {
+                        out_result.type = TokenType::CT_NumberBin;
+                    }
+                }
+                else if (is_hex)
+                {
+                    if (value.find_first_not_of(u8"'0123456789abcdefABCDEF", 2) == ice::String::npos)
+                    {
+                        out_result.type = TokenType::CT_NumberHex;
+                    }
+                }
+                else if (is_oct)
+                {
+                    if (value.find_first_not_of(u8"'01234567", 1) == ice::String::npos)
+                    {
+                        out_result.type = TokenType::CT_NumberOct;
+                    }
+                }
+                else if (is_floating_point || is_float_suffix)
+                {
+                    ice::u64 const dot_pos = value.find_first_not_of(u8"'0123456789", 0);
+                    if (dot_pos != ice::String::npos && value[dot_pos] == u8'.')
+                    {
+                        is_number &= value.find_first_not_of(u8"'0123456789", dot_pos + 1) == ice::String::npos;
+                    }
+
+                    if (is_number)
+                    {
+                        out_result.type = TokenType::CT_NumberFloat;
+                    }
+                }
+                else if (value.find_first_not_of(u8"'0123456789") == ice::String::npos)
+                {
+                    out_result.type = TokenType::CT_Number;
+                }
+            }
+        }
+        else
+        {
+            out_result.type = TokenType::CT_Symbol;
+        }
+    }
+
+} // namespace ice::arctic
@@ -0,0 +1,1195 @@
+#pragma once
+#include <ice/arctic_static_lexer.hxx>
+#include <ice/arctic_syntax_node.hxx>
+#include <ice/arctic_parser_result.hxx>
+
+namespace ice::arctic
+{
+
+    //! \brief A syntax node produced in a constant evaluation, links to other nodes are indices into the image.
+    struct StaticSyntaxNodeData
+    {
+        static constexpr ice::u32 Constant_None = 0xffff'ffff;
+
+        ice::arctic::SyntaxEntity entity = SyntaxEntity::ROOT;
+
+        ice::u32 child = Constant_None;
+        ice::u32 sibling = Constant_None;
+        ice::u32 annotation = Constant_None;
+
+        //! \brief Tokens of the node, in the same order as visited by 'for_each_syntax_token'.
+        ice::arctic::Token tokens[2]{ };
+        bool is_alias = false;
+        bool is_const = false;
+    };
+
+    //! \brief The result of parsing a script in a constant evaluation.
+    //! \note Nodes discarded while parsing are still part of the image, only nodes reachable from definitions are relevant.
+    template<ice::u32 Capacity>
+    struct StaticSyntaxImage
+    {
+        static constexpr ice::u32 Constant_Capacity = Capacity;
+
+        ice::arctic::ParseState state = ParseState::Success;
+        ice::arctic::Token error_token{ };
+
+        ice::u32 node_count = 0;
+        ice::u32 definition_count = 0;
+
+        ice::arctic::StaticSyntaxNodeData nodes[Capacity]{ };
+        ice::u32 definitions[Capacity]{ };
+    };
+
+    namespace detail
+    {
+
+        enum class StaticRuleKind : ice::u8
+        {
+            MatchType,
+            MatchAll,
+            MatchFirst,
+            MatchChild,
+            MatchSibling,
+            Subexpression,
+        };
+
+        enum class StaticRuleStore : ice::u8
+        {
+            Skip,
+            FirstToken,
+            SecondToken,
+            AliasTrue,
+            AliasFalse,
+            ConstTrue,
+        };
+
+        //! \brief Table driven equivalent of 'TokenRule', groups reference other rule tables instead of functions.
+        struct StaticTokenRule
+        {
+            ice::arctic::detail::StaticRuleKind kind;
+            bool optional = false;
+            bool repeat = false;
+
+            ice::arctic::ParseState fail_state = ParseState::Error;
+
+            ice::arctic::TokenType type = TokenType::Invalid;
+            ice::arctic::detail::StaticRuleStore store = StaticRuleStore::Skip;
+
+            ice::arctic::SyntaxEntity entity = SyntaxEntity::ROOT;
+            ice::arctic::detail::StaticTokenRule const* rules = nullptr;
+            ice::u32 count = 0;
+
+            constexpr auto fail_with(ice::arctic::ParseState state) const noexcept -> ice::arctic::detail::StaticTokenRule
+            {
+                StaticTokenRule result = *this;
+                result.fail_state = state;
+                return result;
+            }
+        };
+
+        constexpr auto static_match_type(
+            ice::arctic::TokenType type,
+            ice::arctic::detail::StaticRuleStore store = StaticRuleStore::Skip,
+            bool optional = false
+        ) noexcept -> ice::arctic::detail::StaticTokenRule
+        {
+            return StaticTokenRule{ .kind = StaticRuleKind::MatchType, .optional = optional, .type = type, .store = store };
+        }
+
+        template<ice::u32 Count>
+        constexpr auto static_match_group(
+            ice::arctic::detail::StaticRuleKind kind,
+            ice::arctic::detail::StaticTokenRule const(&rules)[Count],
+            bool optional = false,
+            bool repeat = false,
+            ice::arctic::SyntaxEntity entity = SyntaxEntity::ROOT
+        ) noexcept -> ice::arctic::detail::StaticTokenRule
+        {
+            return StaticTokenRule{
+                .kind = kind,
+                .optional = optional,
+                .repeat = repeat,
+                .entity = entity,
+                .rules = rules,
+                .count = Count
+            };
+        }
+
+        // Mirrors the rule tables in 'arctic_parser_logic_definition.cxx' and 'arctic_parser_logic_expression.cxx'.
+        // Changes need to be made in both places, the '--static-parity' mode of the test driver compares the trees of both parsers.
+        namespace static_rules
+        {
+
+            using enum ice::arctic::TokenType;
+            using enum ice::arctic::detail::StaticRuleKind;
+            using enum ice::arctic::detail::StaticRuleStore;
+
+            inline constexpr StaticTokenRule TypeOfBaseType[]{
+                static_match_type(CT_SquareBracketOpen).fail_with(ParseState::Error_TypeOf_MissingBracketOpen),
+                static_match_type(CT_Symbol, SecondToken).fail_with(ParseState::Error_TypeOf_MissingTypeName),
+                static_match_type(CT_SquareBracketClose).fail_with(ParseState::Error_TypeOf_MissingBracketClose),
+            };
+
+            inline constexpr StaticTokenRule TypeOfSubType[]{
+                static_match_type(KW_Alias, AliasTrue),
+                static_match_type(KW_TypeOf, AliasFalse),
+            };
+
+            inline constexpr StaticTokenRule TypeOf[]{
+                static_match_group(MatchFirst, TypeOfSubType),
+                static_match_group(MatchAll, TypeOfBaseType),
+            };
+
+            inline constexpr StaticTokenRule StructMember[]{
+                static_match_type(CT_Symbol, FirstToken),
+                static_match_type(CT_Colon),
+                static_match_type(CT_Symbol, SecondToken),
+                static_match_type(ST_EndOfLine),
+            };
+
+            inline constexpr StaticTokenRule Struct[]{
+                static_match_type(KW_Struct),
+                static_match_type(CT_SquareBracketOpen).fail_with(ParseState::Error_TypeOf_MissingBracketOpen),
+                static_match_type(ST_EndOfLine),
+                static_match_group(MatchChild, StructMember, true, true, SyntaxEntity::DEF_StructMember),
+                static_match_type(CT_SquareBracketClose).fail_with(ParseState::Error_TypeOf_MissingBracketClose),
+            };
+
+            inline constexpr StaticTokenRule Definition[]{
+                static_match_type(CT_Symbol, FirstToken),
+                static_match_type(OP_Assign),
+            };
+
+            inline constexpr StaticTokenRule FunctionArg[]{
+                static_match_type(ST_EndOfLine, Skip, true),
+                static_match_type(CT_Symbol, FirstToken),
+                static_match_type(CT_Colon),
+                static_match_type(CT_Symbol, SecondToken),
+                static_match_type(ST_EndOfLine, Skip, true),
+                static_match_type(CT_Comma, Skip, true),
+            };
+
+            inline constexpr StaticTokenRule Function[]{
+                static_match_type(CT_Symbol, FirstToken),
+                static_match_type(CT_ParenOpen).fail_with(ParseState::Error_UnexpectedToken),
+                static_match_group(MatchChild, FunctionArg, true, true, SyntaxEntity::DEF_FunctionArgument),
+                static_match_type(CT_ParenClose).fail_with(ParseState::Error_UnexpectedToken),
+                static_match_type(CT_Colon),
+                static_match_type(CT_Symbol, SecondToken),
+                static_match_type(ST_EndOfLine),
+            };
+
+            inline constexpr StaticTokenRule AttributeValue[]{
+                static_match_type(CT_Number, SecondToken),
+                static_match_type(CT_NumberBin, SecondToken),
+                static_match_type(CT_NumberFloat, SecondToken),
+                static_match_type(CT_NumberHex, SecondToken),
+                static_match_type(CT_NumberOct, SecondToken),
+                static_match_type(CT_Literal, SecondToken),
+                static_match_type(CT_String, SecondToken),
+                static_match_type(KW_True, SecondToken),
+                static_match_type(KW_False, SecondToken),
+                static_match_type(CT_Symbol, SecondToken),
+            };
+
+            inline constexpr StaticTokenRule AttributeAssignValue[]{
+                static_match_type(OP_Assign),
+                static_match_group(MatchFirst, AttributeValue),
+            };
+
+            inline constexpr StaticTokenRule AttributeFirst[]{
+                static_match_type(CT_Symbol, FirstToken),
+                static_match_group(MatchAll, AttributeAssignValue, true),
+            };
+
+            inline constexpr StaticTokenRule Attribute[]{
+                static_match_type(CT_Comma),
+                static_match_type(CT_Symbol, FirstToken),
+                static_match_group(MatchAll, AttributeAssignValue, true),
+            };
+
+            inline constexpr StaticTokenRule Attributes[]{
+                static_match_group(MatchChild, AttributeFirst, false, false, SyntaxEntity::DEF_AnnotationAttribute),
+                static_match_group(MatchChild, Attribute, true, true, SyntaxEntity::DEF_AnnotationAttribute),
+            };
+
+            inline constexpr StaticTokenRule Annotation[]{
+                static_match_type(CT_SquareBracketOpen),
+                static_match_group(MatchAll, Attributes),
+                static_match_type(CT_SquareBracketClose),
+            };
+
+            inline constexpr StaticTokenRule VariableQualifier[]{
+                static_match_type(KW_Let),
+                static_match_type(KW_Const, ConstTrue),
+            };
+
+            inline constexpr StaticTokenRule Variable[]{
+                static_match_group(MatchFirst, VariableQualifier),
+                static_match_type(CT_Symbol, FirstToken),
+                static_match_type(CT_Colon),
+                static_match_type(CT_Symbol, SecondToken),
+            };
+
+            inline constexpr StaticTokenRule ExpValues[]{
+                static_match_type(CT_Number, FirstToken),
+                static_match_type(CT_NumberBin, FirstToken),
+                static_match_type(CT_NumberFloat, FirstToken),
+                static_match_type(CT_NumberHex, FirstToken),
+                static_match_type(CT_NumberOct, FirstToken),
+                static_match_type(CT_Literal, FirstToken),
+                static_match_type(CT_String, FirstToken),
+                static_match_type(KW_True, FirstToken),
+                static_match_type(KW_False, FirstToken),
+                static_match_type(CT_Symbol, FirstToken),
+            };
+
+            inline constexpr StaticTokenRule ExpValue[]{
+                static_match_group(MatchFirst, ExpValues),
+            };
+
+            inline constexpr StaticTokenRule ExpBinaryOperations[]{
+                static_match_type(OP_Assign, FirstToken),
+                static_match_type(OP_Plus, FirstToken),
+                static_match_type(OP_Minus, FirstToken),
+                static_match_type(OP_Mul, FirstToken),
+                static_match_type(OP_Div, FirstToken),
+                static_match_type(OP_And, FirstToken),
+                static_match_type(OP_Or, FirstToken),
+            };
+
+            inline constexpr StaticTokenRule ExpBinaryOperation[]{
+                static_match_group(MatchFirst, ExpBinaryOperations),
+            };
+
+            inline constexpr StaticTokenRule ExpBinaryLeftAndOperation[]{
+                static_match_group(MatchSibling, ExpValue, false, false, SyntaxEntity::EXP_Value),
+                static_match_group(MatchSibling, ExpBinaryOperation, true, false, SyntaxEntity::EXP_BinaryOperation),
+            };
+
+            inline constexpr StaticTokenRule ExpBinary[]{
+                static_match_group(MatchAll, ExpBinaryLeftAndOperation, false, true),
+            };
+
+            inline constexpr StaticTokenRule RecursiveExpression[]{
+                StaticTokenRule{ .kind = Subexpression },
+            };
+
+            inline constexpr StaticTokenRule RecursiveExpressionRepeat[]{
+                StaticTokenRule{ .kind = Subexpression, .repeat = true },
+            };
+
+            inline constexpr StaticTokenRule MatchTypeOf = static_match_group(MatchAll, TypeOf);
+            inline constexpr StaticTokenRule MatchStruct = static_match_group(MatchAll, Struct);
+            inline constexpr StaticTokenRule MatchDefinition = static_match_group(MatchAll, Definition);
+            inline constexpr StaticTokenRule MatchFunction = static_match_group(MatchAll, Function);
+            inline constexpr StaticTokenRule MatchAnnotation = static_match_group(MatchAll, Annotation);
+            inline constexpr StaticTokenRule MatchVariable = static_match_group(MatchAll, Variable);
+            inline constexpr StaticTokenRule MatchBinaryAll = static_match_group(MatchAll, ExpBinary);
+            inline constexpr StaticTokenRule MatchRecursive = static_match_group(MatchAll, RecursiveExpression);
+            inline constexpr StaticTokenRule MatchExpression = static_match_group(MatchAll, RecursiveExpressionRepeat);
+            inline constexpr StaticTokenRule MatchPostBinary = static_match_group(
+                MatchSibling, ExpBinaryOperation, true, false, SyntaxEntity::EXP_BinaryOperation
+            );
+
+        } // namespace static_rules
+
+        //! \brief Parser usable in constant evaluation, follows the runtime parser step by step so both produce the same tree.
+        //! \note Unlike the runtime parser, imports are reported as 'Error_Import_NotFound'.
+        template<ice::u32 Capacity>
+        class StaticParser
+        {
+            static constexpr ice::u32 None = StaticSyntaxNodeData::Constant_None;
+
+            struct Result
+            {
+                ice::arctic::ParseState state;
+                ice::u32 node = None;
+
+                constexpr bool has_error() const noexcept
+                {
+                    return state != ParseState::Success;
+                }
+            };
+
+        public:
+            constexpr StaticParser(
+                ice::arctic::StaticLexer& lexer,
+                ice::arctic::StaticSyntaxImage<Capacity>& image
+            ) noexcept
+                : _lexer{ lexer }
+                , _image{ image }
+                , _scratch{ }
+                , _current{ }
+                , _overflow{ false }
+            {
+            }
+
+            constexpr auto parse() noexcept -> ice::arctic::ParseState;
+
+        private:
+            constexpr auto node(ice::u32 idx) noexcept -> ice::arctic::StaticSyntaxNodeData&
+            {
+                return idx < Capacity ? _image.nodes[idx] : _scratch;
+            }
+
+            constexpr auto next_token() noexcept -> ice::arctic::Token
+            {
+                _current = _lexer.next();
+                return _current;
+            }
+
+            constexpr auto create(ice::arctic::SyntaxEntity entity) noexcept -> ice::u32;
+            constexpr void destroy(ice::u32 idx) noexcept;
+
+            constexpr void append_child(ice::u32 parent, ice::u32 child) noexcept;
+            constexpr void append_sibling_or_assign(ice::u32& first, ice::u32 sibling) noexcept;
+
+            constexpr auto match(
+                ice::arctic::detail::StaticTokenRule const& rule,
+                ice::u32 node,
+                ice::arctic::Token& token
+            ) noexcept -> ice::arctic::ParseState;
+
+            constexpr auto match_all(
+                ice::arctic::detail::StaticTokenRule const& group,
+                ice::u32 node,
+                ice::arctic::Token& token
+            ) noexcept -> ice::arctic::ParseState;
+
+            constexpr auto match_first(
+                ice::arctic::detail::StaticTokenRule const& group,
+                ice::u32 node,
+                ice::arctic::Token& token
+            ) noexcept -> ice::arctic::ParseState;
+
+            constexpr auto match_as_node(
+                ice::arctic::detail::StaticTokenRule const& group,
+                ice::u32 node,
+                ice::arctic::Token& token
+            ) noexcept -> ice::arctic::ParseState;
+
+            constexpr auto match_subexpression(ice::u32 node, ice::arctic::Token& token) noexcept -> ice::arctic::ParseState;
+
+            constexpr auto parse_expression(ice::u32 parent, ice::arctic::Token& token) noexcept -> ice::arctic::ParseState
+            {
+                return match(static_rules::MatchExpression, parent, token);
+            }
+
+            constexpr auto parse_expression_block(ice::u32 parent) noexcept -> Result;
+            constexpr auto parse_variable(ice::arctic::SyntaxEntity entity, ice::arctic::Token& token) noexcept -> Result;
+            constexpr auto parse_function() noexcept -> Result;
+            constexpr auto parse_type_definition() noexcept -> Result;
+            constexpr auto parse_annotation(ice::arctic::Token& token) noexcept -> Result;
+
+            constexpr auto parse_definition(ice::arctic::Token& token) noexcept -> Result;
+            constexpr auto parse_context_definition(ice::arctic::Token& token) noexcept -> Result;
+            constexpr auto parse_block(ice::arctic::Token& token) noexcept -> ice::arctic::ParseState;
+
+            constexpr void on_definition(ice::u32 idx) noexcept
+            {
+                _image.definitions[_image.definition_count] = idx;
+                _image.definition_count += 1;
+            }
+
+        private:
+            ice::arctic::StaticLexer& _lexer;
+            ice::arctic::StaticSyntaxImage<Capacity>& _image;
+
+            //! \brief Receives writes to nodes that could not be allocated, the parse fails in such a case.
+            ice::arctic::StaticSyntaxNodeData _scratch;
+
+            //! \brief The last token read, parsing stops at this token if an error is found.
+            ice::arctic::Token _current;
+            bool _overflow;
+        };
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::create(ice::arctic::SyntaxEntity entity) noexcept -> ice::u32
+        {
+            if (_image.node_count == Capacity)
+            {
+                _overflow = true;
+                _scratch = StaticSyntaxNodeData{ .entity = entity };
+                return None;
+            }
+
+            ice::u32 const idx = _image.node_count;
+            _image.nodes[idx] = StaticSyntaxNodeData{ .entity = entity };
+            _image.node_count += 1;
+            return idx;
+        }
+
+        template<ice::u32 Capacity>
+        constexpr void StaticParser<Capacity>::destroy(ice::u32 idx) noexcept
+        {
+            // Only the most recent node can be returned, others are left unreachable.
+            if (idx != None && idx + 1 == _image.node_count)
+            {
+                _image.nodes[idx] = StaticSyntaxNodeData{ };
+                _image.node_count -= 1;
+            }
+        }
+
+        template<ice::u32 Capacity>
+        constexpr void StaticParser<Capacity>::append_child(ice::u32 parent, ice::u32 child) noexcept
+        {
+            if (node(parent).child == None)
+            {
+                node(parent).child = child;
+            }
+            else
+            {
+                ice::u32 children = node(parent).child;
+                while (node(children).sibling != None)
+                {
+                    children = node(children).sibling;
+                }
+
+                node(children).sibling = child;
+            }
+        }
+
+        template<ice::u32 Capacity>
+        constexpr void StaticParser<Capacity>::append_sibling_or_assign(ice::u32& first, ice::u32 sibling) noexcept
+        {
+            if (first == None)
+            {
+                first = sibling;
+            }
+            else
+            {
+                ice::u32 previous_sibling = first;
+                while (node(previous_sibling).sibling != None)
+                {
+                    previous_sibling = node(previous_sibling).sibling;
+                }
+
+                node(previous_sibling).sibling = sibling;
+            }
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::match(
+            ice::arctic::detail::StaticTokenRule const& rule,
+            ice::u32 idx,
+            ice::arctic::Token& token
+        ) noexcept -> ice::arctic::ParseState
+        {
+            if (_overflow)
+            {
+                return ParseState::Error_Limit_NodeCount;
+            }
+
+            ice::arctic::ParseState result = ParseState::Success;
+            switch (rule.kind)
+            {
+            case StaticRuleKind::MatchType:
+                if (token.type != rule.type)
+                {
+                    return rule.fail_state;
+                }
+
+                switch (rule.store)
+                {
+                case StaticRuleStore::FirstToken: node(idx).tokens[0] = token; break;
+                case StaticRuleStore::SecondToken: node(idx).tokens[1] = token; break;
+                case StaticRuleStore::AliasTrue: node(idx).is_alias = true; break;
+                case StaticRuleStore::AliasFalse: node(idx).is_alias = false; break;
+                case StaticRuleStore::ConstTrue: node(idx).is_const = true; break;
+                default: break;
+                }
+
+                token = next_token();
+                return ParseState::Success;
+            case StaticRuleKind::Subexpression:
+                return match_subexpression(idx, token);
+            case StaticRuleKind::MatchAll:
+                result = match_all(rule, idx, token);
+                break;
+            case StaticRuleKind::MatchFirst:
+                result = match_first(rule, idx, token);
+                break;
+            case StaticRuleKind::MatchChild:
+            case StaticRuleKind::MatchSibling:
+                result = match_as_node(rule, idx, token);
+                break;
+            }
+
+            if (rule.fail_state == ParseState::Success || result == ParseState::Success)
+            {
+                return result;
+            }
+            return rule.fail_state;
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::match_all(
+            ice::arctic::detail::StaticTokenRule const& group,
+            ice::u32 idx,
+            ice::arctic::Token& token
+        ) noexcept -> ice::arctic::ParseState
+        {
+            bool matched_once = false;
+            ice::arctic::ParseState result_state = ParseState::Success;
+
+            bool matching = true;
+            for (ice::u32 rule_idx = 0; matching && rule_idx < group.count; ++rule_idx)
+            {
+                StaticTokenRule const& rule = group.rules[rule_idx];
+                ice::utf8 const* previous = token.value.data();
+
+                result_state = match(rule, idx, token);
+                while (result_state == ParseState::Success && rule.repeat)
+                {
+                    matched_once = true;
+                    previous = token.value.data();
+                    result_state = match(rule, idx, token);
+                }
+
+                matching &= (result_state == ParseState::Success) | ((rule.optional || matched_once) && previous == token.value.data());
+            }
+
+            return matching ? ParseState::Success : result_state;
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::match_first(
+            ice::arctic::detail::StaticTokenRule const& group,
+            ice::u32 idx,
+            ice::arctic::Token& token
+        ) noexcept -> ice::arctic::ParseState
+        {
+            ice::utf8 const* const previous = token.value.data();
+            ice::arctic::ParseState result_state = ParseState::Success;
+
+            bool matching = false;
+            for (ice::u32 rule_idx = 0; !matching && rule_idx < group.count && previous == token.value.data(); ++rule_idx)
+            {
+                StaticTokenRule const& rule = group.rules[rule_idx];
+
+                result_state = match(rule, idx, token);
+                while (result_state == ParseState::Success && rule.repeat)
+                {
+                    result_state = match(rule, idx, token);
+                }
+
+                matching |= (result_state == ParseState::Success);
+            }
+
+            return result_state;
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::match_as_node(
+            ice::arctic::detail::StaticTokenRule const& group,
+            ice::u32 idx,
+            ice::arctic::Token& token
+        ) noexcept -> ice::arctic::ParseState
+        {
+            bool matched_once = false;
+            ice::arctic::ParseState result_state = ParseState::Success;
+
+            ice::u32 created = create(group.entity);
+
+            bool matching = true;
+            for (ice::u32 rule_idx = 0; matching && rule_idx < group.count; ++rule_idx)
+            {
+                StaticTokenRule const& rule = group.rules[rule_idx];
+                ice::utf8 const* previous = token.value.data();
+
+                result_state = match(rule, created, token);
+                while (result_state == ParseState::Success && rule.repeat)
+                {
+                    matched_once = true;
+                    previous = token.value.data();
+                    result_state = match(rule, created, token);
+                }
+
+                matching &= (result_state == ParseState::Success) | ((rule.optional || matched_once) && previous == token.value.data());
+
+                if (matching == false)
+                {
+                    destroy(created);
+                    created = None;
+                }
+                else
+                {
+                    result_state = ParseState::Success;
+                }
+            }
+
+            if (group.kind == StaticRuleKind::MatchChild)
+            {
+                append_child(idx, created);
+            }
+            else
+            {
+                append_sibling_or_assign(node(idx).sibling, created);
+            }
+
+            return result_state;
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::match_subexpression(
+            ice::u32 idx,
+            ice::arctic::Token& token
+        ) noexcept -> ice::arctic::ParseState
+        {
+            if (_overflow)
+            {
+                return ParseState::Error_Limit_NodeCount;
+            }
+
+            ice::arctic::ParseState result = ParseState::Success;
+
+            if (token.type == TokenType::ST_EndOfLine)
+            {
+                return ParseState::Error;
+            }
+            else if (token.type == TokenType::CT_ParenOpen)
+            {
+                ice::u32 const sub_expression = create(SyntaxEntity::EXP_ExplicitScope);
+                token = next_token();
+
+                while (result == ParseState::Success && token.type != TokenType::CT_ParenClose)
+                {
+                    result = match_subexpression(sub_expression, token);
+                }
+
+                if (token.type != TokenType::CT_ParenClose)
+                {
+                    result = ParseState::Error_TypeOf_MissingBracketClose;
+                }
+                else
+                {
+                    result = ParseState::Success;
+                    token = next_token();
+                }
+
+                if (result == ParseState::Success)
+                {
+                    append_child(idx, sub_expression);
+
+                    if (token.type != TokenType::ST_EndOfLine)
+                    {
+                        result = match(static_rules::MatchPostBinary, sub_expression, token);
+                    }
+                }
+            }
+            else if (token.type == TokenType::CT_Symbol)
+            {
+                ice::arctic::Token const second = next_token();
+                if (second.type == TokenType::CT_ParenOpen)
+                {
+                    ice::u32 const call = create(SyntaxEntity::EXP_Call);
+                    node(call).tokens[0] = token;
+                    token = next_token();
+
+                    while (result == ParseState::Success && token.type != TokenType::CT_ParenClose)
+                    {
+                        ice::u32 const call_arg = create(SyntaxEntity::EXP_CallArg);
+
+                        while (result == ParseState::Success
+                            && token.type != TokenType::CT_Comma
+                            && token.type != TokenType::CT_ParenClose)
+                        {
+                            result = match_subexpression(call_arg, token);
+
+                            if (token.type == TokenType::ST_EndOfLine && _overflow == false)
+                            {
+                                token = next_token();
+                                result = ParseState::Success;
+                            }
+                        }
+
+                        append_child(call, call_arg);
+
+                        if (token.type == TokenType::CT_Comma && _overflow == false)
+                        {
+                            token = next_token();
+                            result = ParseState::Success;
+                        }
+                    }
+
+                    if (token.type != TokenType::CT_ParenClose)
+                    {
+                        result = ParseState::Error_TypeOf_MissingBracketClose;
+                    }
+
+                    token = next_token();
+
+                    if (result == ParseState::Success)
+                    {
+                        append_child(idx, call);
+                    }
+                }
+                else if (second.type == TokenType::CT_Dot)
+                {
+                    ice::u32 const value = create(SyntaxEntity::EXP_Value);
+                    node(value).tokens[0] = token;
+
+                    ice::u32 member = create(SyntaxEntity::EXP_GetMember);
+                    node(member).tokens[0] = next_token();
+                    node(value).child = member;
+                    token = next_token();
+
+                    while (token.type == TokenType::CT_Dot)
+                    {
+                        member = create(SyntaxEntity::EXP_GetMember);
+                        node(member).tokens[0] = next_token();
+
+                        append_sibling_or_assign(node(value).child, member);
+                        token = next_token();
+                    }
+
+                    append_child(idx, value);
+
+                    if (token.type != TokenType::ST_EndOfLine)
+                    {
+                        result = match(static_rules::MatchPostBinary, value, token);
+                    }
+                }
+                else
+                {
+                    ice::u32 const value = create(SyntaxEntity::EXP_Value);
+                    node(value).tokens[0] = token;
+                    token = second;
+
+                    if (token.type != TokenType::CT_ParenClose
+                        && token.type != TokenType::CT_Comma
+                        && token.type != TokenType::ST_EndOfLine)
+                    {
+                        result = match(static_rules::MatchPostBinary, value, token);
+                    }
+
+                    if (result == ParseState::Success)
+                    {
+                        append_child(idx, value);
+                    }
+                }
+            }
+            else if (token.type == TokenType::OP_Minus)
+            {
+                ice::u32 const unary = create(SyntaxEntity::EXP_UnaryOperation);
+                node(unary).tokens[0] = token;
+
+                token = next_token();
+                if (token.type == TokenType::CT_ParenOpen)
+                {
+                    ice::u32 const temp = create(SyntaxEntity::ROOT);
+                    result = match_subexpression(temp, token);
+
+                    // The runtime parser expects the scope to be always created here.
+                    if (node(temp).child == None)
+                    {
+                        return result == ParseState::Success ? ParseState::Error : result;
+                    }
+
+                    ice::u32 const temp_child = node(temp).child;
+                    node(unary).child = temp_child;
+                    node(unary).sibling = node(temp_child).sibling;
+                    node(temp_child).sibling = None;
+                }
+                else
+                {
+                    result = match(static_rules::MatchRecursive, unary, token);
+                }
+
+                if (result == ParseState::Success)
+                {
+                    append_child(idx, unary);
+                }
+            }
+            else
+            {
+                ice::u32 const temp = create(SyntaxEntity::ROOT);
+                result = match(static_rules::MatchBinaryAll, temp, token);
+
+                if (result == ParseState::Success)
+                {
+                    append_child(idx, node(temp).sibling);
+                }
+            }
+
+            return result;
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::parse_expression_block(ice::u32 parent) noexcept -> Result
+        {
+            ice::u32 child = None;
+            auto const append_block_child = [&](ice::u32 new_child) noexcept
+            {
+                if (child == None)
+                {
+                    node(parent).child = new_child;
+                }
+                else
+                {
+                    node(child).sibling = new_child;
+                }
+                child = new_child;
+            };
+
+            ice::arctic::Token token = next_token();
+
+            do
+            {
+                token = next_token();
+
+                switch (token.type)
+                {
+                case TokenType::KW_Let:
+                case TokenType::KW_Const:
+                {
+                    Result const var_result = parse_variable(SyntaxEntity::DEF_Variable, token);
+                    if (var_result.has_error())
+                    {
+                        return var_result;
+                    }
+
+                    append_block_child(var_result.node);
+                    break;
+                }
+                case TokenType::CT_Symbol:
+                {
+                    ice::u32 const temp = create(SyntaxEntity::ROOT);
+                    if (ParseState const expr_result = parse_expression(temp, token); expr_result != ParseState::Success)
+                    {
+                        return { expr_result };
+                    }
+
+                    ice::u32 const expression = create(SyntaxEntity::EXP_Expression);
+                    node(expression).child = node(temp).child;
+                    append_block_child(expression);
+                    break;
+                }
+                case TokenType::CT_BracketOpen:
+                {
+                    Result const result = parse_expression_block(create(SyntaxEntity::DEF_ExplicitScope));
+                    if (result.has_error())
+                    {
+                        return result;
+                    }
+
+                    append_block_child(result.node);
+                    break;
+                }
+                case TokenType::CT_BracketClose:
+                case TokenType::ST_EndOfLine:
+                    break;
+                case TokenType::ST_EndOfFile:
+                    return { ParseState::Error };
+                default:
+                    // Asserts in the runtime parser.
+                    return { ParseState::Error_UnexpectedToken };
+                }
+
+                if (_overflow)
+                {
+                    return { ParseState::Error_Limit_NodeCount };
+                }
+
+            } while (token.type != TokenType::CT_BracketClose);
+
+            return { ParseState::Success, parent };
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::parse_variable(
+            ice::arctic::SyntaxEntity entity,
+            ice::arctic::Token& token
+        ) noexcept -> Result
+        {
+            ice::u32 const variable = create(entity);
+            if (ParseState const result = match(static_rules::MatchVariable, variable, token); result != ParseState::Success)
+            {
+                return { result };
+            }
+
+            if (node(variable).is_const && token.type != TokenType::OP_Assign)
+            {
+                return { ParseState::Error_Definition_MissingAssignmentOperator };
+            }
+
+            if (token.type == TokenType::OP_Assign)
+            {
+                ice::arctic::Token const saved_token = token;
+                token = next_token();
+
+                ice::u32 const temp = create(SyntaxEntity::ROOT);
+                if (ParseState const expr_result = parse_expression(temp, token); expr_result != ParseState::Success)
+                {
+                    return { expr_result };
+                }
+
+                ice::u32 const operation = create(SyntaxEntity::EXP_BinaryOperation);
+                node(operation).tokens[0] = saved_token;
+                node(operation).sibling = node(temp).child;
+
+                ice::u32 const expression = create(SyntaxEntity::EXP_Expression);
+                node(expression).child = operation;
+
+                append_child(variable, expression);
+            }
+
+            return { ParseState::Success, variable };
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::parse_function() noexcept -> Result
+        {
+            ice::u32 const function = create(SyntaxEntity::DEF_Function);
+
+            ice::arctic::Token token = next_token();
+            if (ParseState const result = match(static_rules::MatchFunction, function, token); result != ParseState::Success)
+            {
+                return { result };
+            }
+
+            if (token.type != TokenType::CT_BracketOpen)
+            {
+                return { ParseState::Error_UnexpectedToken };
+            }
+
+            return { ParseState::Success, function };
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::parse_type_definition() noexcept -> Result
+        {
+            ice::u32 const temp = create(SyntaxEntity::ROOT);
+            ice::arctic::Token token = next_token();
+
+            Result result{ match(static_rules::MatchDefinition, temp, token) };
+            if (result.has_error() == false)
+            {
+                if (token.type == TokenType::KW_Struct)
+                {
+                    ice::u32 const definition = create(SyntaxEntity::DEF_Struct);
+                    node(definition).tokens[0] = node(temp).tokens[0];
+
+                    result = { match(static_rules::MatchStruct, definition, token), definition };
+                }
+                else if (token.type == TokenType::KW_TypeOf || token.type == TokenType::KW_Alias)
+                {
+                    ice::u32 const definition = create(SyntaxEntity::DEF_TypeDef);
+                    node(definition).tokens[0] = node(temp).tokens[0];
+
+                    result = { match(static_rules::MatchTypeOf, definition, token), definition };
+                }
+                else
+                {
+                    result = { ParseState::Error_Definition_UnknownToken };
+                }
+            }
+            return result;
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::parse_annotation(ice::arctic::Token& token) noexcept -> Result
+        {
+            ice::u32 const annotation = create(SyntaxEntity::DEF_Annotation);
+            if (ParseState const result = match(static_rules::MatchAnnotation, annotation, token); result != ParseState::Success)
+            {
+                return { result };
+            }
+            return { ParseState::Success, annotation };
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::parse_definition(ice::arctic::Token& token) noexcept -> Result
+        {
+            switch (token.type)
+            {
+            case TokenType::KW_Fn:
+            {
+                Result result = parse_function();
+                if (result.has_error() == false)
+                {
+                    Result const body_result = parse_expression_block(create(SyntaxEntity::DEF_FunctionBody));
+                    if (body_result.has_error())
+                    {
+                        return body_result;
+                    }
+
+                    node(result.node).sibling = body_result.node;
+                }
+                return result;
+            }
+            case TokenType::KW_Def:
+                return parse_type_definition();
+            case TokenType::KW_Let:
+            case TokenType::KW_Const:
+                return parse_variable(SyntaxEntity::DEF_Variable, token);
+            case TokenType::CT_SquareBracketOpen:
+                return parse_annotation(token);
+            default:
+                return { ParseState::Error_Definition_UnknownToken };
+            }
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::parse_context_definition(ice::arctic::Token& token) noexcept -> Result
+        {
+            switch (token.type)
+            {
+            case TokenType::KW_Fn:
+                return parse_function();
+            case TokenType::KW_Let:
+                return parse_variable(SyntaxEntity::DEF_ContextVariable, token);
+            case TokenType::CT_SquareBracketOpen:
+                return parse_annotation(token);
+            default:
+                return { ParseState::Error_Definition_UnknownToken };
+            }
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::parse_block(ice::arctic::Token& token) noexcept -> ice::arctic::ParseState
+        {
+            token = (next_token(), next_token());
+            if (token.type != TokenType::CT_BracketOpen)
+            {
+                return ParseState::Error_TypeOf_MissingBracketOpen;
+            }
+
+            ice::u32 annotation = None;
+
+            token = next_token();
+            while (token.type != TokenType::CT_BracketClose)
+            {
+                if (token.type == TokenType::ST_EndOfFile)
+                {
+                    return ParseState::Error_TypeOf_MissingBracketClose;
+                }
+
+                Result result{ ParseState::Success };
+                if (token.type != TokenType::ST_EndOfLine)
+                {
+                    result = parse_context_definition(token);
+                }
+
+                if (result.has_error())
+                {
+                    return result.state;
+                }
+
+                if (result.node != None)
+                {
+                    if (node(result.node).entity == SyntaxEntity::DEF_Annotation)
+                    {
+                        append_sibling_or_assign(annotation, result.node);
+                    }
+                    else
+                    {
+                        node(result.node).annotation = annotation;
+                        annotation = None;
+                    }
+
+                    on_definition(result.node);
+                }
+
+                token = next_token();
+            }
+
+            return ParseState::Success;
+        }
+
+        template<ice::u32 Capacity>
+        constexpr auto StaticParser<Capacity>::parse() noexcept -> ice::arctic::ParseState
+        {
+            ice::arctic::Token token = next_token();
+            if (_lexer.valid() == false)
+            {
+                _image.state = ParseState::Error;
+                _image.error_token = _current;
+                return _image.state;
+            }
+
+            Result result{ ParseState::Success };
+            ice::u32 annotation = None;
+            while (result.has_error() == false && token.type != TokenType::ST_EndOfFile)
+            {
+                switch (token.type)
+                {
+                case TokenType::KW_Fn:
+                case TokenType::KW_Def:
+                case TokenType::KW_Let:
+                case TokenType::KW_Const:
+                    result = parse_definition(token);
+                    if (result.has_error() == false)
+                    {
+                        node(result.node).annotation = annotation;
+                        annotation = None;
+                    }
+                    break;
+                case TokenType::KW_Ctx:
+                    result = { parse_block(token) };
+                    break;
+                case TokenType::CT_SquareBracketOpen:
+                    result = parse_definition(token);
+                    if (result.has_error() == false)
+                    {
+                        append_sibling_or_assign(annotation, result.node);
+                    }
+                    break;
+                case TokenType::KW_Import:
+                    // Imports are resolved by modules, there is nothing to load them from in a constant evaluation.
+                    result = { ParseState::Error_Import_NotFound };
+                    break;
+                case TokenType::ST_EndOfLine:
+                    token = next_token();
+                    continue;
+                default:
+                    // Stray tokens are skipped, same as in the runtime parser.
+                    result = { ParseState::Success };
+                    break;
+                }
+
+                if (_overflow)
+                {
+                    result = { ParseState::Error_Limit_NodeCount };
+                }
+
+                if (result.has_error())
+                {
+                    break;
+                }
+
+                if (result.node != None)
+                {
+                    on_definition(result.node);
+                }
+
+                token = next_token();
+            }
+
+            _image.state = result.state;
+            if (result.has_error())
+            {
+                _image.error_token = _current;
+            }
+            return _image.state;
+        }
+
+    } // namespace detail
+
+    //! \brief Parses the given source in a constant evaluation, the returned image holds the parse state instead of failing.
+    //! \note Use 'ice::arctic::compile' to get syntax errors reported as compilation errors.
+    template<ice::u32 Capacity = 512>
+    constexpr auto static_parse(
+        ice::String source,
+        ice::arctic::LexerOptions options = { }
+    ) noexcept -> ice::arctic::StaticSyntaxImage<Capacity>
+    {
+        ice::arctic::StaticSyntaxImage<Capacity> result{ };
+        ice::arctic::StaticLexer lexer{ source, options };
+        ice::arctic::detail::StaticParser<Capacity> parser{ lexer, result };
+        parser.parse();
+        return result;
+    }
+
+} // namespace ice::arctic
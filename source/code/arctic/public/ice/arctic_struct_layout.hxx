@@ -0,0 +1,109 @@
+#pragma once
+#include <ice/arctic_semantic.hxx>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    enum class LayoutRules : ice::u8
+    {
+        //! \brief Natural C++ layout, vectors and matrices are arrays of their scalars.
+        Host,
+
+        //! \brief GLSL uniform blocks, arrays of matrix columns and structs are aligned to 16 bytes.
+        Std140,
+
+        //! \brief GLSL storage blocks, like 'Std140' without rounding matrix columns and structs to 16 bytes.
+        Std430,
+
+        //! \brief HLSL constant buffers, values can't cross 16 byte registers and matrix columns start a new register.
+        HlslCBuffer,
+    };
+
+    struct TypeLayout
+    {
+        ice::u32 size;
+        ice::u32 alignment;
+    };
+
+    struct MemberLayout
+    {
+        ice::arctic::TypeMember const* member;
+        ice::u32 offset;
+        ice::arctic::TypeLayout layout;
+
+        //! \brief Distance between matrix columns, '0' for other types.
+        ice::u32 column_stride;
+    };
+
+    struct StructLayout
+    {
+        ice::arctic::TypeHandle type;
+        ice::arctic::LayoutRules rules;
+        ice::arctic::TypeLayout layout;
+        ice::Span<ice::arctic::MemberLayout const> members;
+    };
+
+    //! \brief Computes the memory layout of resolved types under a single set of rules.
+    //!
+    //! \details Matrices are stored column-major in all rules, as an array of column vectors. Booleans are 4 bytes wide
+    //!   in all GPU rules. Layouts are computed once per type and kept for the lifetime of the table.
+    class StructLayoutTable
+    {
+    public:
+        explicit StructLayoutTable(ice::arctic::LayoutRules rules) noexcept;
+
+        StructLayoutTable(StructLayoutTable const&) noexcept = delete;
+        auto operator=(StructLayoutTable const&) noexcept -> StructLayoutTable& = delete;
+
+        auto rules() const noexcept -> ice::arctic::LayoutRules { return _rules; }
+
+        //! \returns The size and alignment of a value of the type, both are '0' for types without a memory layout,
+        //!   like 'void', stages or structs with unresolved members.
+        auto type_layout(ice::arctic::TypeHandle type) noexcept -> ice::arctic::TypeLayout;
+
+        //! \returns The layout of a struct type and its members, or 'nullptr' for other types.
+        auto struct_layout(ice::arctic::TypeHandle type) noexcept -> ice::arctic::StructLayout const*;
+
+        //! \returns The distance between columns of a matrix type, '0' for other types.
+        auto column_stride(ice::arctic::TypeHandle type) const noexcept -> ice::u32;
+
+        //! \returns The size of a single scalar, '0' for 'void'.
+        auto scalar_size(ice::arctic::TokenType scalar) const noexcept -> ice::u32;
+
+    private:
+        auto vector_layout(ice::arctic::TokenType scalar, ice::u32 size) const noexcept -> ice::arctic::TypeLayout;
+
+        //! \returns The offset of a member placed at or after the given offset.
+        auto place(ice::u32 offset, ice::arctic::TypeHandle type, ice::arctic::TypeLayout layout) const noexcept -> ice::u32;
+
+    private:
+        ice::arctic::LayoutRules const _rules;
+
+        std::deque<ice::arctic::StructLayout> _structs;
+        std::deque<std::vector<ice::arctic::MemberLayout>> _members;
+        std::unordered_map<ice::arctic::TypeHandle, ice::arctic::StructLayout const*> _layouts;
+
+        //! \brief Structs currently being laid out, recursive structs are reported by the semantic model and have no layout.
+        std::vector<ice::arctic::TypeHandle> _visiting;
+    };
+
+    //! \returns The suffix appended to names of generated structs, empty for 'Host'.
+    auto layout_rules_suffix(ice::arctic::LayoutRules rules) noexcept -> ice::String;
+
+    //! \brief Appends C++ definitions of the given structs and all structs used by their members to 'out'.
+    //!
+    //! \details Padding between members is written explicitly and every offset, the size and the alignment are checked
+    //!   with 'static_assert', so host data can be copied into buffers using the same rules without conversions.
+    //!   Vectors and matrices are written as arrays of their scalars, matrices as a flat array including column padding.
+    //!   Structs without a layout are skipped.
+    void write_layout_header(
+        ice::arctic::StructLayoutTable& table,
+        ice::Span<ice::arctic::TypeHandle const> types,
+        std::u8string& out
+    ) noexcept;
+
+} // namespace ice::arctic
@@ -0,0 +1,132 @@
+#pragma once
+#include <ice/arctic_semantic.hxx>
+#include <ice/arctic_operand_list.hxx>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    //! \brief Replaces repeated subexpressions of function bodies with a single local variable.
+    //!
+    //! \details Terms of operand lists are value numbered on their kind, operation token and the value numbers of their
+    //!   operands. Reads of variables are numbered per assignment, so two terms only share a number if none of the
+    //!   variables they read was assigned in between. Calls of functions are never shared and all reads of global and
+    //!   context variables after a call get new numbers, as the function can write them.
+    //!
+    //!   Each repeated term becomes the initializer of a new variable, declared before the statement of its first
+    //!   occurrence, and all occurrences are replaced by a reference to it. If the first occurrence is already the
+    //!   whole initializer of a local that is not assigned before the last occurrence, the local is referenced instead.
+    //!   Only terms with an operation, a constructor call or a member access are shared, single values are cheaper to read.
+    //!
+    //! \note Blocks are handled separately, terms are only shared between statements of the same block.
+    //!   The syntax tree is modified in place, new nodes are created with the given allocator and names of new variables
+    //!   are owned by the eliminator.
+    class SubexpressionEliminator
+    {
+    public:
+        SubexpressionEliminator(
+            ice::arctic::SyntaxNodeAllocator& alloc,
+            ice::arctic::SemanticModel& model
+        ) noexcept;
+
+        SubexpressionEliminator(SubexpressionEliminator const&) noexcept = delete;
+        auto operator=(SubexpressionEliminator const&) noexcept -> SubexpressionEliminator& = delete;
+
+        //! \brief Eliminates repeated subexpressions of all function bodies, definitions need to be resolved by the model.
+        //! \returns The number of created variables.
+        auto eliminate(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept -> ice::u32;
+
+        //! \returns The number of subexpressions replaced by a reference, including the moved first occurrences.
+        auto replaced_count() const noexcept -> ice::u32 { return _replaced_count; }
+
+    private:
+        struct NumberedList
+        {
+            ice::arctic::OperandList list;
+            ice::u32 statement;
+        };
+
+        struct Occurrence
+        {
+            ice::u32 list;
+            ice::u32 term;
+            ice::u32 size;
+            ice::arctic::TypeHandle type;
+
+            //! \brief Set if the term is the whole initializer of a local variable.
+            ice::arctic::SyntaxNode_Variable const* holder;
+
+            //! \brief Set if the holder of the first occurrence was not assigned before this occurrence.
+            bool holder_valid;
+        };
+
+        struct Reference
+        {
+            ice::arctic::SyntaxNode const* definition;
+            ice::arctic::TypeHandle type;
+        };
+
+        void eliminate_block(ice::arctic::SyntaxNode* block) noexcept;
+        bool eliminate_once(ice::arctic::SyntaxNode* block) noexcept;
+
+        //! \param holder The local variable initialized with the list, if any.
+        auto number_list(
+            ice::arctic::SyntaxNode* parent,
+            ice::u32 statement,
+            ice::arctic::SyntaxNode_Variable const* holder = nullptr
+        ) noexcept -> ice::u32;
+        auto number_operand(ice::arctic::SyntaxNode* node, ice::u32 statement) noexcept -> ice::u32;
+        auto number_symbol(ice::arctic::SyntaxNode const* node) noexcept -> ice::u32;
+        auto number_key(std::string const& key) noexcept -> ice::u32;
+        auto number_unique() noexcept -> ice::u32;
+
+        auto operand_type(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::TypeHandle;
+        auto definition_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::SyntaxNode const*;
+
+        void rewrite(std::vector<Occurrence> const& occurrences, std::vector<ice::arctic::SyntaxNode**> const& statements) noexcept;
+
+        auto create_reference(
+            ice::arctic::SyntaxNode const* definition,
+            ice::String name,
+            ice::arctic::TypeHandle type,
+            ice::arctic::TokenLocation location
+        ) noexcept -> ice::arctic::SyntaxNode*;
+
+        auto create_variable(
+            ice::arctic::SyntaxNode* initializer,
+            ice::arctic::TypeHandle type,
+            ice::arctic::TokenLocation location
+        ) noexcept -> ice::arctic::SyntaxNode_Variable*;
+
+        void release(ice::arctic::SyntaxNode* node, bool with_children) noexcept;
+
+    private:
+        ice::arctic::SyntaxNodeAllocator& _alloc;
+        ice::arctic::SemanticModel& _model;
+
+        std::unordered_set<ice::arctic::SyntaxNode const*> _globals;
+        std::unordered_set<ice::String> _local_names;
+        std::deque<std::u8string> _names;
+
+        //! \brief References created by the eliminator, these are not known to the semantic model.
+        std::unordered_map<ice::arctic::SyntaxNode const*, Reference> _references;
+
+        // State of the block currently numbered.
+        std::deque<NumberedList> _lists;
+        std::unordered_map<std::string, ice::u32> _keys;
+        std::unordered_map<ice::u32, std::vector<Occurrence>> _occurrences;
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::u32> _versions;
+        ice::u32 _next_value = 0;
+        ice::u32 _call_epoch = 0;
+        bool _opaque_globals = false;
+
+        ice::u32 _name_index = 0;
+        ice::u32 _variable_count = 0;
+        ice::u32 _replaced_count = 0;
+    };
+
+} // namespace ice::arctic
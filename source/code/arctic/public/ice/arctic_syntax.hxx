@@ -35,6 +35,8 @@ namespace ice::arctic
         EXP_Loop,
     };
 
+    static constexpr ice::u32 Constant_SyntaxEntityCount = static_cast<ice::u32>(SyntaxEntity::EXP_Loop) + 1;
+
     constexpr auto to_string(ice::arctic::SyntaxEntity entity) noexcept
     {
         switch (entity)
@@ -53,6 +55,7 @@ namespace ice::arctic
         case SyntaxEntity::DEF_AnnotationAttribute: return "DEF_AnnotationAttribute";
 
         case SyntaxEntity::EXP_Value: return "EXP_Value";
+        case SyntaxEntity::EXP_GetMember: return "EXP_GetMember";
         case SyntaxEntity::EXP_Call: return "EXP_Call";
         case SyntaxEntity::EXP_CallArg: return "EXP_CallArg";
         case SyntaxEntity::EXP_Variable: return "EXP_Variable";
@@ -0,0 +1,69 @@
+#pragma once
+#include <ice/arctic_syntax_node.hxx>
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    //! \brief Hashes the contents of a script, used to key cached syntax trees.
+    auto hash_source(ice::String source) noexcept -> ice::u64;
+
+    //! \brief Writes the given top-level nodes, their children and token values into a single position-independent blob.
+    //! \note Node and string references are stored as offsets from the start of the blob.
+    void serialize_syntax_tree(
+        ice::Span<ice::arctic::SyntaxNode const* const> definitions,
+        ice::u64 source_hash,
+        std::vector<ice::u64>& out_blob
+    ) noexcept;
+
+    //! \brief A syntax tree loaded from a serialized blob, owns the memory of all nodes and token values.
+    class SyntaxTreeImage
+    {
+    public:
+        SyntaxTreeImage() noexcept = default;
+
+        //! \brief Takes ownership of the blob and relocates all offsets to pointers in a single pass.
+        //! \returns An empty image if the blob is invalid or was created for a different source, nothing outside of the blob is read.
+        static auto load(
+            std::unique_ptr<ice::u64[]> blob,
+            ice::u64 blob_size,
+            ice::u64 expected_hash
+        ) noexcept -> ice::arctic::SyntaxTreeImage;
+
+        bool valid() const noexcept { return _blob != nullptr; }
+
+        //! \brief The loaded top-level nodes, can be passed to 'visit_definitions'.
+        auto definitions() const noexcept -> ice::Span<ice::arctic::SyntaxNode const* const>
+        {
+            return _definitions;
+        }
+
+    private:
+        std::unique_ptr<ice::u64[]> _blob;
+        ice::Span<ice::arctic::SyntaxNode const* const> _definitions;
+    };
+
+    //! \brief Stores and loads serialized syntax trees in a directory, keyed by the hash of the source they where parsed from.
+    class SyntaxTreeCache
+    {
+    public:
+        explicit SyntaxTreeCache(std::filesystem::path directory) noexcept;
+
+        bool store(
+            ice::String source,
+            ice::Span<ice::arctic::SyntaxNode const* const> definitions
+        ) const noexcept;
+
+        auto load(ice::String source) const noexcept -> ice::arctic::SyntaxTreeImage;
+
+    private:
+        auto entry_path(ice::u64 source_hash) const noexcept -> std::filesystem::path;
+
+    private:
+        std::filesystem::path _directory;
+    };
+
+} // namespace ice::arctic
@@ -0,0 +1,32 @@
+#pragma once
+#include <ice/arctic_syntax_node.hxx>
+#include <unordered_map>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    //! \brief Structural hashes of syntax subtrees, built from entities, token values and the hashes of all child nodes.
+    //!
+    //! \details Token locations are ignored, so identical definitions have the same hash across scripts and edits.
+    //!   Annotations are separate definitions and are hashed on their own.
+    class SyntaxTreeHashes
+    {
+    public:
+        //! \brief Hashes the definition and every node owned by it.
+        //! \returns The hash of the whole definition.
+        auto add_definition(ice::arctic::SyntaxNode const* definition) noexcept -> ice::u64;
+
+        //! \returns The hash of the subtree starting at the node, or '0' if the node was not hashed.
+        auto hash(ice::arctic::SyntaxNode const* node) const noexcept -> ice::u64;
+
+        void clear() noexcept;
+
+    private:
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::u64> _hashes;
+    };
+
+    //! \brief Hashes a single subtree without keeping the hashes of the nodes in it.
+    auto hash_syntax_tree(ice::arctic::SyntaxNode const* node) noexcept -> ice::u64;
+
+} // namespace ice::arctic
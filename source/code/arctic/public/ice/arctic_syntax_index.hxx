@@ -0,0 +1,39 @@
+#pragma once
+#include <ice/arctic_syntax_node.hxx>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    //! \brief Nodes of parsed definitions grouped by their entity, each group is kept in source order.
+    //!
+    //! \details Allows passes interested in a single kind of node to iterate only the matching nodes.
+    //!   Annotations are separate definitions, so their nodes are added when the annotation is added.
+    class SyntaxNodeIndex
+    {
+    public:
+        //! \brief Adds the definition and all nodes owned by it.
+        void add_definition(ice::arctic::SyntaxNode const* definition) noexcept;
+
+        void clear() noexcept;
+
+        auto nodes(ice::arctic::SyntaxEntity entity) const noexcept -> ice::Span<ice::arctic::SyntaxNode const* const>
+        {
+            return _nodes[static_cast<ice::u32>(entity)];
+        }
+
+        //! \returns All indexed nodes of the given node type.
+        template<typename NodeType>
+        auto nodes() const noexcept -> ice::Span<NodeType const* const>
+        {
+            ice::Span<ice::arctic::SyntaxNode const* const> const result = nodes(NodeType::RepresentedSyntaxEntity);
+
+            // The node types only add members after the 'SyntaxNode' base, so the pointers are the same.
+            return { reinterpret_cast<NodeType const* const*>(result.data()), result.size() };
+        }
+
+    private:
+        std::vector<ice::arctic::SyntaxNode const*> _nodes[ice::arctic::Constant_SyntaxEntityCount];
+    };
+
+} // namespace ice::arctic
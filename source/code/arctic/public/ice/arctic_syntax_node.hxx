@@ -1,6 +1,9 @@
 #pragma once
 #include <ice/arctic_syntax.hxx>
 #include <ice/arctic_token.hxx>
+#include <ice/arctic_parser_profiler.hxx>
+#include <ice/arctic_memory_stats.hxx>
+#include <type_traits>
 
 namespace ice::arctic
 {
@@ -23,6 +26,9 @@ namespace ice::arctic
 
         ice::arctic::Token name;
         ice::arctic::Token type;
+
+        //! \brief Set for 'const' definitions, their initializer is required and evaluated at compile time.
+        bool is_const;
     };
 
     struct SyntaxNode_ContextVariable : SyntaxNode
@@ -156,6 +162,107 @@ namespace ice::arctic
         static constexpr ice::arctic::SyntaxEntity RepresentedSyntaxEntity = SyntaxEntity::EXP_Assignment;
     };
 
+    namespace detail
+    {
+
+        template<typename NodeType, typename Node>
+        using SyntaxNodeCast = std::conditional_t<std::is_const_v<Node>, NodeType const, NodeType>*;
+
+    } // namespace detail
+
+    //! \brief Calls 'fn' with the node cast to the type representing its entity.
+    //! \note Entities without a dedicated node type are passed as a plain 'SyntaxNode'.
+    template<typename Node, typename Fn>
+    constexpr auto dispatch_syntax_node(Node* node, Fn&& fn) noexcept
+    {
+        using namespace ice::arctic::detail;
+
+        switch (node->entity)
+        {
+        case SyntaxEntity::DEF_TypeDef: return fn(static_cast<SyntaxNodeCast<SyntaxNode_TypeDef, Node>>(node));
+        case SyntaxEntity::DEF_Struct: return fn(static_cast<SyntaxNodeCast<SyntaxNode_Struct, Node>>(node));
+        case SyntaxEntity::DEF_StructMember: return fn(static_cast<SyntaxNodeCast<SyntaxNode_StructMember, Node>>(node));
+        case SyntaxEntity::DEF_Variable: return fn(static_cast<SyntaxNodeCast<SyntaxNode_Variable, Node>>(node));
+        case SyntaxEntity::DEF_ContextVariable: return fn(static_cast<SyntaxNodeCast<SyntaxNode_ContextVariable, Node>>(node));
+        case SyntaxEntity::DEF_Function: return fn(static_cast<SyntaxNodeCast<SyntaxNode_Function, Node>>(node));
+        case SyntaxEntity::DEF_FunctionArgument: return fn(static_cast<SyntaxNodeCast<SyntaxNode_FunctionArgument, Node>>(node));
+        case SyntaxEntity::DEF_FunctionBody: return fn(static_cast<SyntaxNodeCast<SyntaxNode_FunctionBody, Node>>(node));
+        case SyntaxEntity::DEF_ExplicitScope: return fn(static_cast<SyntaxNodeCast<SyntaxNode_Scope, Node>>(node));
+        case SyntaxEntity::DEF_Annotation: return fn(static_cast<SyntaxNodeCast<SyntaxNode_Annotation, Node>>(node));
+        case SyntaxEntity::DEF_AnnotationAttribute: return fn(static_cast<SyntaxNodeCast<SyntaxNode_AnnotationAttribute, Node>>(node));
+        case SyntaxEntity::EXP_Value: return fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionValue, Node>>(node));
+        case SyntaxEntity::EXP_GetMember: return fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionGetMember, Node>>(node));
+        case SyntaxEntity::EXP_Call: return fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionCall, Node>>(node));
+        case SyntaxEntity::EXP_CallArg: return fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionCallArg, Node>>(node));
+        case SyntaxEntity::EXP_Assignment: return fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionAssignment, Node>>(node));
+        case SyntaxEntity::EXP_Expression: return fn(static_cast<SyntaxNodeCast<SyntaxNode_Expression, Node>>(node));
+        case SyntaxEntity::EXP_UnaryOperation: return fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionUnaryOperation, Node>>(node));
+        case SyntaxEntity::EXP_BinaryOperation: return fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionBinaryOperation, Node>>(node));
+        case SyntaxEntity::EXP_ExplicitScope: return fn(static_cast<SyntaxNodeCast<SyntaxNode_ExplicitScope, Node>>(node));
+        case SyntaxEntity::EXP_Branch: return fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionBranch, Node>>(node));
+        default: return fn(node);
+        }
+    }
+
+    //! \brief Calls 'fn' for each token stored in the given node, in declaration order.
+    template<typename Node, typename Fn>
+    constexpr void for_each_syntax_token(Node* node, Fn&& fn) noexcept
+    {
+        using namespace ice::arctic::detail;
+
+        switch (node->entity)
+        {
+        case SyntaxEntity::DEF_TypeDef:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_TypeDef, Node>>(node)->name);
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_TypeDef, Node>>(node)->base_type);
+            break;
+        case SyntaxEntity::DEF_Struct:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_Struct, Node>>(node)->name);
+            break;
+        case SyntaxEntity::DEF_StructMember:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_StructMember, Node>>(node)->name);
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_StructMember, Node>>(node)->type);
+            break;
+        case SyntaxEntity::DEF_Variable:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_Variable, Node>>(node)->name);
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_Variable, Node>>(node)->type);
+            break;
+        case SyntaxEntity::DEF_ContextVariable:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_ContextVariable, Node>>(node)->name);
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_ContextVariable, Node>>(node)->type);
+            break;
+        case SyntaxEntity::DEF_Function:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_Function, Node>>(node)->name);
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_Function, Node>>(node)->result_type);
+            break;
+        case SyntaxEntity::DEF_FunctionArgument:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_FunctionArgument, Node>>(node)->name);
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_FunctionArgument, Node>>(node)->type);
+            break;
+        case SyntaxEntity::DEF_AnnotationAttribute:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_AnnotationAttribute, Node>>(node)->name);
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_AnnotationAttribute, Node>>(node)->value);
+            break;
+        case SyntaxEntity::EXP_Value:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionValue, Node>>(node)->value);
+            break;
+        case SyntaxEntity::EXP_GetMember:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionGetMember, Node>>(node)->member);
+            break;
+        case SyntaxEntity::EXP_Call:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionCall, Node>>(node)->function);
+            break;
+        case SyntaxEntity::EXP_UnaryOperation:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionUnaryOperation, Node>>(node)->operation);
+            break;
+        case SyntaxEntity::EXP_BinaryOperation:
+            fn(static_cast<SyntaxNodeCast<SyntaxNode_ExpressionBinaryOperation, Node>>(node)->operation);
+            break;
+        default:
+            break;
+        }
+    }
+
     struct SyntaxNodeAllocator
     {
         virtual ~SyntaxNodeAllocator() noexcept = default;
@@ -168,12 +275,24 @@ namespace ice::arctic
         {
             T* result = new (allocate(sizeof(T), alignof(T))) T{ std::forward<Args>(args)... };
             result->entity = T::RepresentedSyntaxEntity;
+            ice::arctic::detail::track_node_allocation(T::RepresentedSyntaxEntity, sizeof(T));
+#if ICE_ARCTIC_PARSER_PROFILING
+            ice::arctic::detail::profile_node_allocated();
+#endif
             return result;
         }
 
         template<typename T>
         void destroy(T* ptr) noexcept
         {
+            if (ptr != nullptr)
+            {
+                // Nodes are often destroyed through a base pointer, so the size is taken from the entity.
+                ice::arctic::detail::track_node_deallocation(ptr);
+#if ICE_ARCTIC_PARSER_PROFILING
+                ice::arctic::detail::profile_node_destroyed();
+#endif
+            }
             ptr->~T();
             deallocate(ptr);
         }
@@ -1,15 +1,62 @@
 #pragma once
 #include <ice/arctic_syntax_node.hxx>
+#include <array>
 #include <utility>
 
 namespace ice::arctic
 {
 
+    //! \brief A set of syntax entities, each entity is represented by the bit at its index.
+    using SyntaxEntityMask = ice::u64;
+
+    static_assert(ice::arctic::Constant_SyntaxEntityCount <= 64, "Syntax entities no longer fit into the entity mask.");
+
+    static constexpr ice::arctic::SyntaxEntityMask Constant_SyntaxEntityMask_All = ~ice::arctic::SyntaxEntityMask{ 0 };
+
+    constexpr auto syntax_entity_mask(ice::arctic::SyntaxEntity entity) noexcept -> ice::arctic::SyntaxEntityMask
+    {
+        return ice::arctic::SyntaxEntityMask{ 1 } << static_cast<ice::u32>(entity);
+    }
+
     struct SyntaxVisitorBase
     {
+        explicit SyntaxVisitorBase(
+            ice::arctic::SyntaxEntityMask entity_mask = Constant_SyntaxEntityMask_All
+        ) noexcept
+            : entity_mask{ entity_mask }
+        {
+        }
+
         virtual ~SyntaxVisitorBase() noexcept = default;
 
+        //! \brief Checked before each call to 'visit', 'visit_removed' and 'visit_changed' to skip nodes the visitor doesn't handle.
+        bool accepts(ice::arctic::SyntaxEntity entity) const noexcept
+        {
+            return (entity_mask & ice::arctic::syntax_entity_mask(entity)) != 0;
+        }
+
         virtual void visit(ice::arctic::SyntaxNode const* node) noexcept = 0;
+
+        //! \brief Called by 'Parser::reparse' for a top-level node that was removed by an edit.
+        //! \note The node is released after all visitors where notified.
+        virtual void visit_removed(ice::arctic::SyntaxNode const* /*node*/) noexcept { }
+
+        //! \brief Called by 'Parser::reparse' when a top-level node was replaced by a node with the same entity and name.
+        virtual void visit_changed(
+            ice::arctic::SyntaxNode const* /*previous_node*/,
+            ice::arctic::SyntaxNode const* node
+        ) noexcept
+        {
+            visit(node);
+        }
+
+        //! \brief Called by 'visit_definitions_parallel' after all visitors are finished, one visitor at a time.
+        //! \note Visitors are merged on the calling thread in the order they where given, so results can be
+        //!   published into shared state without synchronization and in a deterministic order.
+        virtual void merge_results() noexcept { }
+
+        //! \brief Entities of the top-level nodes this visitor is called for.
+        ice::arctic::SyntaxEntityMask entity_mask;
     };
 
     template<typename NodeType>
@@ -20,9 +67,20 @@ namespace ice::arctic
         virtual void visit(NodeType const* node) noexcept = 0;
     };
 
+    //! \brief Dispatches top-level nodes to the 'visit' overload of the matching node type.
+    //! \note Only nodes of the listed types are passed to the group, which also excludes the 'ROOT' node.
     template<typename... NodeTypes>
     struct SyntaxVisitorGroup : SyntaxVisitorBase, SyntaxVisitor<NodeTypes>...
     {
+        static constexpr ice::arctic::SyntaxEntityMask EntityMask = (
+            ice::arctic::syntax_entity_mask(NodeTypes::RepresentedSyntaxEntity) | ...
+        );
+
+        SyntaxVisitorGroup() noexcept
+            : SyntaxVisitorBase{ EntityMask }
+        {
+        }
+
         virtual ~SyntaxVisitorGroup() noexcept = default;
 
         template<typename NodeType>
@@ -43,22 +101,59 @@ namespace ice::arctic
                 ice::arctic::SyntaxVisitorGroup<NodeTypes...>*
             ) noexcept;
 
-            static ice::arctic::SyntaxEntity const group_entities[]{
-                NodeTypes::RepresentedSyntaxEntity...
-            };
+            // Indexed directly by the entity, entities not handled by the group have no function.
+            static constexpr std::array<VisitFn*, Constant_SyntaxEntityCount> group_funcs = []() noexcept
+                {
+                    std::array<VisitFn*, Constant_SyntaxEntityCount> result{ };
+                    ((result[static_cast<ice::u32>(NodeTypes::RepresentedSyntaxEntity)] = &visit_fn<NodeTypes>), ...);
+                    return result;
+                }();
+
+            ice::u32 const entity_idx = static_cast<ice::u32>(node->entity);
+            if (entity_idx < Constant_SyntaxEntityCount && group_funcs[entity_idx] != nullptr)
+            {
+                group_funcs[entity_idx](node, this);
+            }
+        }
+    };
 
-            static VisitFn* const group_funcs[]{
-                &visit_fn<NodeTypes>...
-            };
+    //! \brief Visits a list of top-level nodes the same way 'Parser::parse' does, starting with a 'ROOT' node.
+    //! \note Allows to run visitors over an already parsed or loaded syntax tree.
+    inline void visit_definitions(
+        ice::Span<ice::arctic::SyntaxNode const* const> definitions,
+        ice::Span<ice::arctic::SyntaxVisitorBase* const> visitors
+    ) noexcept
+    {
+        ice::arctic::SyntaxNode const root{ .entity = SyntaxEntity::ROOT };
+        for (ice::arctic::SyntaxVisitorBase* visitor : visitors)
+        {
+            if (visitor->accepts(SyntaxEntity::ROOT))
+            {
+                visitor->visit(&root);
+            }
+        }
 
-            for (ice::u32 idx = 0; idx < sizeof...(NodeTypes); ++idx)
+        for (ice::arctic::SyntaxNode const* node : definitions)
+        {
+            for (ice::arctic::SyntaxVisitorBase* visitor : visitors)
             {
-                if (group_entities[idx] == node->entity)
+                if (visitor->accepts(node->entity))
                 {
-                    group_funcs[idx](node, this);
+                    visitor->visit(node);
                 }
             }
         }
-    };
+    }
+
+    //! \brief Runs each visitor over all given nodes on its own worker, using up to 'jobs' threads.
+    //!
+    //! \details Each visitor sees the same sequence of nodes as with 'visit_definitions'.
+    //!   After all workers are finished 'merge_results' is called for each visitor on the calling thread.
+    //! \note The nodes are only read, visitors need to keep their output in their own state until 'merge_results' is called.
+    void visit_definitions_parallel(
+        ice::Span<ice::arctic::SyntaxNode const* const> definitions,
+        ice::Span<ice::arctic::SyntaxVisitorBase* const> visitors,
+        ice::u32 jobs = 0
+    ) noexcept;
 
 } // namespace ice::arctic
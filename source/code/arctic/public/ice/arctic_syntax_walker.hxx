@@ -0,0 +1,232 @@
+#pragma once
+#include <ice/arctic_syntax_node.hxx>
+#include <algorithm>
+#include <concepts>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    //! \brief Returned from a handlers 'enter' function to control the walk, handlers returning 'void' always continue.
+    enum class WalkAction : ice::u8
+    {
+        Continue,
+
+        //! \brief The children of the node are not visited, 'leave' is still called for the node.
+        SkipChildren,
+
+        //! \brief Ends the walk immediately, no further 'enter' or 'leave' functions are called.
+        Stop,
+    };
+
+    enum class WalkResult : ice::u8
+    {
+        Completed,
+        Stopped,
+
+        //! \brief The tree was nested deeper than the walkers stack, the walk was stopped at that point.
+        DepthExceeded,
+    };
+
+    namespace detail
+    {
+
+        template<typename Node>
+        constexpr auto walk_function_body(Node* node) noexcept -> Node*
+        {
+            // The function body is stored as the sibling of the function node.
+            return node->entity == SyntaxEntity::DEF_Function ? node->sibling : nullptr;
+        }
+
+        template<typename Node>
+        constexpr auto walk_first_child(Node* node) noexcept -> Node*
+        {
+            return node->child != nullptr ? node->child : ice::arctic::detail::walk_function_body(node);
+        }
+
+        template<typename Node>
+        constexpr auto walk_next_child(Node* parent, Node* node) noexcept -> Node*
+        {
+            if (parent->entity == SyntaxEntity::DEF_Function && node == parent->sibling)
+            {
+                return nullptr;
+            }
+            return node->sibling != nullptr ? node->sibling : ice::arctic::detail::walk_function_body(parent);
+        }
+
+        template<typename Handler, typename TypedNode>
+        constexpr auto walk_enter_handler(Handler& handler, TypedNode* node) noexcept -> ice::arctic::WalkAction
+        {
+            if constexpr (requires { { handler.enter(node) } -> std::same_as<ice::arctic::WalkAction>; })
+            {
+                return handler.enter(node);
+            }
+            else if constexpr (requires { handler.enter(node); })
+            {
+                handler.enter(node);
+            }
+            return WalkAction::Continue;
+        }
+
+        template<typename Handler, typename TypedNode>
+        constexpr void walk_leave_handler(Handler& handler, TypedNode* node) noexcept
+        {
+            if constexpr (requires { handler.leave(node); })
+            {
+                handler.leave(node);
+            }
+        }
+
+        template<typename Node, typename... Handlers>
+        constexpr auto walk_enter(Node* node, Handlers&... handlers) noexcept -> ice::arctic::WalkAction
+        {
+            return ice::arctic::dispatch_syntax_node(node, [&](auto* typed_node) noexcept -> ice::arctic::WalkAction
+                {
+                    ice::arctic::WalkAction result = WalkAction::Continue;
+                    auto const enter_handler = [&](auto& handler) noexcept
+                    {
+                        if (result != WalkAction::Stop)
+                        {
+                            result = std::max(result, ice::arctic::detail::walk_enter_handler(handler, typed_node));
+                        }
+                    };
+
+                    (enter_handler(handlers), ...);
+                    return result;
+                }
+            );
+        }
+
+        template<typename Node, typename... Handlers>
+        constexpr void walk_leave(Node* node, Handlers&... handlers) noexcept
+        {
+            ice::arctic::dispatch_syntax_node(node, [&](auto* typed_node) noexcept
+                {
+                    (ice::arctic::detail::walk_leave_handler(handlers, typed_node), ...);
+                }
+            );
+        }
+
+    } // namespace detail
+
+    namespace detail
+    {
+
+        template<typename Node, ice::u32 Capacity>
+        struct WalkFixedStack
+        {
+            Node* nodes[Capacity];
+            ice::u32 size = 0;
+
+            constexpr bool push(Node* node) noexcept
+            {
+                if (size == Capacity)
+                {
+                    return false;
+                }
+                nodes[size++] = node;
+                return true;
+            }
+
+            constexpr auto back() const noexcept -> Node* { return nodes[size - 1]; }
+            constexpr void pop() noexcept { size -= 1; }
+            constexpr bool empty() const noexcept { return size == 0; }
+        };
+
+        template<typename Node>
+        struct WalkHeapStack
+        {
+            std::vector<Node*> nodes;
+
+            constexpr bool push(Node* node) noexcept
+            {
+                nodes.push_back(node);
+                return true;
+            }
+
+            constexpr auto back() const noexcept -> Node* { return nodes.back(); }
+            constexpr void pop() noexcept { nodes.pop_back(); }
+            constexpr bool empty() const noexcept { return nodes.empty(); }
+        };
+
+        template<typename Stack, typename Node, typename... Handlers>
+        constexpr auto walk_with_stack(Stack& ancestors, Node* root, Handlers&... handlers) noexcept -> ice::arctic::WalkResult
+        {
+            static_assert(std::is_base_of_v<ice::arctic::SyntaxNode, std::remove_const_t<Node>>);
+
+            Node* node = root;
+            while (node != nullptr)
+            {
+                ice::arctic::WalkAction const action = ice::arctic::detail::walk_enter(node, handlers...);
+                if (action == WalkAction::Stop)
+                {
+                    return WalkResult::Stopped;
+                }
+
+                Node* const first_child = action == WalkAction::Continue ? ice::arctic::detail::walk_first_child(node) : nullptr;
+                if (first_child != nullptr)
+                {
+                    if (ancestors.push(node) == false)
+                    {
+                        return WalkResult::DepthExceeded;
+                    }
+
+                    node = first_child;
+                    continue;
+                }
+
+                // Leave finished nodes until we find one with a next sibling, links are read before the node is left.
+                while (true)
+                {
+                    if (ancestors.empty())
+                    {
+                        ice::arctic::detail::walk_leave(node, handlers...);
+                        return WalkResult::Completed;
+                    }
+
+                    Node* const parent = ancestors.back();
+                    Node* const next = ice::arctic::detail::walk_next_child(parent, node);
+                    ice::arctic::detail::walk_leave(node, handlers...);
+
+                    if (next != nullptr)
+                    {
+                        node = next;
+                        break;
+                    }
+
+                    node = parent;
+                    ancestors.pop();
+                }
+            }
+            return WalkResult::Completed;
+        }
+
+    } // namespace detail
+
+    //! \brief Walks the node and all nodes owned by it in depth-first order, without recursion or allocations.
+    //!
+    //! \details Each handler can provide 'enter' and 'leave' overloads taking the typed node pointers passed by
+    //!   'dispatch_syntax_node', overloads are selected at compile time. Handlers are called in the order they are given.
+    //!   A node is visited with 'enter' before its children and with 'leave' after them, 'leave' is allowed to release the node.
+    //!
+    //! \note The function body, stored as the sibling of a function node, is walked as the last child of the function.
+    //!   Annotations and siblings of the given node are separate definitions and are not walked.
+    //!
+    //! \tparam MaxDepth The number of ancestors kept on the walkers stack.
+    template<ice::u32 MaxDepth = 256, typename Node, typename... Handlers>
+    constexpr auto walk(Node* root, Handlers&&... handlers) noexcept -> ice::arctic::WalkResult
+    {
+        ice::arctic::detail::WalkFixedStack<Node, MaxDepth> ancestors;
+        return ice::arctic::detail::walk_with_stack(ancestors, root, handlers...);
+    }
+
+    //! \brief Walks the same way as 'walk', but keeps the ancestors in a heap allocation, so any depth can be walked.
+    //! \note Meant as a fallback for trees 'walk' returned 'DepthExceeded' for, which are only created without expression depth limits.
+    template<typename Node, typename... Handlers>
+    constexpr auto walk_unbounded(Node* root, Handlers&&... handlers) noexcept -> ice::arctic::WalkResult
+    {
+        ice::arctic::detail::WalkHeapStack<Node> ancestors;
+        return ice::arctic::detail::walk_with_stack(ancestors, root, handlers...);
+    }
+
+} // namespace ice::arctic
@@ -42,6 +42,7 @@ namespace ice::arctic
         KW_Ctx = Keyword | 0x0005,
         KW_Mut = Keyword | 0x0006,
         KW_Def = Keyword | 0x0007,
+        KW_Import = Keyword | 0x0008,
         KW_TypeOf = Keyword | 0x0100,
         KW_Struct = Keyword | 0x0101,
         KW_Alias = Keyword | 0x0102,
@@ -0,0 +1,67 @@
+#pragma once
+#include <ice/arctic_types.hxx>
+#include <string>
+
+//! \brief Enables trace events, define as '1' to record phases, top-level definitions and visitor callbacks.
+//!   Define as '2' to also record each resumption of the word processor and lexer, which creates events for every token.
+//! \note When disabled trace scopes are empty objects and nothing is recorded.
+#ifndef ICE_ARCTIC_TRACING
+#define ICE_ARCTIC_TRACING 0
+#endif
+
+namespace ice::arctic
+{
+
+    //! \brief Records the time between construction and destruction as a single event on the current thread.
+    class TraceScope
+    {
+    public:
+        static constexpr ice::u32 Constant_NoIndex = 0xffff'ffff;
+        static constexpr ice::u32 Constant_MaxDetailSize = 47;
+
+        //! \param name Static name of the event, a 'nullptr' disables the scope.
+        //! \param detail Shown in the event arguments, the text is copied up to 'Constant_MaxDetailSize' bytes.
+        explicit TraceScope(
+            char const* name,
+            char const* detail = nullptr,
+            ice::u32 index = Constant_NoIndex
+        ) noexcept;
+
+        TraceScope(TraceScope const&) noexcept = delete;
+        auto operator=(TraceScope const&) noexcept -> TraceScope& = delete;
+
+        ~TraceScope() noexcept;
+
+        //! \brief Replaces the detail, allows to name an event after the thing it created.
+        void set_detail(ice::String detail) noexcept;
+
+#if ICE_ARCTIC_TRACING
+    private:
+        char const* const _name;
+        ice::u64 const _start_ns;
+        ice::u32 const _index;
+        char _detail[Constant_MaxDetailSize + 1];
+#endif
+    };
+
+    //! \brief Names the current thread in the trace, the name needs to be static.
+    void trace_thread_name(char const* name) noexcept;
+
+    //! \brief Returns all recorded events in the Chrome trace-event format, each thread has its own 'tid'.
+    //! \note Should not be called while other threads are still recording events.
+    auto trace_json() noexcept -> std::string;
+
+    //! \brief Drops all recorded events, the same restrictions as for 'trace_json' apply.
+    void trace_reset() noexcept;
+
+#if ICE_ARCTIC_TRACING == 0
+
+    inline TraceScope::TraceScope(char const*, char const*, ice::u32) noexcept { }
+    inline TraceScope::~TraceScope() noexcept { }
+    inline void TraceScope::set_detail(ice::String) noexcept { }
+
+    inline void trace_thread_name(char const*) noexcept { }
+
+#endif // #if ICE_ARCTIC_TRACING == 0
+
+} // namespace ice::arctic
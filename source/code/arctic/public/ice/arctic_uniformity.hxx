@@ -0,0 +1,119 @@
+#pragma once
+#include <ice/arctic_semantic.hxx>
+#include <ice/arctic_annotation_table.hxx>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ice::arctic
+{
+
+    //! \brief How often the value of an expression changes when a function runs over a batch of entities.
+    //! \note Values are ordered, the uniformity of a combined expression is the highest uniformity of its operands.
+    enum class Uniformity : ice::u8
+    {
+        //! \brief Only depends on literals, global constants and '[constant]' context variables.
+        //!   The value can be computed once per batch, before the function runs.
+        Batch,
+
+        //! \brief The same for all entities, but depends on local variables so it needs to be computed by the function.
+        Uniform,
+
+        //! \brief Depends on per-entity inputs, function arguments, global variables or calls of functions.
+        Varying,
+    };
+
+    //! \brief Classifies expressions of function bodies by the inputs they depend on.
+    //!
+    //! \details Local variables are classified flow-insensitive, a local is as uniform as its initializer and every value
+    //!   assigned to it. Calls of functions are always varying, as their bodies are not analyzed. Constructors of types
+    //!   are as uniform as their arguments.
+    class UniformityAnalysis
+    {
+    public:
+        //! \param annotations Decoded annotations of the definitions, used to find '[constant]' context variables.
+        UniformityAnalysis(
+            ice::arctic::SemanticModel const& model,
+            ice::arctic::AnnotationTables const& annotations
+        ) noexcept;
+
+        UniformityAnalysis(UniformityAnalysis const&) noexcept = delete;
+        auto operator=(UniformityAnalysis const&) noexcept -> UniformityAnalysis& = delete;
+
+        //! \brief Classifies all function bodies, definitions need to be resolved by the semantic model.
+        void analyze(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept;
+
+        //! \returns The uniformity of an operand, an operand list or a local variable, 'Varying' for any other node.
+        auto uniformity_of(ice::arctic::SyntaxNode const* node) const noexcept -> ice::arctic::Uniformity;
+
+    private:
+        void classify_statements(ice::arctic::SyntaxNode const* first, bool& out_changed) noexcept;
+        auto classify_list(ice::arctic::SyntaxNode const* parent) noexcept -> ice::arctic::Uniformity;
+        auto classify_operand(ice::arctic::SyntaxNode const* node) noexcept -> ice::arctic::Uniformity;
+        auto classify_symbol(ice::arctic::Symbol const* symbol) const noexcept -> ice::arctic::Uniformity;
+
+        //! \brief Raises the uniformity of a local variable.
+        void assign_local(ice::arctic::SyntaxNode const* variable, ice::arctic::Uniformity uniformity, bool& out_changed) noexcept;
+
+    private:
+        ice::arctic::SemanticModel const& _model;
+        ice::arctic::AnnotationTables const& _annotations;
+
+        std::unordered_set<ice::arctic::SyntaxNode const*> _globals;
+        std::unordered_map<ice::arctic::SyntaxNode const*, ice::arctic::Uniformity> _nodes;
+    };
+
+    //! \brief Moves batch uniform subexpressions of function bodies into a prologue, evaluated once per batch.
+    //!
+    //! \details Each hoisted subexpression becomes the initializer of a new variable and is replaced by a reference to it.
+    //!   Only complete subexpressions with at least one operation or call are hoisted, single values are cheaper to read
+    //!   directly. Subexpressions with types without a name can't be declared and are kept in place.
+    //!
+    //! \note The syntax tree is modified in place and the analysis is not valid for the modified lists afterwards.
+    //!   New nodes are created with the given allocator and names of new variables are owned by the hoister.
+    class UniformHoister
+    {
+    public:
+        UniformHoister(
+            ice::arctic::SyntaxNodeAllocator& alloc,
+            ice::arctic::SemanticModel& model,
+            ice::arctic::UniformityAnalysis const& analysis
+        ) noexcept;
+
+        UniformHoister(UniformHoister const&) noexcept = delete;
+        auto operator=(UniformHoister const&) noexcept -> UniformHoister& = delete;
+
+        //! \brief Hoists subexpressions of all function bodies, the definitions need to be analyzed.
+        //! \returns The number of hoisted subexpressions.
+        auto hoist(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept -> ice::u32;
+
+        //! \brief Variables holding the hoisted subexpressions, in the order they need to be evaluated.
+        //! \note Prologue variables only reference global definitions and each other, never locals of the functions.
+        auto prologue() const noexcept -> ice::Span<ice::arctic::SyntaxNode_Variable const* const>
+        {
+            return _prologue;
+        }
+
+    private:
+        void hoist_statements(ice::arctic::SyntaxNode* first) noexcept;
+        void hoist_nested(ice::arctic::SyntaxNode* node) noexcept;
+        void hoist_list(ice::arctic::SyntaxNode* parent) noexcept;
+
+        auto create_variable(
+            ice::arctic::SyntaxNode* initializer,
+            ice::arctic::TypeHandle type,
+            ice::arctic::TokenLocation location
+        ) noexcept -> ice::arctic::SyntaxNode_Variable*;
+
+    private:
+        ice::arctic::SyntaxNodeAllocator& _alloc;
+        ice::arctic::SemanticModel& _model;
+        ice::arctic::UniformityAnalysis const& _analysis;
+
+        std::deque<std::u8string> _names;
+        std::vector<ice::arctic::SyntaxNode_Variable const*> _prologue;
+    };
+
+} // namespace ice::arctic
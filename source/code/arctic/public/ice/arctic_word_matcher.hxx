@@ -5,6 +5,7 @@ namespace ice::arctic
 {
 
     //! \brief A word matcher using only basic ascii values for punctuation and whitespaces cases.
+    //! \note Once initialized the matcher is immutable and can be shared between threads.
     struct WordMatcher
     {
         using MatcherFn = auto(ice::utf8 const*, ice::utf8 const*&, ice::u32&) noexcept -> ice::arctic::WordCategory;
@@ -12,9 +12,14 @@ namespace ice::arctic
 
     using WordProcessor = ice::arctic::detail::Generator<ice::arctic::Word>;
 
+    template<>
+    constexpr ice::arctic::MemoryPhase detail::Constant_GeneratorMemoryPhase<ice::arctic::Word> = MemoryPhase::WordProcessing;
+
+    //! \param start_location Location of the first word, allows to process a script starting in the middle.
     auto create_word_processor(
         ice::String script_data,
-        ice::arctic::WordMatcher const* matcher
+        ice::arctic::WordMatcher const* matcher,
+        ice::arctic::WordLocation start_location = { }
     ) noexcept -> ice::arctic::WordProcessor;
 
 } // namespace ice::arctic
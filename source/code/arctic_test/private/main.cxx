@@ -1,8 +1,15 @@
 #include <Windows.h>
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
+#include <fstream>
+#include <initializer_list>
 #include <iostream>
+#include <memory>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <fmt/format.h>
 
@@ -10,6 +17,51 @@
 #include <ice/arctic_word_processor.hxx>
 #include <ice/arctic_lexer.hxx>
 #include <ice/arctic_parser.hxx>
+#include <ice/arctic_module.hxx>
+#include <ice/arctic_compiler.hxx>
+#include <ice/arctic_syntax_cache.hxx>
+#include <ice/arctic_parser_profiler.hxx>
+#include <ice/arctic_memory_stats.hxx>
+#include <ice/arctic_trace.hxx>
+#include <ice/arctic_static_compiler.hxx>
+#include <ice/arctic_syntax_walker.hxx>
+#include <ice/arctic_syntax_hash.hxx>
+#include <ice/arctic_semantic.hxx>
+#include <ice/arctic_constant_folder.hxx>
+#include <ice/arctic_uniformity.hxx>
+#include <ice/arctic_subexpression_eliminator.hxx>
+#include <ice/arctic_struct_layout.hxx>
+#include <ice/arctic_interface_pruner.hxx>
+#include <ice/arctic_function_inliner.hxx>
+#include <ice/arctic_bytecode_compiler.hxx>
+
+#if ICE_ARCTIC_MEMORY_TRACKING
+
+// Forwards all allocations of the test app, so transpiler buffers are charged to the visitor that created them.
+auto operator new(std::size_t size) -> void*
+{
+    std::size_t* const block = static_cast<std::size_t*>(std::malloc(size + sizeof(std::max_align_t)));
+    block[0] = size;
+    ice::arctic::track_allocation(size);
+    return reinterpret_cast<char*>(block) + sizeof(std::max_align_t);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+    {
+        std::size_t* const block = reinterpret_cast<std::size_t*>(static_cast<char*>(ptr) - sizeof(std::max_align_t));
+        ice::arctic::track_deallocation(block[0]);
+        std::free(block);
+    }
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+#endif // #if ICE_ARCTIC_MEMORY_TRACKING
 
 static auto str_view(ice::arctic::Token const& tok) noexcept -> std::string_view
 {
@@ -140,6 +192,136 @@ struct Buffer
     CharT* _buffer;
 };
 
+//! \brief Writes expressions and scopes of a function body in C-like syntax, types are mapped by the transpiler.
+template<typename Transpiler>
+struct ExpressionWriter
+{
+    Transpiler const& transpiler;
+    std::u8string& target;
+    ice::u32 indent = 1;
+    ice::u32 inline_expressions = 0;
+
+    void append_indent() noexcept
+    {
+        target.append(indent * 2, u8' ');
+    }
+
+    static bool has_inline_expression(ice::arctic::SyntaxNode_Variable const* node) noexcept
+    {
+        return node->child != nullptr && node->child->entity == ice::arctic::SyntaxEntity::EXP_Expression;
+    }
+
+    void enter(ice::arctic::SyntaxNode_Scope const*) noexcept
+    {
+        append_indent();
+        target.append(u8"{\n");
+        indent += 1;
+    }
+
+    void leave(ice::arctic::SyntaxNode_Scope const*) noexcept
+    {
+        indent -= 1;
+        append_indent();
+        target.append(u8"}\n");
+    }
+
+    auto enter(ice::arctic::SyntaxNode_Variable const* node) noexcept -> ice::arctic::WalkAction
+    {
+        append_indent();
+        if (node->is_const)
+        {
+            target.append(u8"const ");
+        }
+        target.append(transpiler.symbol_replacer(node->type.value));
+        target.append(u8" ");
+        target.append(node->name.value);
+
+        if (has_inline_expression(node) == false)
+        {
+            target.append(u8";\n");
+            return ice::arctic::WalkAction::SkipChildren;
+        }
+
+        inline_expressions += 1;
+        return ice::arctic::WalkAction::Continue;
+    }
+
+    void leave(ice::arctic::SyntaxNode_Variable const* node) noexcept
+    {
+        inline_expressions -= ice::u32(has_inline_expression(node));
+    }
+
+    void enter(ice::arctic::SyntaxNode_Expression const*) noexcept
+    {
+        if (inline_expressions == 0)
+        {
+            append_indent();
+        }
+    }
+
+    void leave(ice::arctic::SyntaxNode_Expression const*) noexcept
+    {
+        target.append(u8";\n");
+    }
+
+    void enter(ice::arctic::SyntaxNode_ExpressionUnaryOperation const* node) noexcept
+    {
+        target.append(node->operation.value);
+    }
+
+    void enter(ice::arctic::SyntaxNode_ExpressionBinaryOperation const* node) noexcept
+    {
+        target.append(u8" ");
+        target.append(node->operation.value);
+        target.append(u8" ");
+    }
+
+    void enter(ice::arctic::SyntaxNode_ExpressionAssignment const*) noexcept
+    {
+        target.append(u8" =");
+    }
+
+    void enter(ice::arctic::SyntaxNode_ExplicitScope const*) noexcept
+    {
+        target.append(u8"(");
+    }
+
+    void leave(ice::arctic::SyntaxNode_ExplicitScope const*) noexcept
+    {
+        target.append(u8")");
+    }
+
+    void enter(ice::arctic::SyntaxNode_ExpressionCall const* node) noexcept
+    {
+        target.append(transpiler.symbol_replacer(node->function.value));
+        target.append(u8"(");
+    }
+
+    void leave(ice::arctic::SyntaxNode_ExpressionCall const*) noexcept
+    {
+        target.append(u8")");
+    }
+
+    void leave(ice::arctic::SyntaxNode_ExpressionCallArg const* node) noexcept
+    {
+        if (node->sibling != nullptr)
+        {
+            target.append(u8", ");
+        }
+    }
+
+    void enter(ice::arctic::SyntaxNode_ExpressionValue const* node) noexcept
+    {
+        target.append(transpiler.symbol_replacer(node->value.value));
+    }
+
+    void enter(ice::arctic::SyntaxNode_ExpressionGetMember const* node) noexcept
+    {
+        target.append(u8".");
+        target.append(transpiler.symbol_replacer(node->member.value));
+    }
+};
+
 struct GLSL_Transpiler : ice::arctic::SyntaxVisitorGroup<
     ice::arctic::SyntaxNode_Struct,
     ice::arctic::SyntaxNode_ContextVariable,
@@ -148,6 +330,8 @@ struct GLSL_Transpiler : ice::arctic::SyntaxVisitorGroup<
 {
     auto symbol_replacer(std::u8string_view from) const noexcept -> std::u8string_view
     {
+        if (from == u8"f32") return u8"float";
+        if (from == u8"i32") return u8"int";
         if (from == u8"vec3f") return u8"vec3";
         if (from == u8"vec4f") return u8"vec4";
         if (from == u8"mtx4f") return u8"mat4";
@@ -179,112 +363,13 @@ struct GLSL_Transpiler : ice::arctic::SyntaxVisitorGroup<
 
     void transpile_expression(
         std::u8string& target,
-        ice::arctic::SyntaxNode const* node,
-        std::u8string indent = u8"  "
+        ice::arctic::SyntaxNode const* node
     ) const noexcept
     {
-        using ice::arctic::SyntaxEntity;
-
+        ExpressionWriter<GLSL_Transpiler> writer{ *this, target };
         while (node != nullptr)
         {
-            switch (node->entity)
-            {
-            case SyntaxEntity::DEF_ExplicitScope:
-                target.append(indent);
-                target.append(u8"{\n");
-                transpile_expression(target, node->child, indent + u8"  ");
-                target.append(indent);
-                target.append(u8"}\n");
-                break;
-            case SyntaxEntity::DEF_Variable:
-            {
-                ice::arctic::SyntaxNode_Variable const* var = static_cast<ice::arctic::SyntaxNode_Variable const*>(node);
-                target.append(indent);
-                target.append(
-                    symbol_replacer(
-                        var->type.value
-                    )
-                );
-                target.append(u8" ");
-                target.append(var->name.value);
-
-                if (var->child->entity == SyntaxEntity::EXP_Expression)
-                {
-                    transpile_expression(target, node->child, u8"");
-                }
-                else
-                {
-                    target.append(u8";\n");
-                }
-                break;
-            }
-            case SyntaxEntity::EXP_Expression:
-                target.append(indent);
-                transpile_expression(target, node->child, indent);
-                target.append(u8";\n");
-                break;
-            case SyntaxEntity::EXP_UnaryOperation:
-                target.append(static_cast<ice::arctic::SyntaxNode_ExpressionUnaryOperation const*>(node)->operation.value);
-                transpile_expression(target, node->child, indent);
-                break;
-            case SyntaxEntity::EXP_BinaryOperation:
-                target.append(u8" ");
-                target.append(static_cast<ice::arctic::SyntaxNode_ExpressionBinaryOperation const*>(node)->operation.value);
-                target.append(u8" ");
-                break;
-            case SyntaxEntity::EXP_Assignment:
-                target.append(u8" =");
-                transpile_expression(target, node->child, indent);
-                break;
-            case SyntaxEntity::EXP_ExplicitScope:
-                target.append(u8"(");
-                transpile_expression(target, node->child, indent);
-                target.append(u8")");
-                break;
-            case SyntaxEntity::EXP_Call:
-            {
-                target.append(
-                    symbol_replacer(
-                        static_cast<ice::arctic::SyntaxNode_ExpressionCall const*>(node)->function.value
-                    )
-                );
-                target.append(u8"(");
-                ice::arctic::SyntaxNode const* call_arg = node->child;
-                while (call_arg != nullptr)
-                {
-                    transpile_expression(target, call_arg->child, indent);
-
-                    call_arg = call_arg->sibling;
-                    if (call_arg != nullptr)
-                    {
-                        target.append(u8", ");
-                    }
-                }
-                target.append(u8")");
-                break;
-            }
-            case SyntaxEntity::EXP_CallArg:
-                transpile_expression(target, node->child, indent);
-                break;
-            case SyntaxEntity::EXP_Value:
-                target.append(
-                    symbol_replacer(
-                        static_cast<ice::arctic::SyntaxNode_ExpressionValue const*>(node)->value.value
-                    )
-                );
-                transpile_expression(target, node->child, indent);
-                break;
-            case SyntaxEntity::EXP_GetMember:
-                target.append(u8".");
-                target.append(
-                    symbol_replacer(
-                        static_cast<ice::arctic::SyntaxNode_ExpressionGetMember const*>(node)->member.value
-                    )
-                );
-                transpile_expression(target, node->child, indent);
-                break;
-            }
-
+            ice::arctic::walk(node, writer);
             node = node->sibling;
         }
     }
@@ -421,6 +506,11 @@ struct GLSL_Transpiler : ice::arctic::SyntaxVisitorGroup<
         _vtx_outvar = u8"";
     }
 
+    auto output() const noexcept -> std::u8string const&
+    {
+        return _buffer;
+    }
+
 private:
     std::u8string _buffer;
     std::u8string_view _vtx_outvar;
@@ -438,6 +528,8 @@ struct HLSL_Transpiler : ice::arctic::SyntaxVisitorGroup<
         auto const ctx_tokens = _shader_ctx_tokens.begin();
         auto const ctx_tokens_end = _shader_ctx_tokens.end();
 
+        if (from == u8"f32") return u8"float";
+        if (from == u8"i32") return u8"int";
         if (from == u8"vec3f") return u8"float3";
         if (from == u8"vec4f") return u8"float4";
         if (from == u8"mtx4f") return u8"float4x4";
@@ -480,112 +572,13 @@ struct HLSL_Transpiler : ice::arctic::SyntaxVisitorGroup<
 
     void transpile_expression(
         std::u8string& target,
-        ice::arctic::SyntaxNode const* node,
-        std::u8string indent = u8"  "
+        ice::arctic::SyntaxNode const* node
     ) const noexcept
     {
-        using ice::arctic::SyntaxEntity;
-
+        ExpressionWriter<HLSL_Transpiler> writer{ *this, target };
         while (node != nullptr)
         {
-            switch (node->entity)
-            {
-            case SyntaxEntity::DEF_ExplicitScope:
-                target.append(indent);
-                target.append(u8"{\n");
-                transpile_expression(target, node->child, indent + u8"  ");
-                target.append(indent);
-                target.append(u8"}\n");
-                break;
-            case SyntaxEntity::DEF_Variable:
-            {
-                ice::arctic::SyntaxNode_Variable const* var = static_cast<ice::arctic::SyntaxNode_Variable const*>(node);
-                target.append(indent);
-                target.append(
-                    symbol_replacer(
-                        var->type.value
-                    )
-                );
-                target.append(u8" ");
-                target.append(var->name.value);
-
-                if (var->child->entity == SyntaxEntity::EXP_Expression)
-                {
-                    transpile_expression(target, node->child, u8"");
-                }
-                else
-                {
-                    target.append(u8";\n");
-                }
-                break;
-            }
-            case SyntaxEntity::EXP_Expression:
-                target.append(indent);
-                transpile_expression(target, node->child, indent);
-                target.append(u8";\n");
-                break;
-            case SyntaxEntity::EXP_UnaryOperation:
-                target.append(static_cast<ice::arctic::SyntaxNode_ExpressionUnaryOperation const*>(node)->operation.value);
-                transpile_expression(target, node->child, indent);
-                break;
-            case SyntaxEntity::EXP_BinaryOperation:
-                target.append(u8" ");
-                target.append(static_cast<ice::arctic::SyntaxNode_ExpressionBinaryOperation const*>(node)->operation.value);
-                target.append(u8" ");
-                break;
-            case SyntaxEntity::EXP_Assignment:
-                target.append(u8" =");
-                transpile_expression(target, node->child, indent);
-                break;
-            case SyntaxEntity::EXP_ExplicitScope:
-                target.append(u8"(");
-                transpile_expression(target, node->child, indent);
-                target.append(u8")");
-                break;
-            case SyntaxEntity::EXP_Call:
-            {
-                target.append(
-                    symbol_replacer(
-                        static_cast<ice::arctic::SyntaxNode_ExpressionCall const*>(node)->function.value
-                    )
-                );
-                target.append(u8"(");
-                ice::arctic::SyntaxNode const* call_arg = node->child;
-                while (call_arg != nullptr)
-                {
-                    transpile_expression(target, call_arg->child, indent);
-
-                    call_arg = call_arg->sibling;
-                    if (call_arg != nullptr)
-                    {
-                        target.append(u8", ");
-                    }
-                }
-                target.append(u8")");
-                break;
-            }
-            case SyntaxEntity::EXP_CallArg:
-                transpile_expression(target, node->child, indent);
-                break;
-            case SyntaxEntity::EXP_Value:
-                target.append(
-                    symbol_replacer(
-                        static_cast<ice::arctic::SyntaxNode_ExpressionValue const*>(node)->value.value
-                    )
-                );
-                transpile_expression(target, node->child, indent);
-                break;
-            case SyntaxEntity::EXP_GetMember:
-                target.append(u8".");
-                target.append(
-                    symbol_replacer(
-                        static_cast<ice::arctic::SyntaxNode_ExpressionGetMember const*>(node)->member.value
-                    )
-                );
-                transpile_expression(target, node->child, indent);
-                break;
-            }
-
+            ice::arctic::walk(node, writer);
             node = node->sibling;
         }
     }
@@ -800,6 +793,11 @@ struct HLSL_Transpiler : ice::arctic::SyntaxVisitorGroup<
         }
     }
 
+    auto output() const noexcept -> std::u8string const&
+    {
+        return _buffer;
+    }
+
 private:
     std::u8string _buffer;
     std::u8string_view _vtx_outvar;
@@ -813,63 +811,1935 @@ private:
     std::vector<TokenReplacement> _shader_ctx_tokens;
 };
 
-auto main(int argc, char** argv) -> int
+//! \brief Compiles the same script many times using a single thread and all available threads.
+//! \note Used as a stress test for the batch compiler, any diverging result is reported as a failure.
+auto batch_stress_test(ice::utf8 const* contents, ice::u32 script_count) noexcept -> int
 {
-    if (argc < 2)
+    std::vector<ice::arctic::SourceDesc> sources{ script_count, ice::arctic::SourceDesc{ .source = contents } };
+    std::vector<ice::arctic::CompileResult> results_single{ script_count };
+    std::vector<ice::arctic::CompileResult> results_batch{ script_count };
+
+    ice::arctic::WordMatcher matcher{ };
+    ice::arctic::initialize_ascii_matcher(&matcher);
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    ice::u32 const failed_single = ice::arctic::compile_batch(&matcher, sources, results_single, 1);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    ice::u32 const failed_batch = ice::arctic::compile_batch(&matcher, sources, results_batch);
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    ice::arctic::shutdown_matcher(&matcher);
+
+    bool matching_results = failed_single == failed_batch;
+    for (ice::u32 idx = 0; idx < script_count; ++idx)
     {
-        return -1;
+        matching_results &= results_single[idx].state == results_batch[idx].state;
     }
 
-    std::filesystem::path script_path = std::filesystem::absolute(argv[1]);
-
-    Buffer<ice::utf8> contents;
+    std::cout << "Scripts: " << script_count << ", failed: " << failed_batch << std::endl;
+    std::cout << "Single thread: " << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << "ms" << std::endl;
+    std::cout << "All threads: " << std::chrono::duration_cast<std::chrono::milliseconds>(t3 - t2).count() << "ms" << std::endl;
+    return matching_results ? 0 : -1;
+}
 
-    HANDLE file_handle = CreateFile(script_path.c_str(), GENERIC_READ, 0, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-    if (file_handle != INVALID_HANDLE_VALUE)
+void print_diagnostics(ice::Span<ice::arctic::ParseDiagnostic const> diagnostics) noexcept
+{
+    for (ice::arctic::ParseDiagnostic const& diagnostic : diagnostics)
     {
-        DWORD const file_size = GetFileSize(file_handle, nullptr);
-        if (file_size != 0)
+        std::string expected;
+        for (ice::arctic::TokenType type : diagnostic.expected_types())
         {
-            contents = Buffer<ice::utf8>{ file_size + 10 };
-            memset(contents._buffer, 0, file_size + 10);
+            expected += fmt::format("{}{:#x}", expected.empty() ? "" : ", ", ice::u32(type));
+        }
 
-            DWORD bytes_read;
-            BOOL const read_result = ReadFile(file_handle, contents._buffer, file_size, &bytes_read, nullptr);
+        // Line breaks are printed escaped to keep one diagnostic per line.
+        std::string value;
+        for (ice::utf8 character : diagnostic.token.value)
+        {
+            value += character == u8'\n' ? std::string_view{ "\\n" } : character == u8'\r' ? std::string_view{ "\\r" } : std::string_view{ reinterpret_cast<char const*>(&character), 1 };
         }
 
-        CloseHandle(file_handle);
+        std::cout << fmt::format(
+            "{}:{}: {} at '{}'{}{}\n",
+            ice::u32(diagnostic.token.location.line),
+            ice::u32(diagnostic.token.location.column),
+            ice::arctic::to_string(diagnostic.state),
+            value,
+            expected.empty() ? "" : ", expected token types: ",
+            expected
+        );
     }
+}
 
-    ice::u32 token_count = 0;
-
-    ice::arctic::WordMatcher matcher{ };
-    ice::arctic::initialize_ascii_matcher(&matcher);
+//! \brief Parses a script without recovery, all modes working on the syntax tree of a single script start with it.
+//! \note Diagnostics are printed after each step, 'state' is the state of the first failed step.
+struct ParsedScript
+{
+    ParsedScript(
+        ice::String source,
+        ice::arctic::ParserOptions options = { },
+        std::initializer_list<ice::arctic::SyntaxVisitorBase*> visitors = { }
+    ) noexcept
+        : parser{ options }
     {
-        ice::arctic::WordProcessor processor = ice::arctic::create_word_processor(
-            contents._buffer,
-            &matcher
-        );
+        ice::arctic::initialize_ascii_matcher(&matcher);
+        for (ice::arctic::SyntaxVisitorBase* visitor : visitors)
+        {
+            parser.add_visitor(*visitor);
+        }
 
         ice::arctic::Lexer lexer = ice::arctic::create_lexer(
-            std::move(processor)
+            ice::arctic::create_word_processor(source, &matcher)
         );
+        state = parser.parse(lexer);
+        print_diagnostics(parser.diagnostics());
+    }
 
+    ~ParsedScript() noexcept
+    {
+        ice::arctic::shutdown_matcher(&matcher);
+    }
 
-        GLSL_Transpiler my_glsl_gen{ };
-        HLSL_Transpiler my_hlsl_gen{ };
+    ParsedScript(ParsedScript const&) noexcept = delete;
+    auto operator=(ParsedScript const&) noexcept -> ParsedScript& = delete;
 
-        ice::arctic::Parser parser;
-        parser.add_visitor(my_glsl_gen);
-        parser.add_visitor(my_hlsl_gen);
+    //! \brief Resolves the parsed definitions with 'semantic_model', nothing is resolved if parsing failed.
+    auto resolve() noexcept -> ice::arctic::ParseState
+    {
+        if (state == ice::arctic::ParseState::Success)
+        {
+            semantic_model.add_definitions(parser.definitions());
+            state = semantic_model.resolve();
+            print_diagnostics(semantic_model.diagnostics());
+        }
+        return state;
+    }
 
-        auto t1 = std::chrono::high_resolution_clock::now();
+    auto definitions() const noexcept -> ice::Span<ice::arctic::SyntaxNode const* const>
+    {
+        return parser.definitions();
+    }
 
-        parser.parse(lexer);
+    ice::arctic::WordMatcher matcher{ };
+    ice::arctic::Parser parser;
+    ice::arctic::SemanticModel semantic_model;
+    ice::arctic::ParseState state = ice::arctic::ParseState::Success;
+};
 
-        auto t2 = std::chrono::high_resolution_clock::now();
+//! \brief Both transpilers, each prints its output when destroyed.
+struct Transpilers
+{
+    void visit(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept
+    {
+        ice::arctic::SyntaxVisitorBase* const visitors[]{ &glsl, &hlsl };
+        ice::arctic::visit_definitions(definitions, visitors);
+    }
 
-        std::cout << "Tokens: " << token_count << std::endl;
-        std::cout << "Total time: " << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << "ms" << std::endl;
+    void visit_parallel(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept
+    {
+        ice::arctic::SyntaxVisitorBase* const visitors[]{ &glsl, &hlsl };
+        ice::arctic::visit_definitions_parallel(definitions, visitors);
+    }
+
+    GLSL_Transpiler glsl{ };
+    HLSL_Transpiler hlsl{ };
+};
+
+void write_syntax_token(ice::arctic::Token const& token, std::string& out) noexcept
+{
+    out += fmt::format(" '{}'@{}:{}", str_view(token), ice::u32(token.location.line), ice::u32(token.location.column));
+}
+
+//! \brief Writes the node, its tokens with their locations and all nodes owned by it, one node per line.
+void write_syntax_tree(ice::arctic::SyntaxNode const* node, ice::u32 depth, std::string& out) noexcept
+{
+    out.append(depth * 2, ' ');
+    out.append(ice::arctic::to_string(node->entity));
+    ice::arctic::for_each_syntax_token(node, [&out](ice::arctic::Token const& token) noexcept
+        {
+            write_syntax_token(token, out);
+        }
+    );
+
+    if (node->entity == ice::arctic::SyntaxEntity::DEF_TypeDef && static_cast<ice::arctic::SyntaxNode_TypeDef const*>(node)->is_alias)
+    {
+        out += " alias";
+    }
+    else if (node->entity == ice::arctic::SyntaxEntity::DEF_Variable && static_cast<ice::arctic::SyntaxNode_Variable const*>(node)->is_const)
+    {
+        out += " const";
+    }
+    out += '\n';
+
+    for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+    {
+        write_syntax_tree(child, depth + 1, out);
+    }
+}
+
+//! \brief Text of all definitions together with their annotations and function bodies, used to compare syntax trees.
+auto syntax_tree_text(ice::Span<ice::arctic::SyntaxNode const* const> definitions) noexcept -> std::string
+{
+    std::string result;
+    for (ice::arctic::SyntaxNode const* definition : definitions)
+    {
+        for (ice::arctic::SyntaxNode const* annotation = definition->annotation; annotation != nullptr; annotation = annotation->sibling)
+        {
+            write_syntax_tree(annotation, 0, result);
+        }
+
+        write_syntax_tree(definition, 0, result);
+        if (definition->entity == ice::arctic::SyntaxEntity::DEF_Function && definition->sibling != nullptr)
+        {
+            write_syntax_tree(definition->sibling, 1, result);
+        }
+    }
+    return result;
+}
+
+//! \brief Same as the above for a node of an image created by the static parser, nodes are linked by their indices.
+void write_syntax_tree(ice::Span<ice::arctic::StaticSyntaxNodeData const> nodes, ice::u32 idx, ice::u32 depth, std::string& out) noexcept
+{
+    ice::arctic::StaticSyntaxNodeData const& node = nodes[idx];
+    out.append(depth * 2, ' ');
+    out.append(ice::arctic::to_string(node.entity));
+    for (ice::u32 token_idx = 0; token_idx < ice::arctic::static_syntax_token_count(node.entity); ++token_idx)
+    {
+        write_syntax_token(node.tokens[token_idx], out);
+    }
+
+    if (node.entity == ice::arctic::SyntaxEntity::DEF_TypeDef && node.is_alias)
+    {
+        out += " alias";
+    }
+    else if (node.entity == ice::arctic::SyntaxEntity::DEF_Variable && node.is_const)
+    {
+        out += " const";
+    }
+    out += '\n';
+
+    for (ice::u32 child = node.child; child != ice::arctic::StaticSyntaxNodeData::Constant_None; child = nodes[child].sibling)
+    {
+        write_syntax_tree(nodes, child, depth + 1, out);
+    }
+}
+
+//! \brief Same as 'syntax_tree_text' for the definitions of an image created by the static parser.
+template<ice::u32 Capacity>
+auto syntax_tree_text(ice::arctic::StaticSyntaxImage<Capacity> const& image) noexcept -> std::string
+{
+    constexpr ice::u32 None = ice::arctic::StaticSyntaxNodeData::Constant_None;
+    ice::Span<ice::arctic::StaticSyntaxNodeData const> const nodes{ image.nodes, image.node_count };
+
+    std::string result;
+    for (ice::u32 const definition : ice::Span<ice::u32 const>{ image.definitions, image.definition_count })
+    {
+        for (ice::u32 annotation = nodes[definition].annotation; annotation != None; annotation = nodes[annotation].sibling)
+        {
+            write_syntax_tree(nodes, annotation, 0, result);
+        }
+
+        write_syntax_tree(nodes, definition, 0, result);
+        if (nodes[definition].entity == ice::arctic::SyntaxEntity::DEF_Function && nodes[definition].sibling != None)
+        {
+            write_syntax_tree(nodes, nodes[definition].sibling, 1, result);
+        }
+    }
+    return result;
+}
+
+//! \brief Keeps names as they are written in the script, used to compare modified function bodies.
+struct ScriptNames
+{
+    auto symbol_replacer(std::u8string_view from) const noexcept -> std::u8string_view
+    {
+        return from;
+    }
+};
+
+//! \brief Writes the statements of the named function, one statement per line.
+auto function_body_text(ice::Span<ice::arctic::SyntaxNode const* const> definitions, ice::String name) noexcept -> std::u8string
+{
+    std::u8string result;
+    for (ice::arctic::SyntaxNode const* definition : definitions)
+    {
+        if (definition->entity != ice::arctic::SyntaxEntity::DEF_Function
+            || static_cast<ice::arctic::SyntaxNode_Function const*>(definition)->name.value != name
+            || definition->sibling == nullptr)
+        {
+            continue;
+        }
+
+        ScriptNames const names;
+        for (ice::arctic::SyntaxNode const* node = definition->sibling->child; node != nullptr; node = node->sibling)
+        {
+            ice::arctic::walk(node, ExpressionWriter<ScriptNames>{ names, result });
+        }
+    }
+    return result;
+}
+
+//! \brief Records the notifications sent by 'Parser::reparse' for each top-level node.
+struct ReparseLog : ice::arctic::SyntaxVisitorBase
+{
+    static auto label(ice::arctic::SyntaxNode const* node) noexcept -> std::string
+    {
+        // The first token of named definitions is their name.
+        std::string_view name;
+        ice::arctic::for_each_syntax_token(node, [&name](ice::arctic::Token const& token) noexcept
+            {
+                name = name.empty() ? str_view(token) : name;
+            }
+        );
+        return fmt::format("{} '{}'", ice::arctic::to_string(node->entity), name);
+    }
+
+    void visit(ice::arctic::SyntaxNode const* node) noexcept override
+    {
+        events += fmt::format("  added {}\n", label(node));
+    }
+
+    void visit_removed(ice::arctic::SyntaxNode const* node) noexcept override
+    {
+        events += fmt::format("  removed {}\n", label(node));
+    }
+
+    void visit_changed(ice::arctic::SyntaxNode const*, ice::arctic::SyntaxNode const* node) noexcept override
+    {
+        events += fmt::format("  changed {}\n", label(node));
+    }
+
+    std::string events;
+};
+
+//! \brief Applies a single edit with 'Parser::reparse' and compares the result with a fresh parse of the edited script.
+//! \param inserted The inserted text, '\\n' is replaced with a line break.
+auto reparse_compare(ice::utf8 const* contents, ice::u32 offset, ice::u32 removed_size, std::string_view inserted) noexcept -> int
+{
+    std::u8string const previous_source{ contents };
+    std::u8string inserted_text;
+    for (ice::u64 idx = 0; idx < inserted.size(); ++idx)
+    {
+        bool const is_line_break = inserted[idx] == '\\' && idx + 1 < inserted.size() && inserted[idx + 1] == 'n';
+        inserted_text.push_back(is_line_break ? u8'\n' : ice::utf8(inserted[idx]));
+        idx += ice::u64(is_line_break);
+    }
+
+    if (offset + removed_size > previous_source.size())
+    {
+        std::cout << "Edit is outside of the script" << std::endl;
+        return -1;
+    }
+
+    std::u8string source = previous_source;
+    source.replace(offset, removed_size, inserted_text);
+
+    ReparseLog log{ };
+    ParsedScript script{ previous_source, { }, { &log } };
+    if (script.state != ice::arctic::ParseState::Success)
+    {
+        return -1;
+    }
+
+    std::string const parsed_events = std::exchange(log.events, { });
+    ice::arctic::ParseState const state = script.parser.reparse(
+        &script.matcher,
+        previous_source,
+        source,
+        ice::arctic::TextEdit{ .offset = offset, .removed_size = removed_size, .inserted_size = ice::u32(inserted_text.size()) },
+        ice::arctic::LexerOptions{ .rules = ice::arctic::LexerRules::Shader }
+    );
+    print_diagnostics(script.parser.diagnostics());
+    std::cout << "Reparse: " << ice::arctic::to_string(state) << "\n" << log.events;
+
+    // Removed nodes need to be ones passed to visitors by the first parse, each definition is only listed once.
+    bool valid_events = true;
+    for (std::string_view events = log.events; events.empty() == false;)
+    {
+        std::string_view const line = events.substr(0, events.find('\n'));
+        events.remove_prefix(std::min(events.size(), line.size() + 1));
+        if (line.starts_with("  removed "))
+        {
+            valid_events &= parsed_events.find(fmt::format("  added {}\n", line.substr(10))) != std::string::npos;
+        }
+    }
+
+    std::unordered_set<ice::arctic::SyntaxNode const*> const unique_definitions{ script.definitions().begin(), script.definitions().end() };
+    if (valid_events == false || unique_definitions.size() != script.definitions().size())
+    {
+        std::cout << "Reparse reported nodes that were never parsed" << std::endl;
+        return -1;
+    }
+
+    ParsedScript const fresh{ source };
+    std::string const reparsed = syntax_tree_text(script.definitions());
+    std::string const parsed = syntax_tree_text(fresh.definitions());
+    if (state != fresh.state || reparsed != parsed)
+    {
+        std::cout << "Reparsed tree differs from a full parse\n" << reparsed << "---\n" << parsed << std::endl;
+        return -1;
+    }
+
+    std::cout << "Reparsed tree matches a full parse" << std::endl;
+    return 0;
+}
+
+//! \brief Applies edits to scripts the incremental parser had problems with, each result needs to match a full parse.
+auto reparse_check() noexcept -> int
+{
+    // A stray token between definitions is skipped, it must not repeat the definition before it.
+    std::u8string const stray_token_script{
+        u8"context Shader\n\n"
+        u8"def Camera = struct [\n    view : mtx4f\n    projection : mtx4f\n]\n\n"
+        u8"stray\n\n"
+        u8"ctx\n{\n    [constant]\n    let camera : Camera\n}\n"
+    };
+    ice::u32 const members_offset = ice::u32(stray_token_script.find(u8"    view"));
+    ice::u32 const stray_offset = ice::u32(stray_token_script.find(u8"stray"));
+
+    struct EditCase
+    {
+        std::u8string_view source;
+        ice::u32 offset;
+        ice::u32 removed_size;
+        std::string_view inserted;
+    };
+
+    EditCase const cases[]{
+        { stray_token_script, members_offset, 0, "    extra : vec4f\\n" },
+        { stray_token_script, stray_offset, 5, "other" },
+        { stray_token_script, stray_offset, 6, "" },
+    };
+
+    int result = 0;
+    for (EditCase const& edit_case : cases)
+    {
+        std::u8string const source{ edit_case.source };
+        result = reparse_compare(source.c_str(), edit_case.offset, edit_case.removed_size, edit_case.inserted) == 0 ? result : -1;
+    }
+    return result;
+}
+
+//! \brief Parses consecutive broken definitions with recovery enabled, each of them needs to be reported on its own line.
+auto recovery_check() noexcept -> int
+{
+    ice::String constexpr source = u8"context Shader\n"
+        u8"\n"
+        u8"def X = \n"
+        u8"\n"
+        u8"fn B( : vec4f\n"
+        u8"{\n"
+        u8"    B = 1\n"
+        u8"}\n"
+        u8"\n"
+        u8"def Y = \n"
+        u8"\n"
+        u8"const Z : = 1\n"
+        u8"\n"
+        u8"def W = struct\n"
+        u8"\n"
+        u8"fn Ok() : void\n"
+        u8"{\n"
+        u8"    Ok = 1\n"
+        u8"}\n";
+    ice::u32 constexpr expected_lines[]{ 3, 5, 10, 12, 14 };
+
+    ParsedScript const script{ source, { .recover_from_errors = true } };
+
+    ice::Span<ice::arctic::ParseDiagnostic const> const diagnostics = script.parser.diagnostics();
+    bool matches = diagnostics.size() == std::size(expected_lines);
+    for (ice::u64 idx = 0; matches && idx < diagnostics.size(); ++idx)
+    {
+        matches = diagnostics[idx].token.location.line == expected_lines[idx];
+    }
+
+    // The definition following the broken ones still needs to be parsed.
+    matches = matches && script.definitions().size() == 1;
+
+    std::cout << (matches ? "Recovered from all broken definitions" : "Unexpected diagnostics") << std::endl;
+    return matches ? 0 : -1;
+}
+
+//! \brief Trips each parser limit once, the script needs to parse without errors when no limits are set.
+auto limits_check(ice::utf8 const* contents) noexcept -> int
+{
+    ice::String const script{ contents };
+
+    std::u8string deep_script{ u8"context Shader\n\nfn Deep() : void\n{\n    Deep = " };
+    deep_script.append(64, u8'(');
+    deep_script.append(u8"1");
+    deep_script.append(64, u8')');
+    deep_script.append(u8"\n}\n");
+
+    // Large enough to take longer than a millisecond even in optimized builds.
+    std::u8string long_script{ u8"context Shader\n\n" };
+    for (ice::u32 idx = 0; idx < 50'000; ++idx)
+    {
+        long_script.append(u8"const Value : f32 = 1.0 + 2.0 * 3.0\n");
+    }
+
+    struct LimitCase
+    {
+        std::string_view name;
+        ice::String source;
+        ice::arctic::ParserLimits limits;
+        ice::arctic::ParseState expected;
+    };
+
+    LimitCase const cases[]{
+        { "max_allocated_bytes", script, { .max_allocated_bytes = 64 }, ice::arctic::ParseState::Error_Limit_AllocatedBytes },
+        { "max_nodes", script, { .max_nodes = 4 }, ice::arctic::ParseState::Error_Limit_NodeCount },
+        { "max_expression_depth", deep_script, { .max_expression_depth = 16 }, ice::arctic::ParseState::Error_Limit_ExpressionDepth },
+        { "max_tokens", script, { .max_tokens = 16 }, ice::arctic::ParseState::Error_Limit_TokenCount },
+        { "max_time_ms", long_script, { .max_time_ms = 1 }, ice::arctic::ParseState::Error_Limit_Time },
+    };
+
+    int result = 0;
+    for (LimitCase const& limit_case : cases)
+    {
+        ice::arctic::ParseState const unlimited_state = ParsedScript{ limit_case.source }.state;
+        ice::arctic::ParseState const state = ParsedScript{ limit_case.source, { .limits = limit_case.limits } }.state;
+
+        bool const tripped = unlimited_state == ice::arctic::ParseState::Success && state == limit_case.expected;
+        std::cout << fmt::format(
+            "{}: {} ({})\n",
+            limit_case.name,
+            ice::arctic::to_string(state),
+            tripped ? "tripped" : "not tripped"
+        );
+        result = tripped ? result : -1;
+    }
+    return result;
+}
+
+//! \brief Runs the transpilers over a cached syntax tree, the script is only parsed if no valid cache entry exists.
+auto cached_transpile(ice::utf8 const* contents, std::filesystem::path const& cache_dir) noexcept -> int
+{
+    Transpilers transpilers;
+    ice::arctic::SyntaxTreeCache const cache{ cache_dir };
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    ice::arctic::SyntaxTreeImage const image = cache.load(contents);
+    if (image.valid())
+    {
+        transpilers.visit(image.definitions());
+
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::cout << "Loaded from cache: " << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() << "us" << std::endl;
+        return 0;
+    }
+
+    ParsedScript const script{ contents, { }, { &transpilers.glsl, &transpilers.hlsl } };
+    if (script.state == ice::arctic::ParseState::Success)
+    {
+        cache.store(contents, script.definitions());
+    }
+
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "Parsed and cached: " << std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count() << "us" << std::endl;
+    return script.state == ice::arctic::ParseState::Success ? 0 : -1;
+}
+
+//! \brief Loads truncated and corrupted copies of a serialized syntax tree, none of them may be read past the blob.
+auto cache_corruption_check(ice::utf8 const* contents) noexcept -> int
+{
+    ParsedScript const script{ contents };
+    if (script.state != ice::arctic::ParseState::Success)
+    {
+        return -1;
+    }
+
+    ice::u64 const source_hash = ice::arctic::hash_source(contents);
+    std::vector<ice::u64> blob;
+    ice::arctic::serialize_syntax_tree(script.definitions(), source_hash, blob);
+
+    auto const load_copy = [&](ice::u64 word_count, ice::u64 word_idx, ice::u64 word_value) noexcept
+    {
+        std::unique_ptr<ice::u64[]> copy = std::make_unique<ice::u64[]>(word_count);
+        std::copy_n(blob.begin(), word_count, copy.get());
+        copy[word_idx] = word_value;
+        return ice::arctic::SyntaxTreeImage::load(std::move(copy), word_count * sizeof(ice::u64), source_hash).valid();
+    };
+
+    // The header stores the blob size right after the magic, version and source hash.
+    ice::u64 constexpr blob_size_word = 2;
+    ice::u64 constexpr header_words = 4;
+
+    bool const loaded = load_copy(blob.size(), blob_size_word, blob[blob_size_word]);
+
+    // Truncated blobs have their stored size updated, so only the node bounds checks can reject them.
+    ice::u64 truncated_loaded = 0;
+    for (ice::u64 word_count = header_words; word_count < blob.size(); ++word_count)
+    {
+        truncated_loaded += load_copy(word_count, blob_size_word, word_count * sizeof(ice::u64));
+    }
+
+    // Each word is replaced with an invalid entity or offset, a value past the blob and an offset into the middle of a node.
+    ice::u64 corrupted_loaded = 0;
+    ice::u64 corrupted_total = 0;
+    for (ice::u64 word_idx = header_words; word_idx < blob.size(); ++word_idx)
+    {
+        for (ice::u64 const word_value : { ~ice::u64{ 0 }, blob.size() * sizeof(ice::u64), blob[word_idx] ^ 0x8 })
+        {
+            corrupted_loaded += load_copy(blob.size(), word_idx, word_value);
+            corrupted_total += 1;
+        }
+    }
+
+    std::cout << fmt::format(
+        "Original: {}\nTruncated: {} of {} loaded\nCorrupted: {} of {} loaded\n",
+        loaded ? "loaded" : "rejected",
+        truncated_loaded,
+        blob.size() - header_words,
+        corrupted_loaded,
+        corrupted_total
+    );
+    return loaded && truncated_loaded == 0 ? 0 : -1;
+}
+
+//! \brief Transpiles the script with a sequential and a pipelined parser, both need to produce the same output.
+auto pipelined_compare(ice::utf8 const* contents) noexcept -> int
+{
+    std::u8string outputs[2][2];
+    ice::arctic::ParseState states[2];
+    for (bool const pipelined : { false, true })
+    {
+        Transpilers transpilers;
+        ParsedScript const script{ contents, { .pipelined = pipelined }, { &transpilers.glsl, &transpilers.hlsl } };
+
+        states[pipelined] = script.state;
+        outputs[pipelined][0] = transpilers.glsl.output();
+        outputs[pipelined][1] = transpilers.hlsl.output();
+    }
+
+    bool const matches = states[0] == states[1]
+        && outputs[0][0] == outputs[1][0]
+        && outputs[0][1] == outputs[1][1];
+    std::cout << (matches ? "Pipelined output matches sequential output" : "Pipelined output differs from sequential output") << std::endl;
+    return matches ? 0 : -1;
+}
+
+//! \brief Records the entities of all nodes it was called for.
+struct EntityRecorder : ice::arctic::SyntaxVisitorBase
+{
+    using SyntaxVisitorBase::SyntaxVisitorBase;
+
+    void visit(ice::arctic::SyntaxNode const* node) noexcept override
+    {
+        entities.push_back(node->entity);
+    }
+
+    std::vector<ice::arctic::SyntaxEntity> entities;
+};
+
+//! \brief Checks a visitor only interested in functions is skipped for all other nodes, in each way visitors are called.
+auto masked_visitor_check(ice::utf8 const* contents) noexcept -> int
+{
+    ice::arctic::SyntaxEntityMask const function_mask = ice::arctic::syntax_entity_mask(ice::arctic::SyntaxEntity::DEF_Function);
+    EntityRecorder all_nodes{ };
+    EntityRecorder functions{ function_mask };
+    EntityRecorder pipelined_functions{ function_mask };
+    EntityRecorder visited_functions{ function_mask };
+    EntityRecorder parallel_functions{ function_mask };
+
+    ParsedScript const script{ contents, { }, { &all_nodes, &functions } };
+    ParsedScript const pipelined_script{ contents, { .pipelined = true }, { &pipelined_functions } };
+
+    ice::arctic::SyntaxVisitorBase* const visitors[]{ &visited_functions };
+    ice::arctic::visit_definitions(script.definitions(), visitors);
+    ice::arctic::SyntaxVisitorBase* const parallel_visitors[]{ &parallel_functions };
+    ice::arctic::visit_definitions_parallel(script.definitions(), parallel_visitors);
+
+    std::vector<ice::arctic::SyntaxEntity> expected;
+    std::copy_if(
+        all_nodes.entities.begin(), all_nodes.entities.end(), std::back_inserter(expected),
+        [](ice::arctic::SyntaxEntity entity) noexcept { return entity == ice::arctic::SyntaxEntity::DEF_Function; }
+    );
+
+    bool const skipped = script.state == ice::arctic::ParseState::Success
+        && expected.size() < all_nodes.entities.size()
+        && functions.entities == expected
+        && pipelined_functions.entities == expected
+        && visited_functions.entities == expected
+        && parallel_functions.entities == expected;
+
+    std::cout << fmt::format(
+        "Visited {} of {} nodes, masked visitors {}\n",
+        expected.size(),
+        all_nodes.entities.size(),
+        skipped ? "skipped all other nodes" : "were called for other nodes"
+    );
+    return skipped ? 0 : -1;
+}
+
+//! \brief Parses scripts importing modules written to a temporary directory, covering duplicate, missing and cyclic imports.
+auto imports_check() noexcept -> int
+{
+    std::filesystem::path const directory = std::filesystem::temp_directory_path() / "arctic_imports";
+    std::filesystem::create_directories(directory / "lib");
+
+    std::pair<char const*, std::string_view> const modules[]{
+        { "camera.arctic", "context Shader\n\ndef Camera = struct [\n    view : mtx4f\n    projection : mtx4f\n]\n" },
+        { "scene.arctic", "context Shader\nimport \"camera.arctic\"\n\ndef Light = struct [\n    position : vec3f\n]\n" },
+        { "broken.arctic", "context Shader\nimport \"missing.arctic\"\n" },
+        { "cycle_a.arctic", "context Shader\nimport \"cycle_b.arctic\"\n" },
+        { "cycle_b.arctic", "context Shader\nimport \"cycle_a.arctic\"\n" },
+        // Imports are relative to the importing module, so 'lib/shading.arctic' gets the struct from 'lib/common.arctic'.
+        { "common.arctic", "context Shader\n\ndef Unrelated = struct [\n    value : f32\n]\n" },
+        { "lib/common.arctic", "context Shader\n\ndef Material = struct [\n    albedo : vec4f\n]\n" },
+        { "lib/shading.arctic", "context Shader\nimport \"common.arctic\"\n\ndef Surface = struct [\n    normal : vec3f\n]\n" },
+    };
+    for (auto const& [name, module_source] : modules)
+    {
+        std::ofstream{ directory / name, std::ios::binary } << module_source;
+    }
+
+    struct ImportCase
+    {
+        std::string_view name;
+        ice::String source;
+        ice::arctic::ParseState expected;
+        ice::u32 expected_definitions;
+        ice::String import_directory = { };
+    };
+
+    std::u8string const lib_directory = (directory / "lib").generic_u8string();
+
+    ImportCase const cases[]{
+        {
+            "import",
+            u8"context Shader\n\nimport \"scene.arctic\"\nimport \"camera.arctic\"\n\nctx\n{\n    [constant]\n    let camera : Camera\n}\n",
+            ice::arctic::ParseState::Success,
+            4
+        },
+        { "missing", u8"context Shader\n\nimport \"missing.arctic\"\n", ice::arctic::ParseState::Error_Import_NotFound, 0 },
+        { "nested missing", u8"context Shader\n\nimport \"broken.arctic\"\n", ice::arctic::ParseState::Error_Import_ModuleFailed, 0 },
+        { "cycle", u8"context Shader\n\nimport \"cycle_a.arctic\"\n", ice::arctic::ParseState::Error_Import_Cycle, 0 },
+        {
+            "relative",
+            u8"context Shader\n\nimport \"lib/shading.arctic\"\n\nctx\n{\n    [constant]\n    let material : Material\n}\n",
+            ice::arctic::ParseState::Success,
+            4
+        },
+        {
+            "import directory",
+            u8"context Shader\n\nimport \"common.arctic\"\n\nctx\n{\n    [constant]\n    let material : Material\n}\n",
+            ice::arctic::ParseState::Success,
+            3,
+            lib_directory
+        },
+    };
+
+    ice::arctic::ModuleCache modules_cache{ directory };
+
+    int result = 0;
+    for (ImportCase const& import_case : cases)
+    {
+        // Imported types need to be resolved through the parser definitions alone.
+        ParsedScript script{ import_case.source, { .modules = &modules_cache, .import_directory = import_case.import_directory } };
+        ice::arctic::ParseState const state = script.resolve();
+
+        bool const passed = state == import_case.expected
+            && (state != ice::arctic::ParseState::Success || script.definitions().size() == import_case.expected_definitions);
+        std::cout << fmt::format(
+            "{}: {}, {} definitions ({})\n",
+            import_case.name,
+            ice::arctic::to_string(state),
+            script.definitions().size(),
+            passed ? "passed" : "failed"
+        );
+        result = passed ? result : -1;
+    }
+
+    // Threads loading the same modules into an empty cache, including both sides of a cycle, need to get the same results.
+    ice::arctic::ModuleCache parallel_cache{ directory };
+    ice::arctic::WordMatcher matcher{ };
+    ice::arctic::initialize_ascii_matcher(&matcher);
+
+    ice::String const parallel_sources[]{
+        cases[0].source,
+        u8"context Shader\n\nimport \"cycle_a.arctic\"\n",
+        u8"context Shader\n\nimport \"cycle_b.arctic\"\n",
+        cases[4].source,
+    };
+    ice::arctic::ParseState const parallel_expected[]{
+        ice::arctic::ParseState::Success,
+        ice::arctic::ParseState::Error_Import_Cycle,
+        ice::arctic::ParseState::Error_Import_Cycle,
+        ice::arctic::ParseState::Success,
+    };
+
+    std::atomic_uint32_t parallel_failures = 0;
+    {
+        std::vector<std::jthread> threads;
+        for (ice::u32 idx = 0; idx < 16; ++idx)
+        {
+            threads.emplace_back([&, idx]() noexcept
+                {
+                    // Diagnostics are not printed, the output of threads would be interleaved.
+                    ice::arctic::Parser parser{ { .modules = &parallel_cache } };
+                    ice::arctic::Lexer lexer = ice::arctic::create_lexer(
+                        ice::arctic::create_word_processor(parallel_sources[idx % 4], &matcher)
+                    );
+                    if (parser.parse(lexer) != parallel_expected[idx % 4])
+                    {
+                        parallel_failures += 1;
+                    }
+                }
+            );
+        }
+    }
+    ice::arctic::shutdown_matcher(&matcher);
+
+    std::cout << fmt::format(
+        "parallel: {} modules, {} failures ({})\n",
+        parallel_cache.module_count(),
+        parallel_failures.load(),
+        parallel_failures == 0 ? "passed" : "failed"
+    );
+    return parallel_failures == 0 ? result : -1;
+}
+
+//! \brief Collects the node and all nodes owned by it in the order 'walk' enters them, using recursion.
+void collect_syntax_nodes(ice::arctic::SyntaxNode const* node, std::vector<ice::arctic::SyntaxNode const*>* out_groups) noexcept
+{
+    out_groups[static_cast<ice::u32>(node->entity)].push_back(node);
+    for (ice::arctic::SyntaxNode const* child = node->child; child != nullptr; child = child->sibling)
+    {
+        collect_syntax_nodes(child, out_groups);
+    }
+
+    if (node->entity == ice::arctic::SyntaxEntity::DEF_Function && node->sibling != nullptr)
+    {
+        collect_syntax_nodes(node->sibling, out_groups);
+    }
+}
+
+//! \brief Compares the node index of the script and of a script nested deeper than the index walker supports with all nodes of their definitions.
+auto index_check(ice::utf8 const* contents) noexcept -> int
+{
+    std::u8string deep_script{ u8"context Shader\n\nfn Deep() : void\n{\n    Deep = " };
+    deep_script.append(1500, u8'(');
+    deep_script.append(u8"1");
+    deep_script.append(1500, u8')');
+    deep_script.append(u8"\n}\n");
+
+    int result = 0;
+    for (ice::String const source : { ice::String{ contents }, ice::String{ deep_script } })
+    {
+        ParsedScript const script{ source, { .build_node_index = true } };
+
+        std::vector<ice::arctic::SyntaxNode const*> expected[ice::arctic::Constant_SyntaxEntityCount];
+        for (ice::arctic::SyntaxNode const* definition : script.definitions())
+        {
+            collect_syntax_nodes(definition, expected);
+        }
+
+        bool matches = script.state == ice::arctic::ParseState::Success;
+        ice::u64 node_count = 0;
+        for (ice::u32 idx = 0; idx < ice::arctic::Constant_SyntaxEntityCount; ++idx)
+        {
+            ice::Span<ice::arctic::SyntaxNode const* const> const indexed = script.parser.node_index().nodes(ice::arctic::SyntaxEntity(idx));
+            matches = matches && std::equal(indexed.begin(), indexed.end(), expected[idx].begin(), expected[idx].end());
+            node_count += indexed.size();
+        }
+
+        std::cout << fmt::format("Indexed {} nodes, {}\n", node_count, matches ? "all nodes listed in order" : "index differs from the tree");
+        result = matches ? result : -1;
+    }
+    return result;
+}
+
+//! \brief Hashes scripts with two functions sharing a variable definition, the variables need to hash equal and the functions different.
+//! \note The second script nests the variable deeper than the hashing walker supports.
+auto hash_check() noexcept -> int
+{
+    auto const make_script = [](ice::u32 nesting) noexcept -> std::u8string
+    {
+        std::u8string value;
+        value.append(nesting, u8'(');
+        value.append(u8"1.0 + 2.0");
+        value.append(nesting, u8')');
+
+        std::u8string script{ u8"context Shader\n" };
+        for (std::u8string_view const name : { u8"First", u8"Second" })
+        {
+            // Different line breaks move the second function without changing its tokens.
+            script.append(name == u8"First" ? u8"\n" : u8"\n\n\n");
+            script.append(u8"fn ").append(name).append(u8"() : void\n{\n");
+            script.append(u8"    let value : f32 = ").append(value).append(u8"\n");
+            script.append(u8"    ").append(name).append(u8" = value\n}\n");
+        }
+        return script;
+    };
+
+    int result = 0;
+    for (ice::u32 const nesting : { 2u, 1500u })
+    {
+        std::u8string const source = make_script(nesting);
+        ParsedScript const script{ source, { .build_node_index = true } };
+
+        ice::arctic::SyntaxTreeHashes hashes;
+        for (ice::arctic::SyntaxNode const* definition : script.definitions())
+        {
+            hashes.add_definition(definition);
+        }
+
+        ice::Span<ice::arctic::SyntaxNode const* const> const functions = script.parser.node_index().nodes(ice::arctic::SyntaxEntity::DEF_Function);
+        ice::Span<ice::arctic::SyntaxNode const* const> const variables = script.parser.node_index().nodes(ice::arctic::SyntaxEntity::DEF_Variable);
+
+        bool const matches = script.state == ice::arctic::ParseState::Success
+            && functions.size() == 2 && variables.size() == 2
+            && hashes.hash(variables[0]) != 0
+            && hashes.hash(variables[0]) == hashes.hash(variables[1])
+            && hashes.hash(variables[0]) == ice::arctic::hash_syntax_tree(variables[1])
+            && hashes.hash(functions[0]) != hashes.hash(functions[1]);
+
+        std::cout << fmt::format(
+            "Nesting {}: variable hashes {:#x} {:#x}, {}\n",
+            nesting,
+            hashes.hash(variables.empty() ? nullptr : variables[0]),
+            hashes.hash(variables.size() < 2 ? nullptr : variables[1]),
+            matches ? "identical subtrees hash equal" : "unexpected hashes"
+        );
+        result = matches ? result : -1;
+    }
+    return result;
+}
+
+//! \brief Resolves entry functions with a single assignment each, errors need to be reported at the expected operation.
+//! \note Right sides are binary expressions, so the assignment is only valid if it's checked after operator precedence.
+auto semantic_check() noexcept -> int
+{
+    struct Case
+    {
+        ice::String statement;
+        ice::arctic::ParseState expected_state;
+        ice::String expected_token;
+    };
+
+    Case const cases[]{
+        { u8"out_color = camera.view * in_color", ice::arctic::ParseState::Success, u8"" },
+        { u8"VertexMain = in_color * 2.0", ice::arctic::ParseState::Success, u8"" },
+        { u8"VertexMain = camera.projection * camera.view * vec4f(in_vertex, 1)", ice::arctic::ParseState::Success, u8"" },
+        { u8"out_color = in_vertex * 2.0", ice::arctic::ParseState::Error_Semantic_TypeMismatch, u8"=" },
+        { u8"out_color = in_color * 2", ice::arctic::ParseState::Error_Semantic_TypeMismatch, u8"*" },
+        { u8"out_color = camera.view * in_color * 0.5", ice::arctic::ParseState::Success, u8"" },
+    };
+
+    int result = 0;
+    for (Case const& test_case : cases)
+    {
+        std::u8string source{
+            u8"context Shader\n\n"
+            u8"def Camera = struct [\n    view : mtx4f\n    projection : mtx4f\n]\n\n"
+            u8"ctx\n{\n"
+            u8"    [in=0]\n    let in_vertex : vec3f\n\n"
+            u8"    [in=1]\n    let in_color : vec4f\n\n"
+            u8"    [out=0]\n    let out_color : vec4f\n\n"
+            u8"    [constant]\n    let camera : Camera\n}\n\n"
+            u8"fn VertexMain() : VertexShader\n{\n    "
+        };
+        source.append(test_case.statement).append(u8"\n}\n");
+
+        ParsedScript script{ source };
+        ice::arctic::ParseState const state = script.resolve();
+
+        ice::Span<ice::arctic::ParseDiagnostic const> const diagnostics = script.semantic_model.diagnostics();
+        bool const matches = state == test_case.expected_state
+            && (diagnostics.empty() || diagnostics[0].token.value == test_case.expected_token);
+
+        std::cout << fmt::format(
+            "Resolving {}: {}\n",
+            std::string_view{ reinterpret_cast<char const*>(test_case.statement.data()), test_case.statement.size() },
+            matches ? "expected result" : "unexpected result"
+        );
+        result = matches ? result : -1;
+    }
+    return result;
+}
+
+//! \brief Folds constants with invalid initializers, each error needs to be reported once at the failing operation.
+//! \note The folder runs even if the semantic model already reported the error, so both checks are exercised.
+auto fold_errors_check() noexcept -> int
+{
+    struct Case
+    {
+        ice::String definition;
+        ice::arctic::ParseState expected_state;
+        ice::String expected_token;
+    };
+
+    Case const cases[]{
+        { u8"const a : i32 = 2 * 3.0", ice::arctic::ParseState::Error_Semantic_TypeMismatch, u8"*" },
+        { u8"const a : f32 = 1.0 / 0.0", ice::arctic::ParseState::Error_Semantic_DivisionByZero, u8"/" },
+        { u8"const a : i32 = 1 / 0", ice::arctic::ParseState::Error_Semantic_DivisionByZero, u8"/" },
+    };
+
+    int result = 0;
+    for (Case const& test_case : cases)
+    {
+        std::u8string source{ u8"context Shader\n\n" };
+        source.append(test_case.definition).append(u8"\n");
+
+        ParsedScript script{ source };
+        bool const parsed = script.state == ice::arctic::ParseState::Success;
+        script.resolve();
+
+        ice::arctic::ParseState state = script.state;
+        ice::arctic::ConstantFolder folder{ script.parser, script.semantic_model };
+        if (parsed)
+        {
+            state = folder.fold(script.definitions());
+            print_diagnostics(folder.diagnostics());
+        }
+
+        ice::Span<ice::arctic::ParseDiagnostic const> const diagnostics = folder.diagnostics();
+        bool const matches = state == test_case.expected_state
+            && diagnostics.size() == 1
+            && diagnostics[0].token.value == test_case.expected_token;
+
+        std::cout << fmt::format(
+            "Folding {}: {}\n",
+            std::string_view{ reinterpret_cast<char const*>(test_case.definition.data()), test_case.definition.size() },
+            matches ? "reported once at the operation" : "unexpected diagnostics"
+        );
+        result = matches ? result : -1;
+    }
+    return result;
+}
+
+//! \brief Folds function bodies and compares them with the expected result, errors need to be reported once at the failing operation.
+//! \note Statements with errors need to be kept as they are, other statements are still folded.
+auto fold_check() noexcept -> int
+{
+    struct Case
+    {
+        ice::String statements;
+        ice::String expected_body;
+        ice::arctic::ParseState expected_state;
+        ice::String expected_token;
+        ice::u32 expected_column;
+    };
+
+    Case const cases[]{
+        {
+            u8"    const half : f32 = Scale / 16.0\n"
+            u8"    let x : f32 = in_color.x\n"
+            u8"    let y : f32 = x * (2.0 * 3.0) + -(1.0 + 1.0)\n"
+            u8"    let z : i32 = 2 * 3 + Count - 1\n"
+            u8"    let u : f32 = 1.0 + 2.0 + x\n"
+            u8"    let v : f32 = x + 1.0 + 2.0\n"
+            u8"    out_color = vec4f(half * 2.0, 1.0 - 0.5, x, 3.0 / 4.0)\n",
+            u8"  const f32 half = 0.5;\n"
+            u8"  f32 x = in_color.x;\n"
+            u8"  f32 y = x * 6.0 + -2.0;\n"
+            u8"  i32 z = 8;\n"
+            u8"  f32 u = 3.0 + x;\n"
+            u8"  f32 v = x + 1.0 + 2.0;\n"
+            u8"  out_color = vec4f(1.0, 0.5, x, 0.75);\n",
+            ice::arctic::ParseState::Success, u8"", 0
+        },
+        {
+            u8"    let x : f32 = in_color.x\n"
+            u8"    let y : f32 = x * (2 * 3.0)\n"
+            u8"    let z : f32 = 2.0 * 3.0\n",
+            u8"  f32 x = in_color.x;\n"
+            u8"  f32 y = x * (2 * 3.0);\n"
+            u8"  f32 z = 6.0;\n",
+            ice::arctic::ParseState::Error_Semantic_TypeMismatch, u8"*", 26
+        },
+        {
+            u8"    let x : f32 = in_color.x\n"
+            u8"    let y : f32 = x + 1.0 / 0.0\n"
+            u8"    let z : f32 = 1.0 / 4.0\n",
+            u8"  f32 x = in_color.x;\n"
+            u8"  f32 y = x + 1.0 / 0.0;\n"
+            u8"  f32 z = 0.25;\n",
+            ice::arctic::ParseState::Error_Semantic_DivisionByZero, u8"/", 27
+        },
+    };
+
+    int result = 0;
+    for (Case const& test_case : cases)
+    {
+        std::u8string source{
+            u8"context Shader\n\n"
+            u8"const Scale : f32 = 2.0 * 4.0\n"
+            u8"const Count : i32 = Base * 3\n"
+            u8"const Base : i32 = -2 + 3\n\n"
+            u8"ctx\n{\n"
+            u8"    [in=0]\n    let in_color : vec4f\n\n"
+            u8"    [out=0]\n    let out_color : vec4f\n}\n\n"
+            u8"fn VertexMain() : VertexShader\n{\n"
+        };
+        source.append(test_case.statements).append(u8"}\n");
+
+        ParsedScript script{ source };
+        bool const parsed = script.state == ice::arctic::ParseState::Success;
+        script.resolve();
+
+        ice::arctic::ParseState state = script.state;
+        ice::arctic::ConstantFolder folder{ script.parser, script.semantic_model };
+        if (parsed)
+        {
+            state = folder.fold(script.definitions());
+            print_diagnostics(folder.diagnostics());
+        }
+
+        ice::Span<ice::arctic::ParseDiagnostic const> const diagnostics = folder.diagnostics();
+        bool const reported = test_case.expected_token.empty()
+            ? diagnostics.empty()
+            : diagnostics.size() == 1
+                && diagnostics[0].token.value == test_case.expected_token
+                && diagnostics[0].token.location.column == test_case.expected_column;
+
+        std::u8string const body = function_body_text(script.definitions(), u8"VertexMain");
+        bool const matches = parsed && state == test_case.expected_state && reported && body == test_case.expected_body;
+
+        std::cout << fmt::format(
+            "Folding case {}: {}\n",
+            std::distance(cases, &test_case),
+            matches ? "expected result" : "unexpected result"
+        );
+        if (matches == false)
+        {
+            std::cout << std::string_view{ reinterpret_cast<char const*>(body.data()), body.size() };
+        }
+        result = matches ? result : -1;
+    }
+    return result;
+}
+
+//! \brief Parses the script without visitors and runs both transpilers over the result at the same time.
+auto parallel_transpile(ice::utf8 const* contents) noexcept -> int
+{
+    Transpilers transpilers;
+    ParsedScript const script{ contents };
+    if (script.state == ice::arctic::ParseState::Success)
+    {
+        transpilers.visit_parallel(script.definitions());
+    }
+    return script.state == ice::arctic::ParseState::Success ? 0 : -1;
+}
+
+//! \brief Parses the script without visitors, folds constant expressions and runs both transpilers over the result.
+auto folded_transpile(ice::utf8 const* contents) noexcept -> int
+{
+    Transpilers transpilers;
+    ParsedScript script{ contents };
+
+    // Folding depends on resolved types, so the tree is only modified if the semantic model is valid.
+    ice::arctic::ParseState state = script.resolve();
+
+    // The folder owns the text of new literals, so it needs to outlive the transpilers.
+    ice::arctic::ConstantFolder folder{ script.parser, script.semantic_model };
+    if (state == ice::arctic::ParseState::Success)
+    {
+        state = folder.fold(script.definitions());
+        print_diagnostics(folder.diagnostics());
+    }
+
+    if (state == ice::arctic::ParseState::Success)
+    {
+        std::cout << "Folded: " << folder.folded_count() << std::endl;
+        transpilers.visit(script.definitions());
+    }
+    return state == ice::arctic::ParseState::Success ? 0 : -1;
+}
+
+//! \brief Parses the script without visitors, moves batch uniform subexpressions into a prologue and transpiles the result.
+auto hoisted_transpile(ice::utf8 const* contents) noexcept -> int
+{
+    Transpilers transpilers;
+
+    // Annotations are needed to find '[constant]' context variables.
+    ParsedScript script{ contents, { .decode_annotations = true } };
+    ice::arctic::ParseState const state = script.resolve();
+
+    // The hoister owns the names of prologue variables, so it needs to outlive the transpilers.
+    ice::arctic::UniformityAnalysis uniformity{ script.semantic_model, script.parser.annotation_tables() };
+    ice::arctic::UniformHoister hoister{ script.parser, script.semantic_model, uniformity };
+    if (state == ice::arctic::ParseState::Success)
+    {
+        uniformity.analyze(script.definitions());
+        std::cout << "Hoisted: " << hoister.hoist(script.definitions()) << std::endl;
+
+        // The prologue runs once per batch, its results are shared by all entities.
+        std::u8string prologue;
+        ExpressionWriter<GLSL_Transpiler> writer{ transpilers.glsl, prologue };
+        for (ice::arctic::SyntaxNode_Variable const* variable : hoister.prologue())
+        {
+            ice::arctic::walk(static_cast<ice::arctic::SyntaxNode const*>(variable), writer);
+        }
+        std::cout << "Prologue:\n" << std::string_view{ reinterpret_cast<char const*>(prologue.data()), prologue.size() };
+
+        transpilers.visit(script.definitions());
+    }
+    return state == ice::arctic::ParseState::Success ? 0 : -1;
+}
+
+//! \brief Parses the script without visitors, replaces repeated subexpressions with local variables and transpiles the result.
+auto eliminated_transpile(ice::utf8 const* contents) noexcept -> int
+{
+    Transpilers transpilers;
+    ParsedScript script{ contents };
+    ice::arctic::ParseState const state = script.resolve();
+
+    // The eliminator owns the names of new variables, so it needs to outlive the transpilers.
+    ice::arctic::SubexpressionEliminator eliminator{ script.parser, script.semantic_model };
+    if (state == ice::arctic::ParseState::Success)
+    {
+        std::cout << "Variables: " << eliminator.eliminate(script.definitions()) << std::endl;
+        std::cout << "Replaced: " << eliminator.replaced_count() << std::endl;
+        transpilers.visit(script.definitions());
+    }
+    return state == ice::arctic::ParseState::Success ? 0 : -1;
+}
+
+//! \brief Eliminates repeated subexpressions of a single function and compares the body with the expected result.
+//! \note Terms reading a variable assigned between two occurrences and context reads after a call may not be shared.
+auto cse_check() noexcept -> int
+{
+    ice::String const source =
+        u8"context Shader\n\n"
+        u8"def Camera = struct [\n    view : mtx4f\n    projection : mtx4f\n    exposure : f32\n]\n\n"
+        u8"ctx\n{\n"
+        u8"    [in=0]\n    let in_position : vec4f\n\n"
+        u8"    [in=1]\n    let in_scale : f32\n\n"
+        u8"    [out=0]\n    let out_position : vec4f\n\n"
+        u8"    [out=1]\n    let out_color : vec4f\n\n"
+        u8"    [constant]\n    let camera : Camera\n}\n\n"
+        u8"fn Helper(value : f32) : f32\n{\n    Helper = value * 2.0\n}\n\n"
+        u8"fn VertexMain() : VertexShader\n{\n"
+        u8"    let scaled : vec4f = in_position * in_scale\n"
+        u8"    let base : vec4f = in_position * in_scale\n"
+        u8"    let lit : f32 = camera.exposure * in_scale + 1.0\n"
+        u8"    out_color = vec4f(camera.exposure * in_scale + 1.0, 0.0, 0.0, 1.0)\n"
+        u8"    let p0 : vec4f = camera.projection * camera.view * scaled\n"
+        u8"    scaled = base * 2.0\n"
+        u8"    let p1 : vec4f = camera.projection * camera.view * scaled + base\n"
+        u8"    out_position = p1\n"
+        u8"    let neg : vec4f = -(base * 2.0)\n"
+        u8"    let again : vec4f = -(base * 2.0)\n"
+        u8"    let h : f32 = Helper(in_scale * in_scale)\n"
+        u8"    let h2 : f32 = in_scale * in_scale + Helper(lit)\n"
+        u8"}\n";
+
+    // 'p1' reads 'scaled' after it was assigned, so only the camera matrices are shared with 'p0'.
+    ice::String const expected_body =
+        u8"  vec4f scaled = in_position * in_scale;\n"
+        u8"  vec4f base = scaled;\n"
+        u8"  f32 lit = camera.exposure * in_scale + 1.0;\n"
+        u8"  out_color = vec4f(lit, 0.0, 0.0, 1.0);\n"
+        u8"  mtx4f common_value_0 = camera.projection * camera.view;\n"
+        u8"  vec4f p0 = common_value_0 * scaled;\n"
+        u8"  vec4f common_value_1 = base * 2.0;\n"
+        u8"  scaled = common_value_1;\n"
+        u8"  vec4f p1 = common_value_0 * scaled + base;\n"
+        u8"  out_position = p1;\n"
+        u8"  vec4f neg = -(common_value_1);\n"
+        u8"  vec4f again = neg;\n"
+        u8"  f32 h = Helper(in_scale * in_scale);\n"
+        u8"  f32 h2 = in_scale * in_scale + Helper(lit);\n";
+
+    ParsedScript script{ source };
+    if (script.resolve() != ice::arctic::ParseState::Success)
+    {
+        return -1;
+    }
+
+    ice::arctic::SubexpressionEliminator eliminator{ script.parser, script.semantic_model };
+    ice::u32 const variables = eliminator.eliminate(script.definitions());
+
+    std::u8string const body = function_body_text(script.definitions(), u8"VertexMain");
+    bool const matches = variables == 2 && eliminator.replaced_count() == 8 && body == expected_body;
+
+    std::cout << "Variables: " << variables << "\nReplaced: " << eliminator.replaced_count() << "\n"
+        << std::string_view{ reinterpret_cast<char const*>(body.data()), body.size() }
+        << (matches ? "Eliminated the expected subexpressions" : "Unexpected result") << std::endl;
+    return matches ? 0 : -1;
+}
+
+//! \brief Parses the script without visitors and writes C++ definitions of all structs for each set of layout rules.
+auto layout_header(ice::utf8 const* contents) noexcept -> int
+{
+    ParsedScript script{ contents };
+    if (script.state != ice::arctic::ParseState::Success)
+    {
+        return -1;
+    }
+
+    ice::arctic::ParseState const state = script.resolve();
+
+    std::vector<ice::arctic::TypeHandle> types;
+    for (ice::arctic::SyntaxNode const* definition : script.definitions())
+    {
+        ice::arctic::TypeHandle const type = script.semantic_model.type_of(definition);
+        if (type != nullptr && type->kind == ice::arctic::TypeKind::Struct && type->definition == definition)
+        {
+            types.push_back(type);
+        }
+    }
+
+    std::u8string header = u8"#pragma once\n#include <ice/arctic_types.hxx>\n#include <cstddef>\n\n";
+    for (ice::arctic::LayoutRules const rules : {
+        ice::arctic::LayoutRules::Host,
+        ice::arctic::LayoutRules::Std140,
+        ice::arctic::LayoutRules::Std430,
+        ice::arctic::LayoutRules::HlslCBuffer })
+    {
+        ice::arctic::StructLayoutTable layouts{ rules };
+        ice::arctic::write_layout_header(layouts, types, header);
+    }
+    std::cout << std::string_view{ reinterpret_cast<char const*>(header.data()), header.size() };
+    return state == ice::arctic::ParseState::Success ? 0 : -1;
+}
+
+//! \brief Parses the script without visitors, prunes everything not used by entry functions and transpiles the result.
+auto pruned_transpile(ice::utf8 const* contents) noexcept -> int
+{
+    static constexpr std::string_view Constant_PrunedKindNames[]{
+        "input", "output", "constant", "context variable", "variable", "function", "member"
+    };
+
+    Transpilers transpilers;
+
+    // Annotations are needed to report the bindings of pruned inputs and outputs.
+    ParsedScript script{ contents, { .decode_annotations = true } };
+    ice::arctic::ParseState const state = script.resolve();
+
+    ice::arctic::InterfacePruner pruner{ script.parser, script.semantic_model, script.parser.annotation_tables() };
+    if (state == ice::arctic::ParseState::Success)
+    {
+        std::cout << "Pruned: " << pruner.prune(script.definitions()) << std::endl;
+        for (ice::arctic::PrunedEntry const& entry : pruner.pruned())
+        {
+            std::cout << "  " << Constant_PrunedKindNames[static_cast<ice::u32>(entry.kind)] << " ";
+            if (entry.owner.empty() == false)
+            {
+                std::cout << std::string_view{ reinterpret_cast<char const*>(entry.owner.data()), entry.owner.size() } << ".";
+            }
+            std::cout << std::string_view{ reinterpret_cast<char const*>(entry.name.value.data()), entry.name.value.size() };
+            if (entry.binding.empty() == false)
+            {
+                std::cout << " @ " << std::string_view{ reinterpret_cast<char const*>(entry.binding.data()), entry.binding.size() };
+            }
+            std::cout << std::endl;
+        }
+
+        // Members were removed from the tree, so layouts are computed by a model of the remaining definitions.
+        ice::arctic::SemanticModel pruned_model;
+        pruned_model.add_definitions(pruner.definitions());
+        pruned_model.resolve();
+
+        std::vector<ice::arctic::TypeHandle> types;
+        for (ice::arctic::SyntaxNode const* definition : pruner.definitions())
+        {
+            ice::arctic::TypeHandle const type = pruned_model.type_of(definition);
+            if (type != nullptr && type->kind == ice::arctic::TypeKind::Struct && type->definition == definition)
+            {
+                types.push_back(type);
+            }
+        }
+
+        std::u8string header;
+        ice::arctic::StructLayoutTable layouts{ ice::arctic::LayoutRules::Std140 };
+        ice::arctic::write_layout_header(layouts, types, header);
+        std::cout << "Layout:\n" << std::string_view{ reinterpret_cast<char const*>(header.data()), header.size() };
+
+        transpilers.visit(pruner.definitions());
+    }
+    return state == ice::arctic::ParseState::Success ? 0 : -1;
+}
+
+//! \brief Prunes a script reading one of two inputs, only the unused input may be pruned.
+//! \note The second script nests the used input deeper than the reachability walker supports.
+auto prune_depth_check() noexcept -> int
+{
+    int result = 0;
+    for (ice::u32 const nesting : { 2u, 300u })
+    {
+        std::u8string source{
+            u8"context Shader\n\n"
+            u8"ctx\n{\n"
+            u8"    [in=0]\n    let in_a : vec4f\n\n"
+            u8"    [in=1]\n    let in_b : vec4f\n\n"
+            u8"    [out=0]\n    let out_color : vec4f\n}\n\n"
+            u8"fn VertexMain() : VertexShader\n{\n    out_color = "
+        };
+        source.append(nesting, u8'(').append(u8"in_a").append(nesting, u8')');
+        source.append(u8"\n    VertexMain = out_color\n}\n");
+
+        ParsedScript script{ source, { .decode_annotations = true } };
+        ice::arctic::ParseState const state = script.resolve();
+
+        ice::arctic::InterfacePruner pruner{ script.parser, script.semantic_model, script.parser.annotation_tables() };
+        ice::u32 const pruned_count = state == ice::arctic::ParseState::Success ? pruner.prune(script.definitions()) : 0;
+
+        bool const matches = state == ice::arctic::ParseState::Success
+            && pruned_count == 1
+            && pruner.pruned()[0].name.value == u8"in_b";
+
+        std::cout << fmt::format("Nesting {}: pruned {}, {}\n", nesting, pruned_count, matches ? "only the unused input" : "unexpected entries");
+        result = matches ? result : -1;
+    }
+    return result;
+}
+
+//! \brief Parses the script without visitors, inlines calls of small functions and transpiles the result.
+auto inlined_transpile(ice::utf8 const* contents) noexcept -> int
+{
+    Transpilers transpilers;
+    ParsedScript script{ contents };
+    ice::arctic::ParseState state = script.resolve();
+
+    // The inliner owns the names of new locals, so it needs to outlive the transpilers.
+    ice::arctic::FunctionInliner inliner{ script.parser, script.semantic_model };
+    if (state == ice::arctic::ParseState::Success)
+    {
+        std::cout << "Inlined: " << inliner.inline_calls(script.definitions()) << std::endl;
+        for (ice::arctic::SyntaxNode const* definition : script.definitions())
+        {
+            if (definition->entity != ice::arctic::SyntaxEntity::DEF_Function)
+            {
+                continue;
+            }
+
+            std::cout << "  " << str_view(static_cast<ice::arctic::SyntaxNode_Function const*>(definition)->name) << ": ";
+            if (ice::u32 const cost = inliner.inline_cost(definition); cost != ice::arctic::FunctionInliner::Constant_NotInlinable)
+            {
+                std::cout << "cost " << cost << std::endl;
+            }
+            else
+            {
+                std::cout << "not inlinable" << std::endl;
+            }
+        }
+
+        // Copied bodies are checked by a new model, renamed locals can't clash with names of the caller.
+        ice::arctic::SemanticModel inlined_model;
+        inlined_model.add_definitions(script.definitions());
+        state = inlined_model.resolve();
+        print_diagnostics(inlined_model.diagnostics());
+
+        transpilers.visit(script.definitions());
+    }
+    return state == ice::arctic::ParseState::Success ? 0 : -1;
+}
+
+//! \brief Inlines helpers whose argument and local names collide with the caller's and compares the bodies with the expected result.
+//! \note Calls of helpers reading a global shadowed by a local of the caller need to be kept.
+auto inline_check() noexcept -> int
+{
+    ice::String const source =
+        u8"context Shader\n\n"
+        u8"const Scale : f32 = 2.0\n\n"
+        u8"ctx\n{\n"
+        u8"    [in=0]\n    let in_position : vec4f\n\n"
+        u8"    [in=1]\n    let in_scale : f32\n\n"
+        u8"    [out=0]\n    let out_color : vec4f\n}\n\n"
+        u8"fn Double(value : f32) : f32\n{\n    Double = value * Scale\n}\n\n"
+        u8"fn Blend(value : f32, weight : f32) : f32\n{\n"
+        u8"    let scaled : f32 = value * weight\n"
+        u8"    Blend = scaled + weight\n"
+        u8"}\n\n"
+        u8"fn Shadowed(value : f32) : f32\n{\n"
+        u8"    let Scale : f32 = 3.0\n"
+        u8"    Shadowed = Double(value)\n"
+        u8"}\n\n"
+        u8"fn VertexMain() : VertexShader\n{\n"
+        u8"    let value : f32 = in_scale\n"
+        u8"    let scaled : f32 = Blend(value, in_scale * 2.0)\n"
+        u8"    let weight : f32 = in_scale + Double(scaled)\n"
+        u8"    scaled = Blend(weight, value)\n"
+        u8"    out_color = vec4f(value, scaled, weight, 1.0)\n"
+        u8"    VertexMain = in_position\n"
+        u8"}\n";
+
+    // The last call passes the caller's 'weight' as the helper's 'value' and the other way around.
+    ice::String const expected_main =
+        u8"  f32 value = in_scale;\n"
+        u8"  f32 inlined_0_weight = in_scale * 2.0;\n"
+        u8"  f32 inlined_0_scaled = value * inlined_0_weight;\n"
+        u8"  f32 inlined_0_Blend = inlined_0_scaled + inlined_0_weight;\n"
+        u8"  f32 scaled = inlined_0_Blend;\n"
+        u8"  f32 inlined_1_Double = scaled * Scale;\n"
+        u8"  f32 weight = in_scale + inlined_1_Double;\n"
+        u8"  f32 inlined_2_scaled = weight * value;\n"
+        u8"  f32 inlined_2_Blend = inlined_2_scaled + value;\n"
+        u8"  scaled = inlined_2_Blend;\n"
+        u8"  out_color = vec4f(value, scaled, weight, 1.0);\n"
+        u8"  VertexMain = in_position;\n";
+
+    ice::String const expected_shadowed =
+        u8"  f32 Scale = 3.0;\n"
+        u8"  Shadowed = Double(value);\n";
+
+    ParsedScript script{ source };
+    if (script.resolve() != ice::arctic::ParseState::Success)
+    {
+        return -1;
+    }
+
+    ice::arctic::FunctionInliner inliner{ script.parser, script.semantic_model };
+    ice::u32 const inlined = inliner.inline_calls(script.definitions());
+
+    // Renamed locals may not clash with names of the caller, so the result needs to resolve without errors.
+    ice::arctic::SemanticModel inlined_model;
+    inlined_model.add_definitions(script.definitions());
+    ice::arctic::ParseState const state = inlined_model.resolve();
+    print_diagnostics(inlined_model.diagnostics());
+
+    std::u8string const main_body = function_body_text(script.definitions(), u8"VertexMain");
+    std::u8string const shadowed_body = function_body_text(script.definitions(), u8"Shadowed");
+    bool const matches = inlined == 3
+        && state == ice::arctic::ParseState::Success
+        && main_body == expected_main
+        && shadowed_body == expected_shadowed;
+
+    std::cout << "Inlined: " << inlined << "\n"
+        << std::string_view{ reinterpret_cast<char const*>(main_body.data()), main_body.size() }
+        << std::string_view{ reinterpret_cast<char const*>(shadowed_body.data()), shadowed_body.size() }
+        << (matches ? "Inlined the expected calls" : "Unexpected result") << std::endl;
+    return matches ? 0 : -1;
+}
+
+//! \brief Parses the script, compiles all functions to bytecode and prints the disassembly.
+auto bytecode_disassembly(ice::utf8 const* contents) noexcept -> int
+{
+    ParsedScript script{ contents };
+    ice::arctic::ParseState state = script.resolve();
+    if (state == ice::arctic::ParseState::Success)
+    {
+        ice::arctic::Bytecode bytecode;
+        ice::arctic::BytecodeCompiler compiler{ script.semantic_model };
+        state = compiler.compile(script.definitions(), bytecode);
+        print_diagnostics(compiler.diagnostics());
+
+        if (state == ice::arctic::ParseState::Success)
+        {
+            std::u8string disassembly;
+            ice::arctic::disassemble(bytecode.view(), disassembly);
+            std::cout << "Bytecode: " << bytecode.words().size() * sizeof(ice::u32) << " bytes\n"
+                << std::string_view{ reinterpret_cast<char const*>(disassembly.data()), disassembly.size() };
+        }
+    }
+    return state == ice::arctic::ParseState::Success ? 0 : -1;
+}
+
+//! \brief Script compiled together with this executable, syntax errors in it fail the build.
+static constexpr ice::String Constant_EmbeddedScriptSource =
+    u8"context Shader\n"
+    u8"\n"
+    u8"ctx\n"
+    u8"{\n"
+    u8"    [in=0]\n"
+    u8"    let in_position : vec4f\n"
+    u8"\n"
+    u8"    [out=0]\n"
+    u8"    let out_position : vec4f\n"
+    u8"}\n"
+    u8"\n"
+    u8"fn VertexMain() : VertexShader\n"
+    u8"{\n"
+    u8"    out_position = in_position\n"
+    u8"}\n";
+
+static constexpr auto Constant_EmbeddedScript = ice::arctic::compile(Constant_EmbeddedScriptSource);
+
+//! \brief Runs the transpilers over the embedded script, no parsing happens at runtime.
+//! \note The script is parsed afterwards only to check the runtime parser creates the same syntax tree.
+auto static_transpile() noexcept -> int
+{
+    ice::Span<ice::arctic::SyntaxNode const* const> const static_definitions = ice::arctic::static_syntax_tree<Constant_EmbeddedScript>().definitions();
+
+    {
+        Transpilers transpilers;
+        transpilers.visit(static_definitions);
+    }
+
+    ParsedScript const script{ Constant_EmbeddedScriptSource };
+    std::string const static_tree = syntax_tree_text(static_definitions);
+    std::string const runtime_tree = syntax_tree_text(script.definitions());
+
+    bool const matches = script.state == ice::arctic::ParseState::Success && static_tree.empty() == false && static_tree == runtime_tree;
+    if (matches)
+    {
+        std::cout << "Static syntax tree matches the runtime parser" << std::endl;
+    }
+    else
+    {
+        std::cout << "Static syntax tree:\n" << static_tree << "Runtime syntax tree:\n" << runtime_tree;
+    }
+    return matches ? 0 : -1;
+}
+
+//! \brief Parses the script and each form of the grammar with both parsers, the trees and the error states need to match.
+//! \note Imports are left out, the static parser can't resolve them and reports 'Error_Import_NotFound' instead.
+auto static_parity_check(ice::String script) noexcept -> int
+{
+    static constexpr ice::u32 Capacity = 2048;
+
+    ice::String const sources[]{
+        script,
+        // Type definitions.
+        u8"context Shader\n\n"
+        u8"def Color = typeof [vec4f]\n"
+        u8"def Position = alias [vec3f]\n"
+        u8"def Light = struct [\n"
+        u8"    color : Color\n"
+        u8"    radius : f32\n"
+        u8"]\n",
+        // Annotations with every kind of value, stacked annotations and annotations on each kind of definition.
+        u8"context Shader\n\n"
+        u8"[builtin]\n"
+        u8"def Tint = typeof [vec4f]\n\n"
+        u8"[in=0, flat, name=\"color\", scale=1.5, mask=0x0f, bits=0b101, mode=017, enabled=true, packed=false, kind=Light]\n"
+        u8"let tint : vec4f\n\n"
+        u8"[first]\n"
+        u8"[second=1]\n"
+        u8"fn Annotated() : void\n"
+        u8"{\n"
+        u8"}\n\n"
+        u8"[folded]\n"
+        u8"const limit : f32 = 1.0\n",
+        // Context blocks with empty lines and annotated, stacked and plain variables.
+        u8"context Shader\n\n"
+        u8"ctx\n"
+        u8"{\n\n"
+        u8"    [in=0]\n"
+        u8"    let in_a : vec4f\n"
+        u8"    [out=1, flat]\n"
+        u8"    [precise]\n"
+        u8"    let out_b : vec4f\n\n"
+        u8"    let plain : f32\n"
+        u8"}\n\n"
+        u8"ctx\n"
+        u8"{\n"
+        u8"}\n",
+        // Globals and every form of expression in a function body.
+        u8"context Shader\n\n"
+        u8"let global : f32\n"
+        u8"let initialized : f32 = 1.0\n"
+        u8"const folded : f32 = 2.0 * 3.0\n\n"
+        u8"fn Args(\n"
+        u8"    a : f32,\n"
+        u8"    b : vec4f\n"
+        u8") : f32\n"
+        u8"{\n"
+        u8"    let x : f32 = a + b.x * 2.0 - 1 / 3\n"
+        u8"    const y : u32 = 0x10 + 0b11 + 017 + 1\n"
+        u8"    let s : bool = true and false or x\n"
+        u8"    let t : str = \"text\"\n"
+        u8"    x = -a\n"
+        u8"    x = -(a + 1.0)\n"
+        u8"    x = (a + 1.0) * (b.y - 2.0)\n"
+        u8"    x = Args(a, b)\n"
+        u8"    x = Args(\n"
+        u8"        a,\n"
+        u8"        b\n"
+        u8"    )\n"
+        u8"    x = Args(Args(a, b), b)\n"
+        u8"    x = Args(b.zwxy, a)\n"
+        u8"    x = b.x.y\n"
+        u8"    x = Empty()\n"
+        u8"    {\n"
+        u8"        let inner : f32 = x\n"
+        u8"    }\n"
+        u8"    Args = x\n"
+        u8"}\n",
+        // Stray tokens at the top level are skipped by both parsers.
+        u8"context Shader\n\n"
+        u8"stray 1.0 + ( tokens )\n"
+        u8"fn After() : void\n"
+        u8"{\n"
+        u8"}\n",
+    };
+
+    // Only the states are compared for scripts with errors.
+    ice::String const invalid_sources[]{
+        u8"context Shader\n\nfn Broken( : vec4f\n",
+        u8"context Shader\n\nconst missing : f32\n",
+        u8"context Shader\n\ndef Open = struct\n",
+        u8"context Shader\n\nctx\n{\n    fn Inside() : void\n}\n",
+        u8"context Shader\n\ndef Unknown = 1\n",
+    };
+
+    ice::u32 mismatches = 0;
+    auto const compare = [&mismatches](ice::String source, bool is_valid) noexcept
+    {
+        std::unique_ptr<ice::arctic::StaticSyntaxImage<Capacity> const> const image = std::make_unique<ice::arctic::StaticSyntaxImage<Capacity>>(
+            ice::arctic::static_parse<Capacity>(source)
+        );
+
+        ParsedScript const runtime{ source };
+        std::string const static_tree = syntax_tree_text(*image);
+        std::string const runtime_tree = syntax_tree_text(runtime.definitions());
+
+        bool const matches = image->state == runtime.state && (is_valid
+            ? runtime.state == ice::arctic::ParseState::Success && static_tree.empty() == false && static_tree == runtime_tree
+            : runtime.state != ice::arctic::ParseState::Success
+        );
+        if (matches == false)
+        {
+            std::cout << "Mismatch in:\n" << std::string_view{ reinterpret_cast<char const*>(source.data()), source.size() }
+                << "\nStatic parser: " << ice::arctic::to_string(image->state) << "\n" << static_tree
+                << "Runtime parser: " << ice::arctic::to_string(runtime.state) << "\n" << runtime_tree;
+            mismatches += 1;
+        }
+    };
+
+    for (ice::String const source : sources)
+    {
+        compare(source, true);
+    }
+    for (ice::String const source : invalid_sources)
+    {
+        compare(source, false);
+    }
+
+    std::cout << "Compared " << std::size(sources) + std::size(invalid_sources) << " scripts, mismatches: " << mismatches << std::endl;
+    return mismatches == 0 ? 0 : -1;
+}
+
+auto main(int argc, char** argv) -> int
+{
+    if (argc < 2)
+    {
+        return -1;
+    }
+
+    std::filesystem::path script_path = std::filesystem::absolute(argv[1]);
+
+    Buffer<ice::utf8> contents;
+
+    HANDLE file_handle = CreateFile(script_path.c_str(), GENERIC_READ, 0, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file_handle != INVALID_HANDLE_VALUE)
+    {
+        DWORD const file_size = GetFileSize(file_handle, nullptr);
+        if (file_size != 0)
+        {
+            contents = Buffer<ice::utf8>{ file_size + 10 };
+            memset(contents._buffer, 0, file_size + 10);
+
+            DWORD bytes_read;
+            BOOL const read_result = ReadFile(file_handle, contents._buffer, file_size, &bytes_read, nullptr);
+        }
+
+        CloseHandle(file_handle);
+    }
+
+    if (argc >= 4 && std::string_view{ argv[2] } == "--batch")
+    {
+        return batch_stress_test(contents._buffer, ice::u32(std::atoi(argv[3])));
+    }
+
+    if (argc >= 4 && std::string_view{ argv[2] } == "--cache")
+    {
+        return cached_transpile(contents._buffer, std::filesystem::absolute(argv[3]));
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--cache-corrupt")
+    {
+        return cache_corruption_check(contents._buffer);
+    }
+
+    if (argc >= 6 && std::string_view{ argv[2] } == "--reparse")
+    {
+        return reparse_compare(contents._buffer, ice::u32(std::atoi(argv[3])), ice::u32(std::atoi(argv[4])), argv[5]);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--reparse-check")
+    {
+        return reparse_check();
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--recover")
+    {
+        return recovery_check();
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--limits")
+    {
+        return limits_check(contents._buffer);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--pipelined")
+    {
+        return pipelined_compare(contents._buffer);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--masked")
+    {
+        return masked_visitor_check(contents._buffer);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--imports")
+    {
+        return imports_check();
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--index")
+    {
+        return index_check(contents._buffer);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--hash")
+    {
+        return hash_check();
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--semantic")
+    {
+        return semantic_check();
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--fold-errors")
+    {
+        return fold_errors_check();
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--fold-check")
+    {
+        return fold_check();
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--parallel")
+    {
+        return parallel_transpile(contents._buffer);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--fold")
+    {
+        return folded_transpile(contents._buffer);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--hoist")
+    {
+        return hoisted_transpile(contents._buffer);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--cse")
+    {
+        return eliminated_transpile(contents._buffer);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--cse-check")
+    {
+        return cse_check();
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--layout")
+    {
+        return layout_header(contents._buffer);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--prune")
+    {
+        return pruned_transpile(contents._buffer);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--prune-depth")
+    {
+        return prune_depth_check();
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--inline")
+    {
+        return inlined_transpile(contents._buffer);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--inline-check")
+    {
+        return inline_check();
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--bytecode")
+    {
+        return bytecode_disassembly(contents._buffer);
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--static")
+    {
+        return static_transpile();
+    }
+
+    if (argc >= 3 && std::string_view{ argv[2] } == "--static-parity")
+    {
+        return static_parity_check(contents._buffer);
+    }
+
+    ice::u32 token_count = 0;
+
+    // The matcher and the lexer are created before parsing, so they are charged to separate stats.
+    ice::arctic::MemoryStats setup_stats{ };
+    ice::arctic::MemoryScope setup_scope{ setup_stats, ice::arctic::MemoryPhase::Other };
+
+    ice::arctic::WordMatcher matcher{ };
+    ice::arctic::initialize_ascii_matcher(&matcher);
+    {
+        ice::arctic::WordProcessor processor = ice::arctic::create_word_processor(
+            contents._buffer,
+            &matcher
+        );
+
+        ice::arctic::Lexer lexer = ice::arctic::create_lexer(
+            std::move(processor)
+        );
+
+
+        GLSL_Transpiler my_glsl_gen{ };
+        HLSL_Transpiler my_hlsl_gen{ };
+
+        // In check mode all errors are reported in a single pass.
+        ice::arctic::Parser parser{
+            ice::arctic::ParserOptions{ .recover_from_errors = argc >= 3 && std::string_view{ argv[2] } == "--check" }
+        };
+        parser.add_visitor(my_glsl_gen);
+        parser.add_visitor(my_hlsl_gen);
+
+        auto t1 = std::chrono::high_resolution_clock::now();
+
+        parser.parse(lexer);
+
+        auto t2 = std::chrono::high_resolution_clock::now();
+        print_diagnostics(parser.diagnostics());
+
+        // Names and types are only resolved when checking, transpilers don't depend on them yet.
+        if (argc >= 3 && std::string_view{ argv[2] } == "--check")
+        {
+            ice::arctic::SemanticModel semantic_model;
+            semantic_model.add_definitions(parser.definitions());
+            semantic_model.resolve();
+            print_diagnostics(semantic_model.diagnostics());
+        }
+
+        std::cout << "Tokens: " << token_count << std::endl;
+        std::cout << "Total time: " << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << "ms" << std::endl;
+
+        // Rule stats are only collected in builds with 'ICE_ARCTIC_PARSER_PROFILING' enabled.
+        if (argc >= 3 && std::string_view{ argv[2] } == "--profile")
+        {
+            std::cout << ice::arctic::parser_profile_table();
+        }
+        else if (argc >= 3 && std::string_view{ argv[2] } == "--profile-json")
+        {
+            std::cout << ice::arctic::parser_profile_json();
+        }
+        // Trace events are only recorded in builds with 'ICE_ARCTIC_TRACING' enabled.
+        else if (argc >= 3 && std::string_view{ argv[2] } == "--trace")
+        {
+            std::cout << ice::arctic::trace_json();
+        }
+        // Memory stats are only collected in builds with 'ICE_ARCTIC_MEMORY_TRACKING' enabled.
+        else if (argc >= 3 && std::string_view{ argv[2] } == "--memory")
+        {
+            ice::arctic::MemoryStats stats = parser.stats();
+            stats.merge(setup_stats);
+            std::cout << ice::arctic::memory_stats_json(stats);
+        }
     }
 
     ice::arctic::shutdown_matcher(&matcher);